@@ -0,0 +1,173 @@
+/*******************************************************************************
+ * AUTHOR      : Thuan Tang
+ * ID          : 00991588
+ * CLASS       : CS008
+ * HEADER      : btree
+ * DESCRIPTION : This program benchmarks the node search of BTree keys.
+ *      array_utils::first_ge counts 32/64-bit keys with the SIMD compares
+ *      the CPU has, found at run time, and walks other keys. Each table
+ *      times the walk against the count, first on node sized arrays and
+ *      then through BTree::contains(), where a Walked key wraps a long so
+ *      the same tree takes the walk.
+ *
+ *      USAGE: benchmark.out [-n lookups] [-s tree size]
+ ******************************************************************************/
+#include <cstdint>                   // int32_t, int64_t
+#include <cstdlib>                   // atoi()
+#include <iomanip>                   // setw(), setprecision()
+#include <iostream>                  // stream objects
+#include <random>                    // mt19937
+#include <string>                    // string
+#include <vector>                    // vector
+#include "../include/array_utils.h"  // first_ge(), simd_level()
+#include "../include/btree.h"        // BTree class
+#include "../include/timer.h"        // ChronoTimer class
+
+// long key without a SIMD compare, so first_ge walks it
+struct Walked {
+    long key;
+
+    Walked(long k = 0) : key(k) {}
+
+    friend bool operator<(const Walked& lhs, const Walked& rhs) {
+        return lhs.key < rhs.key;
+    }
+    friend bool operator>(const Walked& lhs, const Walked& rhs) {
+        return lhs.key > rhs.key;
+    }
+    friend bool operator<=(const Walked& lhs, const Walked& rhs) {
+        return lhs.key <= rhs.key;
+    }
+    friend bool operator>=(const Walked& lhs, const Walked& rhs) {
+        return lhs.key >= rhs.key;
+    }
+    friend bool operator==(const Walked& lhs, const Walked& rhs) {
+        return lhs.key == rhs.key;
+    }
+    friend bool operator!=(const Walked& lhs, const Walked& rhs) {
+        return lhs.key != rhs.key;
+    }
+    friend Walked& operator+=(Walked& lhs, const Walked& rhs) {
+        lhs.key = rhs.key;
+        return lhs;
+    }
+    friend std::ostream& operator<<(std::ostream& outs, const Walked& w) {
+        return outs << w.key;
+    }
+};
+
+// seconds for lookups of first_ge in random node sized arrays of T
+template <typename T>
+double time_search(std::size_t size, long lookups, bool is_walk);
+
+// seconds for lookups of contains() in a BTree of tree_size keys
+template <typename T>
+double time_contains(std::size_t min, long tree_size, long lookups);
+
+int main(int argc, char* argv[]) {
+    long lookups = 3000000, tree_size = 100000;
+    const std::size_t SIZES[] = {3, 9, 17, 33, 65};  // 2 * min + 1 keys
+    const std::size_t MINIMUMS[] = {1, 4, 8, 16, 32};
+    const char* const LEVELS[] = {"none", "SSE2", "SSE4.2", "AVX2"};
+
+    // PROCESS ARGUMENT FLAGS
+    for(int i = 1; i + 1 < argc; ++i) {
+        if(std::string(argv[i]) == "-n") lookups = std::atoi(argv[i + 1]);
+        if(std::string(argv[i]) == "-s") tree_size = std::atoi(argv[i + 1]);
+    }
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "LOOKUPS: " << lookups << "    TREE SIZE: " << tree_size
+              << "    SIMD: " << LEVELS[array_utils::simd_level()] << std::endl
+              << std::endl
+              << "first_ge() on full nodes (seconds)" << std::endl
+              << std::string(80, '-') << std::endl
+              << "    Keys    int32 walk   int32 count    int64 walk   "
+                 "int64 count"
+              << std::endl;
+
+    for(std::size_t size : SIZES)
+        std::cout << std::setw(8) << size << std::setw(14)
+                  << time_search<std::int32_t>(size, lookups, true)
+                  << std::setw(14)
+                  << time_search<std::int32_t>(size, lookups, false)
+                  << std::setw(14)
+                  << time_search<std::int64_t>(size, lookups, true)
+                  << std::setw(14)
+                  << time_search<std::int64_t>(size, lookups, false)
+                  << std::endl;
+
+    std::cout << std::endl
+              << "BTree::contains() (seconds)" << std::endl
+              << std::string(80, '-') << std::endl
+              << "     Min   Walked walk    long count       Speedup"
+              << std::endl;
+
+    for(std::size_t min : MINIMUMS) {
+        double walk = time_contains<Walked>(min, tree_size, lookups);
+        double count = time_contains<long>(min, tree_size, lookups);
+
+        std::cout << std::setw(8) << min << std::setw(14) << walk
+                  << std::setw(14) << count << std::setw(13) << walk / count
+                  << 'x' << std::endl;
+    }
+
+    return 0;
+}
+
+template <typename T>
+double time_search(std::size_t size, long lookups, bool is_walk) {
+    const std::size_t ARRAYS = 100000;  // bigger than the caches
+    std::mt19937 generator(size);
+    std::vector<T> data(ARRAYS * size);
+    std::vector<T> keys(lookups);
+    std::vector<std::size_t> arrays(lookups);
+    timer::ChronoTimer chrono;
+    std::size_t sum = 0;
+
+    for(std::size_t a = 0; a < ARRAYS; ++a) {  // ascending, gaps up to 100
+        T key = generator() % 100;
+        for(std::size_t i = 0; i < size; ++i)
+            data[a * size + i] = key += 1 + generator() % 100;
+    }
+    for(long i = 0; i < lookups; ++i) {
+        arrays[i] = generator() % ARRAYS;
+        keys[i] = generator() % (100 * size + 100);
+    }
+
+    chrono.start();
+    for(long i = 0; i < lookups; ++i) {
+        const T* array = &data[arrays[i] * size];
+
+        sum += is_walk
+                   ? array_utils::first_ge(array, size, keys[i],
+                                           std::false_type())
+                   : array_utils::first_ge(array, size, keys[i]);
+    }
+    chrono.stop();
+
+    volatile std::size_t sink = sum;  // keep the work from being optimized out
+    (void)sink;
+
+    return chrono.seconds();
+}
+
+template <typename T>
+double time_contains(std::size_t min, long tree_size, long lookups) {
+    btree::BTree<T> tree(false, min);
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<long> key(0, 2 * tree_size - 1);
+    timer::ChronoTimer chrono;
+    long found = 0;
+
+    for(long i = 0; i < tree_size; ++i) tree.insert(T(2 * i));  // even keys
+
+    chrono.start();
+    for(long i = 0; i < lookups; ++i) found += tree.contains(T(key(generator)));
+    chrono.stop();
+
+    volatile long sink = found;  // keep the work from being optimized out
+    (void)sink;
+
+    return chrono.seconds();
+}
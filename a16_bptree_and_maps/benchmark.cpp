@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * AUTHOR      : Thuan Tang
+ * ID          : 00991588
+ * CLASS       : CS008
+ * HEADER      : concurrent_bptree
+ * DESCRIPTION : This program benchmarks the multi-threaded throughput of the
+ *      ConcurrentBPTree against a BPTree shared behind one global mutex. Each
+ *      workload runs a fixed number of operations split across 1 to 16
+ *      threads and reports millions of operations per second.
+ *
+ *      USAGE: benchmark.out [-n operations] [-s prefill size]
+ ******************************************************************************/
+#include <cstdlib>                         // atoi()
+#include <iomanip>                         // setw()
+#include <iostream>                        // stream objects
+#include <mutex>                           // mutex, lock_guard
+#include <random>                          // mt19937
+#include <string>                          // string
+#include <thread>                          // thread objects
+#include <vector>                          // vector
+#include "../include/bptree.h"             // BPTree class
+#include "../include/concurrent_bptree.h"  // ConcurrentBPTree class
+#include "../include/timer.h"              // ChronoTimer class
+
+struct Workload {
+    std::string name;  // name of workload
+    int find;          // percent of finds
+    int insert;        // percent of inserts
+    int remove;        // percent of removes; rest are scans
+};
+
+const int SCAN_LENGTH = 16;  // entries visited per scan
+
+// wraps a BPTree with one global mutex
+class LockedBPTree {
+public:
+    bool find(long key) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _tree.contains(key);
+    }
+
+    bool insert(long key) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _tree.insert(key);
+    }
+
+    bool remove(long key) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _tree.remove(key);
+    }
+
+    long scan(long key) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        long sum = 0;
+        auto it = _tree.lower_bound(key);
+
+        for(int i = 0; i < SCAN_LENGTH && it; ++i, ++it) sum += *it;
+
+        return sum;
+    }
+
+private:
+    std::mutex _mutex;
+    bptree::BPTree<long> _tree{false, concurrent_bptree::MINIMUM};
+};
+
+// wraps a ConcurrentBPTree with the same calls
+class SharedBPTree {
+public:
+    bool find(long key) { return _tree.contains(key); }
+    bool insert(long key) { return _tree.insert(key); }
+    bool remove(long key) { return _tree.remove(key); }
+
+    long scan(long key) {
+        long sum = 0;
+        auto it = _tree.lower_bound(key);
+
+        for(int i = 0; i < SCAN_LENGTH && it; ++i, ++it) sum += *it;
+
+        return sum;
+    }
+
+private:
+    concurrent_bptree::ConcurrentBPTree<long> _tree;
+};
+
+// run workload on tree and return millions of operations per second
+template <typename Tree>
+double run(const Workload& workload, int threads, long operations,
+           long prefill);
+
+// one thread's share of a workload
+template <typename Tree>
+void run_thread(Tree& tree, const Workload& workload, long operations,
+                long key_range, unsigned seed);
+
+int main(int argc, char* argv[]) {
+    long operations = 2000000, prefill = 100000;
+    const int THREADS[] = {1, 2, 4, 8, 16};
+    const Workload WORKLOADS[] = {{"read only", 100, 0, 0},
+                                  {"read mostly", 90, 5, 5},
+                                  {"balanced", 50, 25, 25},
+                                  {"scans", 0, 5, 5}};
+
+    // PROCESS ARGUMENT FLAGS
+    for(int i = 1; i + 1 < argc; ++i) {
+        if(std::string(argv[i]) == "-n") operations = std::atoi(argv[i + 1]);
+        if(std::string(argv[i]) == "-s") prefill = std::atoi(argv[i + 1]);
+    }
+
+    std::cout << "OPERATIONS: " << operations << "    PREFILL: " << prefill
+              << "    HARDWARE THREADS: " << std::thread::hardware_concurrency()
+              << std::endl;
+
+    for(const auto& workload : WORKLOADS) {
+        std::cout << std::endl
+                  << "WORKLOAD: " << workload.name << " (" << workload.find
+                  << "% find, " << workload.insert << "% insert, "
+                  << workload.remove << "% remove, "
+                  << 100 - workload.find - workload.insert - workload.remove
+                  << "% scan)" << std::endl
+                  << std::string(80, '-') << std::endl
+                  << std::setw(8) << "Threads" << std::setw(24)
+                  << "Mutex BPTree (Mops/s)" << std::setw(28)
+                  << "ConcurrentBPTree (Mops/s)" << std::setw(12) << "Speedup"
+                  << std::endl;
+
+        for(int threads : THREADS) {
+            double locked =
+                run<LockedBPTree>(workload, threads, operations, prefill);
+            double shared =
+                run<SharedBPTree>(workload, threads, operations, prefill);
+
+            std::cout << std::fixed << std::setprecision(3) << std::setw(8)
+                      << threads << std::setw(24) << locked << std::setw(28)
+                      << shared << std::setw(11) << shared / locked << "x"
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
+
+template <typename Tree>
+double run(const Workload& workload, int threads, long operations,
+           long prefill) {
+    Tree tree;
+    std::vector<std::thread> workers;
+    timer::ChronoTimer chrono;
+
+    for(long i = 0; i < prefill; ++i) tree.insert(2 * i);  // even keys
+
+    chrono.start();
+    for(int t = 0; t < threads; ++t)
+        workers.emplace_back(run_thread<Tree>, std::ref(tree),
+                             std::cref(workload), operations / threads,
+                             2 * prefill, t + 1);
+    for(auto& worker : workers) worker.join();
+    chrono.stop();
+
+    return operations / chrono.seconds() / 1e6;
+}
+
+template <typename Tree>
+void run_thread(Tree& tree, const Workload& workload, long operations,
+                long key_range, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<long> key(0, key_range - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    long sum = 0;
+
+    for(long i = 0; i < operations; ++i) {
+        int p = percent(generator);
+
+        if(p < workload.find)
+            sum += tree.find(key(generator));
+        else if(p < workload.find + workload.insert)
+            sum += tree.insert(key(generator));
+        else if(p < workload.find + workload.insert + workload.remove)
+            sum += tree.remove(key(generator));
+        else
+            sum += tree.scan(key(generator));
+    }
+
+    volatile long sink = sum;  // keep the work from being optimized out
+    (void)sink;
+}
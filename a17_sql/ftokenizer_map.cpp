@@ -1,21 +1,26 @@
 #include <iostream>
 #include <string>
-#include "../include/bpt_map.h"
+#include <vector>
 #include "../include/ftokenizer.h"
+#include "../include/prefix_bptree.h"
+#include "../include/vector_utils.h"
 
 using namespace std;
 
-bpt_map::MMap<string, long> get_word_indices(char* file_name);
+// word to positions; keys share prefixes, so the leaves store them compressed
+typedef prefix_bptree::PrefixBPTree<vector<long>> WordIndex;
+
+WordIndex get_word_indices(char* file_name);
 
 int main(int argc, char* argv[]) {
-    bpt_map::MMap<string, long> word_indices;
+    WordIndex word_indices;
     word_indices = get_word_indices("solitude.txt");
     cout << endl << endl << endl;
 
     // list all nodes of the index mmap:
-    for(bpt_map::MMap<string, long>::Iterator it = word_indices.begin();
-        it != word_indices.end(); it++) {
-        cout << *it << endl;
+    for(WordIndex::Iterator it = word_indices.begin(); it != word_indices.end();
+        it++) {
+        cout << it->key << " : " << it->value << endl;
     }
 
     cout << endl << endl << endl;
@@ -36,10 +41,9 @@ int main(int argc, char* argv[]) {
     cout << "listing indices from \"" << from << "\" to \"" << to << "\""
          << endl;
     cout << "---------------------------------------------------" << endl;
-    for(bpt_map::MMap<string, long>::Iterator it =
-            word_indices.lower_bound(from);
+    for(WordIndex::Iterator it = word_indices.lower_bound(from);
         it != word_indices.upper_bound(to) && it != word_indices.end(); it++) {
-        cout << *it << endl;
+        cout << it->key << " : " << it->value << endl;
     }
 
     cout << endl
@@ -49,9 +53,9 @@ int main(int argc, char* argv[]) {
     return 0;
 }
 
-bpt_map::MMap<string, long> get_word_indices(char* file_name) {
+WordIndex get_word_indices(char* file_name) {
     const bool debug = false;
-    bpt_map::MMap<string, long> word_indices;
+    WordIndex word_indices;
     ftokenizer::FTokenizer ftk("solitude.txt");
     token::Token t;
     long count = 0;
@@ -62,7 +66,7 @@ bpt_map::MMap<string, long> get_word_indices(char* file_name) {
         if(t.type_string() == "ALPHA") {
             string s;
             s = t.string();
-            word_indices[s] += count;
+            word_indices[s].push_back(count);
             count++;
             if(debug) cout << "|" << t.string() << "|" << endl;
         }
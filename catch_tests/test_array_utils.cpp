@@ -157,6 +157,67 @@ SCENARIO("Array Utilities", "[array_utils]") {
         }
     }
 
+    GIVEN("first greater or equal of integers past a SIMD block") {
+        const int SIZE = 19;
+        long longs[SIZE];
+        unsigned unsigneds[SIZE];
+        char chars[SIZE];
+
+        for(int i = 0; i < SIZE; ++i) {  // -18, -16, ..., 18
+            longs[i] = 2 * i - SIZE + 1;
+            unsigneds[i] = i < SIZE - 1 ? 2 * i : 4000000000u;
+            chars[i] = 'a' + i;
+        }
+
+        WHEN("signed") {
+            REQUIRE(first_ge(longs, SIZE, -19L) == 0);
+            REQUIRE(first_ge(longs, SIZE, -18L) == 0);
+            REQUIRE(first_ge(longs, SIZE, -17L) == 1);
+            REQUIRE(first_ge(longs, SIZE, 0L) == 9);
+            REQUIRE(first_ge(longs, SIZE, 17L) == 18);
+            REQUIRE(first_ge(longs, SIZE, 19L) == 19);
+        }
+
+        WHEN("unsigned over the signed range") {
+            REQUIRE(first_ge(unsigneds, SIZE, 0u) == 0);
+            REQUIRE(first_ge(unsigneds, SIZE, 9u) == 5);
+            REQUIRE(first_ge(unsigneds, SIZE, 35u) == 18);
+            REQUIRE(first_ge(unsigneds, SIZE, 4000000000u) == 18);
+            REQUIRE(first_ge(unsigneds, SIZE, 4000000001u) == 19);
+        }
+
+        WHEN("other integers") {
+            REQUIRE(first_ge(chars, SIZE, 'a') == 0);
+            REQUIRE(first_ge(chars, SIZE, 'k') == 10);
+            REQUIRE(first_ge(chars, SIZE, 'z') == 19);
+        }
+
+        WHEN("every SIMD level the CPU has") {
+            std::int32_t ints[SIZE];
+            std::int64_t bits[SIZE];
+
+            for(int i = 0; i < SIZE; ++i) {
+                ints[i] = static_cast<std::int32_t>(unsigneds[i]);
+                bits[i] = static_cast<std::int64_t>(unsigneds[i]) << 31;
+            }
+
+            for(int level = SIMD_NONE; level <= simd_level(); ++level)
+                for(int size = 0; size <= SIZE; ++size)
+                    for(int i = 0; i < SIZE; ++i) {
+                        std::int64_t entry = bits[i] + 1;
+
+                        REQUIRE(count_less_32(ints, size, ints[i] + 1,
+                                              INT32_MIN, level) ==
+                                std::size_t(std::min(i + 1, size)));
+                        REQUIRE(count_less_64(bits, size, entry, 0, level) ==
+                                std::size_t(std::min(i + 1, size)));
+                        REQUIRE(count_less_64(bits, size, bits[i], 0,
+                                              level) ==
+                                std::size_t(std::min(i, size)));
+                    }
+        }
+    }
+
     GIVEN("attach item") {
         const int SIZE = 3;
         int array[SIZE] = {-1, -1, -1};
@@ -205,6 +205,89 @@ SCENARIO("Adelson-Velsky and Landis Class", "[avl]") {
         }
     }
 
+    GIVEN("AVL's assign with random items and their duplicates") {
+        std::vector<int> items = random_items;
+        items.insert(items.end(), random_items.begin(), random_items.end());
+
+        avl.insert(-1);
+        avl.assign(items.begin(), items.end());
+
+        THEN("all nodes are within balance limits and items are unique") {
+            root = avl.root();
+            REQUIRE(root != nullptr);
+            bst_node::preorder(root, assert_b_limits_and_order<int>);
+
+            // iterator visits ascending items once each, in order
+            auto it = avl.begin();
+            for(int i : ascending_items) {
+                REQUIRE(it != avl.end());
+                REQUIRE(*it == i);
+                ++it;
+            }
+            REQUIRE(it == avl.end());
+
+            is_found = avl.search(-1, found);
+            REQUIRE(is_found == false);
+        }
+    }
+
+    GIVEN("avl inserted with random items, split at 101") {
+        for(int i : random_items) avl.insert(i);
+
+        AVL<int> upper;
+        upper.insert(-1);
+        avl.split(101, upper);
+
+        THEN("items < 101 stay, items >= 101 move and both are balanced") {
+            bst_node::preorder(avl.root(), assert_b_limits_and_order<int>);
+            bst_node::preorder(upper.root(), assert_b_limits_and_order<int>);
+
+            for(int i : ascending_items) {
+                REQUIRE(avl.search(i, found) == (i < 101));
+                REQUIRE(upper.search(i, found) == (i >= 101));
+            }
+            REQUIRE(upper.search(-1, found) == false);
+        }
+
+        THEN("joining upper back gives all items, balanced") {
+            avl.join(upper);
+
+            REQUIRE(upper.empty());
+            bst_node::preorder(avl.root(), assert_b_limits_and_order<int>);
+            for(int i : ascending_items) REQUIRE(avl.search(i, found));
+        }
+
+        THEN("joining items out of order throws and changes nothing") {
+            REQUIRE_THROWS_AS(upper.join(avl), std::invalid_argument);
+            REQUIRE(avl.search(1, found));
+            REQUIRE(upper.search(200, found));
+        }
+    }
+
+    GIVEN("avl with ascending items merged with descending and random items") {
+        AVL<int> descending, random;
+
+        for(int i : ascending_items) avl.insert(i);
+        for(int i : descending_items) descending.insert(i);
+        for(int i : random_items) random.insert(i);
+
+        avl.merge(descending);
+        avl.merge(random);
+
+        THEN("avl holds the union, balanced, and the sources are empty") {
+            REQUIRE(descending.empty());
+            REQUIRE(random.empty());
+            bst_node::preorder(avl.root(), assert_b_limits_and_order<int>);
+
+            int count = 0;
+            for(int i : avl) {
+                REQUIRE(avl.search(i, found));
+                ++count;
+            }
+            REQUIRE(count == 400);
+        }
+    }
+
     GIVEN(
         "AVL's copy constructor and assignment op: avl is inserted with "
         "ascending items") {
@@ -0,0 +1,658 @@
+#include <algorithm>  // std::lower_bound
+#include <cstdlib>    // srand(), rand()
+#include <map>        // std::map
+#include <set>        // std::set
+#include <string>     // std::string
+#include <utility>    // std::move
+#include <vector>     // std::vector
+#include "../include/bpt_map.h"
+#include "../include/bptree.h"
+#include "../include/set.h"
+#include "../lib/catch.hpp"
+
+namespace {
+
+typedef bptree::BPTree<int> Tree;
+typedef std::set<int> Model;
+
+const int KEYS = 10000;  // keys are 0 to KEYS - 1
+
+// tree holds exactly the model's entries, in order
+bool is_same(Tree& tree, const Model& model) {
+    auto walker = model.begin();
+
+    if(tree.size() != model.size() || !tree.verify()) return false;
+    for(auto it = tree.begin(); it != tree.end(); ++it, ++walker)
+        if(walker == model.end() || *it != *walker) return false;
+
+    return walker == model.end();
+}
+
+// count of model entries in [low, high)
+std::size_t count_range(const Model& model, int low, int high) {
+    std::size_t count = 0;
+
+    for(auto it = model.lower_bound(low); it != model.end() && *it < high; ++it)
+        ++count;
+
+    return count;
+}
+
+// erase model entries in [low, high)
+void erase_range(Model& model, int low, int high) {
+    model.erase(model.lower_bound(low), model.lower_bound(high));
+}
+
+// erase model entries where pred(entry); return count erased
+template <typename C, typename Pred>
+std::size_t erase_if(C& model, Pred pred) {
+    std::size_t count = 0;
+
+    for(auto it = model.begin(); it != model.end();)
+        if(pred(*it)) {
+            it = model.erase(it);
+            ++count;
+        } else
+            ++it;
+
+    return count;
+}
+
+// rank, select and count_range of tree match the sorted model
+bool is_ranked(Tree& tree, const Model& model) {
+    std::vector<int> sorted(model.begin(), model.end());
+
+    for(std::size_t k = 0; k <= sorted.size(); ++k) {
+        Tree::Iterator it = tree.select(k);
+
+        if(k == sorted.size() ? it != tree.end() : !it || *it != sorted[k])
+            return false;
+    }
+
+    for(int i = 0; i < 200; ++i) {
+        int low = rand() % (KEYS + 2) - 1, high = rand() % (KEYS + 2) - 1;
+        std::size_t low_rank = std::lower_bound(sorted.begin(), sorted.end(),
+                                                low) - sorted.begin();
+
+        if(tree.rank(low) != low_rank ||
+           tree.count_range(low, high) != count_range(model, low, high))
+            return false;
+    }
+
+    return true;
+}
+
+// fill tree and model with count random keys
+void fill(Tree& tree, Model& model, int count) {
+    for(int i = 0; i < count; ++i) {
+        int key = rand() % KEYS;
+        REQUIRE(tree.insert(key) == model.insert(key).second);
+    }
+}
+
+}  // namespace
+
+SCENARIO("B+ tree bulk erase", "[bptree]") {
+    const std::size_t MINIMUMS[] = {1, 2, 16};
+
+    srand(39);
+
+    for(std::size_t min : MINIMUMS) {
+        GIVEN("a tree with minimum " + std::to_string(min)) {
+            Tree tree(false, min);
+            Model model;
+
+            fill(tree, model, KEYS / 2);
+            REQUIRE(is_same(tree, model));
+
+            WHEN("random ranges are erased") {
+                for(int i = 0; i < 200; ++i) {
+                    int low = rand() % KEYS;
+                    int high = low + rand() % (i % 2 ? 100 : KEYS / 2);
+                    std::size_t count = count_range(model, low, high);
+
+                    REQUIRE(tree.erase_range(low, high) == count);
+                    erase_range(model, low, high);
+                    REQUIRE(is_same(tree, model));
+
+                    if(i % 10 == 9) fill(tree, model, KEYS / 4);
+                }
+
+                THEN("empty and reversed ranges erase nothing") {
+                    std::size_t size = tree.size();
+
+                    REQUIRE(tree.erase_range(KEYS / 2, KEYS / 2) == 0);
+                    REQUIRE(tree.erase_range(KEYS, 0) == 0);
+                    REQUIRE(tree.erase_range(KEYS, 2 * KEYS) == 0);
+                    REQUIRE(tree.size() == size);
+                    REQUIRE(is_same(tree, model));
+                }
+            }
+
+            WHEN("every large range of a small tree is erased") {
+                Tree small(false, min);
+                std::vector<int> keys;
+
+                for(std::size_t i = 0; i < 12 * min + 20; ++i) {
+                    int key = rand() % KEYS;
+                    if(small.insert(key)) keys.push_back(key);
+                }
+                Model all(keys.begin(), keys.end());
+                keys.assign(all.begin(), all.end());
+                keys.push_back(KEYS);
+
+                for(std::size_t i = 0; i < keys.size(); ++i)
+                    for(std::size_t j = i + keys.size() / 3; j < keys.size();
+                        ++j) {
+                        Tree copy(small);
+                        Model left(all);
+
+                        REQUIRE(copy.erase_range(keys[i], keys[j]) == j - i);
+                        erase_range(left, keys[i], keys[j]);
+                        REQUIRE(is_same(copy, left));
+                    }
+            }
+
+            WHEN("all but a few entries are erased by range") {
+                for(std::size_t left = 1; left < 8; ++left) {
+                    auto high = model.end();
+
+                    for(std::size_t i = 0; i < left; ++i) --high;
+                    REQUIRE(tree.erase_range(-1, *high) ==
+                            model.size() - left);
+                    model.erase(model.begin(), high);
+                    REQUIRE(is_same(tree, model));
+
+                    fill(tree, model, KEYS / 4);
+                }
+            }
+
+            WHEN("the whole tree is erased by range") {
+                REQUIRE(tree.erase_range(-1, KEYS) == model.size());
+                model.clear();
+
+                THEN("it is empty and takes new entries") {
+                    REQUIRE(tree.empty());
+                    REQUIRE(tree.begin() == tree.end());
+                    REQUIRE(is_same(tree, model));
+
+                    fill(tree, model, KEYS / 4);
+                    REQUIRE(is_same(tree, model));
+                }
+            }
+
+            WHEN("a predicate thins out the keys below a cut") {
+                for(int i = 0; i < 20; ++i) {
+                    int cut = rand() % KEYS;
+                    auto pred = [cut](int key) {
+                        return key < cut && key % 50 != 0;
+                    };
+
+                    REQUIRE(tree.erase_if(pred) == erase_if(model, pred));
+                    REQUIRE(is_same(tree, model));
+
+                    fill(tree, model, KEYS / 4);
+                }
+            }
+
+            WHEN("entries are erased by predicates") {
+                const int MODULI[] = {2, 3, 7, 1};  // 1 erases the rest
+
+                for(int m : MODULI) {
+                    int r = rand() % m;
+                    auto pred = [m, r](int key) { return key % m == r; };
+
+                    REQUIRE(tree.erase_if(pred) == erase_if(model, pred));
+                    REQUIRE(is_same(tree, model));
+                }
+
+                THEN("nothing is left and nothing more is erased") {
+                    REQUIRE(tree.empty());
+                    REQUIRE(tree.erase_if([](int) { return true; }) == 0);
+                    REQUIRE(tree.verify());
+                }
+            }
+        }
+    }
+
+    GIVEN("maps and a set over the same random keys") {
+        bpt_map::Map<std::string, int> map(2);
+        bpt_map::MMap<int, int> mmap(2);
+        set::Set<int> set(2);
+        std::map<std::string, int> map_model;
+        std::map<int, std::vector<int>> mmap_model;
+        Model set_model;
+
+        for(int i = 0; i < KEYS / 2; ++i) {
+            int key = rand() % KEYS;
+
+            map.insert(std::to_string(key), i);
+            map_model[std::to_string(key)] = i;
+            mmap.insert(key, i);
+            mmap_model[key].push_back(i);
+            set.insert(key);
+            set_model.insert(key);
+        }
+
+        WHEN("ranges and predicates are erased") {
+            std::size_t count = 0;
+
+            // string keys: "2" <= key < "5" by text
+            for(const auto& e : map_model)
+                count += e.first >= "2" && e.first < "5";
+            REQUIRE(map.erase_range("2", "5") == count);
+            map_model.erase(map_model.lower_bound("2"),
+                            map_model.lower_bound("5"));
+            count = erase_if(map_model,
+                             [](const auto& p) { return p.second % 2; });
+            REQUIRE(map.erase_if([](const auto& p) { return p.value % 2; }) ==
+                    count);
+
+            count = 0;
+            for(auto it = mmap_model.lower_bound(1000);
+                it != mmap_model.end() && it->first < 6000; ++it)
+                ++count;
+            REQUIRE(mmap.erase_range(1000, 6000) == count);
+            mmap_model.erase(mmap_model.lower_bound(1000),
+                             mmap_model.lower_bound(6000));
+            count = erase_if(mmap_model, [](const auto& p) {
+                return p.second.size() > 1;
+            });
+            REQUIRE(mmap.erase_if([](const auto& p) {
+                return p.values.size() > 1;
+            }) == count);
+
+            REQUIRE(set.erase_range(KEYS / 4, KEYS / 2) ==
+                    count_range(set_model, KEYS / 4, KEYS / 2));
+            erase_range(set_model, KEYS / 4, KEYS / 2);
+            auto thirds = [](int key) { return key % 3 == 0; };
+            REQUIRE(set.erase_if(thirds) == erase_if(set_model, thirds));
+
+            THEN("each matches its model") {
+                auto m = map_model.begin();
+                auto s = set_model.begin();
+
+                REQUIRE(map.verify());
+                REQUIRE(map.size() == map_model.size());
+                for(auto it = map.begin(); it != map.end(); ++it, ++m) {
+                    REQUIRE(it->key == m->first);
+                    REQUIRE(it->value == m->second);
+                }
+
+                REQUIRE(mmap.verify());
+                REQUIRE(mmap.size() == mmap_model.size());
+                for(const auto& e : mmap_model)
+                    REQUIRE((mmap.at(e.first) == e.second));
+
+                REQUIRE(set.verify());
+                REQUIRE(set.size() == set_model.size());
+                for(auto it = set.begin(); it != set.end(); ++it, ++s)
+                    REQUIRE(*it == *s);
+            }
+        }
+    }
+}
+
+SCENARIO("B+ tree order statistics", "[bptree]") {
+    const std::size_t MINIMUMS[] = {1, 2, 16};
+
+    srand(40);
+
+    for(std::size_t min : MINIMUMS) {
+        GIVEN("a tree with minimum " + std::to_string(min)) {
+            Tree tree(false, min);
+            Model model;
+
+            REQUIRE(tree.select(0) == tree.end());
+            REQUIRE(tree.rank(0) == 0);
+            REQUIRE(tree.count_range(0, KEYS) == 0);
+
+            WHEN("keys are randomly inserted and removed") {
+                for(int i = 1; i <= 20000; ++i) {
+                    int key = rand() % (KEYS / 4);
+
+                    if(rand() % 5 < 3)  // grow the tree while it changes
+                        REQUIRE(tree.insert(key) == model.insert(key).second);
+                    else
+                        REQUIRE(tree.remove(key) == (model.erase(key) == 1));
+
+                    if(i % 1000 == 0) REQUIRE(is_ranked(tree, model));
+                }
+
+                THEN("bulk erases keep the subtree sizes") {
+                    int low = rand() % (KEYS / 8);
+
+                    tree.erase_range(low, low + KEYS / 8);
+                    erase_range(model, low, low + KEYS / 8);
+                    REQUIRE(is_ranked(tree, model));
+
+                    tree.erase_if([](int key) { return key % 3 == 0; });
+                    erase_if(model, [](int key) { return key % 3 == 0; });
+                    REQUIRE(is_ranked(tree, model));
+                }
+
+                THEN("copies and moved trees keep the subtree sizes") {
+                    Tree copy(tree), moved(std::move(tree));
+
+                    REQUIRE(is_ranked(copy, model));
+                    REQUIRE(is_ranked(moved, model));
+                }
+            }
+        }
+    }
+
+    GIVEN("maps and a set over the same random keys") {
+        bpt_map::Map<int, int> map(2);
+        bpt_map::MMap<int, int> mmap(2);
+        set::Set<int> set(2);
+        std::vector<int> keys;
+        Model model;
+
+        for(int i = 0; i < KEYS / 2; ++i) {
+            int key = rand() % KEYS;
+
+            map.insert(key, i);
+            mmap.insert(key, i);
+            set.insert(key);
+            model.insert(key);
+
+            if(rand() % 4 == 0) {
+                key = rand() % KEYS;
+                map.erase(key);
+                mmap.erase(key);
+                set.erase(key);
+                model.erase(key);
+            }
+        }
+        keys.assign(model.begin(), model.end());
+
+        THEN("their order statistics match the sorted keys") {
+            for(std::size_t k = 0; k < keys.size(); ++k) {
+                REQUIRE(map.select(k)->key == keys[k]);
+                REQUIRE(mmap.select(k)->key == keys[k]);
+                REQUIRE(*set.select(k) == keys[k]);
+            }
+            REQUIRE(map.select(keys.size()) == map.end());
+            REQUIRE(mmap.select(keys.size()) == mmap.end());
+            REQUIRE(set.select(keys.size()) == set.end());
+
+            for(int i = 0; i < 1000; ++i) {
+                int low = rand() % KEYS, high = rand() % KEYS;
+                std::size_t rank = std::lower_bound(keys.begin(), keys.end(),
+                                                    low) - keys.begin();
+                std::size_t count = count_range(model, low, high);
+
+                REQUIRE(map.rank(low) == rank);
+                REQUIRE(mmap.rank(low) == rank);
+                REQUIRE(set.rank(low) == rank);
+                REQUIRE(map.count_range(low, high) == count);
+                REQUIRE(mmap.count_range(low, high) == count);
+                REQUIRE(set.count_range(low, high) == count);
+            }
+        }
+    }
+}
+
+SCENARIO("Copy-on-write B+ tree handles", "[bptree]") {
+    GIVEN("a handle with entries") {
+        bptree::CowBPTree<int> tree(false, 2);
+
+        for(int i = 0; i < 100; ++i) tree.write().insert(i);
+
+        THEN("copies share nodes and a write copies only its path") {
+            bptree::CowBPTree<int> copy(tree);
+
+            REQUIRE(copy.is_shared());
+            tree.write().insert(1000);
+            REQUIRE_FALSE(tree.is_shared());
+            REQUIRE_FALSE(copy.is_shared());
+
+            // leaves off the written path are still shared
+            REQUIRE(&*tree->find(0) == &*copy->find(0));
+            REQUIRE(&*tree->find(99) != &*copy->find(99));
+
+            for(int i = 0; i < 100; i += 2) tree.write().remove(i);
+            tree.write().erase_if([](int i) { return i % 3 == 0; });
+            REQUIRE(tree->verify());
+            REQUIRE(copy->verify());
+            REQUIRE(tree->size() == 34);
+
+            int expected = 0;
+            for(auto it = copy->begin(); it != copy->end(); ++it)
+                REQUIRE(*it == expected++);
+            REQUIRE(expected == 100);
+
+            copy.clear();  // tree keeps the nodes it still shared
+            REQUIRE(copy->empty());
+            REQUIRE(tree->verify());
+            REQUIRE(tree->size() == 34);
+        }
+
+        THEN("copies of copies write independently") {
+            bptree::CowBPTree<int> first(tree), second(first);
+            std::vector<bptree::CowBPTree<int>*> handles = {&tree, &first,
+                                                            &second};
+
+            for(std::size_t h = 0; h < handles.size(); ++h)
+                for(int i = (int)h; i < 100; i += 3)
+                    handles[h]->write().remove(i);
+
+            for(std::size_t h = 0; h < handles.size(); ++h) {
+                const bptree::BPTree<int>& view = **handles[h];
+
+                REQUIRE(view.verify());
+                for(int i = 0; i < 100; ++i)
+                    REQUIRE(view.contains(i) == (i % 3 != (int)h));
+            }
+
+            second = first;
+            second.write().erase_range(0, 50);
+            REQUIRE(first->size() == 67);
+            REQUIRE(second->size() == 34);
+        }
+
+        THEN("iterators copy the path to their entry when dereferenced") {
+            bptree::CowBPTree<int> copy(tree);
+            bptree::CowBPTree<int>::Iterator it = tree.find(50);
+            const int* shared = &*copy->find(50);
+
+            REQUIRE(&*it != shared);
+            REQUIRE(&*tree->find(50) == &*it);
+            REQUIRE(&*copy->find(50) == shared);
+
+            int expected = 0;
+            for(it = tree.begin(); it != tree.end(); ++it)
+                REQUIRE(*it == expected++);
+            REQUIRE(expected == 100);
+            REQUIRE(&*tree->find(0) != &*copy->find(0));  // all unshared
+            REQUIRE(tree->verify());
+            REQUIRE(copy->verify());
+        }
+
+        THEN("a moved handle is left empty with the same dups and min") {
+            bptree::CowBPTree<int> moved(std::move(tree));
+
+            REQUIRE(moved->size() == 100);
+            REQUIRE(tree->empty());
+            REQUIRE_FALSE(tree.is_shared());
+            REQUIRE(tree.write().insert(1));
+            REQUIRE_FALSE(tree.write().insert(1));  // still no dups
+            for(int i = 0; i < 20; ++i) tree.write().insert(i);
+            REQUIRE(tree->verify());
+
+            tree = std::move(moved);
+            REQUIRE(tree->size() == 100);
+            REQUIRE(moved->empty());
+        }
+    }
+
+    GIVEN("maps and a set") {
+        bpt_map::Map<int, int> map;
+        bpt_map::MMap<int, int> mmap;
+        set::Set<int> set;
+
+        for(int i = 0; i < 100; ++i) {
+            map.insert(i, i);
+            mmap.insert(i, i);
+            set.insert(i);
+        }
+
+        THEN("writes after a copy never show in the copy") {
+            bpt_map::Map<int, int> copy = map;
+            map[7] = 700;
+            map.at(8) = 800;
+            map.find(9)->value = 900;
+            for(auto it = map.lower_bound(10); it != map.end(); ++it)
+                it->value *= 2;
+            const bpt_map::Map<int, int>& view = copy;
+
+            REQUIRE(map.at(7) == 700);
+            REQUIRE(map.at(50) == 100);
+            for(int i = 0; i < 100; ++i) REQUIRE(view.at(i) == i);
+
+            bpt_map::MMap<int, int> mcopy = mmap.snapshot();
+            mmap[3].push_back(300);
+            const bpt_map::MMap<int, int>& mview = mcopy;
+
+            REQUIRE(mmap.at(3).size() == 2);
+            REQUIRE(mview.at(3).size() == 1);
+
+            set::Set<int> scopy = set;
+            set.erase(5);
+            set.insert(200);
+            REQUIRE(scopy.size() == 100);
+            REQUIRE(scopy.contains(5));
+            REQUIRE_FALSE(scopy.contains(200));
+
+            REQUIRE(map.verify());
+            REQUIRE(copy.verify());
+            REQUIRE(mmap.verify());
+            REQUIRE(mcopy.verify());
+        }
+
+        THEN("references taken after a copy write only to their map") {
+            bpt_map::Map<int, int> copy = map;
+            int& value = map.get(5);
+            value = 500;
+            const bpt_map::Map<int, int>& view = copy;
+
+            REQUIRE(map.at(5) == 500);
+            REQUIRE(view.at(5) == 5);
+        }
+
+        THEN("a multimap iterator keeps its place when a copy is taken") {
+            mmap.insert(1, 2);
+            bpt_map::MMap<int, int>::Iterator it = mmap.find(1);
+
+            REQUIRE(*it->value == 1);
+            ++it;
+            REQUIRE(*it->value == 2);
+
+            bpt_map::MMap<int, int> mcopy = mmap;
+            ++it;  // unshares the leaf mid key
+            REQUIRE(it->key == 2);
+            REQUIRE(mcopy.at(1).size() == 2);
+        }
+
+        THEN("moved maps are left empty and usable") {
+            bpt_map::Map<int, int> moved = std::move(map);
+            bpt_map::MMap<int, int> mmoved = std::move(mmap);
+
+            REQUIRE(moved.size() == 100);
+            REQUIRE(mmoved.size() == 100);
+            REQUIRE(map.empty());
+            REQUIRE(mmap.empty());
+
+            mmap.insert(1, 1);
+            mmap.insert(1, 2);
+            REQUIRE(mmap.at(1).size() == 2);  // dups kept
+            REQUIRE(mmap.verify());
+        }
+    }
+}
+
+SCENARIO("Pooled B+ tree nodes", "[bptree]") {
+    const std::size_t MINIMUMS[] = {1, 2, 16};
+
+    srand(42);
+
+    for(std::size_t min : MINIMUMS) {
+        GIVEN("pooled trees with minimum " + std::to_string(min)) {
+            Tree tree(false, min, true);
+            Model model;
+
+            for(int i = 0; i < 3 * KEYS; ++i) {
+                int key = rand() % KEYS;
+
+                if(rand() % 3)
+                    REQUIRE(tree.insert(key) == model.insert(key).second);
+                else
+                    REQUIRE(tree.remove(key) == (model.erase(key) == 1));
+            }
+            REQUIRE(is_same(tree, model));
+
+            THEN("copies are pooled and independent") {
+                Tree copy(tree), assigned(false, min, true);
+                Model copy_model(model);
+
+                assigned.insert(-1);
+                assigned = tree;
+                fill(copy, copy_model, KEYS);
+                copy.erase_if([](int key) { return key % 2; });
+                erase_if(copy_model, [](int key) { return key % 2; });
+
+                REQUIRE(is_same(copy, copy_model));
+                REQUIRE(is_same(tree, model));
+                REQUIRE(is_same(assigned, model));
+            }
+
+            THEN("pooled and heap trees swap and move") {
+                Tree heap(false, min);
+                Model heap_model;
+
+                fill(heap, heap_model, KEYS);
+                tree.swap(heap);
+                fill(tree, heap_model, KEYS);
+                fill(heap, model, KEYS);
+                REQUIRE(is_same(tree, heap_model));
+                REQUIRE(is_same(heap, model));
+
+                Tree moved(std::move(heap));
+                REQUIRE(heap.empty());
+                REQUIRE(is_same(moved, model));
+            }
+
+            THEN("bulk erases free nodes back to the pool") {
+                for(int i = 0; i < 3; ++i) {
+                    REQUIRE(tree.erase_range(-1, KEYS) == model.size());
+                    model.clear();
+                    REQUIRE(tree.empty());
+
+                    fill(tree, model, KEYS);
+                    REQUIRE(is_same(tree, model));
+                }
+            }
+        }
+    }
+
+    GIVEN("a pooled tree of strings") {
+        bptree::BPTree<std::string> tree(false, 2, true);
+        std::set<std::string> model;
+
+        for(int i = 0; i < KEYS; ++i) {  // long, so leaks show under ASan
+            std::string key = std::string(20, 'k') + std::to_string(rand());
+
+            tree.insert(key);
+            model.insert(key);
+        }
+
+        THEN("entries are freed with their nodes") {
+            bptree::BPTree<std::string> copy(tree);
+
+            for(const std::string& key : model) REQUIRE(copy.remove(key));
+            REQUIRE(copy.empty());
+            REQUIRE(tree.size() == model.size());
+            REQUIRE(tree.verify());
+        }
+    }
+}
@@ -546,6 +546,37 @@ SCENARIO("Binary Search Tree Class", "[bst]") {
         }
     }
 
+    GIVEN("an array of 7 unsorted items with duplicates") {
+        const int SIZE = 7;
+        int arr[SIZE] = {4, 1, 5, 3, 1, 2, 4};
+
+        WHEN("assigned to btree will give the 5 sorted item btree") {
+            // bulk build with items in any order
+            BST<int> btree;
+            btree.insert(100);
+            btree.assign(arr, arr + SIZE);
+
+            // expected output
+            outs =
+                "          |||\n"
+                "     |5|\n"
+                "               |||\n"
+                "          |4|\n"
+                "               |||\n"
+                "|3|\n"
+                "          |||\n"
+                "     |2|\n"
+                "               |||\n"
+                "          |1|\n"
+                "               |||\n";
+
+            // assert expected output for btree
+            ss.str("");
+            ss << btree;
+            REQUIRE(ss.str() == outs);
+        }
+    }
+
     GIVEN("two btree's") {
         const int SIZE_A = 7, SIZE_B = 3;
         int arr_a[SIZE_A] = {30, 40, 45, 50, 55, 60, 70},
@@ -630,3 +661,49 @@ SCENARIO("Binary Search Tree Class", "[bst]") {
         }
     }
 }
+
+SCENARIO("Degenerate Binary Search Tree Class", "[bst]") {
+    using namespace bst;
+
+    const int SIZE = 5000;  // sorted inserts: each one walks the whole chain
+
+    GIVEN("a btree with sorted items inserted") {
+        BST<int> btree;
+
+        for(int i = 0; i < SIZE; ++i) REQUIRE(btree.insert(i));
+        REQUIRE_FALSE(btree.insert(SIZE - 1));
+        REQUIRE(btree.root()->_height == SIZE - 1);  // linked list shaped
+
+        THEN("iterators walk every item in order") {
+            BST<int>::Iterator it = btree.begin();
+            int next = 0;
+
+            for(; it != btree.end(); ++next) REQUIRE(*(it++) == next);
+            REQUIRE(next == SIZE);
+            REQUIRE(it.is_null());
+            REQUIRE(++it == btree.end());  // stays at the end
+        }
+
+        THEN("a copy keeps its own items") {
+            BST<int> copy(btree);
+            int next = 0;
+
+            btree.clear();
+            REQUIRE(btree.empty());
+            REQUIRE(btree.begin() == btree.end());
+
+            for(int item : copy) REQUIRE(item == next++);
+            REQUIRE(next == SIZE);
+        }
+
+        THEN("erasing every item from the bottom empties the btree") {
+            for(int i = SIZE - 1; i >= 0; --i) REQUIRE(btree.erase(i));
+            REQUIRE_FALSE(btree.erase(0));
+            REQUIRE(btree.empty());
+
+            for(int i = 0; i < SIZE; ++i) REQUIRE(btree.insert(i));
+            btree.clear();
+            REQUIRE(btree.empty());
+        }
+    }
+}
@@ -1141,6 +1141,87 @@ SCENARIO("Binary Search Tree Node", "[bst_node]") {
     }
 }
 
+SCENARIO("Degenerate Binary Search Tree Node", "[bst_node]") {
+    using namespace bst_node;
+
+    const int DEPTH = 1000000;  // far deeper than recursion could go
+
+    GIVEN("a right leaning chain of a million nodes") {
+        TreeNode<int>* root = nullptr;
+
+        // build the chain bottom up: 0 -> 1 -> ... -> DEPTH - 1
+        for(int i = DEPTH - 1; i >= 0; --i)
+            root = new TreeNode<int>(i, nullptr, root);
+
+        REQUIRE(root->_item == 0);
+        REQUIRE(root->_height == DEPTH - 1);
+
+        THEN("traversals and iterators visit every node in order") {
+            int next = 0, count = 0;
+            long sum = 0;
+
+            inorder(root, [&next](TreeNode<int>*& r) {
+                REQUIRE(r->_item == next++);
+            });
+            REQUIRE(next == DEPTH);
+
+            preorder(static_cast<const TreeNode<int>*>(root),
+                     [&count](const TreeNode<int>*) { ++count; });
+            postorder(static_cast<const TreeNode<int>*>(root),
+                      [&sum](const TreeNode<int>* r) { sum += r->_item; });
+            REQUIRE(count == DEPTH);
+            REQUIRE(sum == static_cast<long>(DEPTH) * (DEPTH - 1) / 2);
+
+            next = 0;
+            for(TreeIterator<int> it(root); it; ++it) REQUIRE(*it == next++);
+            REQUIRE(next == DEPTH);
+        }
+
+        THEN("insert, search and erase at the bottom of the chain") {
+            TreeNode<int>* found = nullptr;
+
+            REQUIRE(tree_insert(root, DEPTH));
+            REQUIRE_FALSE(tree_insert(root, DEPTH));
+            REQUIRE(root->_height == DEPTH);
+            REQUIRE(tree_search(root, DEPTH, found));
+            REQUIRE(found->_item == DEPTH);
+
+            tree_reinsert(root, DEPTH);
+            REQUIRE(root->_height == DEPTH);
+
+            REQUIRE(tree_erase(root, DEPTH));
+            REQUIRE_FALSE(tree_erase(root, DEPTH));
+            REQUIRE(tree_search(root, DEPTH) == nullptr);
+            REQUIRE(root->_height == DEPTH - 1);
+
+            int max = -1;
+            tree_remove_max(root, max);
+            REQUIRE(max == DEPTH - 1);
+            REQUIRE(root->_height == DEPTH - 2);
+        }
+
+        THEN("copy and clear handle the whole chain") {
+            TreeNode<int>* copy = tree_copy(root);
+            int next = 0;
+
+            REQUIRE(copy != root);
+            REQUIRE(copy->_height == DEPTH - 1);
+            for(TreeIterator<int> it(copy); it; ++it) REQUIRE(*it == next++);
+            REQUIRE(next == DEPTH);
+
+            tree_clear(copy);
+            REQUIRE(copy == nullptr);
+        }
+
+        THEN("erasing every item empties the chain") {
+            for(int i = 0; i < DEPTH; ++i) REQUIRE(tree_erase(root, i));
+            REQUIRE(root == nullptr);
+        }
+
+        tree_clear(root);
+    }
+}
+
 template <typename T>
 void assert_b_limits_and_order(bst_node::TreeNode<T>* root) {
     if(root) {
@@ -0,0 +1,456 @@
+#include <algorithm>  // std::swap_ranges
+#include <cstddef>    // max_align_t
+#include <cstdint>    // uintptr_t
+#include <cstdlib>    // srand(), rand()
+#include <set>        // std::set
+#include <sstream>    // std::stringstream
+#include <stdexcept>  // std::runtime_error
+#include <string>     // std::string
+#include <vector>     // std::vector
+#include "../include/bt_map.h"
+#include "../include/btree.h"
+#include "../include/node_pool.h"
+#include "../lib/catch.hpp"
+
+namespace {
+
+typedef btree::BTree<int> Tree;
+typedef std::set<int> Model;
+
+const int KEYS = 10000;  // keys are 0 to KEYS - 1
+
+// tree holds exactly the model's entries, in order
+template <typename T>
+bool is_same(const btree::BTree<T>& tree, const std::set<T>& model) {
+    auto walker = model.begin();
+
+    if(tree.size() != model.size() || !tree.verify()) return false;
+    for(auto it = tree.begin(); it != tree.end(); ++it, ++walker)
+        if(walker == model.end() || *it != *walker) return false;
+
+    return walker == model.end();
+}
+
+// random inserts and removes, mirrored in model
+template <typename T, typename Make>
+void churn(btree::BTree<T>& tree, std::set<T>& model, int count, Make make) {
+    for(int i = 0; i < count; ++i) {
+        T key = make(rand() % KEYS);
+
+        if(rand() % 3)
+            REQUIRE(tree.insert(key) == model.insert(key).second);
+        else
+            REQUIRE(tree.remove(key) == (model.erase(key) == 1));
+    }
+}
+
+int as_int(int key) { return key; }
+
+// long strings, so a leaked or unconstructed entry shows under ASan
+std::string as_string(int key) {
+    return std::string(20, 'k') + std::to_string(key);
+}
+
+// image of tree saved as image
+template <typename T>
+std::string save(const btree::BTree<T>& tree, btree::Image image) {
+    std::stringstream outs;
+
+    tree.save(outs, image);
+    return outs.str();
+}
+
+// load bytes into tree; false if load() rejected them
+template <typename T>
+bool load(btree::BTree<T>& tree, const std::string& bytes) {
+    std::stringstream ins(bytes);
+
+    try {
+        tree.load(ins);
+    } catch(const std::runtime_error&) {
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+SCENARIO("Node pool", "[node_pool]") {
+    GIVEN("a pool of 40-byte blocks") {
+        node_pool::NodePool pool(40, 16);
+        std::vector<void*> blocks;
+
+        REQUIRE(pool.block_size() % alignof(std::max_align_t) == 0);
+        REQUIRE(pool.block_size() >= 40);
+
+        for(int i = 0; i < 4 + 8 + 16 + 16; ++i)
+            blocks.push_back(pool.allocate());
+
+        THEN("slabs double up to the cap and blocks are aligned") {
+            REQUIRE(pool.slab_count() == 4);
+            REQUIRE(pool.in_use() == blocks.size());
+            for(void* block : blocks) {
+                auto address = reinterpret_cast<std::uintptr_t>(block);
+                REQUIRE(address % alignof(std::max_align_t) == 0);
+            }
+            REQUIRE(std::set<void*>(blocks.begin(), blocks.end()).size() ==
+                    blocks.size());
+        }
+
+        THEN("freed blocks are reused before a new slab") {
+            std::set<void*> freed;
+
+            for(std::size_t i = 0; i < blocks.size(); i += 3) {
+                pool.deallocate(blocks[i]);
+                freed.insert(blocks[i]);
+            }
+            for(std::size_t i = 0; i < freed.size(); ++i)
+                REQUIRE(freed.count(pool.allocate()));
+
+            REQUIRE(pool.slab_count() == 4);
+            REQUIRE(pool.in_use() == blocks.size());
+        }
+    }
+}
+
+SCENARIO("Pooled B-tree nodes", "[btree]") {
+    const std::size_t MINIMUMS[] = {1, 2, 16};
+
+    srand(42);
+
+    for(std::size_t min : MINIMUMS) {
+        GIVEN("pooled trees with minimum " + std::to_string(min)) {
+            Tree tree(false, min, true);
+            Model model;
+
+            churn(tree, model, 3 * KEYS, as_int);
+            REQUIRE(is_same(tree, model));
+
+            THEN("copies are pooled and independent") {
+                Tree copy(tree), assigned(false, min, true);
+                Model copy_model(model);
+
+                assigned.insert(-1);
+                assigned = tree;
+                churn(copy, copy_model, KEYS, as_int);
+
+                REQUIRE(is_same(copy, copy_model));
+                REQUIRE(is_same(tree, model));
+                REQUIRE(is_same(assigned, model));
+            }
+
+            THEN("pooled and heap trees swap") {
+                Tree heap(false, min);
+                Model heap_model;
+
+                churn(heap, heap_model, KEYS, as_int);
+                tree.swap(heap);
+                churn(tree, heap_model, KEYS, as_int);
+                churn(heap, model, KEYS, as_int);
+
+                REQUIRE(is_same(tree, heap_model));
+                REQUIRE(is_same(heap, model));
+            }
+
+            THEN("cleared trees reuse their pool") {
+                for(int i = 0; i < 3; ++i) {
+                    tree.clear();
+                    model.clear();
+                    REQUIRE(tree.empty());
+                    REQUIRE(tree.begin() == tree.end());
+
+                    churn(tree, model, KEYS, as_int);
+                    REQUIRE(is_same(tree, model));
+                }
+            }
+        }
+    }
+
+    GIVEN("a pooled tree of strings") {
+        btree::BTree<std::string> tree(false, 2, true);
+        std::set<std::string> model;
+
+        churn(tree, model, 2 * KEYS, as_string);
+
+        THEN("entries are built and destroyed in the node blocks") {
+            REQUIRE(is_same(tree, model));
+
+            btree::BTree<std::string> copy(tree);
+            for(const std::string& key : model) REQUIRE(copy.remove(key));
+            REQUIRE(copy.empty());
+            REQUIRE(is_same(tree, model));
+        }
+    }
+}
+
+SCENARIO("B-tree binary images", "[btree]") {
+    const btree::Image IMAGES[] = {btree::NODE_IMAGE, btree::SORTED_IMAGE};
+    const std::size_t MINIMUMS[] = {1, 2, 16};
+    const std::size_t HEADER = 4 + 4 + 1 + 1 + 8 + 8;
+
+    srand(43);
+
+    for(std::size_t min : MINIMUMS) {
+        GIVEN("a tree with minimum " + std::to_string(min)) {
+            Tree tree(false, min);
+            Model model;
+
+            churn(tree, model, 2 * KEYS, as_int);
+
+            THEN("a node image reloads the same nodes and minimum") {
+                std::string bytes = save(tree, btree::NODE_IMAGE);
+                Tree loaded(true, 3);
+
+                REQUIRE(load(loaded, bytes));
+                REQUIRE(is_same(loaded, model));
+                REQUIRE(save(loaded, btree::NODE_IMAGE) == bytes);
+                REQUIRE_FALSE(loaded.insert(*model.begin()));  // no dups
+            }
+
+            THEN("a sorted image rebuilds with the loading tree's minimum") {
+                std::string bytes = save(tree, btree::SORTED_IMAGE);
+
+                for(std::size_t other : MINIMUMS) {
+                    Tree loaded(false, other, other == 2);
+                    Model loaded_model(model);
+
+                    REQUIRE(load(loaded, bytes));
+                    REQUIRE(is_same(loaded, model));
+
+                    churn(loaded, loaded_model, KEYS / 10, as_int);
+                    REQUIRE(is_same(loaded, loaded_model));
+                }
+            }
+        }
+    }
+
+    GIVEN("images of a small tree and a tree to load them into") {
+        Tree small(false, 2), tree(false, 2);
+        Model model, kept;
+
+        churn(small, model, 100, as_int);
+        churn(tree, kept, 100, as_int);
+
+        for(btree::Image image : IMAGES) {
+            std::string bytes = save(small, image);
+
+            THEN("every truncated image is rejected and the tree is kept") {
+                for(std::size_t size = 0; size < bytes.size(); ++size) {
+                    REQUIRE_FALSE(load(tree, bytes.substr(0, size)));
+                    REQUIRE(is_same(tree, kept));
+                }
+                REQUIRE(load(tree, bytes));
+                REQUIRE(is_same(tree, model));
+            }
+
+            THEN("a bad magic, version or image type is rejected") {
+                for(std::size_t at : {std::size_t(0), std::size_t(4),
+                                      std::size_t(8)}) {
+                    std::string bad = bytes;
+
+                    bad[at] ^= 0x5a;
+                    REQUIRE_FALSE(load(tree, bad));
+                    REQUIRE(is_same(tree, kept));
+                }
+            }
+        }
+
+        THEN("a node image that breaks the BTree rules is rejected") {
+            std::string bytes = save(small, btree::NODE_IMAGE);
+            std::string bad = bytes;
+
+            bad[HEADER] = 9;  // root data count over the maximum
+            REQUIRE_FALSE(load(tree, bad));
+            bad = bytes;
+            bad[HEADER + 4] ^= 1;  // child count is not data count + 1
+            REQUIRE_FALSE(load(tree, bad));
+            REQUIRE(is_same(tree, kept));
+        }
+
+        THEN("a sorted image out of order is rejected") {
+            std::string bad = save(small, btree::SORTED_IMAGE);
+
+            std::swap_ranges(bad.begin() + HEADER,
+                             bad.begin() + HEADER + sizeof(int),
+                             bad.begin() + HEADER + sizeof(int));
+            REQUIRE_FALSE(load(tree, bad));
+            REQUIRE(is_same(tree, kept));
+        }
+
+        THEN("an empty tree saves and loads") {
+            Tree empty(false, 2);
+
+            for(btree::Image image : IMAGES) {
+                REQUIRE(load(tree, save(empty, image)));
+                REQUIRE(tree.empty());
+                REQUIRE(tree.verify());
+            }
+        }
+    }
+
+    GIVEN("a map and a multimap") {
+        bt_map::Map<std::string, int> map(2);
+        bt_map::MMap<int, std::string> mmap(2);
+
+        for(int i = 0; i < KEYS; ++i) {
+            int key = rand() % KEYS;
+
+            map[as_string(key)] += i;
+            mmap[key].push_back(as_string(i));
+        }
+
+        for(btree::Image image : IMAGES) {
+            std::stringstream map_image, mmap_image;
+
+            map.save(map_image, image);
+            mmap.save(mmap_image, image);
+
+            THEN("they reload the same entries") {
+                bt_map::Map<std::string, int> map_copy;
+                bt_map::MMap<int, std::string> mmap_copy;
+
+                map_copy.load(map_image);
+                mmap_copy.load(mmap_image);
+
+                REQUIRE(map_copy.verify());
+                REQUIRE(map_copy.size() == map.size());
+                for(auto it = map.begin(); it != map.end(); ++it)
+                    REQUIRE(map_copy.at(it->key) == it->value);
+
+                REQUIRE(mmap_copy.verify());
+                REQUIRE(mmap_copy.size() == mmap.size());
+                for(auto it = mmap.begin(); it != mmap.end(); it.next_key())
+                    REQUIRE((mmap_copy.at(it->key) == it->values));
+            }
+
+            THEN("truncated images throw and keep the maps") {
+                std::string bytes = map_image.str();
+                std::stringstream cut(bytes.substr(0, bytes.size() - 1));
+                bt_map::Map<std::string, int> map_copy;
+
+                map_copy.insert("kept", 1);
+                REQUIRE_THROWS_AS(map_copy.load(cut), std::runtime_error);
+                REQUIRE(map_copy.size() == 1);
+                REQUIRE(map_copy.at("kept") == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("B-tree iterators and bounds", "[btree]") {
+    const std::size_t MINIMUMS[] = {1, 2, 16};
+
+    srand(44);
+
+    for(std::size_t min : MINIMUMS) {
+        GIVEN("a tree with minimum " + std::to_string(min)) {
+            Tree tree(false, min);
+            Model model;
+
+            REQUIRE(tree.begin() == tree.end());
+            REQUIRE(tree.lower_bound(0) == tree.end());
+            REQUIRE(tree.upper_bound(0) == tree.end());
+
+            churn(tree, model, 2 * KEYS, as_int);
+
+            THEN("iterators walk the entries in order") {
+                auto walker = model.begin();
+                Tree::Iterator it = tree.begin();
+
+                for(; it != tree.end(); ++walker) {
+                    REQUIRE(walker != model.end());
+                    REQUIRE(*(it++) == *walker);
+                }
+                REQUIRE(walker == model.end());
+                REQUIRE(it.is_null());
+                REQUIRE(++it == tree.end());  // stays at the end
+            }
+
+            THEN("bounds match std::set and start range scans") {
+                for(int i = 0; i < 2000; ++i) {
+                    int key = rand() % (KEYS + 2) - 1;
+                    auto lower = model.lower_bound(key);
+                    auto upper = model.upper_bound(key);
+                    Tree::Iterator low = tree.lower_bound(key);
+                    Tree::Iterator high = tree.upper_bound(key);
+
+                    REQUIRE((lower == model.end()) == (low == tree.end()));
+                    REQUIRE((upper == model.end()) == (high == tree.end()));
+                    if(lower != model.end()) REQUIRE(*low == *lower);
+                    if(upper != model.end()) REQUIRE(*high == *upper);
+
+                    for(int j = 0; j < 20 && lower != model.end();
+                        ++j, ++lower, ++low)
+                        REQUIRE(*low == *lower);
+                    if(lower == model.end()) REQUIRE(low == tree.end());
+                }
+            }
+        }
+    }
+
+    GIVEN("a map and a multimap") {
+        bt_map::Map<int, int> map(2);
+        bt_map::MMap<int, int> mmap(2);
+        std::set<int> keys;
+        std::size_t values = 0;
+
+        for(int i = 0; i < KEYS; ++i) {
+            int key = rand() % KEYS;
+
+            map[key] = key;
+            mmap[key].push_back(i);
+            keys.insert(key);
+            ++values;
+        }
+
+        THEN("their iterators and bounds match the sorted keys") {
+            auto key = keys.begin();
+            std::size_t visited = 0;
+
+            for(auto it = map.begin(); it != map.end(); ++it, ++key)
+                REQUIRE(it->key == *key);
+            REQUIRE(key == keys.end());
+
+            for(auto it = mmap.begin(); it != mmap.end(); ++it) ++visited;
+            REQUIRE(visited == values);  // every value of every key
+
+            for(int i = 0; i < 1000; ++i) {
+                int k = rand() % KEYS;
+                auto lower = keys.lower_bound(k), upper = keys.upper_bound(k);
+
+                REQUIRE(map.find(k) ==
+                        (keys.count(k) ? map.lower_bound(k) : map.end()));
+                REQUIRE(mmap.find(k) ==
+                        (keys.count(k) ? mmap.lower_bound(k) : mmap.end()));
+
+                if(lower == keys.end()) {
+                    REQUIRE(map.lower_bound(k) == map.end());
+                    REQUIRE(mmap.lower_bound(k) == mmap.end());
+                } else {
+                    REQUIRE(map.lower_bound(k)->key == *lower);
+                    REQUIRE(mmap.lower_bound(k)->key == *lower);
+                }
+
+                if(upper == keys.end()) {
+                    REQUIRE(map.upper_bound(k) == map.end());
+                    REQUIRE(mmap.upper_bound(k) == mmap.end());
+                } else {
+                    REQUIRE(map.upper_bound(k)->key == *upper);
+                    REQUIRE(mmap.upper_bound(k)->key == *upper);
+                }
+            }
+        }
+
+        THEN("values are written through iterators in place") {
+            for(auto it = map.lower_bound(KEYS / 2); it != map.end(); ++it)
+                it->value = -it->key;
+            for(auto it = mmap.find(*keys.begin()); it; it.next_key())
+                it->values.clear();
+
+            for(int key : keys) {
+                REQUIRE(map.at(key) == (key < KEYS / 2 ? key : -key));
+                REQUIRE(mmap.at(key).empty());
+            }
+        }
+    }
+}
@@ -0,0 +1,141 @@
+#include <atomic>   // std::atomic
+#include <cstdlib>  // srand(), rand()
+#include <random>   // std::mt19937
+#include <set>      // std::set
+#include <thread>   // std::thread
+#include <vector>   // std::vector
+#include "../include/concurrent_bptree.h"
+#include "../lib/catch.hpp"
+
+namespace {
+
+typedef concurrent_bptree::ConcurrentBPTree<long> Tree;
+
+const long KEYS = 20000;   // keys are 0 to KEYS - 1
+const long STABLE = 50;    // multiples of STABLE are never removed
+const int WRITERS = 4;     // writer t owns keys with key % WRITERS == t
+const int OPERATIONS = 40000;
+
+// entries of tree in iteration order
+std::vector<long> entries(Tree& tree) {
+    std::vector<long> entries;
+
+    for(auto it = tree.begin(); it != tree.end(); ++it) entries.push_back(*it);
+
+    return entries;
+}
+
+// random inserts and removes of writer t's own keys, mirrored in model
+void write(Tree& tree, int t, std::set<long>& model, std::atomic<bool>& ok) {
+    std::mt19937 random(t);
+
+    for(int i = 0; i < OPERATIONS; ++i) {
+        long key = random() % (KEYS / WRITERS) * WRITERS + t;
+
+        if(key % STABLE == 0) continue;
+        if(random() % 2) {
+            if(tree.insert(key) != model.insert(key).second) ok = false;
+        } else if(tree.remove(key) != (model.erase(key) == 1))
+            ok = false;
+    }
+}
+
+// full scans must be in order and see every stable key
+void scan(Tree& tree, std::atomic<bool>& is_done, std::atomic<bool>& ok) {
+    while(!is_done) {
+        long previous = -1, stable = 0;
+
+        for(auto it = tree.begin(); it != tree.end(); ++it) {
+            if(*it <= previous) ok = false;
+            if(*it % STABLE == 0) ++stable;
+            previous = *it;
+        }
+        if(stable != KEYS / STABLE) ok = false;
+
+        auto it = tree.lower_bound(KEYS / 2);  // bounded scan
+        for(int i = 0; i < 100 && it; ++i, ++it)
+            if(*it < KEYS / 2) ok = false;
+    }
+}
+
+}  // namespace
+
+SCENARIO("Concurrent B+ tree", "[concurrent_bptree]") {
+    GIVEN("a tree with small nodes") {
+        Tree tree(false, 2);
+
+        WHEN("most entries are removed") {
+            std::set<long> model;
+
+            srand(36);
+            for(long key = 0; key < KEYS; ++key) {
+                tree.insert(key);
+                model.insert(key);
+            }
+            for(long i = 0; i < KEYS; ++i) {
+                long key = rand() % KEYS;
+
+                REQUIRE(tree.remove(key) == (model.erase(key) == 1));
+            }
+            for(long key = 0; key < KEYS / 2; ++key) {
+                REQUIRE(tree.remove(key) == (model.erase(key) == 1));
+                if(key % 1000 == 0) REQUIRE(tree.verify());
+            }
+
+            THEN("nodes merge and the entries left are in order") {
+                REQUIRE(tree.verify());
+                REQUIRE(tree.size() == model.size());
+                REQUIRE(entries(tree) ==
+                        std::vector<long>(model.begin(), model.end()));
+            }
+
+            THEN("emptied trees collapse and take new entries") {
+                for(long key : model) REQUIRE(tree.remove(key));
+                REQUIRE(tree.empty());
+                REQUIRE(tree.begin() == tree.end());
+                REQUIRE(tree.verify());
+
+                for(long key = 0; key < 100; ++key) REQUIRE(tree.insert(key));
+                REQUIRE(tree.verify());
+                REQUIRE(tree.size() == 100);
+            }
+        }
+
+        WHEN("writers insert and remove while readers scan") {
+            std::vector<std::set<long>> models(WRITERS);
+            std::vector<std::thread> threads;
+            std::atomic<bool> is_done(false), ok(true);
+
+            for(long key = 0; key < KEYS; ++key) {
+                tree.insert(key);
+                models[key % WRITERS].insert(key);
+            }
+
+            for(int t = 0; t < WRITERS; ++t)
+                threads.emplace_back(write, std::ref(tree), t,
+                                     std::ref(models[t]), std::ref(ok));
+            std::thread reader(scan, std::ref(tree), std::ref(is_done),
+                               std::ref(ok));
+            std::thread reader2(scan, std::ref(tree), std::ref(is_done),
+                                std::ref(ok));
+
+            for(auto& thread : threads) thread.join();
+            is_done = true;
+            reader.join();
+            reader2.join();
+
+            THEN("every thread saw consistent results") {
+                std::set<long> all;
+
+                for(const auto& model : models)
+                    all.insert(model.begin(), model.end());
+
+                REQUIRE(ok);
+                REQUIRE(tree.verify());
+                REQUIRE(tree.size() == all.size());
+                REQUIRE(entries(tree) ==
+                        std::vector<long>(all.begin(), all.end()));
+            }
+        }
+    }
+}
@@ -0,0 +1,190 @@
+#include <algorithm>  // std::shuffle
+#include <ctime>      // std::time
+#include <random>     // std::default_random_engine
+#include <set>        // std::set
+#include <vector>     // std::vector
+#include "../include/flat_avl.h"
+#include "../lib/catch.hpp"
+
+SCENARIO("Flat Array-Backed Adelson-Velsky and Landis Class", "[flat_avl]") {
+    using namespace flat_avl;
+
+    bool is_found = false, is_erased = false, is_inserted = false;
+    FlatAVL<int> avl;
+    const int* found = nullptr;
+    std::vector<int> ascending_items, descending_items, random_items;
+
+    // populate vector with ascending items
+    for(int i = 1; i <= 200; ++i) ascending_items.push_back(i);
+
+    // populate vector with descending items
+    for(int i = -1; i >= -200; --i) descending_items.push_back(i);
+
+    // populate random_items and perform STL shuffle
+    random_items = ascending_items;
+    std::shuffle(random_items.begin(), random_items.end(),
+                 std::default_random_engine(time(nullptr)));
+
+    REQUIRE(ascending_items.size());
+    REQUIRE(descending_items.size());
+    REQUIRE(random_items.size());
+
+    GIVEN("insertion: w/ ascending, descending and random items") {
+        std::vector<int>* item_sets[] = {&ascending_items, &descending_items,
+                                         &random_items};
+
+        for(std::vector<int>* items : item_sets) {
+            avl.clear();
+
+            // assert all nodes are in order and within balance limits
+            for(int i : *items) {
+                is_inserted = avl.insert(i);
+                REQUIRE(is_inserted == true);
+                REQUIRE(avl.verify());
+            }
+            REQUIRE(avl.size() == items->size());
+
+            // assert reinserting items will fail
+            for(int i : *items) {
+                is_inserted = avl.insert(i);
+                REQUIRE(is_inserted == false);
+            }
+        }
+    }
+
+    // testing searching, clearing and erasing items in FlatAVL
+    GIVEN("avl inserted with ascending items") {
+        for(int i : ascending_items) {
+            is_inserted = avl.insert(i);
+            REQUIRE(is_inserted == true);
+        }
+
+        THEN("searching: with 'valid' ascending items are found") {
+            for(int i : ascending_items) {
+                is_found = avl.search(i, found);
+
+                REQUIRE(is_found == true);
+                REQUIRE(*found == i);
+            }
+        }
+
+        THEN("searching: with 'invalid' descending items are NOT found") {
+            for(int i : descending_items) {
+                is_found = avl.search(i, found);
+
+                REQUIRE(is_found == false);
+                REQUIRE(found == nullptr);
+            }
+        }
+
+        THEN("clearing: all items are removed and items are NOT found") {
+            avl.clear();
+
+            REQUIRE(avl.empty());
+            REQUIRE(avl.capacity() == 0);
+
+            for(int i : ascending_items) {
+                is_found = avl.search(i, found);
+                REQUIRE(is_found == false);
+            }
+        }
+
+        WHEN(
+            "erasing: all 'valid' items are removed in random order and the "
+            "tree is valid at every erasure") {
+            for(int i : random_items) {
+                is_erased = avl.erase(i);
+                REQUIRE(is_erased == true);
+                REQUIRE(avl.verify());
+            }
+
+            THEN("items are NOT found and nodes are kept for reuse") {
+                REQUIRE(avl.empty());
+                REQUIRE(avl.capacity() == ascending_items.size());
+
+                for(int i : ascending_items) {
+                    is_found = avl.search(i, found);
+                    REQUIRE(is_found == false);
+                }
+            }
+
+            THEN("reinserting: freed nodes are reused") {
+                for(int i : descending_items) avl.insert(i);
+
+                REQUIRE(avl.verify());
+                REQUIRE(avl.capacity() == ascending_items.size());
+            }
+        }
+
+        THEN("erasing: all 'invalid' items fail to remove") {
+            for(int i : descending_items) {
+                is_erased = avl.erase(i);
+                REQUIRE(is_erased == false);
+            }
+        }
+
+        THEN("pop_front: root items are removed until empty") {
+            while(!avl.empty()) {
+                int root = avl.front();
+
+                avl.pop_front();
+                REQUIRE(avl.verify());
+
+                is_found = avl.search(root, found);
+                REQUIRE(is_found == false);
+            }
+        }
+    }
+
+    GIVEN("random inserts and erases are checked against std::set") {
+        std::default_random_engine engine(time(nullptr));
+        std::set<int> expected;
+
+        for(int n = 0; n < 5000; ++n) {
+            int item = engine() % 300;
+
+            if(engine() % 2)
+                REQUIRE(avl.insert(item) == expected.insert(item).second);
+            else
+                REQUIRE(avl.erase(item) == (expected.erase(item) == 1));
+        }
+
+        THEN("items and size match and the tree is valid") {
+            REQUIRE(avl.verify());
+            REQUIRE(avl.size() == expected.size());
+
+            for(int i : expected) {
+                is_found = avl.search(i, found);
+                REQUIRE(is_found == true);
+            }
+        }
+    }
+
+    GIVEN(
+        "FlatAVL's copy constructor and assignment op: avl is inserted with "
+        "ascending items") {
+        for(int i : ascending_items) avl.insert(i);
+
+        FlatAVL<int> avl_copy(avl);
+        FlatAVL<int> avl_assign;
+        avl_assign = avl;
+
+        THEN("avl_copy and avl_assign is unique via avl modifications") {
+            avl.clear();
+            for(int i : descending_items) avl.insert(i);
+
+            REQUIRE(avl_copy.verify());
+            REQUIRE(avl_assign.verify());
+
+            for(int i : ascending_items) {
+                REQUIRE(avl_copy.search(i, found) == true);
+                REQUIRE(avl_assign.search(i, found) == true);
+            }
+
+            for(int i : descending_items) {
+                REQUIRE(avl_copy.search(i, found) == false);
+                REQUIRE(avl_assign.search(i, found) == false);
+            }
+        }
+    }
+}
@@ -1,15 +1,17 @@
+#include <cstdint>  // std::int64_t
 #include <cstdlib>  // srand(), rand()
 #include <ctime>    // std::time
+#include <string>   // std::string
 #include <vector>   // std::vector
 #include "../include/chained_avl_hash.h"
 #include "../include/chained_list_hash.h"
 #include "../include/double_hash.h"
 #include "../include/open_hash.h"
-#include "../include/record.h"
+#include "../include/hash_record.h"
 #include "../lib/catch.hpp"
 
 SCENARIO("Open Hash", "[open_hash]") {
-    using Record = record::Record<int>;
+    using Record = hash_record::Record<int>;
     using OpenHash = open_hash::OpenHash<Record>;
     using DoubleHash = double_hash::DoubleHash<Record>;
     using ChainedAVLHash = chained_avl_hash::ChainedAVLHash<Record>;
@@ -114,4 +116,172 @@ SCENARIO("Open Hash", "[open_hash]") {
     delete[] avl_hash;
     delete[] cl_hash;
     delete[] list;
-}
\ No newline at end of file
+}
+
+SCENARIO("Open addressing hash tables grow", "[open_hash][double_hash]") {
+    using Record = hash_record::Record<int>;
+    using OpenHash = open_hash::OpenHash<Record>;
+    using DoubleHash = double_hash::DoubleHash<Record>;
+
+    const int ITEMS = 2000;
+    Record result;
+
+    GIVEN("tables of size 17 with a max load factor of 0.5") {
+        OpenHash ohash(17, 0.5);
+        DoubleHash dhash(17, 0.5);
+
+        WHEN("more keys than the table size are inserted") {
+            for(int i = 0; i < ITEMS; ++i) {
+                REQUIRE(ohash.insert(Record(i * 7, i)) == true);
+                REQUIRE(dhash.insert(Record(i * 7, i)) == true);
+            }
+
+            THEN("all keys are found and load stays under the max") {
+                REQUIRE(ohash.size() == ITEMS);
+                REQUIRE(dhash.size() == ITEMS);
+                REQUIRE(ohash.load_factor() <= 0.5);
+                REQUIRE(dhash.load_factor() <= 0.5);
+
+                for(int i = 0; i < ITEMS; ++i) {
+                    REQUIRE(ohash.find(i * 7, result) == true);
+                    REQUIRE(result._value == i);
+                    REQUIRE(dhash.find(i * 7, result) == true);
+                    REQUIRE(result._value == i);
+                }
+            }
+
+            THEN("removing and reinserting keys reclaims tombstones") {
+                for(int round = 0; round < 10; ++round) {
+                    for(int i = 0; i < ITEMS; i += 2) {
+                        REQUIRE(ohash.remove(i * 7) == true);
+                        REQUIRE(dhash.remove(i * 7) == true);
+                    }
+                    for(int i = 0; i < ITEMS; i += 2) {
+                        ohash.insert(Record(i * 7, i));
+                        dhash.insert(Record(i * 7, i));
+                    }
+
+                    REQUIRE(ohash.size() + ohash.tombstones() <=
+                            0.5 * ohash.capacity());
+                    REQUIRE(dhash.size() + dhash.tombstones() <=
+                            0.5 * dhash.capacity());
+                }
+
+                for(int i = 0; i < ITEMS; ++i) {
+                    REQUIRE(ohash.find(i * 7, result) == true);
+                    REQUIRE(dhash.find(i * 7, result) == true);
+                }
+            }
+        }
+    }
+
+    GIVEN("tables reserved for ITEMS keys") {
+        OpenHash ohash;
+        DoubleHash dhash;
+
+        ohash.reserve(ITEMS);
+        dhash.reserve(ITEMS);
+
+        std::size_t ohash_capacity = ohash.capacity(),
+                    dhash_capacity = dhash.capacity();
+
+        THEN("inserting ITEMS keys does not grow the tables") {
+            for(int i = 0; i < ITEMS; ++i) {
+                ohash.insert(Record(i, i));
+                dhash.insert(Record(i, i));
+            }
+
+            REQUIRE(ohash.capacity() == ohash_capacity);
+            REQUIRE(dhash.capacity() == dhash_capacity);
+        }
+    }
+
+    GIVEN("an invalid max load factor") {
+        THEN("the constructor throws") {
+            REQUIRE_THROWS_AS(OpenHash(17, 0), std::invalid_argument);
+            REQUIRE_THROWS_AS(DoubleHash(17, 1.5), std::invalid_argument);
+        }
+    }
+}
+
+SCENARIO("Hash tables with string and 64-bit keys", "[hasher]") {
+    using Record = hash_record::Record<int, std::string>;
+    using Id = hash_record::Record<int, std::int64_t>;
+
+    const int ITEMS = 1000;
+    const std::int64_t BIG = std::int64_t(1) << 40;
+    Record result;
+    Id id_result;
+
+    GIVEN("all four hash tables keyed by string") {
+        open_hash::OpenHash<Record> ohash(17);
+        double_hash::DoubleHash<Record> dhash(17);
+        chained_avl_hash::ChainedAVLHash<Record> avl_hash(17);
+        chained_list_hash::ChainedListHash<Record> cl_hash(17);
+
+        for(int i = 0; i < ITEMS; ++i) {
+            Record entry("key" + std::to_string(i), i);
+
+            ohash.insert(entry);
+            dhash.insert(entry);
+            avl_hash.insert(entry);
+            cl_hash.insert(entry);
+        }
+
+        THEN("every key is found once and unknown keys are not") {
+            REQUIRE(ohash.size() == ITEMS);
+            REQUIRE(dhash.size() == ITEMS);
+            REQUIRE(avl_hash.size() == ITEMS);
+            REQUIRE(cl_hash.size() == ITEMS);
+
+            for(int i = 0; i < ITEMS; ++i) {
+                std::string key = "key" + std::to_string(i);
+
+                REQUIRE(ohash.find(key, result) == true);
+                REQUIRE(result._value == i);
+                REQUIRE(dhash.find(key, result) == true);
+                REQUIRE(result._value == i);
+                REQUIRE(avl_hash.find(key, result) == true);
+                REQUIRE(result._value == i);
+                REQUIRE(cl_hash.find(key, result) == true);
+                REQUIRE(result._value == i);
+            }
+
+            REQUIRE(ohash.find("key", result) == false);
+            REQUIRE(dhash.find("", result) == false);
+            REQUIRE(avl_hash.find("key-1", result) == false);
+            REQUIRE(cl_hash.find("KEY1", result) == false);
+        }
+
+        THEN("reinserting a key replaces its value without growing size") {
+            avl_hash.insert(Record("key7", -7));
+            cl_hash.insert(Record("key7", -7));
+
+            REQUIRE(avl_hash.size() == ITEMS);
+            REQUIRE(cl_hash.size() == ITEMS);
+            REQUIRE(avl_hash.find("key7", result) == true);
+            REQUIRE(result._value == -7);
+            REQUIRE(cl_hash.find("key7", result) == true);
+            REQUIRE(result._value == -7);
+        }
+    }
+
+    GIVEN("open addressing tables keyed by negative and 64-bit ids") {
+        open_hash::OpenHash<Id> ohash(17);
+        double_hash::DoubleHash<Id> dhash(17);
+
+        for(int i = 0; i < ITEMS; ++i) {
+            ohash.insert(Id(BIG * i - ITEMS, i));
+            dhash.insert(Id(-BIG * i, i));
+        }
+
+        THEN("every id is found") {
+            for(int i = 0; i < ITEMS; ++i) {
+                REQUIRE(ohash.find(BIG * i - ITEMS, id_result) == true);
+                REQUIRE(id_result._value == i);
+                REQUIRE(dhash.find(-BIG * i, id_result) == true);
+                REQUIRE(id_result._value == i);
+            }
+        }
+    }
+}
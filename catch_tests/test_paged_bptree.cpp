@@ -0,0 +1,124 @@
+#include <cstdio>    // std::remove
+#include <cstdlib>   // srand(), rand()
+#include <fstream>   // std::ifstream
+#include <set>       // std::set
+#include <string>    // std::string
+#include <utility>   // std::pair
+#include <vector>    // std::vector
+#include "../include/paged_bptree.h"
+#include "../lib/catch.hpp"
+
+namespace {
+
+typedef paged_bptree::PagedBPTree<long> Tree;
+typedef std::set<std::pair<std::string, long>> Model;
+
+// keys of 1 to 900 chars, so pages hold 8 to hundreds of entries and the
+// tree is 3 levels deep
+std::string random_key() {
+    std::string key = std::to_string(rand() % 500);
+
+    return key + std::string(rand() % 900, 'a' + key.size());
+}
+
+// tree holds exactly the model's entries, in order
+bool is_same(Tree& tree, const Model& model) {
+    auto walker = model.begin();
+
+    if(tree.size() != model.size() || !tree.verify()) return false;
+    for(auto it = tree.begin(); it != tree.end(); ++it, ++walker)
+        if(walker == model.end() || it->key != walker->first ||
+           it->value != walker->second)
+            return false;
+
+    return walker == model.end();
+}
+
+long file_size(const std::string& fname) {
+    std::ifstream file(fname, std::ios::binary | std::ios::ate);
+
+    return static_cast<long>(file.tellg());
+}
+
+}  // namespace
+
+SCENARIO("Paged B+ tree", "[paged_bptree]") {
+    const std::string fname = "test_paged_bptree.bin";
+    const int sample_size = 3000;
+    std::vector<std::pair<std::string, long>> entries;
+    Model model;
+
+    std::remove(fname.c_str());
+    srand(8);
+    for(int i = 0; i < sample_size; ++i)
+        entries.emplace_back(random_key(), rand() % 4);
+
+    GIVEN("a tree with a buffer pool of 8 frames") {
+        Tree tree(fname, 8);
+
+        for(const auto& e : entries)
+            REQUIRE(tree.insert(e.first, e.second) ==
+                    model.insert(e).second);
+        REQUIRE(is_same(tree, model));
+
+        WHEN("half of the entries are erased and the tree is reopened") {
+            for(int i = 0; i < sample_size; i += 2) {
+                const auto& e = entries[i];
+                REQUIRE(tree.erase(e.first, e.second) ==
+                        (model.erase(e) == 1));
+            }
+            REQUIRE_FALSE(tree.erase("missing", 0));
+            REQUIRE(is_same(tree, model));
+
+            tree.close();
+            tree.open(fname);
+
+            THEN("the entries left are read back from the file") {
+                REQUIRE(is_same(tree, model));
+
+                for(int i = 0; i < sample_size; ++i) {
+                    const std::string& key = entries[i].first;
+                    auto first = model.lower_bound({key, 0});
+                    std::size_t count = 0;
+
+                    while(first != model.end() && first->first == key)
+                        ++first, ++count;
+                    REQUIRE(tree.count(key) == count);
+                }
+            }
+        }
+
+        WHEN("every key is erased by key and the tree is refilled") {
+            long before = 0;
+
+            tree.flush();
+            before = file_size(fname);
+
+            for(const auto& e : entries) {
+                std::size_t count = tree.erase(e.first);
+                REQUIRE(count == model.count({e.first, 0}) +
+                                     model.count({e.first, 1}) +
+                                     model.count({e.first, 2}) +
+                                     model.count({e.first, 3}));
+                for(long v = 0; v < 4; ++v) model.erase({e.first, v});
+            }
+            REQUIRE(tree.empty());
+            REQUIRE(tree.begin() == tree.end());
+            REQUIRE(is_same(tree, model));
+
+            for(const auto& e : entries) {
+                tree.insert(e.first, e.second);
+                model.insert(e);
+            }
+            tree.close();
+            tree.open(fname);
+
+            THEN("freed pages are reused") {
+                REQUIRE(is_same(tree, model));
+                REQUIRE(file_size(fname) <= before);
+            }
+        }
+    }
+
+    std::remove(fname.c_str());
+}
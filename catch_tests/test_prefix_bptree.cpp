@@ -0,0 +1,125 @@
+#include <cstdlib>  // srand(), rand()
+#include <map>      // std::map
+#include <string>   // std::string
+#include <utility>  // std::move
+#include "../include/prefix_bptree.h"
+#include "../lib/catch.hpp"
+
+namespace {
+
+typedef prefix_bptree::PrefixBPTree<int> Tree;
+typedef std::map<std::string, int> Model;
+
+// keys share long prefixes, and some keys are prefixes of others
+std::string random_key() {
+    static const char* const PREFIXES[] = {"", "a", "comput", "computer",
+                                           "prefix/compression/"};
+    std::string key = PREFIXES[rand() % 5];
+
+    for(int length = rand() % 6; length > 0; --length)
+        key += "abcz"[rand() % 4];
+
+    return key;
+}
+
+// tree holds exactly the model's entries, in order
+bool is_same(Tree& tree, const Model& model) {
+    auto walker = model.begin();
+
+    if(tree.size() != model.size() || !tree.verify()) return false;
+    for(auto it = tree.begin(); it != tree.end(); ++it, ++walker)
+        if(walker == model.end() || it->key != walker->first ||
+           it->value != walker->second)
+            return false;
+
+    return walker == model.end();
+}
+
+// iterator and map iterator point to the same entry, or both to the end
+bool is_same(Tree& tree, Tree::Iterator it, const Model& model,
+             Model::const_iterator walker) {
+    if(walker == model.end()) return it == tree.end();
+
+    return it != tree.end() && it->key == walker->first &&
+           it->value == walker->second;
+}
+
+}  // namespace
+
+SCENARIO("Prefix compressed B+ tree", "[prefix_bptree]") {
+    const int sample_size = 5000;
+    const std::size_t MINIMUMS[] = {1, 2, prefix_bptree::MINIMUM};
+
+    srand(37);
+
+    for(std::size_t min : MINIMUMS) {
+        GIVEN("a tree with minimum " + std::to_string(min)) {
+            Tree tree(min);
+            Model model;
+
+            WHEN("keys are randomly inserted and erased") {
+                for(int i = 0; i < sample_size; ++i) {
+                    std::string key = random_key();
+
+                    switch(rand() % 4) {
+                        case 0:
+                        case 1:  // like Map, insert replaces the value
+                            REQUIRE(tree.insert(key, i) == !model.count(key));
+                            model[key] = i;
+                            break;
+                        case 2:
+                            REQUIRE(tree.erase(key) == (model.erase(key) == 1));
+                            break;
+                        default:
+                            tree[key] += i;
+                            model[key] += i;
+                    }
+                }
+
+                THEN("it matches std::map") {
+                    REQUIRE(is_same(tree, model));
+
+                    for(const auto& entry : model) {
+                        REQUIRE(tree.contains(entry.first));
+                        REQUIRE(tree.at(entry.first) == entry.second);
+                    }
+                    REQUIRE_THROWS_AS(tree.at("missing"), std::out_of_range);
+                }
+
+                THEN("bounds match std::map") {
+                    for(int i = 0; i < sample_size; ++i) {
+                        std::string key = random_key();
+
+                        REQUIRE(is_same(tree, tree.find(key), model,
+                                        model.find(key)));
+                        REQUIRE(is_same(tree, tree.lower_bound(key), model,
+                                        model.lower_bound(key)));
+                        REQUIRE(is_same(tree, tree.upper_bound(key), model,
+                                        model.upper_bound(key)));
+                    }
+                }
+
+                THEN("copies and moves keep their own entries") {
+                    Tree copy(tree), moved;
+
+                    tree.clear();
+                    REQUIRE(tree.empty());
+                    REQUIRE(is_same(tree, Model()));
+                    REQUIRE(is_same(copy, model));
+
+                    moved = std::move(copy);
+                    REQUIRE(copy.empty());
+                    REQUIRE(is_same(moved, model));
+                }
+
+                THEN("erasing every key empties the tree") {
+                    for(const auto& entry : model)
+                        REQUIRE(tree.erase(entry.first));
+                    REQUIRE(tree.empty());
+                    REQUIRE(tree.begin() == tree.end());
+                    REQUIRE(tree.verify());
+                }
+            }
+        }
+    }
+}
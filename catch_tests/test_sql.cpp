@@ -0,0 +1,634 @@
+#include <algorithm>  // std::sort
+#include <cstdio>     // std::remove
+#include <fstream>    // std::ofstream
+#include <iostream>   // std::cout
+#include <map>        // std::map
+#include <memory>     // std::unique_ptr
+#include <sstream>    // std::ostringstream, std::istringstream
+#include <string>     // std::string
+#include <vector>     // std::vector
+#include "../include/sql.h"
+#include "../lib/catch.hpp"
+
+typedef std::vector<std::string> Rows;  // rows of values joined by "|"
+
+const char* const BATCH_FILE = "catch_sql_batch.txt";
+const char* const SESSION = "catch_sql";
+
+// SQL of the test session; its tables and session file are removed when done
+class Session {
+public:
+    Session(const std::vector<std::string>& tables);
+    ~Session();
+
+    sql::SQL& sql() { return *_sql; }
+    void reopen();  // save session and restore it in a new SQL
+
+private:
+    std::unique_ptr<sql::SQL> _sql;
+    std::vector<std::string> _tables;
+};
+
+// run commands as a batch file and return what sql printed
+std::string run(sql::SQL& sql, const std::vector<std::string>& commands);
+
+// header and rows of the last table printed in output, values trimmed
+Rows last_table(const std::string& output);
+
+// remove a table's files
+void drop(const std::string& table_name);
+
+// rows after the header, sorted
+Rows sorted_rows(const Rows& rows);
+
+// header and rows of a table with all fields
+Rows table_rows(sql::SQLTable& table);
+
+// header and rows a SELECT query prints for a table opened without
+// IndexMaps, which scans it with its zone maps
+Rows scan(const std::string& table_name, std::string query);
+
+// print Rows one per line when a test fails
+namespace Catch {
+template <>
+struct StringMaker<Rows> {
+    static std::string convert(const Rows& rows) {
+        std::string str = "\n";
+        for(const auto& a : rows) str += a + "\n";
+        return str;
+    }
+};
+}  // namespace Catch
+
+SCENARIO("SQL aggregate functions and GROUP BY", "[sql][aggregate]") {
+    Session session({"t_emp"});
+    sql::SQL& sql = session.sql();
+
+    std::string out = run(
+        sql, {"make table t_emp fields last, dep, salary, year",
+              "insert into t_emp values Blow, CS, 100000, 2018",
+              "insert into t_emp values Blow, Physics, 200000, 2016",
+              "insert into t_emp values Johnson, HR, 150000, 2014",
+              "insert into t_emp values Yao, CS, 99000, 2012",
+              "insert into t_emp values Yang, CS, 161000, 2013"});
+    REQUIRE(out.find("ERROR") == std::string::npos);
+
+    GIVEN("aggregates without GROUP BY") {
+        THEN("all records are one group, numbers compare as numbers") {
+            out = run(sql, {"select COUNT(*), COUNT(last), SUM(salary), "
+                            "MIN(salary), MAX(salary), AVG(salary) "
+                            "from t_emp"});
+            REQUIRE(last_table(out) ==
+                    Rows({"COUNT(*)|COUNT(last)|SUM(salary)|MIN(salary)|"
+                          "MAX(salary)|AVG(salary)",
+                          "5|5|710000|99000|200000|142000"}));
+        }
+
+        THEN("MIN and MAX of strings compare as strings") {
+            out = run(sql, {"select MIN(last), MAX(last) from t_emp"});
+            REQUIRE(last_table(out) ==
+                    Rows({"MIN(last)|MAX(last)", "Blow|Yao"}));
+        }
+
+        THEN("WHERE selects the records to aggregate") {
+            out = run(sql, {"select COUNT(*), SUM(salary) from t_emp "
+                            "where dep = CS and year > 2012"});
+            REQUIRE(last_table(out) ==
+                    Rows({"COUNT(*)|SUM(salary)", "2|261000"}));
+
+            out = run(sql, {"select COUNT(*), MIN(salary) from t_emp "
+                            "where year > 2020"});
+            REQUIRE(last_table(out) ==
+                    Rows({"COUNT(*)|MIN(salary)", "0|"}));
+        }
+    }
+
+    GIVEN("aggregates with GROUP BY") {
+        THEN("one row per group in order of the group field") {
+            out = run(sql, {"select dep, COUNT(*), MAX(salary), AVG(year) "
+                            "from t_emp group by dep"});
+            REQUIRE(last_table(out) ==
+                    Rows({"dep|COUNT(*)|MAX(salary)|AVG(year)",
+                          "CS|3|161000|2014.33333333333", "HR|1|150000|2014",
+                          "Physics|1|200000|2016"}));
+        }
+
+        THEN("groups without records in the WHERE result are left out") {
+            out = run(sql, {"select dep, COUNT(*) from t_emp "
+                            "where year >= 2014 group by dep"});
+            REQUIRE(last_table(out) ==
+                    Rows({"dep|COUNT(*)", "CS|1", "HR|1", "Physics|1"}));
+        }
+    }
+
+    GIVEN("invalid aggregate queries") {
+        THEN("a plain field must be the GROUP BY field") {
+            out = run(sql, {"select last, COUNT(*) from t_emp group by dep"});
+            REQUIRE(out.find("ERROR: Invalid aggregate") != std::string::npos);
+        }
+
+        THEN("only COUNT takes the asterisk") {
+            out = run(sql, {"select SUM(*) from t_emp"});
+            REQUIRE(out.find("ERROR: Invalid aggregate") != std::string::npos);
+        }
+
+        THEN("aggregate and GROUP BY fields must exist") {
+            out = run(sql, {"select SUM(bonus) from t_emp"});
+            REQUIRE(out.find("ERROR: Field name") != std::string::npos);
+
+            out = run(sql, {"select COUNT(*) from t_emp group by bonus"});
+            REQUIRE(out.find("ERROR: Field name") != std::string::npos);
+        }
+    }
+}
+
+SCENARIO("SQL columnar tables", "[sql][columnar]") {
+    Session session({"t_col"});
+
+    std::string out = run(
+        session.sql(),
+        {"create columnar table t_col fields last, dep, salary",
+         "insert into t_col values Blow, CS, 100000",
+         "insert into t_col values Johnson, HR, 150000",
+         "insert into t_col values Yao, CS, 99000",
+         "insert into t_col values \"Van Gogh\", Art, 240000"});
+    REQUIRE(out.find("ERROR") == std::string::npos);
+
+    // each field has its own column file
+    REQUIRE(std::ifstream("t_col_0.col").good());
+    REQUIRE(std::ifstream("t_col_2.col").good());
+
+    GIVEN("a columnar table") {
+        THEN("SELECT reads whole records, projections and WHERE") {
+            out = run(session.sql(), {"select * from t_col"});
+            REQUIRE(last_table(out) == Rows({"last|dep|salary",
+                                             "Blow|CS|100000",
+                                             "Johnson|HR|150000",
+                                             "Yao|CS|99000",
+                                             "Van Gogh|Art|240000"}));
+
+            out = run(session.sql(), {"select salary, last from t_col "
+                                      "where dep = CS or salary > 200000"});
+            REQUIRE(last_table(out) == Rows({"salary|last", "100000|Blow",
+                                             "99000|Yao", "240000|Van Gogh"}));
+        }
+
+        THEN("aggregates read the aggregated column") {
+            out = run(session.sql(), {"select dep, COUNT(*), SUM(salary) "
+                                      "from t_col group by dep"});
+            REQUIRE(last_table(out) ==
+                    Rows({"dep|COUNT(*)|SUM(salary)", "Art|1|240000",
+                          "CS|2|199000", "HR|1|150000"}));
+        }
+
+        THEN("the open column files read records inserted between reads") {
+            out = run(session.sql(),
+                      {"select last from t_col where dep = HR",
+                       "insert into t_col values Yang, HR, 161000",
+                       "select last, salary from t_col where dep = HR"});
+            REQUIRE(last_table(out) ==
+                    Rows({"last|salary", "Johnson|150000", "Yang|161000"}));
+
+            out = run(session.sql(), {"select dep from t_col"});
+            REQUIRE(last_table(out) ==
+                    Rows({"dep", "CS", "HR", "CS", "Art", "HR"}));
+        }
+    }
+
+    GIVEN("a reloaded session") {
+        session.reopen();
+
+        THEN("the table is still columnar with the same records") {
+            out = run(session.sql(),
+                      {"insert into t_col values Yang, CS, 161000",
+                       "select last from t_col where dep = CS"});
+            REQUIRE(last_table(out) == Rows({"last", "Blow", "Yao", "Yang"}));
+
+            std::ifstream column("t_col_0.col",
+                                 std::ios::binary | std::ios::ate);
+            REQUIRE(column.tellg() == 5 * 4);  // one 4 byte code per record
+        }
+    }
+}
+
+SCENARIO("SQL JOIN", "[sql][join]") {
+    Session session({"t_staff", "t_dept", "t_cdept"});
+    sql::SQL& sql = session.sql();
+
+    std::string out = run(
+        sql, {"make table t_staff fields last, dep, salary",
+              "insert into t_staff values Blow, CS, 100000",
+              "insert into t_staff values Johnson, HR, 150000",
+              "insert into t_staff values Yao, CS, 99000",
+              "insert into t_staff values Jones, Art, 80000",
+              "insert into t_staff values Yang, Physics, 161000",
+              "make table t_dept fields dname, floor, last",
+              "insert into t_dept values CS, 3, Knuth",
+              "insert into t_dept values HR, 1, Smith",
+              "insert into t_dept values Physics, 2, Curie",
+              "insert into t_dept values CS, 4, Hopper",
+              "create columnar table t_cdept fields dname, floor, last",
+              "insert into t_cdept values CS, 3, Knuth",
+              "insert into t_cdept values HR, 1, Smith",
+              "insert into t_cdept values Physics, 2, Curie",
+              "insert into t_cdept values CS, 4, Hopper"});
+    REQUIRE(out.find("ERROR") == std::string::npos);
+
+    const Rows JOINED({"t_staff.last|t_dept.floor|t_dept.last",
+                       "Blow|3|Knuth",
+                       "Blow|4|Hopper",
+                       "Johnson|1|Smith",
+                       "Yao|3|Knuth",
+                       "Yao|4|Hopper",
+                       "Yang|2|Curie"});
+
+    GIVEN("an index join") {
+        THEN("fields are qualified or unique unqualified names") {
+            out = run(sql, {"select t_staff.last, floor, t_dept.last "
+                            "from t_staff join t_dept on dep = dname"});
+            REQUIRE(last_table(out) == JOINED);
+
+            out = run(sql, {"select t_staff.last, floor, t_dept.last "
+                            "from t_staff join t_dept "
+                            "on t_dept.dname = t_staff.dep"});
+            REQUIRE(last_table(out) == JOINED);
+        }
+
+        THEN("WHERE filters the joined records") {
+            out = run(sql, {"select t_staff.last, floor from t_staff "
+                            "join t_dept on dep = dname "
+                            "where floor > 3 or t_staff.last = Yang"});
+            REQUIRE(last_table(out) ==
+                    Rows({"t_staff.last|t_dept.floor", "Blow|4", "Yao|4",
+                          "Yang|2"}));
+        }
+    }
+
+    GIVEN("a hash join") {
+        THEN("it is planned when the probe side is larger and fits memory") {
+            sql::SQLTable staff("t_staff"), cdept("t_cdept");
+            REQUIRE(cdept.storage() == sql::SQLTable::STORAGE_COLUMN);
+            REQUIRE(staff.plan_join(cdept, "dname") ==
+                    sql::SQLTable::JOIN_HASH);
+            REQUIRE(cdept.plan_join(staff, "dep") ==
+                    sql::SQLTable::JOIN_INDEX);
+
+            // a build side that would spill is probed by its index instead
+            std::size_t memory_rows = sql::SQLTable::join_memory_rows();
+            sql::SQLTable::set_join_memory_rows(2);
+            int plan = staff.plan_join(cdept, "dname");
+            sql::SQLTable::set_join_memory_rows(memory_rows);
+            REQUIRE(plan == sql::SQLTable::JOIN_INDEX);
+
+            // no index, no choice
+            sql::SQLTable scanned("t_cdept", false);
+            REQUIRE(cdept.plan_join(scanned, "dname") ==
+                    sql::SQLTable::JOIN_HASH);
+        }
+
+        THEN("it finds the same records as the index join") {
+            out = run(sql, {"select t_staff.last, floor, t_cdept.last "
+                            "from t_staff join t_cdept on dep = dname"});
+            Rows rows = last_table(out);
+            REQUIRE(!rows.empty());
+            REQUIRE(rows[0] == "t_staff.last|t_cdept.floor|t_cdept.last");
+            REQUIRE(sorted_rows(rows) == sorted_rows(JOINED));
+        }
+
+        THEN("a build side larger than memory is spilled and still matches") {
+            sql::SQLTable staff("t_staff"), cdept("t_cdept", false);
+            sql::SQLTable joined(
+                "t_joined",
+                {"t_staff.last", "t_staff.dep", "t_staff.salary",
+                 "t_cdept.dname", "t_cdept.floor", "t_cdept.last"},
+                sql::SQLTable::STORAGE_ROW, false);
+
+            std::size_t memory_rows = sql::SQLTable::join_memory_rows();
+            sql::SQLTable::set_join_memory_rows(2);
+            REQUIRE(staff.plan_join(cdept, "dname") ==
+                    sql::SQLTable::JOIN_HASH);
+            REQUIRE(staff.join(cdept, "dep", "dname", joined));
+            sql::SQLTable::set_join_memory_rows(memory_rows);
+
+            Rows rows = table_rows(joined);
+            joined.delete_table();
+            REQUIRE(sorted_rows(rows) ==
+                    Rows({"Blow|CS|100000|CS|3|Knuth",
+                          "Blow|CS|100000|CS|4|Hopper",
+                          "Johnson|HR|150000|HR|1|Smith",
+                          "Yang|Physics|161000|Physics|2|Curie",
+                          "Yao|CS|99000|CS|3|Knuth",
+                          "Yao|CS|99000|CS|4|Hopper"}));
+
+            // partition files are removed
+            REQUIRE(!std::ifstream("t_staff.tbl.probe0").good());
+            REQUIRE(!std::ifstream("t_cdept.tbl.build0").good());
+        }
+    }
+
+    GIVEN("a self-join") {
+        THEN("the JOIN table is qualified by its alias") {
+            out = run(sql, {"select t_staff.last, boss.last from t_staff "
+                            "join t_staff as boss on t_staff.dep = boss.dep "
+                            "where t_staff.dep = CS"});
+            REQUIRE(last_table(out) ==
+                    Rows({"t_staff.last|boss.last", "Blow|Blow", "Blow|Yao",
+                          "Yao|Blow", "Yao|Yao"}));
+        }
+
+        THEN("a spilled hash join partitions the table once per side") {
+            sql::SQLTable staff("t_staff", false);
+            sql::SQLTable joined("t_joined", {"last", "dep", "salary", "last2",
+                                              "dep2", "salary2"},
+                                 sql::SQLTable::STORAGE_ROW, false);
+
+            std::size_t memory_rows = sql::SQLTable::join_memory_rows();
+            sql::SQLTable::set_join_memory_rows(2);
+            REQUIRE(staff.join(staff, "dep", "dep", joined));
+            sql::SQLTable::set_join_memory_rows(memory_rows);
+
+            // CS has 2 x 2 pairs; HR, Art and Physics one each
+            Rows rows = table_rows(joined);
+            joined.delete_table();
+            REQUIRE(rows.size() == 1 + 7);
+        }
+    }
+
+    GIVEN("invalid joins") {
+        THEN("a table joins itself only under an alias") {
+            out = run(sql, {"select * from t_staff join t_staff on dep = dep"});
+            REQUIRE(out.find("ERROR: Invalid JOIN") != std::string::npos);
+
+            out = run(sql, {"select * from t_staff join t_dept as t_staff "
+                            "on dep = dname"});
+            REQUIRE(out.find("ERROR: Invalid JOIN") != std::string::npos);
+        }
+
+        THEN("the joined table must exist") {
+            out = run(sql,
+                      {"select * from t_staff join t_none on dep = dname"});
+            REQUIRE(out.find("ERROR") != std::string::npos);
+        }
+
+        THEN("unqualified names must belong to one table") {
+            out = run(sql, {"select last from t_staff "
+                            "join t_dept on dep = dname"});
+            REQUIRE(out.find("ERROR") != std::string::npos);
+
+            out = run(sql,
+                      {"select * from t_staff join t_dept on last = last"});
+            REQUIRE(out.find("ERROR: Invalid JOIN") != std::string::npos);
+        }
+    }
+}
+
+SCENARIO("SQL index", "[sql][index]") {
+    sql::SQLIndex index;
+    std::map<std::string, long> expected;  // value to record count
+
+    GIVEN("values added between range lookups") {
+        for(long i = 0; i < 2000; ++i) {
+            std::string value = std::to_string(i * 7919 % 1009);
+            index[value] += i;
+            ++expected[value];
+
+            std::string probe = std::to_string(i % 1100);
+            auto low = index.lower_bound(probe);
+            auto exp_low = expected.lower_bound(probe);
+            REQUIRE((low == index.end()) == (exp_low == expected.end()));
+            if(exp_low != expected.end()) REQUIRE(low->key == exp_low->first);
+
+            auto upp = index.upper_bound(probe);
+            auto exp_upp = expected.upper_bound(probe);
+            REQUIRE((upp == index.end()) == (exp_upp == expected.end()));
+            if(exp_upp != expected.end()) REQUIRE(upp->key == exp_upp->first);
+        }
+
+        THEN("iteration is in order of values with all positions") {
+            REQUIRE(index.size() == expected.size());
+
+            auto exp = expected.begin();
+            for(auto it = index.begin(); it != index.end(); ++it, ++exp) {
+                REQUIRE(it->key == exp->first);
+                REQUIRE(long(it->value.size()) == exp->second);
+            }
+            REQUIRE(exp == expected.end());
+        }
+
+        THEN("find uses exact values") {
+            REQUIRE(index.find("1008") != index.end());
+            REQUIRE(index.find("1008")->key == "1008");
+            REQUIRE(index.find("1009") == index.end());
+            REQUIRE(index.find("") == index.end());
+        }
+
+        THEN("a copy is ordered by its own values") {
+            sql::SQLIndex copy(index);
+            index.clear();
+            copy["0000"] += 1;
+
+            REQUIRE(copy.size() == expected.size() + 1);
+            REQUIRE(copy.begin()->key == "0");
+            REQUIRE((++copy.begin())->key == "0000");
+            REQUIRE(copy.find("1008") != copy.end());
+            REQUIRE(index.begin() == index.end());
+        }
+    }
+}
+
+SCENARIO("SQL zone maps", "[sql][zone]") {
+    Session session({"t_zone", "t_row"});
+    const long COUNT = 2500;  // records over three zone blocks
+    const std::string ID = "record_long_prefix_";  // longer than ZONE_WIDTH
+    const std::streamoff ZONE_BYTES =
+        sizeof(std::size_t) + 2 * sql::REC_ROW * sql::ZONE_WIDTH;
+    std::vector<std::string> commands = {
+        "create columnar table t_zone fields id, name",
+        "make table t_row fields id, name",
+        "insert into t_row values 1, a"};
+
+    for(long i = 1; i <= COUNT; ++i) {
+        std::string n = std::to_string(10000 + i).substr(1);  // 4 digits
+        commands.push_back("insert into t_zone values " + ID + n + ", n" + n);
+    }
+
+    std::string out = run(session.sql(), commands);
+    REQUIRE(out.find("ERROR") == std::string::npos);
+
+    GIVEN("a column stored table") {
+        THEN("it keeps one compact zone per block; indexed row tables none") {
+            std::ifstream zone("t_zone.tbl.zone",
+                               std::ios::binary | std::ios::ate);
+            REQUIRE(zone.tellg() == 3 * ZONE_BYTES);
+            REQUIRE(!std::ifstream("t_row.tbl.zone").good());
+        }
+
+        THEN("WHERE finds the records of matching blocks") {
+            Rows last = {"name", "n2499", "n2500"};
+            REQUIRE(scan("t_zone", "select name from t_zone "
+                                   "where name >= n2499") == last);
+
+            last = {"name", "n0001", "n0002", "n2498", "n2499", "n2500"};
+            REQUIRE(scan("t_zone", "select name from t_zone "
+                                   "where name < n0003 or name > n2497") ==
+                    last);
+
+            // the IndexMaps find the same records
+            out = run(session.sql(),
+                      {"select name from t_zone "
+                       "where name < n0003 or name > n2497"});
+            REQUIRE(last_table(out) == last);
+        }
+
+        THEN("values longer than the zone's prefixes still match") {
+            const std::string query = "select name from t_zone where id ";
+
+            REQUIRE(scan("t_zone", query + "= " + ID + "1500") ==
+                    Rows({"name", "n1500"}));
+            REQUIRE(scan("t_zone", query + "> " + ID + "2498") ==
+                    Rows({"name", "n2499", "n2500"}));
+        }
+
+        THEN("a block whose zone can not match is not read") {
+            // first block's zone claims only n9999, so n0001 is not read
+            std::remove("t_zone.tbl.zone");
+            sql::SQLRecord("t_zone.tbl").update_zone({ID, "n9999"}, 1);
+
+            REQUIRE(scan("t_zone", "select name from t_zone "
+                                   "where name <= n0001 or name = n2000") ==
+                    Rows({"name", "n2000"}));
+        }
+    }
+}
+
+SCENARIO("SQL session loading", "[sql][session]") {
+    Session session({"t_lazy"});
+
+    std::string out = run(session.sql(),
+                          {"make table t_lazy fields last, first",
+                           "insert into t_lazy values Blow, Joe",
+                           "insert into t_lazy values Yao, Jack"});
+    REQUIRE(out.find("ERROR") == std::string::npos);
+
+    GIVEN("a reloaded session") {
+        session.reopen();
+
+        THEN("its tables are listed") {
+            std::ostringstream outs;
+            std::streambuf* cout_buf = std::cout.rdbuf(outs.rdbuf());
+            session.sql().print_table_list();
+            std::cout.rdbuf(cout_buf);
+
+            REQUIRE(outs.str().find("t_lazy\n") != std::string::npos);
+        }
+
+        THEN("a table is read on first access, not when loading") {
+            // written after loading; an eagerly read table would miss it
+            sql::SQLTable("t_lazy").insert({"Yang", "Bo"});
+
+            out = run(session.sql(), {"select * from t_lazy",
+                                      "select first from t_lazy "
+                                      "where last = Yang"});
+            REQUIRE(out.find("Yao                  Jack") !=
+                    std::string::npos);
+            REQUIRE(last_table(out) == Rows({"first", "Bo"}));
+        }
+    }
+}
+
+Session::Session(const std::vector<std::string>& tables)
+    : _sql(new sql::SQL), _tables(tables) {
+    _sql->change_session(SESSION);
+}
+
+Session::~Session() {
+    _sql.reset();  // saves session
+    for(const auto& a : _tables) drop(a);
+    std::remove((std::string(SESSION) + ".sql").c_str());
+}
+
+void Session::reopen() {
+    _sql.reset();
+    _sql.reset(new sql::SQL);
+    _sql->change_session(SESSION);
+}
+
+std::string run(sql::SQL& sql, const std::vector<std::string>& commands) {
+    std::ofstream batch(BATCH_FILE);
+    for(const auto& a : commands) batch << a << '\n';
+    batch.close();
+
+    std::ostringstream outs;
+    std::streambuf* cout_buf = std::cout.rdbuf(outs.rdbuf());
+    sql.load_commands(BATCH_FILE);
+    std::cout.rdbuf(cout_buf);
+
+    std::remove(BATCH_FILE);
+
+    return outs.str();
+}
+
+Rows last_table(const std::string& output) {
+    const std::size_t WIDTH = sql::SQLTable::PRINT_COL_WIDTH + 1;
+    std::size_t start = output.rfind("\nTABLE: ");
+    Rows rows;
+
+    if(start == std::string::npos) return rows;
+
+    std::istringstream ins(output.substr(start + 1));
+    std::string line;
+    std::getline(ins, line);  // table title
+
+    while(std::getline(ins, line) && !line.empty()) {
+        if(line[0] == '-') continue;  // header underline
+
+        std::string row;
+        for(std::size_t i = 0; i + 1 < line.size(); i += WIDTH) {
+            std::string value = line.substr(i, WIDTH);
+            value.erase(value.find_last_not_of(' ') + 1);
+            row += (i ? "|" : "") + value;
+        }
+        rows.push_back(row);
+    }
+
+    return rows;
+}
+
+void drop(const std::string& table_name) {
+    sql::SQLTable(table_name).delete_table();
+}
+
+Rows sorted_rows(const Rows& rows) {
+    Rows sorted(rows.begin() + (rows.empty() ? 0 : 1), rows.end());
+    std::sort(sorted.begin(), sorted.end());
+
+    return sorted;
+}
+
+Rows table_rows(sql::SQLTable& table) {
+    std::ostringstream outs;
+    std::streambuf* cout_buf = std::cout.rdbuf(outs.rdbuf());
+    std::cout << "\nTABLE: " << std::endl;
+    table.print();
+    std::cout.rdbuf(cout_buf);
+
+    return last_table(outs.str());
+}
+
+Rows scan(const std::string& table_name, std::string query) {
+    sql::SQLTable table(table_name, false);
+    sql::SQLTable selected(table_name + "__scan__");
+    sql::SQLParser parser(&query[0]);
+    sql::ParseTree tree;
+    sql::QueueTokens infix;
+    parser.parse_query(tree, infix);
+
+    std::ostringstream outs;
+    std::streambuf* cout_buf = std::cout.rdbuf(outs.rdbuf());
+    std::cout << "\nTABLE: " << table_name << std::endl;
+    table.select(tree["FIELDS"], infix, selected);
+    std::cout.rdbuf(cout_buf);
+    selected.delete_table();
+
+    return last_table(outs.str());
+}
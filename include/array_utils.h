@@ -9,11 +9,17 @@
 #ifndef ARRAY_UTILS_H
 #define ARRAY_UTILS_H
 
-#include <iomanip>   // setw()
-#include <iostream>  // stream objects
-#include <string>    // string objects
-#include <utility>   // move()
-#include <vector>    // vector objects
+#include <cstdint>      // int32_t, int64_t
+#include <iomanip>      // setw()
+#include <iostream>     // stream objects
+#include <string>       // string objects
+#include <type_traits>  // integral_constant, is_same
+#include <utility>      // move()
+#include <vector>       // vector objects
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ARRAY_UTILS_SIMD  // SIMD paths built per function, picked at run time
+#include <immintrin.h>    // SSE2/SSE4.2/AVX2 intrinsics
+#endif
 
 namespace array_utils {
 
@@ -33,9 +39,52 @@ template <typename T>
 void ordered_insert(T* data, std::size_t& size, const T& entry,
                     bool replace = false);
 
+// SIMD compares of the CPU running the program; each level has the ones below
+enum Simd { SIMD_NONE, SIMD_SSE2, SIMD_SSE42, SIMD_AVX2 };
+
+// 32/64-bit integers that count_less() compares with SIMD
+template <typename T>
+struct is_simd_key
+    : std::integral_constant<bool, std::is_same<T, std::int32_t>::value ||
+                                       std::is_same<T, std::uint32_t>::value ||
+                                       std::is_same<T, std::int64_t>::value ||
+                                       std::is_same<T, std::uint64_t>::value> {
+};
+
+inline int simd_level();  // found once
+
+// fewer 64-bit keys than this are walked: 2-4 per compare does not pay for
+// the setup on nodes that small
+enum { SIMD_MIN_KEYS_64 = 8 };
+
 // return the first element in data that is not less than entry
 template <typename T>
 std::size_t first_ge(const T* data, std::size_t size, const T& entry);
+template <typename T>  // linear walk
+std::size_t first_ge(const T* data, std::size_t size, const T& entry,
+                     std::false_type);
+template <typename T>  // sorted SIMD keys: count_less() if the CPU has it
+std::size_t first_ge(const T* data, std::size_t size, const T& entry,
+                     std::true_type);
+
+// return the number of elements in data less than entry, without branches;
+// 32/64-bit integers compare 4-8 elements per instruction with SSE/AVX2
+template <typename T>
+std::size_t count_less(const T* data, std::size_t size, const T& entry);
+inline std::size_t count_less_32(const std::int32_t* data, std::size_t size,
+                                 std::int32_t entry, std::int32_t bias,
+                                 int level = simd_level());
+inline std::size_t count_less_64(const std::int64_t* data, std::size_t size,
+                                 std::int64_t entry, std::int64_t bias,
+                                 int level = simd_level());
+inline std::size_t count_less(const std::int32_t* data, std::size_t size,
+                              const std::int32_t& entry);
+inline std::size_t count_less(const std::uint32_t* data, std::size_t size,
+                              const std::uint32_t& entry);
+inline std::size_t count_less(const std::int64_t* data, std::size_t size,
+                              const std::int64_t& entry);
+inline std::size_t count_less(const std::uint64_t* data, std::size_t size,
+                              const std::uint64_t& entry);
 
 // append entry to the right of data
 template <typename T>
@@ -211,9 +260,10 @@ void ordered_insert(T* data, std::size_t& size, const T& entry, bool replace) {
 /*******************************************************************************
  * DESCRIPTION:
  *  Find the index of the first value that's greater than or equal to entry.
+ *  32/64-bit integers are counted with SIMD compares when the CPU has them.
  *
  * PRE-CONDITIONS:
- *  const T* data   : templated array
+ *  const T* data   : templated array; ascending order
  *  std::size_t size: array size
  *  const T& entry  : entry item to compare
  *
@@ -225,12 +275,438 @@ void ordered_insert(T* data, std::size_t& size, const T& entry, bool replace) {
  ******************************************************************************/
 template <typename T>
 std::size_t first_ge(const T* data, std::size_t size, const T& entry) {
+    return first_ge(data, size, entry, is_simd_key<T>());
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Find the index of the first value that's greater than or equal to entry
+ *  by a linear walk.
+ *
+ * PRE-CONDITIONS:
+ *  const T* data   : templated array
+ *  std::size_t size: array size
+ *  const T& entry  : entry item to compare
+ *  std::false_type : T has no SIMD compare
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: index
+ ******************************************************************************/
+template <typename T>
+std::size_t first_ge(const T* data, std::size_t size, const T& entry,
+                     std::false_type) {
     std::size_t walker = 0;  // forward walker
     while(walker < size && data[walker] < entry) ++walker;
 
     return walker;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Find the index of the first value that's greater than or equal to entry
+ *  in sorted integers: the count of values less than entry, with SIMD
+ *  compares. Without them a scalar count loses to the walk on nodes of 16
+ *  or more keys, and fewer than SIMD_MIN_KEYS_64 64-bit keys lose to it
+ *  too, so those are walked instead.
+ *
+ * PRE-CONDITIONS:
+ *  const T* data   : array in ascending order
+ *  std::size_t size: array size
+ *  const T& entry  : entry item to compare
+ *  std::true_type  : T is a 32/64-bit integer
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: index
+ ******************************************************************************/
+template <typename T>
+std::size_t first_ge(const T* data, std::size_t size, const T& entry,
+                     std::true_type) {
+    if(sizeof(T) == 4 ? simd_level() >= SIMD_SSE2
+                      : size >= SIMD_MIN_KEYS_64 && simd_level() >= SIMD_SSE42)
+        return count_less(data, size, entry);
+
+    return first_ge(data, size, entry, std::false_type());
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Counts the values less than entry. Every value is compared and the
+ *  results are summed, so there is no branch on the data.
+ *
+ * PRE-CONDITIONS:
+ *  const T* data   : templated array
+ *  std::size_t size: array size
+ *  const T& entry  : entry item to compare
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count
+ ******************************************************************************/
+template <typename T>
+std::size_t count_less(const T* data, std::size_t size, const T& entry) {
+    std::size_t count = 0;
+    for(std::size_t i = 0; i < size; ++i) count += data[i] < entry;
+
+    return count;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Finds the SIMD compares of the CPU running the program, once. Builds
+ *  without the x86 intrinsics have none.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  int: Simd level
+ ******************************************************************************/
+inline int simd_level() {
+#if defined(ARRAY_UTILS_SIMD)
+    static const int level = [] {
+        __builtin_cpu_init();  // may run before static constructors
+
+        if(__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+        if(__builtin_cpu_supports("sse4.2")) return SIMD_SSE42;
+        if(__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+        return SIMD_NONE;
+    }();
+
+    return level;
+#else
+    return SIMD_NONE;
+#endif
+}
+
+#if defined(ARRAY_UTILS_SIMD)
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Counts the 32-bit values less than entry, 4 per compare. Built for SSE2
+ *  whatever the compile flags; only call when the CPU has it.
+ *
+ * PRE-CONDITIONS:
+ *  const std::int32_t* data: array
+ *  std::size_t size        : array size
+ *  std::int32_t entry      : entry item to compare, xor'd with bias
+ *  std::int32_t bias       : 0 for signed, INT32_MIN for unsigned values
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count
+ ******************************************************************************/
+__attribute__((target("sse2"))) inline std::size_t count_less_32_sse2(
+    const std::int32_t* data, std::size_t size, std::int32_t entry,
+    std::int32_t bias) {
+    const __m128i key4 = _mm_set1_epi32(entry);
+    const __m128i bias4 = _mm_set1_epi32(bias);
+    std::size_t count = 0, i = 0;
+
+    for(; i + 4 <= size; i += 4) {
+        __m128i block = _mm_xor_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), bias4);
+        __m128i less = _mm_cmpgt_epi32(key4, block);
+        count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(less)));
+    }
+    for(; i < size; ++i) count += (data[i] ^ bias) < entry;
+
+    return count;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Counts the 32-bit values less than entry, 8 per compare, then 4. Built
+ *  for AVX2 whatever the compile flags; only call when the CPU has it.
+ *
+ * PRE-CONDITIONS:
+ *  const std::int32_t* data: array
+ *  std::size_t size        : array size
+ *  std::int32_t entry      : entry item to compare, xor'd with bias
+ *  std::int32_t bias       : 0 for signed, INT32_MIN for unsigned values
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count
+ ******************************************************************************/
+__attribute__((target("avx2"))) inline std::size_t count_less_32_avx2(
+    const std::int32_t* data, std::size_t size, std::int32_t entry,
+    std::int32_t bias) {
+    const __m256i key8 = _mm256_set1_epi32(entry);
+    const __m256i bias8 = _mm256_set1_epi32(bias);
+    std::size_t count = 0, i = 0;
+
+    for(; i + 8 <= size; i += 8) {
+        __m256i block = _mm256_xor_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)),
+            bias8);
+        __m256i less = _mm256_cmpgt_epi32(key8, block);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(less));
+        count += __builtin_popcount(mask);
+    }
+    if(i + 4 <= size) {
+        __m128i block = _mm_xor_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)),
+            _mm256_castsi256_si128(bias8));
+        __m128i less = _mm_cmpgt_epi32(_mm256_castsi256_si128(key8), block);
+        count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(less)));
+        i += 4;
+    }
+    for(; i < size; ++i) count += (data[i] ^ bias) < entry;
+
+    return count;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Counts the 64-bit values less than entry, 2 per compare. Built for
+ *  SSE4.2 whatever the compile flags; only call when the CPU has it.
+ *
+ * PRE-CONDITIONS:
+ *  const std::int64_t* data: array
+ *  std::size_t size        : array size
+ *  std::int64_t entry      : entry item to compare, xor'd with bias
+ *  std::int64_t bias       : 0 for signed, INT64_MIN for unsigned values
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count
+ ******************************************************************************/
+__attribute__((target("sse4.2"))) inline std::size_t count_less_64_sse42(
+    const std::int64_t* data, std::size_t size, std::int64_t entry,
+    std::int64_t bias) {
+    const __m128i key2 = _mm_set1_epi64x(entry);
+    const __m128i bias2 = _mm_set1_epi64x(bias);
+    std::size_t count = 0, i = 0;
+
+    for(; i + 2 <= size; i += 2) {
+        __m128i block = _mm_xor_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), bias2);
+        __m128i less = _mm_cmpgt_epi64(key2, block);
+        count += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(less)));
+    }
+    if(i < size) count += (data[i] ^ bias) < entry;
+
+    return count;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Counts the 64-bit values less than entry, 4 per compare, then 2. Built
+ *  for AVX2 whatever the compile flags; only call when the CPU has it.
+ *
+ * PRE-CONDITIONS:
+ *  const std::int64_t* data: array
+ *  std::size_t size        : array size
+ *  std::int64_t entry      : entry item to compare, xor'd with bias
+ *  std::int64_t bias       : 0 for signed, INT64_MIN for unsigned values
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count
+ ******************************************************************************/
+__attribute__((target("avx2"))) inline std::size_t count_less_64_avx2(
+    const std::int64_t* data, std::size_t size, std::int64_t entry,
+    std::int64_t bias) {
+    const __m256i key4 = _mm256_set1_epi64x(entry);
+    const __m256i bias4 = _mm256_set1_epi64x(bias);
+    std::size_t count = 0, i = 0;
+
+    for(; i + 4 <= size; i += 4) {
+        __m256i block = _mm256_xor_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)),
+            bias4);
+        __m256i less = _mm256_cmpgt_epi64(key4, block);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(less));
+        count += __builtin_popcount(mask);
+    }
+    if(i + 2 <= size) {
+        __m128i block = _mm_xor_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)),
+            _mm256_castsi256_si128(bias4));
+        __m128i less = _mm_cmpgt_epi64(_mm256_castsi256_si128(key4), block);
+        count += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(less)));
+        i += 2;
+    }
+    if(i < size) count += (data[i] ^ bias) < entry;
+
+    return count;
+}
+#endif  // ARRAY_UTILS_SIMD
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Counts the 32-bit values less than entry, 8 per compare with AVX2 and 4
+ *  with SSE2, as level allows; the rest one at a time. Values and entry are
+ *  xor'd with bias first; a bias of the sign bit turns unsigned order into
+ *  the signed order the compares use.
+ *
+ * PRE-CONDITIONS:
+ *  const std::int32_t* data: array
+ *  std::size_t size        : array size
+ *  std::int32_t entry      : entry item to compare
+ *  std::int32_t bias       : 0 for signed, INT32_MIN for unsigned values
+ *  int level               : Simd level to use, at most simd_level()
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count
+ ******************************************************************************/
+inline std::size_t count_less_32(const std::int32_t* data, std::size_t size,
+                                 std::int32_t entry, std::int32_t bias,
+                                 int level) {
+    std::size_t count = 0;
+    entry ^= bias;
+
+#if defined(ARRAY_UTILS_SIMD)
+    if(level >= SIMD_AVX2) return count_less_32_avx2(data, size, entry, bias);
+    if(level >= SIMD_SSE2) return count_less_32_sse2(data, size, entry, bias);
+#else
+    (void)level;  // no SIMD in this build
+#endif
+    for(std::size_t i = 0; i < size; ++i) count += (data[i] ^ bias) < entry;
+
+    return count;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Counts the 64-bit values less than entry, 4 per compare with AVX2 and 2
+ *  with SSE4.2, as level allows; the rest one at a time. Values and entry
+ *  are xor'd with bias first; a bias of the sign bit turns unsigned order
+ *  into the signed order the compares use.
+ *
+ * PRE-CONDITIONS:
+ *  const std::int64_t* data: array
+ *  std::size_t size        : array size
+ *  std::int64_t entry      : entry item to compare
+ *  std::int64_t bias       : 0 for signed, INT64_MIN for unsigned values
+ *  int level               : Simd level to use, at most simd_level()
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count
+ ******************************************************************************/
+inline std::size_t count_less_64(const std::int64_t* data, std::size_t size,
+                                 std::int64_t entry, std::int64_t bias,
+                                 int level) {
+    std::size_t count = 0;
+    entry ^= bias;
+
+#if defined(ARRAY_UTILS_SIMD)
+    if(level >= SIMD_AVX2) return count_less_64_avx2(data, size, entry, bias);
+    if(level >= SIMD_SSE42) return count_less_64_sse42(data, size, entry, bias);
+#else
+    (void)level;  // no SIMD in this build
+#endif
+    for(std::size_t i = 0; i < size; ++i) count += (data[i] ^ bias) < entry;
+
+    return count;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Counts the signed 32-bit values less than entry with SIMD compares.
+ *
+ * PRE-CONDITIONS:
+ *  const std::int32_t* data : array
+ *  std::size_t size         : array size
+ *  const std::int32_t& entry: entry item to compare
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count
+ ******************************************************************************/
+inline std::size_t count_less(const std::int32_t* data, std::size_t size,
+                              const std::int32_t& entry) {
+    return count_less_32(data, size, entry, 0);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Counts the unsigned 32-bit values less than entry with SIMD compares.
+ *
+ * PRE-CONDITIONS:
+ *  const std::uint32_t* data : array
+ *  std::size_t size          : array size
+ *  const std::uint32_t& entry: entry item to compare
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count
+ ******************************************************************************/
+inline std::size_t count_less(const std::uint32_t* data, std::size_t size,
+                              const std::uint32_t& entry) {
+    return count_less_32(reinterpret_cast<const std::int32_t*>(data), size,
+                         static_cast<std::int32_t>(entry), INT32_MIN);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Counts the signed 64-bit values less than entry with SIMD compares.
+ *
+ * PRE-CONDITIONS:
+ *  const std::int64_t* data : array
+ *  std::size_t size         : array size
+ *  const std::int64_t& entry: entry item to compare
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count
+ ******************************************************************************/
+inline std::size_t count_less(const std::int64_t* data, std::size_t size,
+                              const std::int64_t& entry) {
+    return count_less_64(data, size, entry, 0);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Counts the unsigned 64-bit values less than entry with SIMD compares.
+ *
+ * PRE-CONDITIONS:
+ *  const std::uint64_t* data : array
+ *  std::size_t size          : array size
+ *  const std::uint64_t& entry: entry item to compare
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count
+ ******************************************************************************/
+inline std::size_t count_less(const std::uint64_t* data, std::size_t size,
+                              const std::uint64_t& entry) {
+    return count_less_64(reinterpret_cast<const std::int64_t*>(data), size,
+                         static_cast<std::int64_t>(entry), INT64_MIN);
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Inserts entry at the end of the array.
@@ -6,11 +6,18 @@
  * DESCRIPTION : This header defines a templated AVL (Adelson-Velsky and
  *      Landis), which is a balanced version of templated BST. Insertions and
  *      erasures of TreeNodes will guarantee a full or complete binary tree.
+ *      Iterators walk the items in order; they are invalidated by insert
+ *      and erase.
+ *
+ *      join(), split() and merge() move nodes between trees instead of
+ *      copying items: join and split are O(log n), and merge (set union) is
+ *      O(m log(n / m + 1)) for trees of m <= n items.
  ******************************************************************************/
 #ifndef AVL_H
 #define AVL_H
 
 #include <cassert>     // assert()
+#include <stdexcept>   // invalid_argument
 #include "bst_node.h"  // BST TreeNode class
 
 namespace avl {
@@ -18,6 +25,8 @@ namespace avl {
 template <typename T>
 class AVL {
 public:
+    typedef bst_node::TreeIterator<T> Iterator;  // inorder iterator
+
     // CONSTRUCTORS
     AVL() : _root(nullptr) {}
     AVL(const T* sorted_list, int size = -1);  // with array of sorted items
@@ -30,16 +39,23 @@ public:
     // ACCESSORS
     bool empty() const;
     T& front() const;
+    Iterator begin() const;  // smallest item
+    Iterator end() const;
     void print_inorder(std::ostream& outs = std::cout) const;
     const bst_node::TreeNode<T>* root() const;
     bool search(const T& target, bst_node::TreeNode<T>*& found_ptr) const;
 
     // MUTATORS
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last);  // bulk build, any order
     void clear();
     bool erase(const T& target);
     bool insert(const T& insert_me);
     void reinsert(const T& insert_me);
     void pop_front();
+    void join(AVL<T>& rhs);                   // append greater items
+    void split(const T& key, AVL<T>& right);  // move items >= key to right
+    void merge(AVL<T>& rhs);                  // set union, moves rhs
 
     // FRIENDS
     friend std::ostream& operator<<(std::ostream& outs, const AVL<T>& tree) {
@@ -47,7 +63,8 @@ public:
         return outs;
     }
     friend AVL<T>& operator+=(AVL<T>& lhs, const AVL<T>& rhs) {
-        bst_node::tree_add(lhs._root, rhs._root, true);
+        AVL<T> copy(rhs);
+        lhs.merge(copy);
         return lhs;
     }
 
@@ -173,6 +190,42 @@ T& AVL<T>::front() const {
     return _root->_item;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an inorder Iterator to the smallest item.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  AVL<T>::Iterator: end() if empty
+ ******************************************************************************/
+template <typename T>
+typename AVL<T>::Iterator AVL<T>::begin() const {
+    return Iterator(_root);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the Iterator past the largest item.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  AVL<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+typename AVL<T>::Iterator AVL<T>::end() const {
+    return Iterator();
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Print AVL's item with inorder traversal.
@@ -230,6 +283,32 @@ bool AVL<T>::search(const T& target, bst_node::TreeNode<T>*& found_ptr) const {
     return bst_node::tree_search(_root, target, found_ptr);
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Replaces all items with the items in [first, last), in any order, and
+ *  builds a full or complete binary tree in one pass, with no per-item
+ *  search or rotations. Duplicates are dropped, keeping the first.
+ *
+ * PRE-CONDITIONS:
+ *  InputIt first: iterator to the first item
+ *  InputIt last : iterator past the last item
+ *
+ * POST-CONDITIONS:
+ *  TreeNode<T>* _root: old nodes deallocated; new nodes allocated
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+template <typename InputIt>
+void AVL<T>::assign(InputIt first, InputIt last) {
+    std::vector<T> items(first, last);
+    bst_node::TreeNode<T>* root = bst_node::tree_from_unsorted_list(items);
+
+    bst_node::tree_clear(_root);
+    _root = root;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Deallocates all nodes linked to _root.
@@ -323,6 +402,91 @@ void AVL<T>::pop_front() {
     tree_pop_root(_root, true);
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Moves all of rhs's items, which must all be greater than this tree's
+ *  items, to the end of this tree. O(log n).
+ *
+ * PRE-CONDITIONS:
+ *  AVL<T>& rhs: AVL with items greater than all items in this tree
+ *
+ * POST-CONDITIONS:
+ *  TreeNode<T>* _root: rhs's nodes joined to the right
+ *  rhs              : empty
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void AVL<T>::join(AVL<T>& rhs) {
+    const bst_node::TreeNode<T>*max = _root, *min = rhs._root;
+
+    if(max && min) {
+        while(max->_right) max = max->_right;
+        while(min->_left) min = min->_left;
+
+        if(!(max->_item < min->_item))
+            throw std::invalid_argument("AVL::join - items are not in order");
+    }
+
+    _root = bst_node::tree_join(_root, rhs._root);
+    rhs._root = nullptr;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Moves all items >= key to right, replacing right's items. This tree
+ *  keeps the items < key. O(log n).
+ *
+ * PRE-CONDITIONS:
+ *  const T& key: split item
+ *  AVL<T>& right: AVL to receive the items >= key; not this tree
+ *
+ * POST-CONDITIONS:
+ *  TreeNode<T>* _root: items < key
+ *  right             : items >= key
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void AVL<T>::split(const T& key, AVL<T>& right) {
+    if(&right == this)
+        throw std::invalid_argument("AVL::split - right is this tree");
+
+    bst_node::TreeNode<T>*lower = nullptr, *found = nullptr, *upper = nullptr;
+
+    right.clear();
+    bst_node::tree_split(_root, key, lower, found, upper);
+
+    _root = lower;
+    right._root = found ? bst_node::tree_join<T>(nullptr, found, upper) : upper;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Moves all of rhs's items into this tree (set union). On duplicate items,
+ *  this tree's item is kept and rhs's is deallocated.
+ *  O(m log(n / m + 1)) for trees of m <= n items.
+ *
+ * PRE-CONDITIONS:
+ *  AVL<T>& rhs: AVL with items in any order
+ *
+ * POST-CONDITIONS:
+ *  TreeNode<T>* _root: union of both trees
+ *  rhs              : empty
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void AVL<T>::merge(AVL<T>& rhs) {
+    if(&rhs == this) return;  // union with itself is itself
+
+    _root = bst_node::tree_union(_root, rhs._root);
+    rhs._root = nullptr;
+}
+
 }  // namespace avl
 
 #endif  // AVL_H
@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * AUTHOR      : Thuan Tang
+ * ID          : 00991588
+ * CLASS       : CS008
+ * HEADER      : binary_io
+ * DESCRIPTION : This header provides write_binary() and read_binary(), the
+ *      binary encodings used to save and load trees. Trivially copyable
+ *      items are written as raw bytes in native byte order; strings and
+ *      vectors are written as a 64-bit count followed by their items.
+ *
+ *      Other types join in with their own write_binary()/read_binary()
+ *      overloads, found by argument dependent lookup (see Pair and MPair).
+ *      Call them unqualified after "using binary_io::write_binary;".
+ *
+ *      A failed or short read sets the stream's failbit; the caller checks
+ *      the stream after reading.
+ ******************************************************************************/
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <cstdint>      // uint64_t
+#include <istream>      // istream
+#include <ostream>      // ostream
+#include <string>       // string
+#include <type_traits>  // enable_if, is_trivially_copyable
+#include <vector>       // vector
+
+namespace binary_io {
+
+template <typename T>
+typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+write_binary(std::ostream& outs, const T& item);
+
+template <typename T>
+typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+read_binary(std::istream& ins, T& item);
+
+inline void write_binary(std::ostream& outs, const std::string& item);
+inline void read_binary(std::istream& ins, std::string& item);
+
+template <typename T>
+void write_binary(std::ostream& outs, const std::vector<T>& items);
+
+template <typename T>
+void read_binary(std::istream& ins, std::vector<T>& items);
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Writes a trivially copyable item as its raw bytes.
+ *
+ * PRE-CONDITIONS:
+ *  std::ostream& outs: binary output stream
+ *  const T& item     : item to write
+ *
+ * POST-CONDITIONS:
+ *  sizeof(T) bytes written
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+write_binary(std::ostream& outs, const T& item) {
+    outs.write(reinterpret_cast<const char*>(&item), sizeof(T));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Reads a trivially copyable item from its raw bytes.
+ *
+ * PRE-CONDITIONS:
+ *  std::istream& ins: binary input stream
+ *  T& item          : item to read into
+ *
+ * POST-CONDITIONS:
+ *  sizeof(T) bytes read
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+read_binary(std::istream& ins, T& item) {
+    ins.read(reinterpret_cast<char*>(&item), sizeof(T));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Writes a string as its length and characters.
+ *
+ * PRE-CONDITIONS:
+ *  std::ostream& outs       : binary output stream
+ *  const std::string& item  : string to write
+ *
+ * POST-CONDITIONS:
+ *  string written
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+inline void write_binary(std::ostream& outs, const std::string& item) {
+    write_binary(outs, static_cast<std::uint64_t>(item.size()));
+    outs.write(item.data(), item.size());
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Reads a string written by write_binary().
+ *
+ * PRE-CONDITIONS:
+ *  std::istream& ins : binary input stream
+ *  std::string& item : string to read into
+ *
+ * POST-CONDITIONS:
+ *  string read; failbit set on a short read
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+inline void read_binary(std::istream& ins, std::string& item) {
+    const std::uint64_t CHUNK = 4096;  // a bad length fails, not over-allocs
+    std::uint64_t length = 0;
+
+    read_binary(ins, length);
+    item.clear();
+
+    while(ins && length) {
+        std::size_t old_size = item.size(),
+                    count = length < CHUNK ? length : CHUNK;
+
+        item.resize(old_size + count);
+        ins.read(&item[old_size], count);
+        length -= count;
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Writes a vector as its item count and items.
+ *
+ * PRE-CONDITIONS:
+ *  std::ostream& outs           : binary output stream
+ *  const std::vector<T>& items  : vector to write
+ *
+ * POST-CONDITIONS:
+ *  vector written
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void write_binary(std::ostream& outs, const std::vector<T>& items) {
+    write_binary(outs, static_cast<std::uint64_t>(items.size()));
+    for(const T& item : items) write_binary(outs, item);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Reads a vector written by write_binary().
+ *
+ * PRE-CONDITIONS:
+ *  std::istream& ins      : binary input stream
+ *  std::vector<T>& items  : vector to read into
+ *
+ * POST-CONDITIONS:
+ *  vector read; failbit set on a short read
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void read_binary(std::istream& ins, std::vector<T>& items) {
+    std::uint64_t count = 0;
+
+    read_binary(ins, count);
+    items.clear();
+
+    for(; ins && count; --count) {
+        items.emplace_back();
+        read_binary(ins, items.back());
+    }
+}
+
+}  // namespace binary_io
+
+#endif  // BINARY_IO_H
@@ -17,22 +17,37 @@
  *          MMap::Iterator returns MPair with operator-> access to key/value
  *          or key/values. Increment of iterators for MMap::Iterator cycles
  *          value per key and then increment to next key.
+ *
+ *          Copies of Map/MMap share the tree's nodes, so a copy or
+ *          snapshot() is O(1), and a write copies only its root-to-leaf path.
+ *          Non-const iterators copy the path to their entry when it is
+ *          dereferenced. References stay valid for writing until the next
+ *          copy is taken.
  ******************************************************************************/
 #ifndef BPT_MAP_H
 #define BPT_MAP_H
 
-#include <vector>    // vector objects
-#include "bptree.h"  // BPTree class
-#include "pair.h"    // Pair struct
+#include <type_traits>  // conditional, is_arithmetic, remove_const
+#include <utility>      // forward(), move()
+#include <vector>       // vector objects
+#include "bptree.h"     // BPTree class
+#include "pair.h"       // Pair struct
 
 namespace bpt_map {
 
+// key probe for lookups with KT; an arithmetic KT is converted to K so that
+// integer keys are never compared with mixed signedness
+template <typename K, typename KT>
+using KeyProbe = pair::Key<typename std::conditional<
+    std::is_arithmetic<KT>::value, typename std::remove_const<K>::type,
+    KT>::type>;
+
 template <typename K, typename V>
 class Map {
 public:
     typedef pair::Pair<const K, V> Pair;
     typedef bptree::BPTree<Pair> MapBase;
-    typedef typename bptree::BPTree<Pair>::Iterator MapBaseIter;
+    typedef typename bptree::CowBPTree<Pair>::Iterator MapBaseIter;
 
     class Iterator {
     public:
@@ -79,6 +94,8 @@ public:
     // CONSTRUCTOR
     Map(std::size_t min = bptree::MINIMUM) : _map(true, min) {}
 
+    Map<K, V> snapshot() const;  // O(1) copy; shares tree until a write
+
     // capacity
     std::size_t size() const;
     bool empty() const;
@@ -88,35 +105,61 @@ public:
     Iterator begin();
     Iterator end() const;
     Iterator end();
-    Iterator find(const K& key);
-    Iterator lower_bound(const K& key);
-    Iterator upper_bound(const K& key);
+    // lookups take K or any KT comparable with K (ie: const char*)
+    template <typename KT>
+    Iterator find(const KT& key);
+    template <typename KT>
+    Iterator lower_bound(const KT& key);
+    template <typename KT>
+    Iterator upper_bound(const KT& key);
     Pair& front();
     Pair& back();
-    const V& operator[](const K& key) const;
-    V& operator[](const K& key);
-    const V& at(const K& key) const;
-    V& at(const K& key);
+    template <typename KT>
+    const V& operator[](const KT& key) const;
+    template <typename KT>
+    V& operator[](const KT& key);
+    template <typename KT>
+    const V& at(const KT& key) const;
+    template <typename KT>
+    V& at(const KT& key);
 
     // modifiers
     bool insert(const K& k, const V& v);
+    bool insert(const K& k, V&& v);
+    template <typename... Args>
+    bool emplace(const K& k, Args&&... args);  // insert V(args) at k
+    template <typename... Args>
+    bool try_emplace(const K& k, Args&&... args);  // only if k is new
     bool erase(const K& key);
+    template <typename KT>  // erase keys in [low, high)
+    std::size_t erase_range(const KT& low, const KT& high);
+    template <typename Pred>  // erase Pairs where pred(pair)
+    std::size_t erase_if(Pred pred);
     void clear();
     V& get(const K& key);
 
+    // order statistics
+    template <typename KT>
+    std::size_t rank(const KT& key) const;  // count of keys < key
+    Iterator select(std::size_t k);         // k-th Pair from 0; else end()
+    template <typename KT>  // count of keys in [low, high)
+    std::size_t count_range(const KT& low, const KT& high) const;
+
     // operations
-    bool contains(const K& key) const;
+    template <typename KT>
+    bool contains(const KT& key) const;
     bool contains(const Pair& target) const;
-    std::size_t count(const K& key) const;
+    template <typename KT>
+    std::size_t count(const KT& key) const;
     void print_debug() const;
     bool verify() const;
 
     friend std::ostream& operator<<(std::ostream& outs, const Map<K, V>& map) {
-        return outs << map._map;
+        return outs << *map._map;
     }
 
 private:
-    MapBase _map;
+    bptree::CowBPTree<Pair> _map;  // shared with copies until written
 };
 
 template <typename K, typename V>
@@ -124,7 +167,7 @@ class MMap {
 public:
     typedef pair::MPair<const K, V> MPair;
     typedef bptree::BPTree<MPair> MMapBase;
-    typedef typename bptree::BPTree<MPair>::Iterator MMapBaseIter;
+    typedef typename bptree::CowBPTree<MPair>::Iterator MMapBaseIter;
 
     class Iterator {
     public:
@@ -180,6 +223,8 @@ public:
 
     MMap(std::size_t min = bptree::MINIMUM) : _mmap(true, min) {}
 
+    MMap<K, V> snapshot() const;  // O(1) copy; shares tree until a write
+
     // capacity
     std::size_t size() const;
     bool empty() const;
@@ -189,36 +234,83 @@ public:
     Iterator begin();
     Iterator end() const;
     Iterator end();
-    Iterator find(const K& key);
-    Iterator lower_bound(const K& key);
-    Iterator upper_bound(const K& key);
-    const std::vector<V>& operator[](const K& key) const;
-    std::vector<V>& operator[](const K& key);
-    const std::vector<V>& at(const K& key) const;
-    std::vector<V>& at(const K& key);
+    // lookups take K or any KT comparable with K (ie: const char*)
+    template <typename KT>
+    Iterator find(const KT& key);
+    template <typename KT>
+    Iterator lower_bound(const KT& key);
+    template <typename KT>
+    Iterator upper_bound(const KT& key);
+    template <typename KT>
+    const std::vector<V>& operator[](const KT& key) const;
+    template <typename KT>
+    std::vector<V>& operator[](const KT& key);
+    template <typename KT>
+    const std::vector<V>& at(const KT& key) const;
+    template <typename KT>
+    std::vector<V>& at(const KT& key);
 
     // modifiers
     bool insert(const K& k, const V& v);
+    bool insert(const K& k, V&& v);
+    template <typename... Args>
+    bool emplace(const K& k, Args&&... args);  // append V(args) at k
+    template <typename... Args>
+    bool try_emplace(const K& k, Args&&... args);  // only if k is new
     bool erase(const K& key);
+    template <typename KT>  // erase keys in [low, high)
+    std::size_t erase_range(const KT& low, const KT& high);
+    template <typename Pred>  // erase MPairs where pred(mpair)
+    std::size_t erase_if(Pred pred);
     void clear();
     std::vector<V>& get(const K& key);
 
+    // order statistics
+    template <typename KT>
+    std::size_t rank(const KT& key) const;  // count of keys < key
+    Iterator select(std::size_t k);         // k-th MPair from 0; else end()
+    template <typename KT>  // count of keys in [low, high)
+    std::size_t count_range(const KT& low, const KT& high) const;
+
     // operations
-    bool contains(const K& key) const;
-    std::size_t count(const K& key) const;
+    template <typename KT>
+    bool contains(const KT& key) const;
+    template <typename KT>
+    std::size_t count(const KT& key) const;
     void print_debug() const;
     bool verify() const;
 
     friend std::ostream& operator<<(std::ostream& outs, const MMap<K, V>& map) {
-        return outs << map._mmap;
+        return outs << *map._mmap;
     }
 
 private:
-    MMapBase _mmap;
+    bptree::CowBPTree<MPair> _mmap;  // shared with copies until written
 };
 
 // ----- MAP IMPLEMENTATIONS -----
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns a snapshot of 'this' in O(1). The snapshot shares the tree's
+ *  nodes, and a write on either side copies only the nodes on its path.
+ *  References taken from 'this' before the snapshot may still point into
+ *  shared nodes, so take them again before writing through them.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Map<K, V>
+ ******************************************************************************/
+template <typename K, typename V>
+Map<K, V> Map<K, V>::snapshot() const {
+    return *this;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Returns the total keys in map.
@@ -234,7 +326,7 @@ private:
  ******************************************************************************/
 template <typename K, typename V>
 std::size_t Map<K, V>::size() const {
-    return _map.size();
+    return _map->size();
 }
 
 /*******************************************************************************
@@ -252,7 +344,7 @@ std::size_t Map<K, V>::size() const {
  ******************************************************************************/
 template <typename K, typename V>
 bool Map<K, V>::empty() const {
-    return _map.empty();
+    return _map->empty();
 }
 
 /*******************************************************************************
@@ -270,7 +362,7 @@ bool Map<K, V>::empty() const {
  ******************************************************************************/
 template <typename K, typename V>
 typename Map<K, V>::Iterator Map<K, V>::begin() const {
-    return Map<K, V>::Iterator(_map.begin());
+    return Map<K, V>::Iterator(_map->begin());
 }
 
 /*******************************************************************************
@@ -306,7 +398,7 @@ typename Map<K, V>::Iterator Map<K, V>::begin() {
  ******************************************************************************/
 template <typename K, typename V>
 typename Map<K, V>::Iterator Map<K, V>::end() const {
-    return Map<K, V>::Iterator(_map.end());
+    return Map<K, V>::Iterator(_map->end());
 }
 
 /*******************************************************************************
@@ -324,7 +416,7 @@ typename Map<K, V>::Iterator Map<K, V>::end() const {
  ******************************************************************************/
 template <typename K, typename V>
 typename Map<K, V>::Iterator Map<K, V>::end() {
-    return Map<K, V>::Iterator(_map.end());
+    return Map<K, V>::Iterator(_map->end());
 }
 
 /*******************************************************************************
@@ -332,7 +424,7 @@ typename Map<K, V>::Iterator Map<K, V>::end() {
  *  Return iterator that points to Pair that matches key.
  *
  * PRE-CONDITIONS:
- *  none
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -341,8 +433,9 @@ typename Map<K, V>::Iterator Map<K, V>::end() {
  *  Map<K, V>::Iterator: points Pair that matches key
  ******************************************************************************/
 template <typename K, typename V>
-typename Map<K, V>::Iterator Map<K, V>::find(const K& key) {
-    return Map<K, V>::Iterator(_map.find(Pair(key)));
+template <typename KT>
+typename Map<K, V>::Iterator Map<K, V>::find(const KT& key) {
+    return Map<K, V>::Iterator(_map.find(KeyProbe<K, KT>(key)));
 }
 
 /*******************************************************************************
@@ -351,7 +444,7 @@ typename Map<K, V>::Iterator Map<K, V>::find(const K& key) {
  *  other words, key is less than or equal to the iterator.
  *
  * PRE-CONDITIONS:
- *  none
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -360,8 +453,9 @@ typename Map<K, V>::Iterator Map<K, V>::find(const K& key) {
  *  Map<K, V>::Iterator: points Pair is greater than or equal to key
  ******************************************************************************/
 template <typename K, typename V>
-typename Map<K, V>::Iterator Map<K, V>::lower_bound(const K& key) {
-    return Map<K, V>::Iterator(_map.lower_bound(Pair(key)));
+template <typename KT>
+typename Map<K, V>::Iterator Map<K, V>::lower_bound(const KT& key) {
+    return Map<K, V>::Iterator(_map.lower_bound(KeyProbe<K, KT>(key)));
 }
 
 /*******************************************************************************
@@ -370,7 +464,7 @@ typename Map<K, V>::Iterator Map<K, V>::lower_bound(const K& key) {
  *  the iterator is one step beyond the key.
  *
  * PRE-CONDITIONS:
- *  none
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -379,8 +473,9 @@ typename Map<K, V>::Iterator Map<K, V>::lower_bound(const K& key) {
  *  Map<K, V>::Iterator: points Pair one after the key.
  ******************************************************************************/
 template <typename K, typename V>
-typename Map<K, V>::Iterator Map<K, V>::upper_bound(const K& key) {
-    return Map<K, V>::Iterator(_map.upper_bound(Pair(key)));
+template <typename KT>
+typename Map<K, V>::Iterator Map<K, V>::upper_bound(const KT& key) {
+    return Map<K, V>::Iterator(_map.upper_bound(KeyProbe<K, KT>(key)));
 }
 
 /*******************************************************************************
@@ -398,7 +493,7 @@ typename Map<K, V>::Iterator Map<K, V>::upper_bound(const K& key) {
  ******************************************************************************/
 template <typename K, typename V>
 typename Map<K, V>::Pair& Map<K, V>::front() {
-    return _map.front();
+    return _map.write().front();
 }
 
 /*******************************************************************************
@@ -416,7 +511,7 @@ typename Map<K, V>::Pair& Map<K, V>::front() {
  ******************************************************************************/
 template <typename K, typename V>
 typename Map<K, V>::Pair& Map<K, V>::back() {
-    return _map.back();
+    return _map.write().back();
 }
 
 /*******************************************************************************
@@ -424,7 +519,7 @@ typename Map<K, V>::Pair& Map<K, V>::back() {
  *  Returns the reference value at given key via subscript operator.
  *
  * PRE-CONDITIONS:
- *  const K& key: key to find Pair
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -433,8 +528,9 @@ typename Map<K, V>::Pair& Map<K, V>::back() {
  *  const V&
  ******************************************************************************/
 template <typename K, typename V>
-const V& Map<K, V>::operator[](const K& key) const {
-    return _map.get(Pair(key)).value;
+template <typename KT>
+const V& Map<K, V>::operator[](const KT& key) const {
+    return _map->get(KeyProbe<K, KT>(key)).value;
 }
 
 /*******************************************************************************
@@ -442,7 +538,7 @@ const V& Map<K, V>::operator[](const K& key) const {
  *  Returns the reference value at given key via subscript operator.
  *
  * PRE-CONDITIONS:
- *  const K& key: key to find Pair
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -451,8 +547,11 @@ const V& Map<K, V>::operator[](const K& key) const {
  *  V&
  ******************************************************************************/
 template <typename K, typename V>
-V& Map<K, V>::operator[](const K& key) {
-    return _map.get(Pair(key)).value;
+template <typename KT>
+V& Map<K, V>::operator[](const KT& key) {
+    MapBaseIter it = _map.find(KeyProbe<K, KT>(key));  // no Pair if key exists
+
+    return it ? (*it).value : _map.write().get(Pair(K(key))).value;
 }
 
 /*******************************************************************************
@@ -460,7 +559,7 @@ V& Map<K, V>::operator[](const K& key) {
  *  Returns the reference value at given key.
  *
  * PRE-CONDITIONS:
- *  const K& key: key to find Pair
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -469,8 +568,9 @@ V& Map<K, V>::operator[](const K& key) {
  *  const V&
  ******************************************************************************/
 template <typename K, typename V>
-const V& Map<K, V>::at(const K& key) const {
-    return _map.get(Pair(key)).value;
+template <typename KT>
+const V& Map<K, V>::at(const KT& key) const {
+    return _map->get(KeyProbe<K, KT>(key)).value;
 }
 
 /*******************************************************************************
@@ -478,7 +578,7 @@ const V& Map<K, V>::at(const K& key) const {
  *  Returns the reference value at given key.
  *
  * PRE-CONDITIONS:
- *  const K& key: key to find Pair
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -487,8 +587,11 @@ const V& Map<K, V>::at(const K& key) const {
  *  V&
  ******************************************************************************/
 template <typename K, typename V>
-V& Map<K, V>::at(const K& key) {
-    return _map.get(Pair(key)).value;
+template <typename KT>
+V& Map<K, V>::at(const KT& key) {
+    MapBaseIter it = _map.find(KeyProbe<K, KT>(key));  // no Pair if key exists
+
+    return it ? (*it).value : _map.write().get(Pair(K(key))).value;
 }
 
 /*******************************************************************************
@@ -507,7 +610,71 @@ V& Map<K, V>::at(const K& key) {
  ******************************************************************************/
 template <typename K, typename V>
 bool Map<K, V>::insert(const K& k, const V& v) {
-    return _map.insert(Pair(k, v));
+    return _map.write().insert(Pair(k, v));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts Pair into map by moving the value.
+ *
+ * PRE-CONDITIONS:
+ *  const K& k: key for Pair
+ *  V&& v     : value for pair
+ *
+ * POST-CONDITIONS:
+ *  v moved from
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename K, typename V>
+bool Map<K, V>::insert(const K& k, V&& v) {
+    return _map.write().insert(Pair(k, std::move(v)));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts Pair into map with value constructed from args in the tree's
+ *  storage for it. Like insert, the value of an existing key is replaced.
+ *
+ * PRE-CONDITIONS:
+ *  const K& k    : key for Pair
+ *  Args&&... args: arguments for V's constructor
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename K, typename V>
+template <typename... Args>
+bool Map<K, V>::emplace(const K& k, Args&&... args) {
+    return _map.write().emplace(std::piecewise_construct, k,
+                                std::forward<Args>(args)...);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts Pair into map with value constructed from args, only when key is
+ *  not in map. Otherwise, value is not constructed. One search finds the key
+ *  or its insert position.
+ *
+ * PRE-CONDITIONS:
+ *  const K& k    : key for Pair
+ *  Args&&... args: arguments for V's constructor
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool: false if key already exists
+ ******************************************************************************/
+template <typename K, typename V>
+template <typename... Args>
+bool Map<K, V>::try_emplace(const K& k, Args&&... args) {
+    return _map.write().try_emplace(KeyProbe<K, K>(k), std::piecewise_construct,
+                                    k, std::forward<Args>(args)...);
 }
 
 /*******************************************************************************
@@ -526,7 +693,47 @@ bool Map<K, V>::insert(const K& k, const V& v) {
  ******************************************************************************/
 template <typename K, typename V>
 bool Map<K, V>::erase(const K& key) {
-    return _map.remove(Pair(key));
+    return _map.write().remove(Pair(key));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Erase all Pairs with keys in the range [low, high).
+ *
+ * PRE-CONDITIONS:
+ *  const KT& low : inclusive lower key, or value comparable with K
+ *  const KT& high: exclusive upper key, or value comparable with K
+ *
+ * POST-CONDITIONS:
+ *  Pairs in range removed
+ *
+ * RETURN:
+ *  std::size_t: count of erased Pairs
+ ******************************************************************************/
+template <typename K, typename V>
+template <typename KT>
+std::size_t Map<K, V>::erase_range(const KT& low, const KT& high) {
+    return _map.write().erase_range(KeyProbe<K, KT>(low),
+                                    KeyProbe<K, KT>(high));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Erase all Pairs where pred(pair) is true.
+ *
+ * PRE-CONDITIONS:
+ *  Pred pred: callable as bool pred(const Pair&)
+ *
+ * POST-CONDITIONS:
+ *  Pairs satisfying pred removed
+ *
+ * RETURN:
+ *  std::size_t: count of erased Pairs
+ ******************************************************************************/
+template <typename K, typename V>
+template <typename Pred>
+std::size_t Map<K, V>::erase_if(Pred pred) {
+    return _map.write().erase_if(pred);
 }
 
 /*******************************************************************************
@@ -562,7 +769,9 @@ void Map<K, V>::clear() {
  ******************************************************************************/
 template <typename K, typename V>
 V& Map<K, V>::get(const K& key) {
-    return _map.get(Pair(key)).value;
+    MapBaseIter it = _map.find(pair::Key<K>(key));  // no Pair if key exists
+
+    return it ? (*it).value : _map.write().get(Pair(key)).value;
 }
 
 /*******************************************************************************
@@ -570,7 +779,7 @@ V& Map<K, V>::get(const K& key) {
  *  Checks if key is contained in Map.
  *
  * PRE-CONDITIONS:
- *  const K& key: key to find Pair
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -579,8 +788,9 @@ V& Map<K, V>::get(const K& key) {
  *  bool
  ******************************************************************************/
 template <typename K, typename V>
-bool Map<K, V>::contains(const K& key) const {
-    return _map.contains(Pair(key));
+template <typename KT>
+bool Map<K, V>::contains(const KT& key) const {
+    return _map->contains(KeyProbe<K, KT>(key));
 }
 
 /*******************************************************************************
@@ -598,7 +808,7 @@ bool Map<K, V>::contains(const K& key) const {
  ******************************************************************************/
 template <typename K, typename V>
 bool Map<K, V>::contains(const Pair& target) const {
-    return _map.contains(target);
+    return _map->contains(target);
 }
 
 /*******************************************************************************
@@ -606,7 +816,7 @@ bool Map<K, V>::contains(const Pair& target) const {
  *  Returns the number of elements for given key.
  *
  * PRE-CONDITIONS:
- *  const K& key: key to find Pair
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -615,8 +825,66 @@ bool Map<K, V>::contains(const Pair& target) const {
  *  std::size_t
  ******************************************************************************/
 template <typename K, typename V>
-std::size_t Map<K, V>::count(const K& key) const {
-    return _map.find(MPair(key)) ? 1 : 0;
+template <typename KT>
+std::size_t Map<K, V>::count(const KT& key) const {
+    return _map->contains(KeyProbe<K, KT>(key)) ? 1 : 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the count of keys less than key.
+ *
+ * PRE-CONDITIONS:
+ *  const KT& key: key, or value comparable with K
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename K, typename V>
+template <typename KT>
+std::size_t Map<K, V>::rank(const KT& key) const {
+    return _map->rank(KeyProbe<K, KT>(key));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the k-th smallest Pair, counting from 0.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t k: index of Pair in key order
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Map<K, V>::Iterator: end() when k is out of range
+ ******************************************************************************/
+template <typename K, typename V>
+typename Map<K, V>::Iterator Map<K, V>::select(std::size_t k) {
+    return Map<K, V>::Iterator(_map.select(k));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the count of keys in the range [low, high).
+ *
+ * PRE-CONDITIONS:
+ *  const KT& low : inclusive lower key, or value comparable with K
+ *  const KT& high: exclusive upper key, or value comparable with K
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename K, typename V>
+template <typename KT>
+std::size_t Map<K, V>::count_range(const KT& low, const KT& high) const {
+    return _map->count_range(KeyProbe<K, KT>(low), KeyProbe<K, KT>(high));
 }
 
 /*******************************************************************************
@@ -634,7 +902,7 @@ std::size_t Map<K, V>::count(const K& key) const {
  ******************************************************************************/
 template <typename K, typename V>
 void Map<K, V>::print_debug() const {
-    _map.print(std::cout, true);
+    _map->print(std::cout, true);
 }
 
 /*******************************************************************************
@@ -652,11 +920,32 @@ void Map<K, V>::print_debug() const {
  ******************************************************************************/
 template <typename K, typename V>
 bool Map<K, V>::verify() const {
-    return _map.verify();
+    return _map->verify();
 }
 
 // ----- MMAP IMPLEMENTATIONS -----
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns a snapshot of 'this' in O(1). The snapshot shares the tree's
+ *  nodes, and a write on either side copies only the nodes on its path.
+ *  References taken from 'this' before the snapshot may still point into
+ *  shared nodes, so take them again before writing through them.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  MMap<K, V>
+ ******************************************************************************/
+template <typename K, typename V>
+MMap<K, V> MMap<K, V>::snapshot() const {
+    return *this;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Returns the total keys in map.
@@ -672,7 +961,7 @@ bool Map<K, V>::verify() const {
  ******************************************************************************/
 template <typename K, typename V>
 std::size_t MMap<K, V>::size() const {
-    return _mmap.size();
+    return _mmap->size();
 }
 
 /*******************************************************************************
@@ -690,7 +979,7 @@ std::size_t MMap<K, V>::size() const {
  ******************************************************************************/
 template <typename K, typename V>
 bool MMap<K, V>::empty() const {
-    return _mmap.empty();
+    return _mmap->empty();
 }
 
 /*******************************************************************************
@@ -708,7 +997,7 @@ bool MMap<K, V>::empty() const {
  ******************************************************************************/
 template <typename K, typename V>
 typename MMap<K, V>::Iterator MMap<K, V>::begin() const {
-    return MMap<K, V>::Iterator(_mmap.begin());
+    return MMap<K, V>::Iterator(_mmap->begin());
 }
 
 /*******************************************************************************
@@ -744,7 +1033,7 @@ typename MMap<K, V>::Iterator MMap<K, V>::begin() {
  ******************************************************************************/
 template <typename K, typename V>
 typename MMap<K, V>::Iterator MMap<K, V>::end() const {
-    return MMap<K, V>::Iterator(_mmap.end());
+    return MMap<K, V>::Iterator(_mmap->end());
 }
 
 /*******************************************************************************
@@ -762,7 +1051,7 @@ typename MMap<K, V>::Iterator MMap<K, V>::end() const {
  ******************************************************************************/
 template <typename K, typename V>
 typename MMap<K, V>::Iterator MMap<K, V>::end() {
-    return MMap<K, V>::Iterator(_mmap.end());
+    return MMap<K, V>::Iterator(_mmap->end());
 }
 
 /*******************************************************************************
@@ -770,7 +1059,7 @@ typename MMap<K, V>::Iterator MMap<K, V>::end() {
  *  Return iterator that points to MPair that matches key.
  *
  * PRE-CONDITIONS:
- *  none
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -779,8 +1068,9 @@ typename MMap<K, V>::Iterator MMap<K, V>::end() {
  *  MMap<K, V>::Iterator: points MPair that matches key
  ******************************************************************************/
 template <typename K, typename V>
-typename MMap<K, V>::Iterator MMap<K, V>::find(const K& key) {
-    return MMap<K, V>::Iterator(_mmap.find(MPair(key)));
+template <typename KT>
+typename MMap<K, V>::Iterator MMap<K, V>::find(const KT& key) {
+    return MMap<K, V>::Iterator(_mmap.find(KeyProbe<K, KT>(key)));
 }
 
 /*******************************************************************************
@@ -789,7 +1079,7 @@ typename MMap<K, V>::Iterator MMap<K, V>::find(const K& key) {
  *  other words, key is less than or equal to the iterator.
  *
  * PRE-CONDITIONS:
- *  none
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -798,8 +1088,10 @@ typename MMap<K, V>::Iterator MMap<K, V>::find(const K& key) {
  *  Map<K, V>::Iterator: points Pair is greater than or equal to key
  ******************************************************************************/
 template <typename K, typename V>
-typename MMap<K, V>::Iterator MMap<K, V>::lower_bound(const K& key) {
-    return MMap<K, V>::Iterator(_mmap.lower_bound(MPair(key)));
+template <typename KT>
+typename MMap<K, V>::Iterator MMap<K, V>::lower_bound(const KT& key) {
+    return MMap<K, V>::Iterator(
+        _mmap.lower_bound(KeyProbe<K, KT>(key)));
 }
 
 /*******************************************************************************
@@ -808,7 +1100,7 @@ typename MMap<K, V>::Iterator MMap<K, V>::lower_bound(const K& key) {
  *  the iterator is one step beyond the key.
  *
  * PRE-CONDITIONS:
- *  none
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -817,8 +1109,10 @@ typename MMap<K, V>::Iterator MMap<K, V>::lower_bound(const K& key) {
  *  Map<K, V>::Iterator: points Pair one after the key.
  ******************************************************************************/
 template <typename K, typename V>
-typename MMap<K, V>::Iterator MMap<K, V>::upper_bound(const K& key) {
-    return MMap<K, V>::Iterator(_mmap.upper_bound(MPair(key)));
+template <typename KT>
+typename MMap<K, V>::Iterator MMap<K, V>::upper_bound(const KT& key) {
+    return MMap<K, V>::Iterator(
+        _mmap.upper_bound(KeyProbe<K, KT>(key)));
 }
 
 /*******************************************************************************
@@ -826,7 +1120,7 @@ typename MMap<K, V>::Iterator MMap<K, V>::upper_bound(const K& key) {
  *  Returns the reference value list at given key via subscript operator.
  *
  * PRE-CONDITIONS:
- *  const K& key: key to find MPair
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -835,8 +1129,9 @@ typename MMap<K, V>::Iterator MMap<K, V>::upper_bound(const K& key) {
  *  const std::vector<V>&
  ******************************************************************************/
 template <typename K, typename V>
-const std::vector<V>& MMap<K, V>::operator[](const K& key) const {
-    return _mmap.get(MPair(key)).values;
+template <typename KT>
+const std::vector<V>& MMap<K, V>::operator[](const KT& key) const {
+    return _mmap->get(KeyProbe<K, KT>(key)).values;
 }
 
 /*******************************************************************************
@@ -844,7 +1139,7 @@ const std::vector<V>& MMap<K, V>::operator[](const K& key) const {
  *  Returns the reference value list at given key via subscript operator.
  *
  * PRE-CONDITIONS:
- *  const K& key: key to find MPair
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -853,8 +1148,11 @@ const std::vector<V>& MMap<K, V>::operator[](const K& key) const {
  *  std::vector<V>&
  ******************************************************************************/
 template <typename K, typename V>
-std::vector<V>& MMap<K, V>::operator[](const K& key) {
-    return _mmap.get(MPair(key)).values;
+template <typename KT>
+std::vector<V>& MMap<K, V>::operator[](const KT& key) {
+    MMapBaseIter it = _mmap.find(KeyProbe<K, KT>(key));  // no MPair if found
+
+    return it ? (*it).values : _mmap.write().get(MPair(K(key))).values;
 }
 
 /*******************************************************************************
@@ -862,7 +1160,7 @@ std::vector<V>& MMap<K, V>::operator[](const K& key) {
  *  Returns the reference value list at given key.
  *
  * PRE-CONDITIONS:
- *  const K& key: key to find MPair
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -871,8 +1169,9 @@ std::vector<V>& MMap<K, V>::operator[](const K& key) {
  *  const std::vector<V>&
  ******************************************************************************/
 template <typename K, typename V>
-const std::vector<V>& MMap<K, V>::at(const K& key) const {
-    return _mmap.get(MPair(key)).values;
+template <typename KT>
+const std::vector<V>& MMap<K, V>::at(const KT& key) const {
+    return _mmap->get(KeyProbe<K, KT>(key)).values;
 }
 
 /*******************************************************************************
@@ -880,7 +1179,7 @@ const std::vector<V>& MMap<K, V>::at(const K& key) const {
  *  Returns the reference value list at given key.
  *
  * PRE-CONDITIONS:
- *  const K& key: key to find MPair
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -889,8 +1188,11 @@ const std::vector<V>& MMap<K, V>::at(const K& key) const {
  *  std::vector<V>&
  ******************************************************************************/
 template <typename K, typename V>
-std::vector<V>& MMap<K, V>::at(const K& key) {
-    return _mmap.get(MPair(key)).values;
+template <typename KT>
+std::vector<V>& MMap<K, V>::at(const KT& key) {
+    MMapBaseIter it = _mmap.find(KeyProbe<K, KT>(key));  // no MPair if found
+
+    return it ? (*it).values : _mmap.write().get(MPair(K(key))).values;
 }
 
 /*******************************************************************************
@@ -909,7 +1211,73 @@ std::vector<V>& MMap<K, V>::at(const K& key) {
  ******************************************************************************/
 template <typename K, typename V>
 bool MMap<K, V>::insert(const K& k, const V& v) {
-    return _mmap.insert(MPair(k, v));
+    return _mmap.write().insert(MPair(k, v));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts MPair into map by moving the value.
+ *
+ * PRE-CONDITIONS:
+ *  const K& k: key for MPair
+ *  V&& v     : value for MPair
+ *
+ * POST-CONDITIONS:
+ *  v moved from
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename K, typename V>
+bool MMap<K, V>::insert(const K& k, V&& v) {
+    return _mmap.write().insert(MPair(k, std::move(v)));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts MPair into map with value constructed from args in the tree's
+ *  storage for it. Like insert, the value is appended to an existing key's
+ *  values.
+ *
+ * PRE-CONDITIONS:
+ *  const K& k    : key for MPair
+ *  Args&&... args: arguments for V's constructor
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename K, typename V>
+template <typename... Args>
+bool MMap<K, V>::emplace(const K& k, Args&&... args) {
+    return _mmap.write().emplace(std::piecewise_construct, k,
+                                 std::forward<Args>(args)...);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts MPair into map with value constructed from args, only when key is
+ *  not in map. Otherwise, value is not constructed. One search finds the key
+ *  or its insert position.
+ *
+ * PRE-CONDITIONS:
+ *  const K& k    : key for MPair
+ *  Args&&... args: arguments for V's constructor
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool: false if key already exists
+ ******************************************************************************/
+template <typename K, typename V>
+template <typename... Args>
+bool MMap<K, V>::try_emplace(const K& k, Args&&... args) {
+    return _mmap.write().try_emplace(KeyProbe<K, K>(k),
+                                     std::piecewise_construct, k,
+                                     std::forward<Args>(args)...);
 }
 
 /*******************************************************************************
@@ -928,7 +1296,47 @@ bool MMap<K, V>::insert(const K& k, const V& v) {
  ******************************************************************************/
 template <typename K, typename V>
 bool MMap<K, V>::erase(const K& key) {
-    return _mmap.remove(MPair(key));
+    return _mmap.write().remove(MPair(key));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Erase all MPairs with keys in the range [low, high).
+ *
+ * PRE-CONDITIONS:
+ *  const KT& low : inclusive lower key, or value comparable with K
+ *  const KT& high: exclusive upper key, or value comparable with K
+ *
+ * POST-CONDITIONS:
+ *  MPairs in range removed
+ *
+ * RETURN:
+ *  std::size_t: count of erased MPairs
+ ******************************************************************************/
+template <typename K, typename V>
+template <typename KT>
+std::size_t MMap<K, V>::erase_range(const KT& low, const KT& high) {
+    return _mmap.write().erase_range(KeyProbe<K, KT>(low),
+                                     KeyProbe<K, KT>(high));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Erase all MPairs where pred(mpair) is true.
+ *
+ * PRE-CONDITIONS:
+ *  Pred pred: callable as bool pred(const MPair&)
+ *
+ * POST-CONDITIONS:
+ *  MPairs satisfying pred removed
+ *
+ * RETURN:
+ *  std::size_t: count of erased MPairs
+ ******************************************************************************/
+template <typename K, typename V>
+template <typename Pred>
+std::size_t MMap<K, V>::erase_if(Pred pred) {
+    return _mmap.write().erase_if(pred);
 }
 
 /*******************************************************************************
@@ -964,7 +1372,9 @@ void MMap<K, V>::clear() {
  ******************************************************************************/
 template <typename K, typename V>
 std::vector<V>& MMap<K, V>::get(const K& key) {
-    return _mmap.get(Pair(key)).values;
+    MMapBaseIter it = _mmap.find(pair::Key<K>(key));  // no MPair if found
+
+    return it ? (*it).values : _mmap.write().get(MPair(key)).values;
 }
 
 /*******************************************************************************
@@ -972,7 +1382,7 @@ std::vector<V>& MMap<K, V>::get(const K& key) {
  *  Checks if key is contained in MMap.
  *
  * PRE-CONDITIONS:
- *  const MPair& target: the MPair to find
+ *  const KT& key: key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -981,8 +1391,9 @@ std::vector<V>& MMap<K, V>::get(const K& key) {
  *  bool
  ******************************************************************************/
 template <typename K, typename V>
-bool MMap<K, V>::contains(const K& key) const {
-    return _mmap.contains(MPair(key));
+template <typename KT>
+bool MMap<K, V>::contains(const KT& key) const {
+    return _mmap->contains(KeyProbe<K, KT>(key));
 }
 
 /*******************************************************************************
@@ -990,7 +1401,66 @@ bool MMap<K, V>::contains(const K& key) const {
  *  Returns the number of elements for given key.
  *
  * PRE-CONDITIONS:
- *  const K& key: key to find MPair
+ *  const KT& key: key, or value comparable with K
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename K, typename V>
+template <typename KT>
+std::size_t MMap<K, V>::count(const KT& key) const {
+    MMapBaseIter it = _mmap->find(KeyProbe<K, KT>(key));
+
+    return it ? (*it).values.size() : 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the count of keys less than key.
+ *
+ * PRE-CONDITIONS:
+ *  const KT& key: key, or value comparable with K
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename K, typename V>
+template <typename KT>
+std::size_t MMap<K, V>::rank(const KT& key) const {
+    return _mmap->rank(KeyProbe<K, KT>(key));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the k-th smallest MPair, counting from 0.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t k: index of MPair in key order
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  MMap<K, V>::Iterator: end() when k is out of range
+ ******************************************************************************/
+template <typename K, typename V>
+typename MMap<K, V>::Iterator MMap<K, V>::select(std::size_t k) {
+    return MMap<K, V>::Iterator(_mmap.select(k));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the count of keys in the range [low, high).
+ *
+ * PRE-CONDITIONS:
+ *  const KT& low : inclusive lower key, or value comparable with K
+ *  const KT& high: exclusive upper key, or value comparable with K
  *
  * POST-CONDITIONS:
  *  none
@@ -999,8 +1469,9 @@ bool MMap<K, V>::contains(const K& key) const {
  *  std::size_t
  ******************************************************************************/
 template <typename K, typename V>
-std::size_t MMap<K, V>::count(const K& key) const {
-    return _mmap.get(MPair(key)).values.size();
+template <typename KT>
+std::size_t MMap<K, V>::count_range(const KT& low, const KT& high) const {
+    return _mmap->count_range(KeyProbe<K, KT>(low), KeyProbe<K, KT>(high));
 }
 
 /*******************************************************************************
@@ -1018,7 +1489,7 @@ std::size_t MMap<K, V>::count(const K& key) const {
  ******************************************************************************/
 template <typename K, typename V>
 void MMap<K, V>::print_debug() const {
-    _mmap.print(std::cout, true);
+    _mmap->print(std::cout, true);
 }
 
 /*******************************************************************************
@@ -1036,7 +1507,7 @@ void MMap<K, V>::print_debug() const {
  ******************************************************************************/
 template <typename K, typename V>
 bool MMap<K, V>::verify() const {
-    return _mmap.verify();
+    return _mmap->verify();
 }
 
 }  // namespace bpt_map
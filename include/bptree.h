@@ -6,7 +6,11 @@
  * DESCRIPTION : This header provides a templated self-balancing BPTree class,
  *      the B+ Tree, that allows for more than two children per node but with
  *      the real data only at the leaf nodes. The data is held in an array of
- *      smart pointers.
+ *      smart pointers. Each node and its arrays share one allocation, taken
+ *      from a per-tree NodePool when the tree is pooled. CowBPTree is a
+ *      copy-on-write handle: copies share nodes, counted by _refs, and a
+ *      writer copies only the shared nodes on its root-to-leaf path. Leaves
+ *      are not chained, so iterators find the next leaf from the root.
  *
  *      RULES:
  *      1. Root can have 0 entries if no children, or at least 1 entry if it
@@ -25,25 +29,34 @@
 #ifndef BPTREE_H
 #define BPTREE_H
 
+#include <atomic>             // atomic
 #include <cassert>            // assert()
 #include <memory>             // shared_ptr
 #include <string>             // string
+#include <utility>            // swap()
+#include <vector>             // vector
+#include "node_pool.h"        // NodePool class
 #include "smart_ptr_utils.h"  // smart pointer utilities
 #include "sort.h"             // verify()
 
 namespace bptree {
 enum { MINIMUM = 1 };
 
+template <class T>
+class CowBPTree;
+
 template <class T>
 class BPTree {
 public:
     class Iterator {
     public:
         friend class BPTree;
+        friend class CowBPTree<T>;
 
         // CONSTRUCTOR
-        Iterator(const BPTree<T>* it = nullptr, std::size_t index = 0)
-            : _it(it), _index(index) {}
+        Iterator(const BPTree<T>* it = nullptr, std::size_t index = 0,
+                 const BPTree<T>* root = nullptr)
+            : _it(it), _index(index), _root(root), _levels(0) {}
 
         bool is_null() { return !_it; }
         explicit operator bool() { return _it; }
@@ -70,7 +83,8 @@ public:
 
         Iterator& operator++() {  // pre-inc
             if(_it && ++_index == _it->_data_count) {
-                _it = _it->_next;
+                _it = _root ? _root->next_leaf(_it, _up, _at, _levels)
+                            : nullptr;
                 _index = 0;
             }
             return *this;
@@ -86,7 +100,8 @@ public:
         void print_Iterator() { std::cout << *_it; }
         void next_key() {
             if(_it) {
-                _it = _it->_next;
+                _it = _root ? _root->next_leaf(_it, _up, _at, _levels)
+                            : nullptr;
                 _index = 0;
             }
         };
@@ -102,18 +117,28 @@ public:
         }
 
     private:
+        enum { LEVELS = 4 };  // ancestors of _it kept to cross leaves
+
         const BPTree<T>* _it;
         std::size_t _index;
+        const BPTree<T>* _root;        // tree to find the next leaf in
+        std::size_t _levels;           // ancestors known; 0 until crossed
+        const BPTree<T>* _up[LEVELS];  // _up[0] is _it's parent
+        std::size_t _at[LEVELS];       // subset taken in each of _up
     };
 
     // CONSTRUCTOR
-    BPTree(bool dups = false, std::size_t min = MINIMUM);
+    BPTree(bool dups = false, std::size_t min = MINIMUM, bool pooled = false);
 
     // BIG THREE
     ~BPTree();
     BPTree(const BPTree<T>& src);
     BPTree<T>& operator=(const BPTree<T>& rhs);
 
+    // MOVE
+    BPTree(BPTree<T>&& src);
+    BPTree<T>& operator=(BPTree<T>&& rhs);
+
     // capacity
     std::size_t size() const;
     bool empty() const;
@@ -123,26 +148,54 @@ public:
     Iterator begin();
     Iterator end() const;
     Iterator end();
-    Iterator find(const T& entry) const;
-    Iterator find(const T& entry);
-    Iterator lower_bound(const T& entry) const;
-    Iterator lower_bound(const T& entry);
-    Iterator upper_bound(const T& entry) const;
-    Iterator upper_bound(const T& entry);
+    // lookups take T or any U where T < U and U < T compare (ie: a key)
+    template <typename U>
+    Iterator find(const U& entry) const;
+    template <typename U>
+    Iterator find(const U& entry);
+    template <typename U>
+    Iterator lower_bound(const U& entry) const;
+    template <typename U>
+    Iterator lower_bound(const U& entry);
+    template <typename U>
+    Iterator upper_bound(const U& entry) const;
+    template <typename U>
+    Iterator upper_bound(const U& entry);
     const T& front() const;
     T& front();
     const T& back() const;
     T& back();
-    const T& get(const T& entry) const;  // return a ref to entry in the tree
+    template <typename U>
+    const T& get(const U& entry) const;  // return a ref to entry in the tree
     T& get(const T& entry);              // return a ref to entry in the tree
+    T& get(T&& entry);                   // moves entry in if not found
 
     // modifiers
     bool insert(const T& entry);
+    bool insert(T&& entry);
+    template <typename... Args>
+    bool emplace(Args&&... args);  // insert T constructed from args
+    template <typename U, typename... Args>  // T(args) only if key is new
+    bool try_emplace(const U& key, Args&&... args);
     bool remove(const T& entry);
-    void clear();  // clear data and delete all nodes
+    template <typename U>  // remove [low, high); return count removed
+    std::size_t erase_range(const U& low, const U& high);
+    template <typename Pred>  // remove when pred(entry); return count removed
+    std::size_t erase_if(Pred pred);
+    void clear();                // clear data and delete all nodes
+    void swap(BPTree<T>& other);  // swap trees without copying
+
+    // order statistics from subtree sizes
+    template <typename U>
+    std::size_t rank(const U& entry) const;  // count of entries < entry
+    Iterator select(std::size_t k) const;    // k-th entry from 0; else end()
+    Iterator select(std::size_t k);
+    template <typename U>  // count of entries in [low, high)
+    std::size_t count_range(const U& low, const U& high) const;
 
     // misc
-    bool contains(const T& entry) const;
+    template <typename U>
+    bool contains(const U& entry) const;
     void print(std::ostream& outs = std::cout, bool debug = false,
                int level = 0, int index = 0) const;
     bool verify() const;
@@ -152,6 +205,7 @@ public:
         bt.print(outs);
         return outs;
     }
+    friend class CowBPTree<T>;
 
 private:
     std::size_t _min;           // minimum entries
@@ -162,18 +216,39 @@ private:
     std::shared_ptr<T>* _data;  // holds the keys -> _data[_max+1]
     std::size_t _child_count;   // number of children
     BPTree<T>** _subset;        // subtrees -> _subset[_max+2]
-    BPTree<T>* _next;           // next sibling's subset
-
-    void copy(const BPTree<T>& other);                    // wrapper to copy
-    void copy(const BPTree<T>& other, BPTree<T>*& next);  // copy tree
+    std::atomic<std::size_t> _refs;  // parents holding this node
+    node_pool::NodePool* _pool;  // node blocks if pooled; owned by root
+
+    // node storage: a node, its subset and its data share one block
+    BPTree(bool dups, std::size_t min, node_pool::NodePool* pool, char* block);
+    std::size_t subset_offset() const;  // subset array's offset in block
+    std::size_t data_offset() const;    // data array's offset in block
+    std::size_t block_size() const;     // bytes per block
+    char* block() const;                // block holding 'this' arrays
+    void construct_arrays(char* block);
+    BPTree<T>* make_node();               // new node from this tree's storage
+    void destroy_node(BPTree<T>* node);  // free node from make_node()
+
+    // node sharing between trees of CowBPTree handles
+    BPTree<T>* own(BPTree<T>*& node);    // node := unshared copy if shared
+    void share(const BPTree<T>& other);  // copy node; share its subsets
+    void release_node(BPTree<T>* node);  // drop a ref; free if it was last
+
+    void copy(const BPTree<T>& other);  // copy tree
     void deallocate();
 
     inline bool is_leaf() const { return _child_count == 0; }  // check if leaf
     void update_size();
 
     // insert element functions
-    bool loose_insert(const T& entry);  // allows _max+1 data in the root
-    void fix_excess(std::size_t i);     // fix excess of data in child i
+    template <typename U>  // U is const T& or T; item := inserted entry
+    bool insert_entry(U&& entry, T*& item);
+    // make() builds a new entry; merge(T&) adds to an equal one if allowed
+    template <typename U, typename Make, typename Merge>
+    bool insert_entry(const U& key, Make& make, Merge& merge, T*& item);
+    template <typename U, typename Make, typename Merge>  // _max+1 in root
+    bool loose_insert(const U& key, Make& make, Merge& merge, T*& item);
+    void fix_excess(std::size_t i);  // fix excess of data in child i
 
     // remove element functions
     bool loose_remove(const T& entry);    // allows _min-1 data in the root
@@ -184,16 +259,37 @@ private:
     void rotate_right(std::size_t i);  // xfer one data from child i-1 to i
     void merge_with_next_subset(std::size_t i);  // merge subset i w/ subset i+1
 
+    // bulk remove functions
+    template <typename Pred>  // remove where pred in [first, last]; fix once
+    std::size_t remove_if(Pred pred, const BPTree<T>* first,
+                          const BPTree<T>* last);
+    template <typename Pred>  // index of first leaf entry where pred
+    std::size_t first_of(Pred pred) const;
+    template <typename Pred>  // remove leaf entry i and later where pred
+    void remove_in_leaf(Pred pred, std::size_t i);
+    void get_leaves(std::vector<BPTree<T>*>& leaves);  // leaves in order
+    bool balance_leaves(BPTree<T>* left, BPTree<T>* right);  // false: merged
+    void build(std::vector<BPTree<T>*>& leaves);  // build keys over leaves
+
     const BPTree<T>* get_smallest_node() const;
     BPTree<T>* get_smallest_node();
     const BPTree<T>* get_largest_node() const;
     BPTree<T>* get_largest_node();
+    const BPTree<T>* next_leaf(const BPTree<T>* leaf,  // else nullptr
+                               const BPTree<T>** up, std::size_t* at,
+                               std::size_t& levels) const;
     void get_smallest(std::shared_ptr<T>& entry);    // entry := leftmost leaf
     void get_largest(std::shared_ptr<T>& entry);     // entry := rightmost leaf
     void remove_largest(std::shared_ptr<T>& entry);  // remove largest child
 
-    const T* find_ptr(const T& entry) const;  // return ptr to T; else nullptr
-    T* find_ptr(const T& entry);              // return ptr to T; else nullptr
+    template <typename U>
+    const BPTree<T>* find_leaf(const U& entry) const;  // leaf entry goes in
+    template <typename U>
+    BPTree<T>* find_leaf(const U& entry);  // owns the path to the leaf
+    template <typename U>
+    const T* find_ptr(const U& entry) const;  // return ptr to T; else nullptr
+    template <typename U>
+    T* find_ptr(const U& entry);  // return ptr to T; else nullptr
     std::shared_ptr<T> find_shared_ptr(const T& entry);
 
     bool verify_tree(int& height, bool& has_stored_height, int level = 0) const;
@@ -203,12 +299,117 @@ private:
                       const std::shared_ptr<T>& item) const;
 };
 
+// copy-on-write handle to a BPTree: copies share the root in O(1) and then
+// share nodes. A write first copies the root, then each shared node on its
+// path, so the other copies keep their view unchanged. Non-const lookups
+// return an Iterator that copies the path to its entry when dereferenced.
+// References from it stay valid for writing until the next copy is taken.
+template <class T>
+class CowBPTree {
+public:
+    typedef typename BPTree<T>::Iterator TreeIter;
+
+    class Iterator {
+    public:
+        friend class CowBPTree;
+
+        // CONSTRUCTOR
+        Iterator(TreeIter it = TreeIter(), CowBPTree<T>* owner = nullptr)
+            : _it(it), _owner(owner), _owned(nullptr), _epoch(0) {}
+
+        bool is_null() { return !_it; }
+        explicit operator bool() { return (bool)_it; }
+
+        T& operator*() { return *own(); }
+        T* operator->() { return &*own(); }
+
+        Iterator& operator++() {  // pre-inc
+            ++_it;
+            return *this;
+        }
+
+        Iterator operator++(int _u) {  // post-inc
+            (void)_u;                  // suppress unused warning
+            Iterator it = *this;       // make temp
+            operator++();              // pre-inc
+            return it;                 // return previous state
+        }
+
+        void next_key() { _it.next_key(); }
+
+        // FRIENDS
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs._it == rhs._it;
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+            return lhs._it != rhs._it;
+        }
+
+    private:
+        TreeIter _it;              // position in the tree
+        CowBPTree<T>* _owner;      // handle written through; nullptr if const
+        const BPTree<T>* _owned;   // leaf last made unshared for writing
+        std::size_t _epoch;        // owner's epoch when _owned was unshared
+
+        TreeIter& own() {  // _it, once the path to its leaf is unshared
+            if(_owner && _owner->_epoch && _it &&
+               (leaf_of(_it) != _owned || _epoch != _owner->_epoch))
+                unshare();
+            return _it;
+        }
+
+        void unshare();  // copies the shared nodes on the path to _it
+    };
+
+    // CONSTRUCTOR
+    CowBPTree(bool dups = false, std::size_t min = MINIMUM)
+        : _tree(std::make_shared<BPTree<T>>(dups, min)), _epoch(0) {}
+
+    // COPY: shares the tree in O(1)
+    CowBPTree(const CowBPTree<T>& src);
+    CowBPTree<T>& operator=(const CowBPTree<T>& rhs);
+
+    // MOVE: src is left empty with the same dups and min
+    CowBPTree(CowBPTree<T>&& src);
+    CowBPTree<T>& operator=(CowBPTree<T>&& rhs);
+
+    // read access never copies
+    const BPTree<T>& operator*() const { return *_tree; }
+    const BPTree<T>* operator->() const { return _tree.get(); }
+
+    // lookups for writing: entries are unshared when dereferenced
+    Iterator begin();
+    Iterator end();
+    template <typename U>
+    Iterator find(const U& entry);
+    template <typename U>
+    Iterator lower_bound(const U& entry);
+    template <typename U>
+    Iterator upper_bound(const U& entry);
+    Iterator select(std::size_t k);
+
+    BPTree<T>& write();  // write access; unshares the root first
+    void clear();        // empty tree; shared nodes are left to the copies
+    bool is_shared() const { return _tree.use_count() > 1; }
+
+private:
+    std::shared_ptr<BPTree<T>> _tree;  // root shared by copies
+    mutable std::size_t _epoch;        // bumped by copies; 0 if never shared
+
+    std::shared_ptr<BPTree<T>> make_empty() const;  // same dups and min
+    TreeIter own_path(TreeIter it);  // it in a tree with its path unshared
+    static const BPTree<T>* leaf_of(const TreeIter& it) { return it._it; }
+};
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Default constructor.
  *
  * PRE-CONDITIONS:
- *  bool dups: allows duplicate items.
+ *  bool dups       : allows duplicate items.
+ *  std::size_t min : minimum entries per node
+ *  bool pooled     : allocate nodes from a NodePool owned by the tree
  *
  * POST-CONDITIONS:
  *  initializations
@@ -217,7 +418,7 @@ private:
  *  none
  ******************************************************************************/
 template <typename T>
-BPTree<T>::BPTree(bool dups, std::size_t min)
+BPTree<T>::BPTree(bool dups, std::size_t min, bool pooled)
     : _min(min),
       _max(2 * _min),
       _dups_ok(dups),
@@ -226,14 +427,18 @@ BPTree<T>::BPTree(bool dups, std::size_t min)
       _data(nullptr),
       _child_count(0),
       _subset(nullptr),
-      _next(nullptr) {
-    _data = new std::shared_ptr<T>[_max + 1];
-    _subset = new BPTree<T>*[_max + 2];
+      _refs(1),
+      _pool(nullptr) {
+    if(pooled) _pool = new node_pool::NodePool(block_size());
+
+    // root's block is never pooled, so an empty tree takes no slab
+    construct_arrays(static_cast<char*>(::operator new(block_size())));
 }
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Destructor. Deallocates all heap memory from this object.
+ *  Destructor. Deallocates all heap memory from this object. The root also
+ *  frees its arrays' block and its NodePool.
  *
  * PRE-CONDITIONS:
  *  none
@@ -246,12 +451,21 @@ BPTree<T>::BPTree(bool dups, std::size_t min)
  ******************************************************************************/
 template <typename T>
 BPTree<T>::~BPTree() {
+    typedef std::shared_ptr<T> Entry;
+
     deallocate();
+    for(std::size_t i = 0; i <= _max; ++i) _data[i].~Entry();
+
+    // a node's block is freed by destroy_node(); the root frees its own
+    if(block() != reinterpret_cast<char*>(this)) {
+        ::operator delete(block());
+        delete _pool;
+    }
 }
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Copy constructor.
+ *  Copy constructor. The copy is pooled when src is.
  *
  * PRE-CONDITIONS:
  *  const BPTree<T>& src: source BPTree to copy
@@ -264,17 +478,7 @@ BPTree<T>::~BPTree() {
  ******************************************************************************/
 template <typename T>
 BPTree<T>::BPTree(const BPTree<T>& src)
-    : _min(src._min),
-      _max(src._max),
-      _dups_ok(src._dups_ok),
-      _size(0),
-      _data_count(0),
-      _data(nullptr),
-      _child_count(0),
-      _subset(nullptr),
-      _next(nullptr) {
-    _data = new std::shared_ptr<T>[_max + 1];
-    _subset = new BPTree<T>*[_max + 2];
+    : BPTree(src._dups_ok, src._min, src._pool != nullptr) {
     copy(src);
 }
 
@@ -294,11 +498,50 @@ BPTree<T>::BPTree(const BPTree<T>& src)
 template <typename T>
 BPTree<T>& BPTree<T>::operator=(const BPTree<T>& rhs) {
     if(this != &rhs) {
-        _min = rhs._min;
-        _max = rhs._max;
-        _dups_ok = rhs._dups_ok;
-        clear();
-        copy(rhs);
+        BPTree<T> temp(rhs);  // copy into rhs's block size, then take it
+        swap(temp);
+    }
+    return *this;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Move constructor. Takes src's nodes without copying; src is left empty.
+ *
+ * PRE-CONDITIONS:
+ *  BPTree<T>&& src: source BPTree to move
+ *
+ * POST-CONDITIONS:
+ *  'this' owns src's nodes; src is empty
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+BPTree<T>::BPTree(BPTree<T>&& src)
+    : BPTree(src._dups_ok, src._min, src._pool != nullptr) {
+    swap(src);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Move assignment operator. Takes rhs's nodes without copying; rhs is left
+ *  empty.
+ *
+ * PRE-CONDITIONS:
+ *  BPTree<T>&& rhs: source BPTree to move
+ *
+ * POST-CONDITIONS:
+ *  'this' owns rhs's nodes; rhs is empty
+ *
+ * RETURN:
+ *  *this
+ ******************************************************************************/
+template <typename T>
+BPTree<T>& BPTree<T>::operator=(BPTree<T>&& rhs) {
+    if(this != &rhs) {
+        swap(rhs);
+        rhs.clear();
     }
     return *this;
 }
@@ -354,7 +597,7 @@ bool BPTree<T>::empty() const {
  ******************************************************************************/
 template <typename T>
 typename BPTree<T>::Iterator BPTree<T>::begin() const {
-    return size() ? BPTree<T>::Iterator(get_smallest_node())
+    return size() ? BPTree<T>::Iterator(get_smallest_node(), 0, this)
                   : BPTree<T>::Iterator(nullptr);
 }
 
@@ -373,7 +616,7 @@ typename BPTree<T>::Iterator BPTree<T>::begin() const {
  ******************************************************************************/
 template <typename T>
 typename BPTree<T>::Iterator BPTree<T>::begin() {
-    return size() ? BPTree<T>::Iterator(get_smallest_node())
+    return size() ? BPTree<T>::Iterator(get_smallest_node(), 0, this)
                   : BPTree<T>::Iterator(nullptr);
 }
 
@@ -418,7 +661,7 @@ typename BPTree<T>::Iterator BPTree<T>::end() {
  *  Return iterator to entry; else iterator points to nullptr.
  *
  * PRE-CONDITIONS:
- *  const T& entry: target
+ *  const U& entry: target, T or key comparable with T
  *
  * POST-CONDITIONS:
  *  none
@@ -427,22 +670,18 @@ typename BPTree<T>::Iterator BPTree<T>::end() {
  *  BPTree<T>::Iterator
  ******************************************************************************/
 template <typename T>
-typename BPTree<T>::Iterator BPTree<T>::find(const T& entry) const {
+template <typename U>
+typename BPTree<T>::Iterator BPTree<T>::find(const U& entry) const {
+    const BPTree<T>* leaf = find_leaf(entry);
+
     // find index of T that's greater or qual to entry
-    std::size_t i = smart_ptr_utils::first_ge(_data, _data_count, entry);
-    bool is_found = (i < _data_count && !(entry < *_data[i]));
+    std::size_t i = smart_ptr_utils::first_ge(leaf->_data, leaf->_data_count,
+                                              entry);
 
-    if(is_leaf()) {
-        if(is_found)
-            return BPTree<T>::Iterator(this, i);
-        else
-            return BPTree<T>::Iterator(nullptr);
-    } else {                                     // @ !leaf
-        if(is_found)                             // when found
-            return _subset[i + 1]->find(entry);  // recurse i+1
-        else                                     // when !found
-            return _subset[i]->find(entry);      // recurse to find entry
-    }
+    if(i < leaf->_data_count && !(entry < *leaf->_data[i]))
+        return BPTree<T>::Iterator(leaf, i, this);
+    else
+        return BPTree<T>::Iterator(nullptr);
 }
 
 /*******************************************************************************
@@ -450,7 +689,7 @@ typename BPTree<T>::Iterator BPTree<T>::find(const T& entry) const {
  *  Return iterator to entry; else iterator points to nullptr.
  *
  * PRE-CONDITIONS:
- *  const T& entry: target
+ *  const U& entry: target, T or key comparable with T
  *
  * POST-CONDITIONS:
  *  none
@@ -459,22 +698,9 @@ typename BPTree<T>::Iterator BPTree<T>::find(const T& entry) const {
  *  BPTree<T>::Iterator
  ******************************************************************************/
 template <typename T>
-typename BPTree<T>::Iterator BPTree<T>::find(const T& entry) {
-    // find index of T that's greater or qual to entry
-    std::size_t i = smart_ptr_utils::first_ge(_data, _data_count, entry);
-    bool is_found = (i < _data_count && !(entry < *_data[i]));
-
-    if(is_leaf()) {
-        if(is_found)
-            return BPTree<T>::Iterator(this, i);
-        else
-            return BPTree<T>::Iterator(nullptr);
-    } else {                                     // @ !leaf
-        if(is_found)                             // when found
-            return _subset[i + 1]->find(entry);  // recurse i+1
-        else                                     // when !found
-            return _subset[i]->find(entry);      // recurse to find entry
-    }
+template <typename U>
+typename BPTree<T>::Iterator BPTree<T>::find(const U& entry) {
+    return static_cast<const BPTree<T>*>(this)->find(entry);
 }
 
 /*******************************************************************************
@@ -483,7 +709,7 @@ typename BPTree<T>::Iterator BPTree<T>::find(const T& entry) {
  *  other words, entry is less than or equal to the iterator.
  *
  * PRE-CONDITIONS:
- *  const T& entry: target
+ *  const U& entry: target, T or key comparable with T
  *
  * POST-CONDITIONS:
  *  none
@@ -492,27 +718,20 @@ typename BPTree<T>::Iterator BPTree<T>::find(const T& entry) {
  *  const BPTree<T>::Iterator
  ******************************************************************************/
 template <typename T>
-typename BPTree<T>::Iterator BPTree<T>::lower_bound(const T& entry) const {
+template <typename U>
+typename BPTree<T>::Iterator BPTree<T>::lower_bound(const U& entry) const {
+    const BPTree<T>* leaf = find_leaf(entry);
+
     // find index of T that's greater or qual to entry
-    std::size_t i = smart_ptr_utils::first_ge(_data, _data_count, entry);
-    bool is_found = (i < _data_count && !(entry < *_data[i]));
+    std::size_t i = smart_ptr_utils::first_ge(leaf->_data, leaf->_data_count,
+                                              entry);
 
-    if(is_leaf()) {
-        if(i < _data_count) {
-            if(is_found || entry < *_data[i])  // found or less than/equal
-                return BPTree<T>::Iterator(this, i);  // return this and i
-            else if(i + 1 < _data_count)  // if greater and next i in bounds
-                return BPTree<T>::Iterator(this, i + 1);  // return this w/ i+1
-            else                                          // if next i !bounds
-                return BPTree<T>::Iterator(this->_next, 0);  // return next
-        } else                                               // if not in _data
-            return BPTree<T>::Iterator(this->_next, 0);      // return next
-    } else {                                                 // @ !leaf
-        if(is_found)                                         // when found
-            return _subset[i + 1]->lower_bound(entry);       // recurse i+1
-        else                                                 // when !found
-            return _subset[i]->lower_bound(entry);           // recurse @ i
-    }
+    if(i < leaf->_data_count)  // found or less than
+        return BPTree<T>::Iterator(leaf, i, this);
+    if(!i) return BPTree<T>::Iterator(nullptr);  // empty tree
+
+    BPTree<T>::Iterator last(leaf, i - 1, this);  // all of leaf < entry
+    return ++last;                                // return next leaf's front
 }
 
 /*******************************************************************************
@@ -521,7 +740,7 @@ typename BPTree<T>::Iterator BPTree<T>::lower_bound(const T& entry) const {
  *  other words, entry is less than or equal to the iterator.
  *
  * PRE-CONDITIONS:
- *  const T& entry: target
+ *  const U& entry: target, T or key comparable with T
  *
  * POST-CONDITIONS:
  *  none
@@ -530,27 +749,9 @@ typename BPTree<T>::Iterator BPTree<T>::lower_bound(const T& entry) const {
  *  BPTree<T>::Iterator
  ******************************************************************************/
 template <typename T>
-typename BPTree<T>::Iterator BPTree<T>::lower_bound(const T& entry) {
-    // find index of T that's greater or qual to entry
-    std::size_t i = smart_ptr_utils::first_ge(_data, _data_count, entry);
-    bool is_found = (i < _data_count && !(entry < *_data[i]));
-
-    if(is_leaf()) {
-        if(i < _data_count) {
-            if(is_found || entry < *_data[i])  // found or less than/equal
-                return BPTree<T>::Iterator(this, i);  // return this and i
-            else if(i + 1 < _data_count)  // if greater and next i in bounds
-                return BPTree<T>::Iterator(this, i + 1);  // return this w/ i+1
-            else                                          // if next i !bounds
-                return BPTree<T>::Iterator(this->_next, 0);  // return next
-        } else                                               // if not in _data
-            return BPTree<T>::Iterator(this->_next, 0);      // return next
-    } else {                                                 // @ !leaf
-        if(is_found)                                         // when found
-            return _subset[i + 1]->lower_bound(entry);       // recurse i+1
-        else                                                 // when !found
-            return _subset[i]->lower_bound(entry);           // recurse @ i
-    }
+template <typename U>
+typename BPTree<T>::Iterator BPTree<T>::lower_bound(const U& entry) {
+    return static_cast<const BPTree<T>*>(this)->lower_bound(entry);
 }
 
 /*******************************************************************************
@@ -559,7 +760,7 @@ typename BPTree<T>::Iterator BPTree<T>::lower_bound(const T& entry) {
  *  the iterator is one step beyond the entry.
  *
  * PRE-CONDITIONS:
- *  const T& entry: target
+ *  const U& entry: target, T or key comparable with T
  *
  * POST-CONDITIONS:
  *  none
@@ -568,10 +769,11 @@ typename BPTree<T>::Iterator BPTree<T>::lower_bound(const T& entry) {
  *  const BPTree<T>::Iterator
  ******************************************************************************/
 template <typename T>
-typename BPTree<T>::Iterator BPTree<T>::upper_bound(const T& entry) const {
+template <typename U>
+typename BPTree<T>::Iterator BPTree<T>::upper_bound(const U& entry) const {
     BPTree<T>::Iterator upper = lower_bound(entry);  // get lower bound
 
-    if(upper && *upper == entry) ++upper;  // if equal to entry, increment
+    if(upper && !(entry < *upper)) ++upper;  // if equal to entry, increment
 
     return upper;
 }
@@ -582,7 +784,7 @@ typename BPTree<T>::Iterator BPTree<T>::upper_bound(const T& entry) const {
  *  the iterator is one step beyond the entry.
  *
  * PRE-CONDITIONS:
- *  const T& entry: target
+ *  const U& entry: target, T or key comparable with T
  *
  * POST-CONDITIONS:
  *  none
@@ -591,10 +793,11 @@ typename BPTree<T>::Iterator BPTree<T>::upper_bound(const T& entry) const {
  *  BPTree<T>::Iterator
  ******************************************************************************/
 template <typename T>
-typename BPTree<T>::Iterator BPTree<T>::upper_bound(const T& entry) {
+template <typename U>
+typename BPTree<T>::Iterator BPTree<T>::upper_bound(const U& entry) {
     BPTree<T>::Iterator upper = lower_bound(entry);  // get lower bound
 
-    if(upper && *upper == entry) ++upper;  // if equal to entry, increment
+    if(upper && !(entry < *upper)) ++upper;  // if equal to entry, increment
 
     return upper;
 }
@@ -619,20 +822,25 @@ const T& BPTree<T>::front() const {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Returns the first (leftmost) entry.
+ *  Returns the first (leftmost) entry. Shared nodes on its path are copied
+ *  first, so writes through it stay in 'this' tree.
  *
  * PRE-CONDITIONS:
  *  none
  *
  * POST-CONDITIONS:
- *  none
+ *  path to the first entry is not shared
  *
  * RETURN:
  *  T&
  ******************************************************************************/
 template <typename T>
 T& BPTree<T>::front() {
-    return *get_smallest_node()->_data[0];
+    BPTree<T>* walker = this;
+
+    while(!walker->is_leaf()) walker = walker->own(walker->_subset[0]);
+
+    return *walker->_data[0];
 }
 
 /*******************************************************************************
@@ -656,21 +864,26 @@ const T& BPTree<T>::back() const {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Returns the last (rightmost) entry.
+ *  Returns the last (rightmost) entry. Shared nodes on its path are copied
+ *  first, so writes through it stay in 'this' tree.
  *
  * PRE-CONDITIONS:
  *  none
  *
  * POST-CONDITIONS:
- *  none
+ *  path to the last entry is not shared
  *
  * RETURN:
  *  T&
  ******************************************************************************/
 template <typename T>
 T& BPTree<T>::back() {
-    BPTree<T>* largest = get_largest_node();
-    return *largest->_data[largest->_data_count - 1];
+    BPTree<T>* walker = this;
+
+    while(!walker->is_leaf())
+        walker = walker->own(walker->_subset[walker->_child_count - 1]);
+
+    return *walker->_data[walker->_data_count - 1];
 }
 
 /*******************************************************************************
@@ -679,7 +892,7 @@ T& BPTree<T>::back() {
  *throws invalid argument exception.
  *
  * PRE-CONDITIONS:
- *  const T& entry: must be contained in the BPTree
+ *  const U& entry: must be contained in the BPTree
  *
  * POST-CONDITIONS:
  *  none
@@ -688,7 +901,8 @@ T& BPTree<T>::back() {
  *  const T&
  ******************************************************************************/
 template <typename T>
-const T& BPTree<T>::get(const T& entry) const {
+template <typename U>
+const T& BPTree<T>::get(const U& entry) const {
     const T* found = find_ptr(entry);
 
     if(found)
@@ -715,14 +929,140 @@ template <typename T>
 T& BPTree<T>::get(const T& entry) {
     T* found = find_ptr(entry);
 
-    if(!found) {
-        insert(entry);
-        found = find_ptr(entry);
-    }
+    if(!found) insert_entry(entry, found);
+
+    return *found;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the entry contained in the BPTree. If entry is not found, then
+ *  moves the entry into the BPTree and returns it.
+ *
+ * PRE-CONDITIONS:
+ *  T&& entry: entry to find or move in
+ *
+ * POST-CONDITIONS:
+ *  entry moved from if not found
+ *
+ * RETURN:
+ *  T&
+ ******************************************************************************/
+template <typename T>
+T& BPTree<T>::get(T&& entry) {
+    T* found = find_ptr(entry);
+
+    if(!found) insert_entry(std::move(entry), found);
 
     return *found;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Insert entry int BPTree.
+ *
+ * PRE-CONDITIONS:
+ *  const T& entry: entry item to be inserted
+ *
+ * POST-CONDITIONS:
+ *  T entry inserted
+ *  _size inc if successful
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+bool BPTree<T>::insert(const T& entry) {
+    T* item = nullptr;
+    return insert_entry(entry, item);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Insert entry int BPTree by moving it into its leaf.
+ *
+ * PRE-CONDITIONS:
+ *  T&& entry: entry item to be inserted
+ *
+ * POST-CONDITIONS:
+ *  T entry inserted; entry moved from
+ *  _size inc if successful
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+bool BPTree<T>::insert(T&& entry) {
+    T* item = nullptr;
+    return insert_entry(std::move(entry), item);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Insert entry constructed from args into BPTree. The entry is constructed
+ *  once, in the storage its leaf keeps, and is then searched for.
+ *
+ * PRE-CONDITIONS:
+ *  Args&&... args: arguments for T's constructor
+ *
+ * POST-CONDITIONS:
+ *  T entry inserted
+ *  _size inc if successful
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+template <typename... Args>
+bool BPTree<T>::emplace(Args&&... args) {
+    std::shared_ptr<T> entry = std::make_shared<T>(std::forward<Args>(args)...);
+    const T& key = *entry;  // kept alive by the tree once inserted
+    T* item = nullptr;
+
+    auto make = [&]() { return std::move(entry); };
+    auto merge = [&](T& found) {
+        if(!_dups_ok) return false;
+
+        found += std::move(*entry);  // append entry
+        return true;
+    };
+
+    return insert_entry(key, make, merge, item);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Insert entry constructed from args into BPTree only when no entry equal
+ *  to key is in the BPTree. One search finds the entry or the position to
+ *  insert; the entry is constructed only when it is inserted.
+ *
+ * PRE-CONDITIONS:
+ *  const U& key  : T or any U where T < U and U < T compare
+ *  Args&&... args: arguments for T's constructor; T(args) compares as key
+ *
+ * POST-CONDITIONS:
+ *  T entry inserted if key is new
+ *  _size inc if successful
+ *
+ * RETURN:
+ *  bool: false if key already exists
+ ******************************************************************************/
+template <typename T>
+template <typename U, typename... Args>
+bool BPTree<T>::try_emplace(const U& key, Args&&... args) {
+    T* item = nullptr;
+
+    auto make = [&]() {
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    };
+    auto merge = [](T& found) {
+        (void)found;
+        return false;
+    };
+
+    return insert_entry(key, make, merge, item);
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Insert entry int BPTree.
@@ -732,22 +1072,62 @@ T& BPTree<T>::get(const T& entry) {
  *  fix_excess can then fix this child, which was formally the parent.
  *
  * PRE-CONDITIONS:
- *  const T& entry: entry item to be inserted
+ *  U&& entry: entry item to be inserted; copied if const T&, else moved
+ *  T*& item : any
  *
  * POST-CONDITIONS:
  *  T entry inserted
  *  _size inc if successful
+ *  T*& item: points to the entry in the BPTree
  *
  * RETURN:
  *  bool
  ******************************************************************************/
 template <typename T>
-bool BPTree<T>::insert(const T& entry) {
+template <typename U>
+bool BPTree<T>::insert_entry(U&& entry, T*& item) {
+    auto make = [&]() {
+        return std::make_shared<T>(std::forward<U>(entry));
+    };
+    auto merge = [&](T& found) {
+        if(!_dups_ok) return false;  // return false on same entry
+
+        found += std::forward<U>(entry);  // append entry
+        return true;
+    };
+
+    return insert_entry(entry, make, merge, item);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Insert an entry found by key into BPTree, as insert_entry above. The new
+ *  entry comes from make() and is only built when key is not found; an
+ *  entry equal to key is passed to merge() instead.
+ *
+ * PRE-CONDITIONS:
+ *  const U& key: compares as the entry to insert
+ *  Make& make  : std::shared_ptr<T>() for a new entry equal to key
+ *  Merge& merge: bool(T& found) adds to found; false if not inserted
+ *  T*& item    : any
+ *
+ * POST-CONDITIONS:
+ *  T entry inserted or merged
+ *  _size inc if a new entry is inserted
+ *  T*& item: points to the new or found entry in the BPTree
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+template <typename U, typename Make, typename Merge>
+bool BPTree<T>::insert_entry(const U& key, Make& make, Merge& merge,
+                             T*& item) {
     using namespace smart_ptr_utils;
 
-    if(loose_insert(entry)) {
+    if(loose_insert(key, make, merge, item)) {
         if(_data_count > _max) {
-            BPTree<T>* new_node = new BPTree<T>(_dups_ok, _min);  // xfer to new
+            BPTree<T>* new_node = make_node();  // xfer to new
 
             // transfer 'this' data/subset to new node's data/subset
             transfer_array(_data, _data_count, new_node->_data,
@@ -794,7 +1174,7 @@ bool BPTree<T>::remove(const T& entry) {
 
     if(loose_remove(entry)) {
         if(_data_count <= 1 && _child_count == 1) {
-            BPTree<T>* pop = _subset[0];  // hold child
+            BPTree<T>* pop = own(_subset[0]);  // hold child
 
             // transfer only child's data/subset back to 'this'
             transfer_array(_subset[0]->_data, _subset[0]->_data_count, _data,
@@ -804,7 +1184,7 @@ bool BPTree<T>::remove(const T& entry) {
             update_size();
 
             pop->_child_count = 0;  // prevent double delete
-            delete pop;
+            destroy_node(pop);
         }
         return true;
     } else
@@ -813,43 +1193,238 @@ bool BPTree<T>::remove(const T& entry) {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Deallocates all heap BPTrees and clear data/subset counts. Reallocate data
- *  and subset.
+ *  Remove all entries in the range [low, high). A few entries are removed one
+ *  at a time. Otherwise, only the leaves from low's leaf to high's leaf are
+ *  trimmed, emptied leaves are unlinked whole and the tree is rebalanced once.
  *
  * PRE-CONDITIONS:
- *  none
+ *  const U& low : inclusive lower bound, T or key comparable with T
+ *  const U& high: exclusive upper bound, T or key comparable with T
  *
  * POST-CONDITIONS:
- *  empty
+ *  entries in [low, high) removed
+ *  _size dec by count removed
  *
  * RETURN:
- *  none
+ *  std::size_t: count of removed entries
  ******************************************************************************/
 template <typename T>
-void BPTree<T>::clear() {
-    deallocate();
-    _data = new std::shared_ptr<T>[_max + 1];
-    _subset = new BPTree<T>*[_max + 2];
+template <typename U>
+std::size_t BPTree<T>::erase_range(const U& low, const U& high) {
+    Iterator first = lower_bound(low), last = first;
+    std::size_t count = 0;
+
+    for(; last && *last < high; ++last) ++count;  // last := first >= high
+
+    if(count * 3 < _size) {  // few entries: remove one at a time
+        std::vector<std::shared_ptr<T>> doomed;
+        for(; first != last; ++first)
+            doomed.push_back(first._it->_data[first._index]);
+        for(const auto& entry : doomed) remove(*entry);
+
+        return count;
+    }
+
+    return remove_if(
+        [&low, &high](const T& entry) {
+            return !(entry < low) && entry < high;
+        },
+        first._it, last._it);
 }
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Checks if entry is contained in BPTree.
+ *  Remove all entries where pred(entry) is true. Every leaf is filtered in
+ *  place, emptied leaves are unlinked whole and the tree is rebalanced once.
  *
  * PRE-CONDITIONS:
- *  const T& entry: target
+ *  Pred pred: callable as bool pred(const T&)
  *
  * POST-CONDITIONS:
- *  none
+ *  entries satisfying pred removed
+ *  _size dec by count removed
  *
  * RETURN:
- *  bool
+ *  std::size_t: count of removed entries
  ******************************************************************************/
 template <typename T>
-bool BPTree<T>::contains(const T& entry) const {
-    // find index of T that's greater or qual to entry
-    std::size_t i = smart_ptr_utils::first_ge(_data, _data_count, entry);
-    bool is_found = (i < _data_count && !(entry < *_data[i]));
+template <typename Pred>
+std::size_t BPTree<T>::erase_if(Pred pred) {
+    return remove_if(pred, get_smallest_node(), nullptr);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Deallocates all heap BPTrees and clear data/subset counts. The root keeps
+ *  its arrays.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  empty
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BPTree<T>::clear() {
+    deallocate();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Swap the root states and node pointers of two BPTrees. Only the roots
+ *  are touched, as no node points back to its root.
+ *
+ * PRE-CONDITIONS:
+ *  BPTree<T>& other: BPTree to swap with
+ *
+ * POST-CONDITIONS:
+ *  'this' and other's states swapped
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BPTree<T>::swap(BPTree<T>& other) {
+    std::swap(_min, other._min);
+    std::swap(_max, other._max);
+    std::swap(_dups_ok, other._dups_ok);
+    std::swap(_size, other._size);
+    std::swap(_data_count, other._data_count);
+    std::swap(_data, other._data);
+    std::swap(_child_count, other._child_count);
+    std::swap(_subset, other._subset);
+    std::swap(_pool, other._pool);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the rank of entry: the count of entries less than entry. One path
+ *  is walked from the root, adding the sizes of the subsets left of it.
+ *
+ * PRE-CONDITIONS:
+ *  const U& entry: target, T or key comparable with T
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count of entries less than entry
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+std::size_t BPTree<T>::rank(const U& entry) const {
+    using namespace smart_ptr_utils;
+
+    const BPTree<T>* walker = this;
+    std::size_t count = 0;
+
+    while(!walker->is_leaf()) {
+        std::size_t i = first_ge(walker->_data, walker->_data_count, entry);
+
+        // key at i is in subset i+1 when equal to entry
+        if(i < walker->_data_count && !(entry < *walker->_data[i])) ++i;
+
+        for(std::size_t j = 0; j < i; ++j) count += walker->_subset[j]->_size;
+        walker = walker->_subset[i];
+    }
+
+    return count + first_ge(walker->_data, walker->_data_count, entry);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the k-th smallest entry, counting from 0. One path is
+ *  walked from the root, skipping the subsets left of the k-th entry.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t k: index of entry in sorted order
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  const BPTree<T>::Iterator: end() when k is out of range
+ ******************************************************************************/
+template <typename T>
+typename BPTree<T>::Iterator BPTree<T>::select(std::size_t k) const {
+    if(k >= _size) return end();
+
+    const BPTree<T>* walker = this;
+
+    while(!walker->is_leaf()) {
+        std::size_t i = 0;
+
+        for(; k >= walker->_subset[i]->_size; ++i)
+            k -= walker->_subset[i]->_size;
+        walker = walker->_subset[i];
+    }
+
+    return BPTree<T>::Iterator(walker, k, this);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the k-th smallest entry, counting from 0.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t k: index of entry in sorted order
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  BPTree<T>::Iterator: end() when k is out of range
+ ******************************************************************************/
+template <typename T>
+typename BPTree<T>::Iterator BPTree<T>::select(std::size_t k) {
+    return static_cast<const BPTree<T>*>(this)->select(k);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the count of entries in the range [low, high) from two ranks. An
+ *  empty or reversed range counts 0.
+ *
+ * PRE-CONDITIONS:
+ *  const U& low : inclusive lower bound, T or key comparable with T
+ *  const U& high: exclusive upper bound, T or key comparable with T
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: count of entries in [low, high)
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+std::size_t BPTree<T>::count_range(const U& low, const U& high) const {
+    std::size_t low_rank = rank(low), high_rank = rank(high);
+
+    return high_rank > low_rank ? high_rank - low_rank : 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if entry is contained in BPTree.
+ *
+ * PRE-CONDITIONS:
+ *  const U& entry: target, T or key comparable with T
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+bool BPTree<T>::contains(const U& entry) const {
+    // find index of T that's greater or qual to entry
+    std::size_t i = smart_ptr_utils::first_ge(_data, _data_count, entry);
+    bool is_found = (i < _data_count && !(entry < *_data[i]));
 
     if(is_leaf()) {
         if(is_found)
@@ -893,123 +1468,348 @@ void BPTree<T>::print(std::ostream& outs, bool debug, int level,
             if(debug) outs << index << ' ';
             outs << '|' << *_data[i] << "|\n";
 
-            if(!is_leaf() && !i) _subset[i]->print(outs, debug, level + 1, i);
-        }
+            if(!is_leaf() && !i) _subset[i]->print(outs, debug, level + 1, i);
+        }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if the internal BPTree's rules are valid.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+bool BPTree<T>::verify() const {
+    bool has_stored_height = false;
+    int height = 0;
+    return verify_tree(height, has_stored_height);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Walk backwards to uniquely copy another BPTree into 'this', so each key
+ *  entry can share the leaf entry of the subset already copied to its right.
+ *  REQUIREMENT: empty 'this'.
+ *
+ * PRE-CONDITIONS:
+ *  const BPTree<T>& other: source BPTree to copy
+ *  'this' BPTree must be EMPTY/cleared before copying!
+ *
+ * POST-CONDITIONS:
+ *  unique copy of other's states
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BPTree<T>::copy(const BPTree<T>& other) {
+    assert(this != &other);
+    assert(empty());
+
+    // copy states
+    _size = other._size;
+    _data_count = other._data_count;
+    _child_count = other._child_count;
+
+    if(is_leaf()) {  // when leaf
+        for(std::size_t i = 0; i < _data_count; ++i)
+            _data[i] = std::make_shared<T>(*other._data[i]);  // make new
+    } else {
+        for(int i = (int)_child_count - 1; i >= 0; --i) {  // copy backwards
+            _subset[i] = make_node();
+            _subset[i]->copy(*other._subset[i]);
+
+            if(i < (int)_data_count)  // link inner node dup to leaf's ptr
+                _data[i] = _subset[i + 1]->find_shared_ptr(*other._data[i]);
+        }
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Releases all subsets, freeing those no other tree shares, and release
+ *  data. Clear data/subset counts.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  empty
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BPTree<T>::deallocate() {
+    for(std::size_t i = 0; i < _child_count; ++i)
+        release_node(_subset[i]);  // destructor recurses into subset
+    for(std::size_t i = 0; i < _data_count; ++i) _data[i].reset();
+
+    _size = 0;
+    _data_count = 0;
+    _child_count = 0;  // must clear child to prevent double delete
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Node constructor. Constructs a node whose arrays follow it in block.
+ *
+ * PRE-CONDITIONS:
+ *  bool dups                 : allows duplicate items.
+ *  std::size_t min           : minimum entries per node
+ *  node_pool::NodePool* pool : tree's pool; nullptr when not pooled
+ *  char* block               : block of block_size() bytes; 'this' is at it
+ *
+ * POST-CONDITIONS:
+ *  initializations
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+BPTree<T>::BPTree(bool dups, std::size_t min, node_pool::NodePool* pool,
+                  char* block)
+    : _min(min),
+      _max(2 * _min),
+      _dups_ok(dups),
+      _size(0),
+      _data_count(0),
+      _data(nullptr),
+      _child_count(0),
+      _subset(nullptr),
+      _refs(1),
+      _pool(pool) {
+    construct_arrays(block);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the offset of the subset array in a block: right after the node.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename T>
+std::size_t BPTree<T>::subset_offset() const {
+    const std::size_t ALIGN = alignof(BPTree<T>*);
+    return (sizeof(BPTree<T>) + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the offset of the data array in a block: after _max+2 subsets.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename T>
+std::size_t BPTree<T>::data_offset() const {
+    const std::size_t ALIGN = alignof(std::shared_ptr<T>);
+    std::size_t end = subset_offset() + (_max + 2) * sizeof(BPTree<T>*);
+    return (end + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the bytes of a block: a node, its subset and its data arrays.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename T>
+std::size_t BPTree<T>::block_size() const {
+    return data_offset() + (_max + 1) * sizeof(std::shared_ptr<T>);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the block holding 'this' arrays. A node made by make_node() is at
+ *  the start of its own block; the root's block is elsewhere.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  char*
+ ******************************************************************************/
+template <typename T>
+char* BPTree<T>::block() const {
+    return reinterpret_cast<char*>(_subset) - subset_offset();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Points subset and data into block and constructs the empty data entries.
+ *
+ * PRE-CONDITIONS:
+ *  char* block: block of block_size() bytes
+ *
+ * POST-CONDITIONS:
+ *  _subset and _data point into block
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BPTree<T>::construct_arrays(char* block) {
+    _subset = reinterpret_cast<BPTree<T>**>(block + subset_offset());
+    _data = reinterpret_cast<std::shared_ptr<T>*>(block + data_offset());
+
+    for(std::size_t i = 0; i <= _max; ++i)
+        new(_data + i) std::shared_ptr<T>();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns a new empty node of this tree. The node and its arrays are built
+ *  in one block, taken from the tree's pool when pooled.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  BPTree<T>*
+ ******************************************************************************/
+template <typename T>
+BPTree<T>* BPTree<T>::make_node() {
+    char* block = static_cast<char*>(_pool ? _pool->allocate()
+                                           : ::operator new(block_size()));
+
+    return new(block) BPTree<T>(_dups_ok, _min, _pool, block);
 }
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Checks if the internal BPTree's rules are valid.
+ *  Destroys a node from make_node() with its subsets, and frees its block.
  *
  * PRE-CONDITIONS:
- *  none
+ *  BPTree<T>* node: node from make_node()
  *
  * POST-CONDITIONS:
- *  none
+ *  node freed
  *
  * RETURN:
- *  bool
+ *  none
  ******************************************************************************/
 template <typename T>
-bool BPTree<T>::verify() const {
-    bool has_stored_height = false;
-    int height = 0;
-    return verify_tree(height, has_stored_height);
+void BPTree<T>::destroy_node(BPTree<T>* node) {
+    node->~BPTree();
+
+    if(_pool)
+        _pool->deallocate(node);
+    else
+        ::operator delete(node);
 }
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Uniquely copies another BPTree's into 'this'. REQUIREMENT: empty 'this'.
- *  This is a wrapper to call the copy() with tree pointer by ref to keep track
- *  of leaf nodes.
+ *  Makes node, a subset of 'this', unshared before it is written. A node held
+ *  by other trees too is replaced with a copy that shares its subsets, so
+ *  only the written path is ever copied.
  *
  * PRE-CONDITIONS:
- *  const BPTree<T>& other: source BPTree to copy
- *  'this' BPTree must be EMPTY/cleared before copying!
+ *  BPTree<T>*& node: subset pointer of 'this'
  *
  * POST-CONDITIONS:
- *  unique copy of other's states
+ *  node is held only by 'this'
  *
  * RETURN:
- *  none
+ *  BPTree<T>*: node
  ******************************************************************************/
 template <typename T>
-void BPTree<T>::copy(const BPTree<T>& other) {
-    assert(this != &other);
-    assert(empty());
+BPTree<T>* BPTree<T>::own(BPTree<T>*& node) {
+    if(node->_refs > 1) {
+        BPTree<T>* shared = node;
 
-    BPTree<T>* next = nullptr;  // to keep track of leaf node by ref
-    copy(other, next);
+        node = make_node();
+        node->share(*shared);
+        release_node(shared);  // other trees still hold it
+    }
+
+    return node;
 }
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Walkbackwards to uniquely copy another BPTree. Update every unique leaf's
- *  _next to ref next (which will keep track of next unique leaf node).
+ *  Copies one node of other into 'this'. A leaf copies its entries; a key
+ *  node shares other's key entries and subsets, adding a ref to each subset.
+ *  Shared nodes are never pooled, as any of their trees may free them.
  *
  * PRE-CONDITIONS:
- *  const BPTree<T>& other: source BPTree to copy
- *  BPTree<T>*& next = nullptr and keep track of next unique leaf node
+ *  const BPTree<T>& other: node to copy
+ *  'this' is empty and not pooled
  *
  * POST-CONDITIONS:
- *  next := the next leaf node
- *  unique copy of other's states
+ *  'this' holds other's entries
  *
  * RETURN:
  *  none
  ******************************************************************************/
 template <typename T>
-void BPTree<T>::copy(const BPTree<T>& other, BPTree<T>*& next) {
-    // copy states
+void BPTree<T>::share(const BPTree<T>& other) {
+    assert(!_pool && !other._pool);
+    assert(empty());
+
     _size = other._size;
     _data_count = other._data_count;
     _child_count = other._child_count;
 
-    if(is_leaf()) {  // when leaf
-        for(std::size_t i = 0; i < _data_count; ++i)
-            _data[i] = std::make_shared<T>(*other._data[i]);  // make new
-
-        _next = next;  // assign this' _next to ref next
-        next = this;   // update ref next to this
-    } else {
-        for(int i = (int)_child_count - 1; i >= 0; --i) {  // copy backwards
-            _subset[i] = new BPTree<T>(other._dups_ok, other._min);
-            _subset[i]->copy(*other._subset[i], next);
-
-            if(i < (int)_data_count)  // link inner node dup to leaf's ptr
-                _data[i] = _subset[i + 1]->find_shared_ptr(*other._data[i]);
-        }
+    for(std::size_t i = 0; i < _data_count; ++i)
+        _data[i] = is_leaf() ? std::make_shared<T>(*other._data[i])
+                             : other._data[i];
+    for(std::size_t i = 0; i < _child_count; ++i) {
+        _subset[i] = other._subset[i];
+        ++_subset[i]->_refs;
     }
 }
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Deallocates all heap BPTrees and clear data/subset counts.
+ *  Drops a parent's ref to node. The last ref destroys node.
  *
  * PRE-CONDITIONS:
- *  none
+ *  BPTree<T>* node: node from make_node()
  *
  * POST-CONDITIONS:
- *  empty
+ *  node freed if no tree holds it
  *
  * RETURN:
  *  none
  ******************************************************************************/
 template <typename T>
-void BPTree<T>::deallocate() {
-    for(std::size_t i = 0; i < _child_count; ++i) {
-        _subset[i]->clear();  // recurse into subset
-        delete _subset[i];
-    }
-    _size = 0;
-    _data_count = 0;
-    _child_count = 0;  // must clear child to prevent double delete
-    _next = nullptr;
-
-    delete[] _data;
-    delete[] _subset;
-    _data = nullptr;    // set to nullptr to prevent double delete
-    _subset = nullptr;  // set to nullptr to prevent double delete
+void BPTree<T>::release_node(BPTree<T>* node) {
+    if(--node->_refs == 0) destroy_node(node);
 }
 
 /*******************************************************************************
@@ -1040,40 +1840,45 @@ void BPTree<T>::update_size() {
  *child when child is over MAX limit.
  *
  * PRE-CONDITIONS:
- *  const T& entry: item to insert
+ *  const U& key: compares as the entry to insert
+ *  Make& make  : std::shared_ptr<T>() for a new entry equal to key
+ *  Merge& merge: bool(T& found) adds to found; false if not inserted
+ *  T*& item    : any
  *
  * POST-CONDITIONS:
- *  none
+ *  T*& item: points to the entry in the BPTree
  *
  * RETURN:
  *  bool
  ******************************************************************************/
 template <typename T>
-bool BPTree<T>::loose_insert(const T& entry) {
-    // find index of T that's greater or qual to entry
-    std::size_t i = smart_ptr_utils::first_ge(_data, _data_count, entry);
-    bool is_found = (i < _data_count && !(entry < *_data[i]));
+template <typename U, typename Make, typename Merge>
+bool BPTree<T>::loose_insert(const U& key, Make& make, Merge& merge,
+                             T*& item) {
+    // find index of T that's greater or qual to key
+    std::size_t i = smart_ptr_utils::first_ge(_data, _data_count, key);
+    bool is_found = (i < _data_count && !(key < *_data[i]));
     bool is_inserted = true;
 
     if(is_leaf()) {
         if(is_found) {
-            if(_dups_ok)
-                *_data[i] += entry;  // append entry
-            else
-                is_inserted = false;  // return false on same entry
+            is_inserted = merge(*_data[i]);
+            item = _data[i].get();
         } else {
-            std::shared_ptr<T> new_entry = std::make_shared<T>(entry);
+            std::shared_ptr<T> new_entry = make();
+            item = new_entry.get();
             smart_ptr_utils::insert_item(_data, i, _data_count,
                                          std::move(new_entry));
         }
     } else {
-        if(is_found) {
-            is_inserted = _subset[i + 1]->loose_insert(entry);  // recurse i+1
+        if(is_found) {  // recurse i+1
+            is_inserted = own(_subset[i + 1])->loose_insert(key, make, merge,
+                                                            item);
 
             // fix child node's over limit
             if(_subset[i + 1]->_data_count > _max) fix_excess(i + 1);
-        } else {
-            is_inserted = _subset[i]->loose_insert(entry);  // !found, recurse i
+        } else {  // !found, recurse i
+            is_inserted = own(_subset[i])->loose_insert(key, make, merge, item);
 
             // fix child node's over limit
             if(_subset[i]->_data_count > _max) fix_excess(i);
@@ -1108,7 +1913,7 @@ void BPTree<T>::fix_excess(std::size_t i) {
     using namespace smart_ptr_utils;
 
     bool is_after_mid = _subset[i]->is_leaf() ? false : true;  // after mid?
-    BPTree<T>* new_node = new BPTree<T>(_dups_ok, _min);       // xfer excess
+    BPTree<T>* new_node = make_node();                         // xfer excess
 
     // move after half of subset[i]'s data to new node's data
     split(_subset[i]->_data, _subset[i]->_data_count, new_node->_data,
@@ -1129,9 +1934,6 @@ void BPTree<T>::fix_excess(std::size_t i) {
     // insert mid back into data[i]; subset[i]'s data_count points to mid
     insert_item(_data, i, _data_count, std::move(mid));
 
-    new_node->_next = _subset[i]->_next;  // update next pointers
-    _subset[i]->_next = new_node;
-
     new_node->update_size();
     _subset[i]->update_size();
 }
@@ -1169,13 +1971,13 @@ bool BPTree<T>::loose_remove(const T& entry) {
             is_removed = false;  // not found @ leaf, then false
     } else {
         if(is_found) {
-            is_removed = _subset[i + 1]->loose_remove(entry);  // recurse i+1
+            is_removed = own(_subset[i + 1])->loose_remove(entry);  // i+1
 
             // fix child's shortage
             if(_subset[i + 1]->_data_count < _min) fix_shortage(i + 1);
             remove_dup_key(entry);
         } else {
-            is_removed = _subset[i]->loose_remove(entry);  // !found, recurse i
+            is_removed = own(_subset[i])->loose_remove(entry);  // !found, i
 
             // fix child's shortage
             if(_subset[i]->_data_count < _min) fix_shortage(i);
@@ -1242,7 +2044,7 @@ void BPTree<T>::remove_dup_key(const T& entry) {
         if(is_found)
             _subset[i + 1]->get_smallest(_data[i]);
         else
-            _subset[i]->remove_dup_key(entry);
+            own(_subset[i])->remove_dup_key(entry);
     }
 }
 
@@ -1274,6 +2076,8 @@ template <typename T>
 void BPTree<T>::rotate_left(std::size_t i) {
     using namespace smart_ptr_utils;
 
+    own(_subset[i]);
+    own(_subset[i + 1]);
     if(_subset[i + 1]->is_leaf()) {
         // move subset[i+1]'s front data to subset[i]'s back
         attach_item(_subset[i]->_data, _subset[i]->_data_count,
@@ -1328,6 +2132,8 @@ template <typename T>
 void BPTree<T>::rotate_right(std::size_t i) {
     using namespace smart_ptr_utils;
 
+    own(_subset[i - 1]);
+    own(_subset[i]);
     if(_subset[i - 1]->is_leaf()) {
         // transfer subset[i-1]'s last data to replace data[i-1] via detach
         detach_item(_subset[i - 1]->_data, _subset[i - 1]->_data_count,
@@ -1363,7 +2169,7 @@ void BPTree<T>::rotate_right(std::size_t i) {
  *  1. If child i is leaf, then delete data[i];
  *     else transfer and append data @ i to child i.
  *  2. Appends entire data/subset of child i+1 to child i.
- *  3. Update child i's next pointer and delete child i+1.
+ *  3. Delete child i+1.
  *
  * PRE-CONDITIONS:
  *  std::size_t i: destintion child
@@ -1379,6 +2185,9 @@ void BPTree<T>::rotate_right(std::size_t i) {
  ******************************************************************************/
 template <typename T>
 void BPTree<T>::merge_with_next_subset(std::size_t i) {
+    own(_subset[i]);
+    own(_subset[i + 1]);
+
     // remove data[i] down to subset[i]'s data via attach
     std::shared_ptr<T> removed;
     smart_ptr_utils::delete_item(_data, i, _data_count, removed);
@@ -1394,16 +2203,287 @@ void BPTree<T>::merge_with_next_subset(std::size_t i) {
                            _subset[i + 1]->_child_count, _subset[i]->_subset,
                            _subset[i]->_child_count);
 
-    _subset[i]->_next = _subset[i + 1]->_next;  // update next pointer
-
     // deallocate empty subset[i+1] and remove subset[i+1] from subset
-    delete _subset[i + 1];
+    destroy_node(_subset[i + 1]);
     smart_ptr_utils::delete_item(_subset, i + 1, _child_count);  // shift left
 
-    // _subset[i]->_next = _subset[i + 1];  // update next pointer
     _subset[i]->update_size();
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Remove leaf entries where pred(entry) is true, checking only the leaves
+ *  from first to last. Nothing is written until a leaf has an entry to
+ *  remove; then only such leaves are unshared and filtered. The surviving
+ *  leaves are kept as they are, except for short leaves that are merged or
+ *  balanced with a neighbor. Then the key entries are rebuilt over the
+ *  leaves once.
+ *
+ * PRE-CONDITIONS:
+ *  Pred pred              : callable as bool pred(const T&)
+ *  const BPTree<T>* first : first leaf to check
+ *  const BPTree<T>* last  : last leaf to check; nullptr checks to the end
+ *
+ * POST-CONDITIONS:
+ *  entries satisfying pred removed
+ *  _size dec by count removed
+ *
+ * RETURN:
+ *  std::size_t: count of removed entries
+ ******************************************************************************/
+template <typename T>
+template <typename Pred>
+std::size_t BPTree<T>::remove_if(Pred pred, const BPTree<T>* first,
+                                 const BPTree<T>* last) {
+    std::size_t size = _size;
+
+    if(is_leaf()) {  // root is the only leaf
+        remove_in_leaf(pred, first_of(pred));
+        return size - _size;
+    }
+
+    std::vector<BPTree<T>*> leaves, kept;
+    std::size_t k = 0;
+    bool is_changed = false;
+
+    get_leaves(leaves);
+    while(k < leaves.size() && leaves[k] != first) ++k;
+
+    for(; k < leaves.size(); ++k) {
+        std::size_t i = leaves[k]->first_of(pred);
+
+        if(i < leaves[k]->_data_count) {
+            if(!is_changed) {  // hold the leaves; delete key nodes only
+                for(BPTree<T>* leaf : leaves) ++leaf->_refs;
+                clear();
+                is_changed = true;
+            }
+            own(leaves[k])->remove_in_leaf(pred, i);
+        }
+
+        if(leaves[k] == last) break;
+    }
+
+    if(!is_changed) return 0;  // no leaf changed
+
+    for(BPTree<T>*& leaf : leaves) {
+        if(!leaf->_data_count ||
+           (!kept.empty() && (kept.back()->_data_count < _min ||
+                              leaf->_data_count < _min) &&
+            !balance_leaves(own(kept.back()), own(leaf))))
+            release_node(leaf);  // emptied or merged into previous leaf
+        else
+            kept.push_back(leaf);
+    }
+
+    if(kept.size() > 1 && kept.back()->_data_count < _min &&
+       !balance_leaves(own(kept[kept.size() - 2]), own(kept.back()))) {
+        release_node(kept.back());
+        kept.pop_back();
+    }
+
+    build(kept);
+    return size - _size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the index of the first entry of 'this' leaf where pred(entry) is
+ *  true, without changing the leaf.
+ *
+ * PRE-CONDITIONS:
+ *  Pred pred: callable as bool pred(const T&)
+ *  'this' is a leaf
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: _data_count when no entry matches
+ ******************************************************************************/
+template <typename T>
+template <typename Pred>
+std::size_t BPTree<T>::first_of(Pred pred) const {
+    std::size_t i = 0;
+
+    while(i < _data_count && !pred(static_cast<const T&>(*_data[i]))) ++i;
+
+    return i;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Remove the entries of 'this' leaf where pred(entry) is true, keeping the
+ *  order of the rest. Entries before i are kept and entry i is removed, as
+ *  first_of() already checked them.
+ *
+ * PRE-CONDITIONS:
+ *  Pred pred    : callable as bool pred(const T&)
+ *  std::size_t i: first_of(pred)
+ *  'this' is a leaf
+ *
+ * POST-CONDITIONS:
+ *  entries satisfying pred removed
+ *  _size updated
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+template <typename Pred>
+void BPTree<T>::remove_in_leaf(Pred pred, std::size_t i) {
+    std::size_t kept = i;
+
+    for(++i; i < _data_count; ++i)
+        if(!pred(static_cast<const T&>(*_data[i])))
+            std::swap(_data[kept++], _data[i]);
+
+    while(_data_count > kept) _data[--_data_count].reset();
+    update_size();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Appends the leaves of 'this' to leaves, from the smallest.
+ *
+ * PRE-CONDITIONS:
+ *  std::vector<BPTree<T>*>& leaves: any
+ *
+ * POST-CONDITIONS:
+ *  leaves appended
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BPTree<T>::get_leaves(std::vector<BPTree<T>*>& leaves) {
+    if(is_leaf())
+        leaves.push_back(this);
+    else
+        for(std::size_t i = 0; i < _child_count; ++i)
+            _subset[i]->get_leaves(leaves);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Fix two neighboring leaves when either is short. If both fit in one leaf,
+ *  right's entries are appended to left. Otherwise, the entries are split
+ *  evenly, so each leaf has at least _min entries.
+ *
+ * PRE-CONDITIONS:
+ *  BPTree<T>* left : leaf
+ *  BPTree<T>* right: leaf after left
+ *
+ * POST-CONDITIONS:
+ *  left and right balanced, or right is empty
+ *
+ * RETURN:
+ *  bool: false when right is merged into left
+ ******************************************************************************/
+template <typename T>
+bool BPTree<T>::balance_leaves(BPTree<T>* left, BPTree<T>* right) {
+    using namespace smart_ptr_utils;
+
+    std::size_t total = left->_data_count + right->_data_count;
+
+    if(total <= _max) {
+        merge(right->_data, right->_data_count, left->_data, left->_data_count);
+        left->update_size();
+        return false;
+    }
+
+    std::size_t half = total / 2, shift = 0;
+
+    if(left->_data_count < half) {  // move right's front to left
+        shift = half - left->_data_count;
+        for(std::size_t i = 0; i < right->_data_count; ++i)
+            if(i < shift)
+                left->_data[left->_data_count++] = std::move(right->_data[i]);
+            else
+                right->_data[i - shift] = std::move(right->_data[i]);
+        right->_data_count -= shift;
+    } else {  // move left's back to right
+        shift = left->_data_count - half;
+        for(std::size_t i = right->_data_count; i-- > 0;)
+            right->_data[i + shift] = std::move(right->_data[i]);
+        for(std::size_t i = 0; i < shift; ++i)
+            right->_data[i] = std::move(left->_data[half + i]);
+        left->_data_count = half;
+        right->_data_count += shift;
+    }
+
+    left->update_size();
+    right->update_size();
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Rebuild 'this' as the root over sorted, non-short leaves, bottom up.
+ *  Nodes are spread evenly over the fewest parents of at most _max+1
+ *  children, so every key node holds at least _min entries. Each key entry
+ *  shares the smallest leaf entry of the subset to its right.
+ *
+ * PRE-CONDITIONS:
+ *  std::vector<BPTree<T>*>& leaves: leaves in order; caller holds a ref
+ *  'this' is cleared
+ *
+ * POST-CONDITIONS:
+ *  leaves held by 'this'
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BPTree<T>::build(std::vector<BPTree<T>*>& leaves) {
+    using namespace smart_ptr_utils;
+
+    if(leaves.size() == 1) {  // root is the only leaf
+        own(leaves[0]);
+        transfer_array(leaves[0]->_data, leaves[0]->_data_count, _data,
+                       _data_count);
+        update_size();
+        destroy_node(leaves[0]);
+        return;
+    }
+
+    std::vector<BPTree<T>*> nodes;             // current level's nodes
+    std::vector<std::shared_ptr<T>> smallest;  // smallest entry per node
+
+    for(std::size_t k = 0; k < leaves.size(); ++k) {
+        nodes.push_back(leaves[k]);
+        smallest.push_back(leaves[k]->_data[0]);
+    }
+
+    while(nodes.size() > _max + 1) {  // build key levels
+        std::vector<BPTree<T>*> parents;
+        std::vector<std::shared_ptr<T>> parents_smallest;
+        std::size_t n = nodes.size(), count = (n + _max) / (_max + 1);
+
+        for(std::size_t i = 0, k = 0; i < count; ++i) {
+            BPTree<T>* parent = make_node();
+            std::size_t end = k + n / count + (i < n % count);
+
+            parents_smallest.push_back(smallest[k]);
+            while(k < end) {
+                if(parent->_child_count)
+                    parent->_data[parent->_data_count++] = smallest[k];
+                parent->_subset[parent->_child_count++] = nodes[k++];
+            }
+            parent->update_size();
+            parents.push_back(parent);
+        }
+        nodes.swap(parents);
+        smallest.swap(parents_smallest);
+    }
+
+    for(std::size_t k = 0; k < nodes.size(); ++k) {  // 'this' is the root
+        if(k) _data[_data_count++] = smallest[k];
+        _subset[_child_count++] = nodes[k];
+    }
+    update_size();
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Return pointer to smallest item @ leaf node.
@@ -1488,6 +2568,82 @@ BPTree<T>* BPTree<T>::get_largest_node() {
         return _subset[_child_count - 1]->get_largest_node();
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the leaf after leaf in 'this' tree. Leaves are not chained, as a
+ *  shared leaf has a different next leaf in each tree. The iterator keeps
+ *  leaf's lowest ancestors, so the next leaf is usually found by climbing
+ *  them. Otherwise, one path is walked from the root by leaf's last entry,
+ *  turning right at the deepest node with a subset right of the path.
+ *
+ * PRE-CONDITIONS:
+ *  const BPTree<T>* leaf: non-empty leaf of 'this' tree
+ *  const BPTree<T>** up : leaf's ancestors from its parent; Iterator::LEVELS
+ *  std::size_t* at      : at[k] is the index taken in up[k]
+ *  std::size_t& levels  : count of ancestors known; 0 if none
+ *
+ * POST-CONDITIONS:
+ *  up, at and levels hold the next leaf's ancestors
+ *
+ * RETURN:
+ *  const BPTree<T>*: nullptr when leaf is the last
+ ******************************************************************************/
+template <typename T>
+const BPTree<T>* BPTree<T>::next_leaf(const BPTree<T>* leaf,
+                                      const BPTree<T>** up, std::size_t* at,
+                                      std::size_t& levels) const {
+    using namespace smart_ptr_utils;
+
+    const std::size_t HEIGHT = 64;  // a node has at least 2 subsets
+    const BPTree<T>* path[HEIGHT];  // nodes from the root
+    std::size_t index[HEIGHT];      // index taken in each node
+    const BPTree<T>* walker = this;
+    std::size_t k = 0, depth = 0, turn = HEIGHT;
+
+    // climb the known ancestors to one with a subset right of the path
+    while(k < levels && at[k] + 1 >= up[k]->_child_count) ++k;
+    if(k < levels) {
+        walker = up[k]->_subset[++at[k]];
+        while(k-- > 0) {  // down its left side
+            up[k] = walker;
+            at[k] = 0;
+            walker = walker->_subset[0];
+        }
+        return walker;
+    }
+
+    const T& last = *leaf->_data[leaf->_data_count - 1];
+
+    for(; !walker->is_leaf(); ++depth) {
+        std::size_t i = first_ge(walker->_data, walker->_data_count, last);
+
+        // key at i is in subset i+1 when equal to last
+        if(i < walker->_data_count && !(last < *walker->_data[i])) ++i;
+
+        if(i + 1 < walker->_child_count) turn = depth;
+        path[depth] = walker;
+        index[depth] = i;
+        walker = walker->_subset[i];
+    }
+
+    levels = 0;
+    if(turn == HEIGHT) return nullptr;
+
+    walker = path[turn]->_subset[++index[turn]];
+    for(depth = turn + 1; !walker->is_leaf(); ++depth) {  // down left side
+        path[depth] = walker;
+        index[depth] = 0;
+        walker = walker->_subset[0];
+    }
+
+    for(; levels < Iterator::LEVELS && levels < depth; ++levels) {
+        up[levels] = path[depth - 1 - levels];
+        at[levels] = index[depth - 1 - levels];
+    }
+
+    return walker;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Return by reference the smallest item @ leaf node.
@@ -1532,30 +2688,96 @@ void BPTree<T>::get_largest(std::shared_ptr<T>& entry) {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Recursively goes into BPTree and removes the largest item and calls
- *  fix_shortage on the way out of recursion.
+ *  Recursively goes into BPTree and removes the largest item and calls
+ *  fix_shortage on the way out of recursion.
+ *
+ * PRE-CONDITIONS:
+ *  T& entry: entry to hold removed item
+ *
+ * POST-CONDITIONS:
+ *  T& entry: set to removed item
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BPTree<T>::remove_largest(std::shared_ptr<T>& entry) {
+    if(is_leaf())
+        smart_ptr_utils::detach_item(_data, _data_count, entry);
+    else {
+        own(_subset[_child_count - 1])->remove_largest(entry);
+
+        // fix child's shortage
+        if(_subset[_child_count - 1]->_data_count < _min)
+            fix_shortage(_child_count - 1);
+    }
+    update_size();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the leaf where entry is or would be inserted. One path is walked
+ *  from the root.
+ *
+ * PRE-CONDITIONS:
+ *  const U& entry: target, T or key comparable with T
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  const BPTree<T>*
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+const BPTree<T>* BPTree<T>::find_leaf(const U& entry) const {
+    using namespace smart_ptr_utils;
+
+    const BPTree<T>* walker = this;
+
+    while(!walker->is_leaf()) {
+        std::size_t i = first_ge(walker->_data, walker->_data_count, entry);
+
+        // key at i is in subset i+1 when equal to entry
+        if(i < walker->_data_count && !(entry < *walker->_data[i])) ++i;
+
+        walker = walker->_subset[i];
+    }
+
+    return walker;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the leaf where entry is or would be inserted. Shared nodes on the
+ *  path are copied on the way down, so the leaf can be written.
  *
  * PRE-CONDITIONS:
- *  T& entry: entry to hold removed item
+ *  const U& entry: target, T or key comparable with T
  *
  * POST-CONDITIONS:
- *  T& entry: set to removed item
+ *  path to the leaf is not shared
  *
  * RETURN:
- *  none
+ *  BPTree<T>*
  ******************************************************************************/
 template <typename T>
-void BPTree<T>::remove_largest(std::shared_ptr<T>& entry) {
-    if(is_leaf())
-        smart_ptr_utils::detach_item(_data, _data_count, entry);
-    else {
-        _subset[_child_count - 1]->remove_largest(entry);
+template <typename U>
+BPTree<T>* BPTree<T>::find_leaf(const U& entry) {
+    using namespace smart_ptr_utils;
 
-        // fix child's shortage
-        if(_subset[_child_count - 1]->_data_count < _min)
-            fix_shortage(_child_count - 1);
+    BPTree<T>* walker = this;
+
+    while(!walker->is_leaf()) {
+        std::size_t i = first_ge(walker->_data, walker->_data_count, entry);
+
+        // key at i is in subset i+1 when equal to entry
+        if(i < walker->_data_count && !(entry < *walker->_data[i])) ++i;
+
+        walker = walker->own(walker->_subset[i]);
     }
-    update_size();
+
+    return walker;
 }
 
 /*******************************************************************************
@@ -1564,7 +2786,7 @@ void BPTree<T>::remove_largest(std::shared_ptr<T>& entry) {
  *  found, then nullptr.
  *
  * PRE-CONDITIONS:
- *  const T& entry: item to find
+ *  const U& entry: item to find, T or key comparable with T
  *
  * POST-CONDITIONS:
  *  none
@@ -1573,55 +2795,48 @@ void BPTree<T>::remove_largest(std::shared_ptr<T>& entry) {
  *  const T*
  ******************************************************************************/
 template <typename T>
-const T* BPTree<T>::find_ptr(const T& entry) const {
+template <typename U>
+const T* BPTree<T>::find_ptr(const U& entry) const {
+    const BPTree<T>* leaf = find_leaf(entry);
+
     // find index of T that's greater or qual to entry
-    std::size_t i = smart_ptr_utils::first_ge(_data, _data_count, entry);
-    bool is_found = (i < _data_count && !(entry < *_data[i]));
+    std::size_t i = smart_ptr_utils::first_ge(leaf->_data, leaf->_data_count,
+                                              entry);
 
-    if(is_leaf()) {
-        if(is_found)
-            return &(*_data[i]);
-        else
-            return nullptr;
-    } else {                                         // @ !leaf
-        if(is_found)                                 // when found
-            return _subset[i + 1]->find_ptr(entry);  // recurse i+1
-        else                                         // when !found
-            return _subset[i]->find_ptr(entry);      // recurse to find entry
-    }
+    if(i < leaf->_data_count && !(entry < *leaf->_data[i]))
+        return &(*leaf->_data[i]);
+    else
+        return nullptr;
 }
 
 /*******************************************************************************
  * DESCRIPTION:
  *  Returns the pointer to entry contained in the tree. If the entry is not
- *  found, then nullptr.
+ *  found, then nullptr. Shared nodes on the path are copied first, so the
+ *  entry can be written.
  *
  * PRE-CONDITIONS:
- *  const T& entry: item to find
+ *  const U& entry: item to find, T or key comparable with T
  *
  * POST-CONDITIONS:
- *  none
+ *  path to entry's leaf is not shared
  *
  * RETURN:
  *  T*
  ******************************************************************************/
 template <typename T>
-T* BPTree<T>::find_ptr(const T& entry) {
+template <typename U>
+T* BPTree<T>::find_ptr(const U& entry) {
+    BPTree<T>* leaf = find_leaf(entry);
+
     // find index of T that's greater or qual to entry
-    std::size_t i = smart_ptr_utils::first_ge(_data, _data_count, entry);
-    bool is_found = (i < _data_count && !(entry < *_data[i]));
+    std::size_t i = smart_ptr_utils::first_ge(leaf->_data, leaf->_data_count,
+                                              entry);
 
-    if(is_leaf()) {
-        if(is_found)
-            return &(*_data[i]);
-        else
-            return nullptr;
-    } else {                                         // @ !leaf
-        if(is_found)                                 // when found
-            return _subset[i + 1]->find_ptr(entry);  // recurse i+1
-        else                                         // when !found
-            return _subset[i]->find_ptr(entry);      // recurse to find entry
-    }
+    if(i < leaf->_data_count && !(entry < *leaf->_data[i]))
+        return &(*leaf->_data[i]);
+    else
+        return nullptr;
 }
 
 /*******************************************************************************
@@ -1699,6 +2914,11 @@ bool BPTree<T>::verify_tree(int& height, bool& has_stored_height,
         if(_child_count > _max + 1 || _child_count != _data_count + 1)
             return false;
 
+        // verify size is the sum of subset sizes
+        std::size_t size = 0;
+        for(std::size_t i = 0; i < _child_count; ++i) size += _subset[i]->_size;
+        if(size != _size) return false;
+
         for(std::size_t i = 0; i < _child_count; ++i) {
             if(i + 1 < _child_count) {
                 // verify that data[i] exists in one of the subset
@@ -1715,6 +2935,8 @@ bool BPTree<T>::verify_tree(int& height, bool& has_stored_height,
                 return false;
         }
     } else {
+        if(_size != _data_count) return false;  // verify leaf size
+
         if(!has_stored_height) {  // store child height for the first time
             height = level;
             has_stored_height = true;
@@ -1778,6 +3000,315 @@ bool BPTree<T>::is_le_subset(const BPTree<T>* subtree,
     return true;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Unshares the path to the entry for writing. own() calls it on the first
+ *  access after the owner was copied, or on a new leaf; later accesses on
+ *  the same leaf are free. A const iterator never copies.
+ *
+ * PRE-CONDITIONS:
+ *  _owner and _it are set
+ *
+ * POST-CONDITIONS:
+ *  path to the entry is not shared
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void CowBPTree<T>::Iterator::unshare() {
+    _it = _owner->own_path(_it);
+    _owned = leaf_of(_it);
+    _epoch = _owner->_epoch;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Copy constructor. Shares src's tree in O(1). Both epochs move on, so
+ *  iterators of src unshare their path again before the next write.
+ *
+ * PRE-CONDITIONS:
+ *  const CowBPTree<T>& src: source handle
+ *
+ * POST-CONDITIONS:
+ *  'this' shares src's tree
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+CowBPTree<T>::CowBPTree(const CowBPTree<T>& src)
+    : _tree(src._tree), _epoch(++src._epoch) {}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Copy assignment operator. Shares rhs's tree in O(1).
+ *
+ * PRE-CONDITIONS:
+ *  const CowBPTree<T>& rhs: source handle
+ *
+ * POST-CONDITIONS:
+ *  'this' shares rhs's tree
+ *
+ * RETURN:
+ *  *this
+ ******************************************************************************/
+template <typename T>
+CowBPTree<T>& CowBPTree<T>::operator=(const CowBPTree<T>& rhs) {
+    if(this != &rhs) {
+        _tree = rhs._tree;
+        ++_epoch;
+        ++rhs._epoch;
+    }
+    return *this;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Move constructor. Takes src's tree and its epoch; src is left with an
+ *  empty tree of the same dups and min.
+ *
+ * PRE-CONDITIONS:
+ *  CowBPTree<T>&& src: source handle
+ *
+ * POST-CONDITIONS:
+ *  src is empty
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+CowBPTree<T>::CowBPTree(CowBPTree<T>&& src)
+    : _tree(src.make_empty()), _epoch(0) {
+    std::swap(_tree, src._tree);
+    std::swap(_epoch, src._epoch);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Move assignment operator. Takes rhs's tree and its epoch; rhs is left
+ *  with an empty tree of the same dups and min.
+ *
+ * PRE-CONDITIONS:
+ *  CowBPTree<T>&& rhs: source handle
+ *
+ * POST-CONDITIONS:
+ *  rhs is empty
+ *
+ * RETURN:
+ *  *this
+ ******************************************************************************/
+template <typename T>
+CowBPTree<T>& CowBPTree<T>::operator=(CowBPTree<T>&& rhs) {
+    if(this != &rhs) {
+        _tree = rhs.make_empty();
+        _epoch = 0;
+        std::swap(_tree, rhs._tree);
+        std::swap(_epoch, rhs._epoch);
+    }
+    return *this;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Points to left most element in tree, for writing.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  CowBPTree<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+typename CowBPTree<T>::Iterator CowBPTree<T>::begin() {
+    return Iterator(_tree->begin(), this);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Points to nullptr.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  CowBPTree<T>::Iterator: points to nullptr
+ ******************************************************************************/
+template <typename T>
+typename CowBPTree<T>::Iterator CowBPTree<T>::end() {
+    return Iterator();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Return iterator to entry for writing; else iterator points to nullptr.
+ *
+ * PRE-CONDITIONS:
+ *  const U& entry: target, T or key comparable with T
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  CowBPTree<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+typename CowBPTree<T>::Iterator CowBPTree<T>::find(const U& entry) {
+    return Iterator(_tree->find(entry), this);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Return iterator to the first entry not less than entry, for writing.
+ *
+ * PRE-CONDITIONS:
+ *  const U& entry: target, T or key comparable with T
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  CowBPTree<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+typename CowBPTree<T>::Iterator CowBPTree<T>::lower_bound(const U& entry) {
+    return Iterator(_tree->lower_bound(entry), this);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Return iterator to the first entry greater than entry, for writing.
+ *
+ * PRE-CONDITIONS:
+ *  const U& entry: target, T or key comparable with T
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  CowBPTree<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+typename CowBPTree<T>::Iterator CowBPTree<T>::upper_bound(const U& entry) {
+    return Iterator(_tree->upper_bound(entry), this);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the k-th smallest entry for writing, counting from 0.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t k: index of entry in sorted order
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  CowBPTree<T>::Iterator: end() when k is out of range
+ ******************************************************************************/
+template <typename T>
+typename CowBPTree<T>::Iterator CowBPTree<T>::select(std::size_t k) {
+    return Iterator(_tree->select(k), this);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the tree for writing. When other copies share the root, 'this'
+ *  first takes its own root, which shares the root's subsets. Writes then
+ *  copy only the shared nodes on their path, so the others keep their view
+ *  unchanged.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  root is not shared
+ *
+ * RETURN:
+ *  BPTree<T>&
+ ******************************************************************************/
+template <typename T>
+BPTree<T>& CowBPTree<T>::write() {
+    if(is_shared()) {
+        std::shared_ptr<BPTree<T>> tree = make_empty();
+
+        tree->share(*_tree);
+        _tree = tree;
+    }
+
+    return *_tree;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Empties the tree. A shared root is left to the other copies and replaced
+ *  by an empty one; shared nodes only lose a ref.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  tree is empty and not shared
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void CowBPTree<T>::clear() {
+    if(is_shared())
+        _tree = make_empty();
+    else
+        _tree->clear();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns a new empty tree with the dups and min of 'this' tree.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::shared_ptr<BPTree<T>>
+ ******************************************************************************/
+template <typename T>
+std::shared_ptr<BPTree<T>> CowBPTree<T>::make_empty() const {
+    return std::make_shared<BPTree<T>>(_tree->_dups_ok, _tree->_min);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns it, moved to the same entry in the written tree after the path
+ *  to its leaf is unshared. The leaf keeps its layout, so the index holds.
+ *
+ * PRE-CONDITIONS:
+ *  TreeIter it: entry of 'this' tree, or of a tree it shared before write()
+ *
+ * POST-CONDITIONS:
+ *  root and path to the entry are not shared
+ *
+ * RETURN:
+ *  TreeIter
+ ******************************************************************************/
+template <typename T>
+typename CowBPTree<T>::TreeIter CowBPTree<T>::own_path(TreeIter it) {
+    BPTree<T>& tree = write();
+
+    return TreeIter(tree.find_leaf(*it), it._index, &tree);
+}
+
 }  // namespace bptree
 
 #endif  // BPTREE_H
@@ -6,6 +6,8 @@
  * DESCRIPTION : This header defines a templated BST (Binary Search Tree).
  *      Insertions and erasures of TreeNodes will not guarantee a full or
  *      complete binary tree.
+ *      Iterators walk the items in order; they are invalidated by insert
+ *      and erase.
  ******************************************************************************/
 #ifndef BST_H
 #define BST_H
@@ -18,6 +20,8 @@ namespace bst {
 template <typename T>
 class BST {
 public:
+    typedef bst_node::TreeIterator<T> Iterator;  // inorder iterator
+
     // CONSTRUCTORS
     BST() : _root(nullptr) {}
     BST(const T* sorted_list, int size = -1);  // with array of sorted items
@@ -30,10 +34,14 @@ public:
     // ACCESSORS
     bool empty() const;
     T& front() const;
+    Iterator begin() const;  // smallest item
+    Iterator end() const;
     const bst_node::TreeNode<T>* root() const;
     bool search(const T& target, bst_node::TreeNode<T>*& found_ptr) const;
 
     // MUTATORS
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last);  // bulk build, any order
     void clear();
     bool erase(const T& target);
     bool insert(const T& insert_me);
@@ -171,6 +179,42 @@ T& BST<T>::front() const {
     return _root->_item;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an inorder Iterator to the smallest item.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  BST<T>::Iterator: end() if empty
+ ******************************************************************************/
+template <typename T>
+typename BST<T>::Iterator BST<T>::begin() const {
+    return Iterator(_root);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the Iterator past the largest item.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  BST<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+typename BST<T>::Iterator BST<T>::end() const {
+    return Iterator();
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Returns access to copy BST's root.
@@ -208,6 +252,32 @@ bool BST<T>::search(const T& target, bst_node::TreeNode<T>*& found_ptr) const {
     return bst_node::tree_search(_root, target, found_ptr);
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Replaces all items with the items in [first, last), in any order, and
+ *  builds a full or complete binary tree in one pass, with no per-item
+ *  search or rotations. Duplicates are dropped, keeping the first.
+ *
+ * PRE-CONDITIONS:
+ *  InputIt first: iterator to the first item
+ *  InputIt last : iterator past the last item
+ *
+ * POST-CONDITIONS:
+ *  TreeNode<T>* _root: old nodes deallocated; new nodes allocated
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+template <typename InputIt>
+void BST<T>::assign(InputIt first, InputIt last) {
+    std::vector<T> items(first, last);
+    bst_node::TreeNode<T>* root = bst_node::tree_from_unsorted_list(items);
+
+    bst_node::tree_clear(_root);
+    _root = root;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Deallocates all nodes linked to _root.
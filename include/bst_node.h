@@ -6,13 +6,25 @@
  * DESCRIPTION : This header defines a templated binary search tree node and
  *      templated functions that will process the nodes. These functions are
  *      the base to build the binary search tree class BST.
+ *
+ *      Insert, erase, search, clear, copy and the traversals are iterative,
+ *      so a degenerate (linked list shaped) tree of any height never
+ *      overflows the call stack. Insert and erase keep the path of links
+ *      they walked down, then update heights and rotate back up it.
+ *      Traversals keep an explicit stack of links on the heap, and pass f
+ *      the link to each node just as a recursive traversal would.
+ *      TreeIterator walks a tree in order with a stack of ancestors.
  ******************************************************************************/
 #ifndef BST_NODE_H
 #define BST_NODE_H
 
 #include <algorithm>  // max()
+#include <algorithm>  // is_sorted(), stable_sort(), unique()
 #include <iostream>   // stream objects
+#include <stdexcept>  // invalid_argument
 #include <string>     // string objects
+#include <utility>    // pair
+#include <vector>     // vector
 
 namespace bst_node {
 
@@ -42,6 +54,61 @@ struct TreeNode {
     }
 };
 
+template <typename T>
+class TreeIterator {
+public:
+    // CONSTRUCTOR
+    TreeIterator(TreeNode<T>* root = nullptr) : _stack() { push_left(root); }
+
+    bool is_null() { return _stack.empty(); }
+    explicit operator bool() { return !_stack.empty(); }
+
+    T& operator*() {
+        if(_stack.empty())
+            throw std::invalid_argument("TreeIterator - nullptr check");
+
+        return _stack.back()->_item;
+    }
+
+    T* operator->() { return &operator*(); }
+
+    TreeIterator& operator++() {  // pre-inc
+        if(!_stack.empty()) {
+            TreeNode<T>* right = _stack.back()->_right;
+            _stack.pop_back();
+            push_left(right);  // next is leftmost of right subtree, if any
+        }
+        return *this;
+    }
+
+    TreeIterator operator++(int _u) {  // post-inc
+        (void)_u;                      // suppress unused warning
+        TreeIterator it = *this;       // make temp
+        operator++();                  // pre-inc
+        return it;                     // return previous state
+    }
+
+    // FRIENDS
+    friend bool operator==(const TreeIterator& lhs, const TreeIterator& rhs) {
+        if(lhs._stack.empty() || rhs._stack.empty())
+            return lhs._stack.empty() == rhs._stack.empty();
+
+        return lhs._stack.back() == rhs._stack.back();
+    }
+
+    friend bool operator!=(const TreeIterator& lhs, const TreeIterator& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    std::vector<TreeNode<T>*> _stack;  // current node on top, then ancestors
+                                       // whose items are still ahead
+
+    void push_left(TreeNode<T>* node) {
+        for(; node; node = node->_left) _stack.push_back(node);
+    }
+};
+
 template <typename T>  // add a node in the binary tree
 bool tree_insert(TreeNode<T>*& root, const T& target, bool balance = false);
 
@@ -84,6 +151,26 @@ void tree_add(TreeNode<T>*& dest, const TreeNode<T>* src, bool balance = false);
 template <typename T>  // sorted array -> tree
 TreeNode<T>* tree_from_sorted_list(const T* a, int size);
 
+template <typename T>  // unsorted items -> sorted, deduped items -> tree
+TreeNode<T>* tree_from_unsorted_list(std::vector<T>& items);
+
+template <typename T>  // height of a tree, -1 when empty
+int tree_height(const TreeNode<T>* root);
+
+template <typename T>  // left < mid < right -> balanced tree
+TreeNode<T>* tree_join(TreeNode<T>* left, TreeNode<T>* mid,
+                       TreeNode<T>* right);
+
+template <typename T>  // left < right -> balanced tree
+TreeNode<T>* tree_join(TreeNode<T>* left, TreeNode<T>* right);
+
+template <typename T>  // tree -> items < key, node == key, items > key
+void tree_split(TreeNode<T>* root, const T& key, TreeNode<T>*& left,
+                TreeNode<T>*& found, TreeNode<T>*& right);
+
+template <typename T>  // set union of two balanced trees
+TreeNode<T>* tree_union(TreeNode<T>* a, TreeNode<T>* b);
+
 template <typename T>  // root becomes child of left node
 TreeNode<T>* rotate_left(TreeNode<T>*& root);
 
@@ -93,6 +180,9 @@ TreeNode<T>* rotate_right(TreeNode<T>*& root);
 template <typename T>  // decide which rotate is needed based on balance factor
 TreeNode<T>* rotate(TreeNode<T>*& root);
 
+template <typename T>  // update heights and rotate up a path of links
+void tree_rebalance(std::vector<TreeNode<T>**>& path, bool balance = false);
+
 template <typename T, typename F>  // traversal of node with function pointer
 void inorder(TreeNode<T>*& root, F f);
 
@@ -171,6 +261,8 @@ int TreeNode<T>::update_height() {
  * DESCRIPTION:
  *  Inserts an unique node in ascending order. If balance is true, will rotate
  *  tree to full or complete binary tree.
+ *  Mechanism: Walk down from root, keeping the links passed, to the empty
+ *             link target belongs in. Then rebalance back up the links.
  *
  * PRE-CONDITIONS:
  *  TreeNode<T>*& root: root by reference
@@ -185,20 +277,24 @@ int TreeNode<T>::update_height() {
  ******************************************************************************/
 template <typename T>
 bool tree_insert(TreeNode<T>*& root, const T& target, bool balance) {
-    bool is_insert = false;
-
-    if(!root) {
-        root = new TreeNode<T>(target);
-        is_insert = true;
-    } else if(target < root->_item)
-        is_insert = tree_insert(root->_left, target, balance);  // --> left
-    else if(target > root->_item)
-        is_insert = tree_insert(root->_right, target, balance);  // --> right
+    std::vector<TreeNode<T>**> path;
+    TreeNode<T>** link = &root;
+
+    while(*link) {
+        path.push_back(link);
+
+        if(target < (*link)->_item)
+            link = &(*link)->_left;  // --> left
+        else if(target > (*link)->_item)
+            link = &(*link)->_right;  // --> right
+        else
+            return false;  // duplicate: tree is unchanged
+    }
 
-    root->update_height();
-    if(balance) root = rotate(root);
+    *link = new TreeNode<T>(target);
+    tree_rebalance(path, balance);
 
-    return is_insert;
+    return true;
 }
 
 /*******************************************************************************
@@ -220,23 +316,27 @@ bool tree_insert(TreeNode<T>*& root, const T& target, bool balance) {
  ******************************************************************************/
 template <typename T>
 void tree_reinsert(TreeNode<T>*& root, const T& target, bool balance) {
-    if(!root)
-        root = new TreeNode<T>(target);
-    else if(target == root->_item)
-        root->_item = target;
-    else if(target < root->_item)
-        tree_insert(root->_left, target, balance);  // --> left
-    else if(target > root->_item)
-        tree_insert(root->_right, target, balance);  // --> right
+    std::vector<TreeNode<T>**> path;
+    TreeNode<T>** link = &root;
+
+    while(*link) {
+        if(target == (*link)->_item) {
+            (*link)->_item = target;  // replace in place: shape is unchanged
+            return;
+        }
+
+        path.push_back(link);
+        link = target < (*link)->_item ? &(*link)->_left : &(*link)->_right;
+    }
 
-    root->update_height();
-    if(balance) root = rotate(root);
+    *link = new TreeNode<T>(target);
+    tree_rebalance(path, balance);
 }
 
 /*******************************************************************************
  * DESCRIPTION:
  *  Searches root node for given target. Search failure returns nullptr, else
- *  returns target node.
+ *  returns target node. Iterative walk down from root.
  *
  * PRE-CONDITIONS:
  *  TreeNode<T>*& root: root by value
@@ -250,13 +350,11 @@ void tree_reinsert(TreeNode<T>*& root, const T& target, bool balance) {
  ******************************************************************************/
 template <typename T>
 TreeNode<T>* tree_search(TreeNode<T>* root, const T& target) {
-    // base: nullptr or target, return root (root = nullptr if not found)
-    if(!root || target == root->_item) return root;
+    // stop at nullptr or target (root = nullptr if not found)
+    while(root && !(target == root->_item))
+        root = target < root->_item ? root->_left : root->_right;
 
-    if(target < root->_item)
-        return tree_search(root->_left, target);  // recurse left node
-    else
-        return tree_search(root->_right, target);  // recurse right node
+    return root;
 }
 
 /*******************************************************************************
@@ -277,16 +375,8 @@ TreeNode<T>* tree_search(TreeNode<T>* root, const T& target) {
  ******************************************************************************/
 template <typename T>
 bool tree_search(TreeNode<T>* root, const T& target, TreeNode<T>*& found_ptr) {
-    // base: nullptr or target, return bool, set found_ptr
-    if(!root || target == root->_item) {
-        found_ptr = root;
-        return root ? true : false;
-    }
-
-    if(target < root->_item)
-        return tree_search(root->_left, target, found_ptr);  // recurse left
-    else
-        return tree_search(root->_right, target, found_ptr);  // recurse right
+    found_ptr = tree_search(root, target);
+    return found_ptr ? true : false;
 }
 
 /*******************************************************************************
@@ -347,7 +437,9 @@ void tree_print_debug(TreeNode<T>* root, std::ostream& outs, int level) {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Deallocates all nodes linked to root.
+ *  Deallocates all nodes of root without recursion or a stack: a node with a
+ *  left child is rotated right until it has none, then it is deleted and its
+ *  right child becomes root.
  *
  * PRE-CONDITIONS:
  *  TreeNode<T>*& root: root by reference
@@ -360,12 +452,17 @@ void tree_print_debug(TreeNode<T>* root, std::ostream& outs, int level) {
  ******************************************************************************/
 template <typename T>
 void tree_clear(TreeNode<T>*& root) {
-    if(root) {
-        tree_clear(root->_left);   // recurse left node
-        tree_clear(root->_right);  // recurse right node
-
-        delete root;     // delete current root
-        root = nullptr;  // reset ptr to nullptr
+    while(root) {
+        if(root->_left) {  // rotate right: left child becomes root
+            TreeNode<T>* left = root->_left;
+            root->_left = left->_right;
+            left->_right = root;
+            root = left;
+        } else {
+            TreeNode<T>* pop = root;
+            root = root->_right;  // root = nullptr when last node
+            delete pop;           // delete current root
+        }
     }
 }
 
@@ -373,6 +470,8 @@ void tree_clear(TreeNode<T>*& root) {
  * DESCRIPTION:
  *  Erase a target node by traversing the bst root. If balance is true, will
  *  rotate tree to full or complete binary tree.
+ *  Mechanism: Walk down from root, keeping the links passed, to the target's
+ *             link. Pop the target there, then rebalance back up the links.
  *
  * PRE-CONDITIONS:
  *  TreeNode<T>*& root: root by reference
@@ -387,42 +486,29 @@ void tree_clear(TreeNode<T>*& root) {
  ******************************************************************************/
 template <typename T>
 bool tree_erase(TreeNode<T>*& root, const T& target, bool balance) {
-    bool is_erased = false;
-
-    if(!root) return is_erased;  // base: root is nullptr
-
-    // erase found target
-    if(target == root->_item) {
-        if(!root->_left) {
-            TreeNode<T>* pop = root;
-            root = root->_right;  // root = nullptr when !root->_right
+    std::vector<TreeNode<T>**> path;
+    TreeNode<T>** link = &root;
 
-            delete pop;
-            pop = nullptr;
-        } else {
-            T max;
-            tree_remove_max(root->_left, max, balance);
-            root->_item = max;
-        }
+    while(*link && !(target == (*link)->_item)) {
+        path.push_back(link);
+        link = target < (*link)->_item ? &(*link)->_left : &(*link)->_right;
+    }
 
-        is_erased = true;
-    } else if(target < root->_item)
-        is_erased = tree_erase(root->_left, target, balance);  // recurse left
-    else
-        is_erased = tree_erase(root->_right, target, balance);  // recurse right
+    if(!*link) return false;  // target not found
 
-    if(root) {  // check root b/c root == nullptr when target is max node
-        root->update_height();
-        if(balance) root = rotate(root);
-    };
+    tree_pop_root(*link, balance);
+    tree_rebalance(path, balance);
 
-    return is_erased;
+    return true;
 }
 
 /*******************************************************************************
  * DESCRIPTION:
  *  Removes the largest node in the bst root and return max item. If balance
  *  is true, will rotate tree to full or complete binary tree.
+ *  Mechanism: Walk the right links down to the max node, keeping the links
+ *             passed. Replace the max node by its left child, then rebalance
+ *             back up the links.
  *
  * PRE-CONDITIONS:
  *  TreeNode<T>*& root: root by reference
@@ -438,24 +524,21 @@ bool tree_erase(TreeNode<T>*& root, const T& target, bool balance) {
  ******************************************************************************/
 template <typename T>
 void tree_remove_max(TreeNode<T>*& root, T& max_value, bool balance) {
-    if(!root) return;  // base: root is nullptr
-
-    if(!root->_right) {
-        max_value = root->_item;
+    std::vector<TreeNode<T>**> path;
+    TreeNode<T>** link = &root;
 
-        TreeNode<T>* pop = root;
-        root = root->_left;
+    if(!root) return;  // empty tree
 
-        delete pop;
-        pop = nullptr;
+    for(; (*link)->_right; link = &(*link)->_right) path.push_back(link);
 
-        return;
-    }
+    TreeNode<T>* pop = *link;
+    max_value = pop->_item;
+    *link = pop->_left;
 
-    tree_remove_max(root->_right, max_value, balance);  // recurse right
+    delete pop;
+    pop = nullptr;
 
-    root->update_height();
-    if(balance) root = rotate(root);
+    tree_rebalance(path, balance);
 }
 
 /*******************************************************************************
@@ -497,6 +580,8 @@ void tree_pop_root(TreeNode<T>*& root, bool balance) {
  * DESCRIPTION:
  *  Copys all nodes from source root and returns destination root. If balance
  *  is true, will rotate tree to full or complete binary tree.
+ *  Mechanism: Copy nodes top down with an explicit stack of (source, link to
+ *             fill) pairs, then update heights and rotate bottom up.
  *
  * PRE-CONDITIONS:
  *  TreeNode<T>*& root: source root
@@ -510,14 +595,27 @@ void tree_pop_root(TreeNode<T>*& root, bool balance) {
  ******************************************************************************/
 template <typename T>
 TreeNode<T>* tree_copy(TreeNode<T>* root, bool balance) {
-    if(root) {
-        root = new TreeNode<T>(root->_item, tree_copy(root->_left, balance),
-                               tree_copy(root->_right, balance));
+    TreeNode<T>* copy = nullptr;
+    std::vector<std::pair<const TreeNode<T>*, TreeNode<T>**>> stack;
+
+    if(root) stack.emplace_back(root, &copy);
 
-        if(balance) root = rotate(root);
+    while(!stack.empty()) {
+        const TreeNode<T>* src = stack.back().first;
+        TreeNode<T>*& dest = *stack.back().second;
+        stack.pop_back();
+
+        dest = new TreeNode<T>(src->_item);
+        if(src->_right) stack.emplace_back(src->_right, &dest->_right);
+        if(src->_left) stack.emplace_back(src->_left, &dest->_left);
     }
 
-    return root;  // base: root is nullptr, else return new root
+    postorder(copy, [balance](TreeNode<T>*& r) {  // children before parent
+        r->update_height();
+        if(balance) r = rotate(r);
+    });
+
+    return copy;  // nullptr if root is nullptr, else return new root
 }
 
 /*******************************************************************************
@@ -539,11 +637,9 @@ TreeNode<T>* tree_copy(TreeNode<T>* root, bool balance) {
  ******************************************************************************/
 template <typename T>
 void tree_add(TreeNode<T>*& dest, const TreeNode<T>* src, bool balance) {
-    if(src) {
-        tree_insert(dest, src->_item, balance);
-        tree_add(dest, src->_left, balance);   // recurse left
-        tree_add(dest, src->_right, balance);  // recurse right
-    }
+    preorder(src, [&dest, balance](const TreeNode<T>* r) {
+        tree_insert(dest, r->_item, balance);
+    });
 }
 
 /*******************************************************************************
@@ -572,6 +668,205 @@ TreeNode<T>* tree_from_sorted_list(const T* a, int size) {
         tree_from_sorted_list(a + (size / 2) + 1, (size - 1) / 2));
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Creates a full or complete binary tree from items in any order. Items are
+ *  sorted, unless already sorted, and duplicates are dropped, keeping the
+ *  first one like repeated tree_insert() calls would.
+ *  Mechanism: stable_sort, unique by !(a < b) and tree_from_sorted_list.
+ *             O(n) when items are sorted, O(n log n) otherwise, with no
+ *             rotations.
+ *
+ * PRE-CONDITIONS:
+ *  std::vector<T>& items: items in any order
+ *
+ * POST-CONDITIONS:
+ *  items sorted and deduped; allocation of all nodes from items
+ *
+ * RETURN:
+ *  TreeNode<T>*: bst node with unique items as full/complete binary tree
+ ******************************************************************************/
+template <typename T>
+TreeNode<T>* tree_from_unsorted_list(std::vector<T>& items) {
+    if(!std::is_sorted(items.begin(), items.end()))
+        std::stable_sort(items.begin(), items.end());
+
+    items.erase(std::unique(items.begin(), items.end(),
+                            [](const T& a, const T& b) { return !(a < b); }),
+                items.end());
+
+    return tree_from_sorted_list(items.data(), static_cast<int>(items.size()));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Height of a tree, where an empty tree is -1 and a leaf is 0.
+ *
+ * PRE-CONDITIONS:
+ *  const TreeNode<T>* root: root of tree
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  int: root's height, else -1
+ ******************************************************************************/
+template <typename T>
+int tree_height(const TreeNode<T>* root) {
+    return root ? root->_height : -1;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Joins two balanced trees and a middle node into one balanced tree, where
+ *  all items in left < mid's item < all items in right.
+ *  Mechanism: Walk down the right spine of the taller left tree (or the left
+ *             spine of the taller right tree) to a subtree at most one
+ *             taller than the other tree, hang it and the other tree off
+ *             mid, then rotate on the way back up. O(|height difference|).
+ *
+ * PRE-CONDITIONS:
+ *  TreeNode<T>* left : balanced tree with items < mid's item
+ *  TreeNode<T>* mid  : single node; its children are overwritten
+ *  TreeNode<T>* right: balanced tree with items > mid's item
+ *
+ * POST-CONDITIONS:
+ *  nodes of left, mid and right are relinked into one tree
+ *
+ * RETURN:
+ *  TreeNode<T>*: root of joined tree
+ ******************************************************************************/
+template <typename T>
+TreeNode<T>* tree_join(TreeNode<T>* left, TreeNode<T>* mid,
+                       TreeNode<T>* right) {
+    if(tree_height(left) > tree_height(right) + 1) {
+        left->_right = tree_join(left->_right, mid, right);  // --> right spine
+        left->update_height();
+        return rotate(left);
+    }
+
+    if(tree_height(right) > tree_height(left) + 1) {
+        right->_left = tree_join(left, mid, right->_left);  // --> left spine
+        right->update_height();
+        return rotate(right);
+    }
+
+    mid->_left = left;
+    mid->_right = right;
+    mid->update_height();
+
+    return mid;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Joins two balanced trees into one balanced tree, where all items in left
+ *  < all items in right.
+ *  Mechanism: Remove left's max and join with it as the middle node.
+ *             O(log n).
+ *
+ * PRE-CONDITIONS:
+ *  TreeNode<T>* left : balanced tree with items < right's items
+ *  TreeNode<T>* right: balanced tree
+ *
+ * POST-CONDITIONS:
+ *  nodes of left and right are relinked into one tree
+ *
+ * RETURN:
+ *  TreeNode<T>*: root of joined tree
+ ******************************************************************************/
+template <typename T>
+TreeNode<T>* tree_join(TreeNode<T>* left, TreeNode<T>* right) {
+    if(!left) return right;
+    if(!right) return left;
+
+    T max;
+    tree_remove_max(left, max, true);
+
+    return tree_join(left, new TreeNode<T>(max), right);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Splits a balanced tree by key into balanced trees of items < key and
+ *  items > key, and the node == key if any.
+ *  Mechanism: Walk down to key, then join the subtrees left behind on the
+ *             way back up. O(log n).
+ *
+ * PRE-CONDITIONS:
+ *  TreeNode<T>* root  : balanced tree
+ *  const T& key       : split item
+ *  TreeNode<T>*& left : place holder for items < key
+ *  TreeNode<T>*& found: place holder for node == key
+ *  TreeNode<T>*& right: place holder for items > key
+ *
+ * POST-CONDITIONS:
+ *  nodes of root are relinked into left, found and right
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void tree_split(TreeNode<T>* root, const T& key, TreeNode<T>*& left,
+                TreeNode<T>*& found, TreeNode<T>*& right) {
+    if(!root) {  // base: key is not in tree
+        left = found = right = nullptr;
+        return;
+    }
+
+    TreeNode<T>*lower = root->_left, *upper = root->_right, *part = nullptr;
+
+    if(key < root->_item) {
+        tree_split(lower, key, left, found, part);  // --> left
+        right = tree_join(part, root, upper);
+    } else if(root->_item < key) {
+        tree_split(upper, key, part, found, right);  // --> right
+        left = tree_join(lower, root, part);
+    } else {
+        left = lower;
+        right = upper;
+        found = root;
+
+        found->_left = found->_right = nullptr;
+        found->update_height();
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Set union of two balanced trees. On duplicate items, a's item is kept.
+ *  Mechanism: Split a by b's root item, union the halves with b's subtrees
+ *             and join them around the root. O(m log(n / m + 1)) for trees
+ *             of m <= n items.
+ *
+ * PRE-CONDITIONS:
+ *  TreeNode<T>* a: balanced tree
+ *  TreeNode<T>* b: balanced tree
+ *
+ * POST-CONDITIONS:
+ *  nodes of a and b are relinked into one tree; duplicates of b deallocated
+ *
+ * RETURN:
+ *  TreeNode<T>*: root of union
+ ******************************************************************************/
+template <typename T>
+TreeNode<T>* tree_union(TreeNode<T>* a, TreeNode<T>* b) {
+    if(!a) return b;
+    if(!b) return a;
+
+    TreeNode<T>*left = nullptr, *found = nullptr, *right = nullptr;
+    TreeNode<T>*b_left = b->_left, *b_right = b->_right;
+
+    tree_split(a, b->_item, left, found, right);
+
+    if(found) {  // keep a's item
+        delete b;
+        b = found;
+    }
+
+    return tree_join(tree_union(left, b_left), b, tree_union(right, b_right));
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Rotate the root to the left, by making the root the child of the right
@@ -663,9 +958,38 @@ TreeNode<T>* rotate(TreeNode<T>*& root) {
     return root;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Updates heights, and rotates if balance is true, from the last link of a
+ *  path up to the first. Each link is the root pointer or a child pointer of
+ *  the node before it, so a rotation only changes what that link points to.
+ *
+ * PRE-CONDITIONS:
+ *  std::vector<TreeNode<T>**>& path: links walked down from root
+ *  bool balance                    : rotate nodes to balance tree
+ *
+ * POST-CONDITIONS:
+ *  heights updated and nodes rotated along path; path is emptied
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void tree_rebalance(std::vector<TreeNode<T>**>& path, bool balance) {
+    for(; !path.empty(); path.pop_back()) {
+        TreeNode<T>*& link = *path.back();
+
+        if(link) {
+            link->update_height();
+            if(balance) link = rotate(link);
+        }
+    }
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Inorder traversal of node with function pointer to process root.
+ *  Iterative, with an explicit stack of links.
  *
  * PRE-CONDITIONS:
  *  TreeNode<T>*& root: root by reference
@@ -679,16 +1003,26 @@ TreeNode<T>* rotate(TreeNode<T>*& root) {
  ******************************************************************************/
 template <typename T, typename F>
 void inorder(TreeNode<T>*& root, F f) {
-    if(root) {
-        inorder(root->_left, f);
-        f(root);
-        inorder(root->_right, f);
+    std::vector<TreeNode<T>**> stack;  // links whose nodes are ahead
+    TreeNode<T>** link = &root;
+
+    while(*link || !stack.empty()) {
+        if(*link) {  // go left as far as possible
+            stack.push_back(link);
+            link = &(*link)->_left;
+        } else {  // process node, then its right subtree
+            link = stack.back();
+            stack.pop_back();
+            f(*link);
+            link = &(*link)->_right;
+        }
     }
 }
 
 /*******************************************************************************
  * DESCRIPTION:
  *  Const inorder traversal of node with function pointer to process root.
+ *  Iterative, with an explicit stack.
  *
  * PRE-CONDITIONS:
  *  const TreeNode<T>* root: root by const value
@@ -702,16 +1036,25 @@ void inorder(TreeNode<T>*& root, F f) {
  ******************************************************************************/
 template <typename T, typename F>
 void inorder(const TreeNode<T>* root, F f) {
-    if(root) {
-        inorder(root->_left, f);
-        f(root);
-        inorder(root->_right, f);
+    std::vector<const TreeNode<T>*> stack;  // nodes that are ahead
+
+    while(root || !stack.empty()) {
+        if(root) {  // go left as far as possible
+            stack.push_back(root);
+            root = root->_left;
+        } else {  // process node, then its right subtree
+            root = stack.back();
+            stack.pop_back();
+            f(root);
+            root = root->_right;
+        }
     }
 }
 
 /*******************************************************************************
  * DESCRIPTION:
  *  Preorder traversal of node with function pointer to process root.
+ *  Iterative, with an explicit stack of links.
  *
  * PRE-CONDITIONS:
  *  TreeNode<T>*& root: root by reference
@@ -725,16 +1068,24 @@ void inorder(const TreeNode<T>* root, F f) {
  ******************************************************************************/
 template <typename T, typename F>
 void preorder(TreeNode<T>*& root, F f) {
-    if(root) {
-        f(root);
-        preorder(root->_left, f);
-        preorder(root->_right, f);
+    std::vector<TreeNode<T>**> stack(1, &root);  // links to process
+
+    while(!stack.empty()) {
+        TreeNode<T>** link = stack.back();
+        stack.pop_back();
+
+        if(*link) {
+            f(*link);
+            stack.push_back(&(*link)->_right);  // right after left subtree
+            stack.push_back(&(*link)->_left);
+        }
     }
 }
 
 /*******************************************************************************
  * DESCRIPTION:
  *  Const preorder traversal of node with function pointer to process root.
+ *  Iterative, with an explicit stack.
  *
  * PRE-CONDITIONS:
  *  const TreeNode<T>* root: root by const value
@@ -748,16 +1099,24 @@ void preorder(TreeNode<T>*& root, F f) {
  ******************************************************************************/
 template <typename T, typename F>
 void preorder(const TreeNode<T>* root, F f) {
-    if(root) {
-        f(root);
-        preorder(root->_left, f);
-        preorder(root->_right, f);
+    std::vector<const TreeNode<T>*> stack(1, root);  // nodes to process
+
+    while(!stack.empty()) {
+        root = stack.back();
+        stack.pop_back();
+
+        if(root) {
+            f(root);
+            stack.push_back(root->_right);  // right after left subtree
+            stack.push_back(root->_left);
+        }
     }
 }
 
 /*******************************************************************************
  * DESCRIPTION:
  *  Mutator: postorder traversal of node with function pointer to process root.
+ *  Iterative, with an explicit stack of links.
  *
  * PRE-CONDITIONS:
  *  TreeNode<T>*& root: root by reference
@@ -771,16 +1130,29 @@ void preorder(const TreeNode<T>* root, F f) {
  ******************************************************************************/
 template <typename T, typename F>
 void postorder(TreeNode<T>*& root, F f) {
-    if(root) {
-        postorder(root->_left, f);
-        postorder(root->_right, f);
-        f(root);
+    // links with true once their children are pushed
+    std::vector<std::pair<TreeNode<T>**, bool>> stack(1, {&root, false});
+
+    while(!stack.empty()) {
+        TreeNode<T>** link = stack.back().first;
+
+        if(!*link)
+            stack.pop_back();
+        else if(!stack.back().second) {  // children first, left then right
+            stack.back().second = true;
+            stack.emplace_back(&(*link)->_right, false);
+            stack.emplace_back(&(*link)->_left, false);
+        } else {
+            stack.pop_back();
+            f(*link);
+        }
     }
 }
 
 /*******************************************************************************
  * DESCRIPTION:
  *  Const postorder traversal of node with function pointer to process root.
+ *  Iterative, with an explicit stack.
  *
  * PRE-CONDITIONS:
  *  const TreeNode<T>* root: root by const value
@@ -794,10 +1166,22 @@ void postorder(TreeNode<T>*& root, F f) {
  ******************************************************************************/
 template <typename T, typename F>
 void postorder(const TreeNode<T>* root, F f) {
-    if(root) {
-        postorder(root->_left, f);
-        postorder(root->_right, f);
-        f(root);
+    // nodes with true once their children are pushed
+    std::vector<std::pair<const TreeNode<T>*, bool>> stack(1, {root, false});
+
+    while(!stack.empty()) {
+        root = stack.back().first;
+
+        if(!root)
+            stack.pop_back();
+        else if(!stack.back().second) {  // children first, left then right
+            stack.back().second = true;
+            stack.emplace_back(root->_right, false);
+            stack.emplace_back(root->_left, false);
+        } else {
+            stack.pop_back();
+            f(root);
+        }
     }
 }
 
@@ -11,10 +11,16 @@
  *          MMap uses BTree as base with MPair. It does not allow duplicate
  *          keys but allow duplicate values. The values are stored in
  *          key/vector structure.
+ *          Both save to and load from a binary image of their BTree, so a
+ *          map is reloaded without re-inserting its keys.
+ *          Iterators walk the keys in order, and find/lower_bound/upper_bound
+ *          start a range scan at a key. MMap's Iterator visits each value.
  ******************************************************************************/
 #ifndef BT_MAP_H
 #define BT_MAP_H
 
+#include <istream>  // istream
+#include <ostream>  // ostream
 #include <vector>   // vector objects
 #include "btree.h"  // BTree class
 #include "pair.h"   // Pair struct
@@ -26,6 +32,45 @@ class Map {
 public:
     typedef pair::Pair<K, V> Pair;
     typedef btree::BTree<Pair> MapBase;
+    typedef typename btree::BTree<Pair>::Iterator MapBaseIter;
+
+    class Iterator {
+    public:
+        friend class Map;
+
+        // CONSTRUCTOR
+        Iterator(MapBaseIter it = MapBaseIter()) : _it(it) {}
+
+        bool is_null() { return !_it; }
+        explicit operator bool() { return (bool)_it; }
+
+        Pair& operator*() { return *_it; }    // member access
+        Pair* operator->() { return &*_it; }  // member access
+
+        Iterator& operator++() {  // pre-inc
+            ++_it;
+            return *this;
+        }
+
+        Iterator operator++(int _u) {  // post-inc
+            (void)_u;                  // suppress unused warning
+            Iterator it = *this;       // make temp
+            operator++();              // pre-inc
+            return it;                 // return previous state
+        }
+
+        // FRIENDS
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs._it == rhs._it;
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+            return lhs._it != rhs._it;
+        }
+
+    private:
+        MapBaseIter _it;
+    };
 
     // CONSTRUCTOR
     Map(std::size_t min = btree::MINIMUM) : _map(true, min) {}
@@ -35,6 +80,11 @@ public:
     bool empty() const;
 
     // element access
+    Iterator begin() const;
+    Iterator end() const;
+    Iterator find(const K& key) const;
+    Iterator lower_bound(const K& key) const;  // first key >= key
+    Iterator upper_bound(const K& key) const;  // first key > key
     const V& operator[](const K& key) const;
     V& operator[](const K& key);
     const V& at(const K& key) const;
@@ -47,12 +97,15 @@ public:
     V& get(const K& key);
 
     // operations
-    // Iterator find(const K& key); // iterator not implemented
     bool contains(const Pair& target) const;
     std::size_t count(const K& key) const;
     void print_debug() const;
     bool verify() const;
 
+    // binary image
+    void save(std::ostream& outs, btree::Image image = btree::NODE_IMAGE) const;
+    void load(std::istream& ins);  // replaces map; throws on a bad image
+
     friend std::ostream& operator<<(std::ostream& outs, const Map<K, V>& map) {
         return outs << map._map;
     }
@@ -66,6 +119,59 @@ class MMap {
 public:
     typedef pair::MPair<K, V> MPair;
     typedef btree::BTree<MPair> MMapBase;
+    typedef typename btree::BTree<MPair>::Iterator MMapBaseIter;
+
+    class Iterator {
+    public:
+        friend class MMap;
+
+        // CONSTRUCTOR
+        Iterator(MMapBaseIter it = MMapBaseIter()) : _it(it) {
+            // Initialize MPair's vector iter to begin()
+            if(_it) _it->value = _it->values.begin();
+        }
+
+        bool is_null() { return !_it; }
+        explicit operator bool() { return (bool)_it; }
+
+        MPair& operator*() { return *_it; }    // member access
+        MPair* operator->() { return &*_it; }  // member access
+
+        Iterator& operator++() {  // pre-inc
+            // _it->value is values' iter; inc values' iter and cmp to end()
+            if(++_it->value == _it->values.end()) {  // if end(), inc entire
+                ++_it;                               // BTree's iter
+                if(_it) _it->value = _it->values.begin();  // init values's iter
+            }
+            return *this;
+        }
+
+        Iterator operator++(int _u) {  // post-inc
+            (void)_u;                  // suppress unused warning
+            Iterator it = *this;       // make temp
+            operator++();              // pre-inc
+            return it;                 // return previous state
+        }
+
+        void next_key() {  // skip the key's remaining values
+            if(_it) {
+                ++_it;
+                if(_it) _it->value = _it->values.begin();
+            }
+        }
+
+        // FRIENDS
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs._it == rhs._it;
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+            return lhs._it != rhs._it;
+        }
+
+    private:
+        MMapBaseIter _it;
+    };
 
     MMap(std::size_t min = btree::MINIMUM) : _mmap(true, min) {}
 
@@ -74,6 +180,11 @@ public:
     bool empty() const;
 
     // element access
+    Iterator begin() const;
+    Iterator end() const;
+    Iterator find(const K& key) const;
+    Iterator lower_bound(const K& key) const;  // first key >= key
+    Iterator upper_bound(const K& key) const;  // first key > key
     const std::vector<V>& operator[](const K& key) const;
     std::vector<V>& operator[](const K& key);
     const std::vector<V>& at(const K& key) const;
@@ -86,12 +197,15 @@ public:
     std::vector<V>& get(const K& key);
 
     // operations
-    // Iterator find(const K& key); // iterator not implemented
     bool contains(const K& key) const;
     std::size_t count(const K& key) const;
     void print_debug() const;
     bool verify() const;
 
+    // binary image
+    void save(std::ostream& outs, btree::Image image = btree::NODE_IMAGE) const;
+    void load(std::istream& ins);  // replaces map; throws on a bad image
+
     friend std::ostream& operator<<(std::ostream& outs, const MMap<K, V>& map) {
         return outs << map._mmap;
     }
@@ -138,6 +252,101 @@ bool Map<K, V>::empty() const {
     return _map.empty();
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an Iterator to the smallest key.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Map<K, V>::Iterator: end() if empty
+ ******************************************************************************/
+template <typename K, typename V>
+typename Map<K, V>::Iterator Map<K, V>::begin() const {
+    return Iterator(_map.begin());
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the Iterator past the largest key.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Map<K, V>::Iterator
+ ******************************************************************************/
+template <typename K, typename V>
+typename Map<K, V>::Iterator Map<K, V>::end() const {
+    return Iterator();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an Iterator to key.
+ *
+ * PRE-CONDITIONS:
+ *  const K& key: key to search
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Map<K, V>::Iterator: end() if key is not found
+ ******************************************************************************/
+template <typename K, typename V>
+typename Map<K, V>::Iterator Map<K, V>::find(const K& key) const {
+    MapBaseIter it = _map.lower_bound(Pair(key));
+
+    if(it && !(key < it->key))
+        return Iterator(it);
+    else
+        return end();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an Iterator to the first key that is not less than key.
+ *
+ * PRE-CONDITIONS:
+ *  const K& key: key to search
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Map<K, V>::Iterator: end() if all keys are less than key
+ ******************************************************************************/
+template <typename K, typename V>
+typename Map<K, V>::Iterator Map<K, V>::lower_bound(const K& key) const {
+    return Iterator(_map.lower_bound(Pair(key)));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an Iterator to the first key that is greater than key.
+ *
+ * PRE-CONDITIONS:
+ *  const K& key: key to search
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Map<K, V>::Iterator: end() if no key is greater than key
+ ******************************************************************************/
+template <typename K, typename V>
+typename Map<K, V>::Iterator Map<K, V>::upper_bound(const K& key) const {
+    return Iterator(_map.upper_bound(Pair(key)));
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Returns the reference value at given key via subscript operator.
@@ -356,6 +565,43 @@ bool Map<K, V>::verify() const {
     return _map.verify();
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Saves the map to a binary image. See btree.h for the format.
+ *
+ * PRE-CONDITIONS:
+ *  std::ostream& outs : binary output stream
+ *  btree::Image image : NODE_IMAGE or SORTED_IMAGE
+ *
+ * POST-CONDITIONS:
+ *  image written to outs
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename K, typename V>
+void Map<K, V>::save(std::ostream& outs, btree::Image image) const {
+    _map.save(outs, image);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Loads a binary image from save(), replacing the map.
+ *
+ * PRE-CONDITIONS:
+ *  std::istream& ins: binary input stream at an image
+ *
+ * POST-CONDITIONS:
+ *  map replaced; throws runtime_error if the image is bad or short
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename K, typename V>
+void Map<K, V>::load(std::istream& ins) {
+    _map.load(ins);
+}
+
 // ----- MMAP IMPLEMENTATIONS -----
 
 /*******************************************************************************
@@ -394,6 +640,101 @@ bool MMap<K, V>::empty() const {
     return _mmap.empty();
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an Iterator to the smallest key.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  MMap<K, V>::Iterator: end() if empty
+ ******************************************************************************/
+template <typename K, typename V>
+typename MMap<K, V>::Iterator MMap<K, V>::begin() const {
+    return Iterator(_mmap.begin());
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the Iterator past the largest key.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  MMap<K, V>::Iterator
+ ******************************************************************************/
+template <typename K, typename V>
+typename MMap<K, V>::Iterator MMap<K, V>::end() const {
+    return Iterator();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an Iterator to key.
+ *
+ * PRE-CONDITIONS:
+ *  const K& key: key to search
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  MMap<K, V>::Iterator: end() if key is not found
+ ******************************************************************************/
+template <typename K, typename V>
+typename MMap<K, V>::Iterator MMap<K, V>::find(const K& key) const {
+    MMapBaseIter it = _mmap.lower_bound(MPair(key));
+
+    if(it && !(key < it->key))
+        return Iterator(it);
+    else
+        return end();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an Iterator to the first key that is not less than key.
+ *
+ * PRE-CONDITIONS:
+ *  const K& key: key to search
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  MMap<K, V>::Iterator: end() if all keys are less than key
+ ******************************************************************************/
+template <typename K, typename V>
+typename MMap<K, V>::Iterator MMap<K, V>::lower_bound(const K& key) const {
+    return Iterator(_mmap.lower_bound(MPair(key)));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an Iterator to the first key that is greater than key.
+ *
+ * PRE-CONDITIONS:
+ *  const K& key: key to search
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  MMap<K, V>::Iterator: end() if no key is greater than key
+ ******************************************************************************/
+template <typename K, typename V>
+typename MMap<K, V>::Iterator MMap<K, V>::upper_bound(const K& key) const {
+    return Iterator(_mmap.upper_bound(MPair(key)));
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Returns the reference value list at given key via subscript operator.
@@ -612,6 +953,43 @@ bool MMap<K, V>::verify() const {
     return _mmap.verify();
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Saves the mmap to a binary image. See btree.h for the format.
+ *
+ * PRE-CONDITIONS:
+ *  std::ostream& outs : binary output stream
+ *  btree::Image image : NODE_IMAGE or SORTED_IMAGE
+ *
+ * POST-CONDITIONS:
+ *  image written to outs
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename K, typename V>
+void MMap<K, V>::save(std::ostream& outs, btree::Image image) const {
+    _mmap.save(outs, image);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Loads a binary image from save(), replacing the mmap.
+ *
+ * PRE-CONDITIONS:
+ *  std::istream& ins: binary input stream at an image
+ *
+ * POST-CONDITIONS:
+ *  mmap replaced; throws runtime_error if the image is bad or short
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename K, typename V>
+void MMap<K, V>::load(std::istream& ins) {
+    _mmap.load(ins);
+}
+
 }  // namespace bt_map
 
 #endif  // BT_MAP_H
@@ -4,7 +4,9 @@
  * CLASS       : CS008
  * HEADER      : btree
  * DESCRIPTION : This header provides a templated self-balancing BTree class,
- *      that allows for more than two children per node.
+ *      that allows for more than two children per node. Each node and its
+ *      arrays share one allocation, taken from a per-tree NodePool when the
+ *      tree is pooled.
  *
  *      RULES:
  *      1. Root can have 0 entries if no children, or at least 1 entry if it
@@ -15,23 +17,131 @@
  *      5. Every nonleaf node is:
  *         A) entry at i is greater than all entries in child i.
  *         B) entry at i is less than all entires in child i+1.
+ *
+ *      BINARY IMAGE (save/load; entries encoded by write_binary()):
+ *      header : magic(4) | version(4) | image(1) | dups(1) | min(8) | size(8)
+ *      NODE_IMAGE  : nodes in preorder, each as
+ *                    data count(4) | child count(4) | entries
+ *      SORTED_IMAGE: size entries in ascending order
+ *
+ *      A node image rebuilds the same nodes and takes the saved min and
+ *      dups. A sorted image is bulk built bottom up with the loading tree's
+ *      min, so it also loads into a tree of another min. Images are in
+ *      native byte order, for reloading on the same platform.
+ *
+ *      ITERATOR:
+ *      An Iterator walks the entries in order with a stack of (node, index)
+ *      frames from the root, so stepping never recurses or revisits the
+ *      root. A frame below the top is the child index it descended into; the
+ *      entry at that index is next once the child is done. Iterators are
+ *      invalidated by insert and remove.
  ******************************************************************************/
 #ifndef BTREE_H
 #define BTREE_H
 
 #include <cassert>        // assert()
+#include <cstddef>        // max_align_t
+#include <cstdint>        // uint8_t, uint32_t, uint64_t
+#include <istream>        // istream
+#include <ostream>        // ostream
+#include <stdexcept>      // invalid_argument, runtime_error
 #include <string>         // string objects
+#include <utility>        // swap()
+#include <vector>         // vector
 #include "array_utils.h"  // array utilities
+#include "binary_io.h"    // write_binary(), read_binary()
+#include "node_pool.h"    // NodePool class
 #include "sort.h"         // verify() sortedness
 
 namespace btree {
 enum { MINIMUM = 1 };
 
+enum Image {
+    NODE_IMAGE,   // node structure; loads without comparing entries
+    SORTED_IMAGE  // ascending entries; bulk built on load
+};
+
 template <class T>
 class BTree {
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "BTree: over-aligned T is not supported");
+
 public:
+    class Iterator {
+    public:
+        friend class BTree;
+
+        // CONSTRUCTOR
+        Iterator() : _path() {}
+
+        bool is_null() { return _path.empty(); }
+        explicit operator bool() { return !_path.empty(); }
+
+        T& operator*() {
+            if(_path.empty())
+                throw std::invalid_argument("BTree::Iterator - nullptr check");
+
+            const Frame& top = _path.back();
+            return const_cast<T&>(top.node->_data[top.index]);
+        }
+
+        T* operator->() { return &operator*(); }
+
+        Iterator& operator++() {  // pre-inc
+            if(_path.empty()) return *this;
+
+            Frame& top = _path.back();
+            if(top.node->is_leaf())
+                ++top.index;
+            else  // next is leftmost entry of the child after the entry
+                push_leftmost(top.node->_subset[++top.index]);
+            pop_finished();
+
+            return *this;
+        }
+
+        Iterator operator++(int _u) {  // post-inc
+            (void)_u;                  // suppress unused warning
+            Iterator it = *this;       // make temp
+            operator++();              // pre-inc
+            return it;                 // return previous state
+        }
+
+        // FRIENDS
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            if(lhs._path.empty() || rhs._path.empty())
+                return lhs._path.empty() == rhs._path.empty();
+
+            return lhs._path.back().node == rhs._path.back().node &&
+                   lhs._path.back().index == rhs._path.back().index;
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        struct Frame {
+            const BTree<T>* node;  // node on the path from root
+            std::size_t index;     // entry; child index below the top
+        };
+
+        std::vector<Frame> _path;  // root first; empty at end
+
+        void push_leftmost(const BTree<T>* node) {
+            for(; node; node = node->is_leaf() ? nullptr : node->_subset[0])
+                _path.push_back({node, 0});
+        }
+
+        void pop_finished() {  // pop frames past their node's last entry
+            while(!_path.empty() &&
+                  _path.back().index >= _path.back().node->_data_count)
+                _path.pop_back();
+        }
+    };
+
     // CONSTRUCTOR
-    BTree(bool dups = false, std::size_t min = MINIMUM);
+    BTree(bool dups = false, std::size_t min = MINIMUM, bool pooled = false);
 
     // BIG THREE
     ~BTree();
@@ -43,13 +153,18 @@ public:
     bool empty() const;
 
     // element access
+    Iterator begin() const;
+    Iterator end() const;
+    Iterator lower_bound(const T& entry) const;  // first entry >= entry
+    Iterator upper_bound(const T& entry) const;  // first entry > entry
     const T& get(const T& entry) const;  // return a ref to entry in the tree
     T& get(const T& entry);              // return a ref to entry in the tree
 
     // modifiers
     bool insert(const T& entry);
     bool remove(const T& entry);
-    void clear();  // clear data and delete all linked nodes
+    void clear();                // clear data and delete all linked nodes
+    void swap(BTree<T>& other);  // swap trees without copying
 
     // operations
     T* find(const T& entry);  // return ptr to T; else nullptr
@@ -58,6 +173,10 @@ public:
                int level = 0, int index = 0) const;
     bool verify() const;
 
+    // binary image
+    void save(std::ostream& outs, Image image = NODE_IMAGE) const;
+    void load(std::istream& ins);  // replaces tree; throws on a bad image
+
     // FRIENDS
     friend std::ostream& operator<<(std::ostream& outs, const BTree<T>& bt) {
         bt.print(outs);
@@ -73,10 +192,29 @@ private:
     T* _data;                  // holds the keys -> _data[_max+1]
     std::size_t _child_count;  // number of children
     BTree<T>** _subset;        // subtrees -> _subset[_max+2]
+    node_pool::NodePool* _pool;  // node blocks if pooled; owned by root
+
+    // node storage: a node, its subset and its data share one block
+    BTree(bool dups, std::size_t min, node_pool::NodePool* pool, char* block);
+    std::size_t subset_offset() const;  // subset array's offset in block
+    std::size_t data_offset() const;    // data array's offset in block
+    std::size_t block_size() const;     // bytes per block
+    char* block() const;                // block holding 'this' arrays
+    void construct_arrays(char* block);
+    BTree<T>* make_node();              // new node from this tree's storage
+    void destroy_node(BTree<T>* node);  // free node from make_node()
 
     void copy(const BTree<T>& other);  // make unique copy from source
+    Iterator bound(const T& entry, bool is_upper) const;  // lower/upper
     void deallocate();
 
+    // binary image functions
+    enum { IMAGE_MAGIC = 0x31525442, IMAGE_VERSION = 1 };  // "BTR1"
+    void save_nodes(std::ostream& outs) const;  // preorder node records
+    void save_sorted(std::ostream& outs) const;  // in order entries
+    bool load_nodes(std::istream& ins, int level, int& leaf_level);
+    void build(std::vector<T>& items);  // bulk build from sorted entries
+
     inline bool is_leaf() const { return _child_count == 0; }  // check if leaf
     void update_size();
 
@@ -103,7 +241,9 @@ private:
  *  Default constructor.
  *
  * PRE-CONDITIONS:
- *  bool dups: allows duplicate items.
+ *  bool dups       : allows duplicate items.
+ *  std::size_t min : minimum entries per node
+ *  bool pooled     : allocate nodes from a NodePool owned by the tree
  *
  * POST-CONDITIONS:
  *  initializations
@@ -112,7 +252,7 @@ private:
  *  none
  ******************************************************************************/
 template <typename T>
-BTree<T>::BTree(bool dups, std::size_t min)
+BTree<T>::BTree(bool dups, std::size_t min, bool pooled)
     : _min(min),
       _max(2 * _min),
       _dups_ok(dups),
@@ -120,14 +260,18 @@ BTree<T>::BTree(bool dups, std::size_t min)
       _data_count(0),
       _data(nullptr),
       _child_count(0),
-      _subset(nullptr) {
-    _data = new T[_max + 1];
-    _subset = new BTree<T>*[_max + 2];
+      _subset(nullptr),
+      _pool(nullptr) {
+    if(pooled) _pool = new node_pool::NodePool(block_size());
+
+    // root's block is never pooled, so an empty tree takes no slab
+    construct_arrays(static_cast<char*>(::operator new(block_size())));
 }
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Destructor. Deallocates all heap memory from this object.
+ *  Destructor. Deallocates all heap memory from this object. The root also
+ *  frees its arrays' block and its NodePool.
  *
  * PRE-CONDITIONS:
  *  none
@@ -141,11 +285,18 @@ BTree<T>::BTree(bool dups, std::size_t min)
 template <typename T>
 BTree<T>::~BTree() {
     deallocate();
+    for(std::size_t i = 0; i <= _max; ++i) _data[i].~T();
+
+    // a node's block is freed by destroy_node(); the root frees its own
+    if(block() != reinterpret_cast<char*>(this)) {
+        ::operator delete(block());
+        delete _pool;
+    }
 }
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Copy constructor.
+ *  Copy constructor. The copy is pooled when src is.
  *
  * PRE-CONDITIONS:
  *  const BTree<T>& src: source BTree to copy
@@ -158,16 +309,7 @@ BTree<T>::~BTree() {
  ******************************************************************************/
 template <typename T>
 BTree<T>::BTree(const BTree<T>& src)
-    : _min(src._min),
-      _max(src._max),
-      _dups_ok(src._dups_ok),
-      _size(0),
-      _data_count(0),
-      _data(nullptr),
-      _child_count(0),
-      _subset(nullptr) {
-    _data = new T[_max + 1];
-    _subset = new BTree<T>*[_max + 2];
+    : BTree(src._dups_ok, src._min, src._pool != nullptr) {
     copy(src);
 }
 
@@ -187,10 +329,8 @@ BTree<T>::BTree(const BTree<T>& src)
 template <typename T>
 BTree<T>& BTree<T>::operator=(const BTree<T>& rhs) {
     if(this != &rhs) {
-        _min = rhs._min;
-        _max = rhs._max;
-        clear();
-        copy(rhs);
+        BTree<T> temp(rhs);  // copy into rhs's block size, then take it
+        swap(temp);
     }
     return *this;
 }
@@ -231,6 +371,81 @@ bool BTree<T>::empty() const {
     return _size == 0;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an Iterator to the smallest entry.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  BTree<T>::Iterator: end() if empty
+ ******************************************************************************/
+template <typename T>
+typename BTree<T>::Iterator BTree<T>::begin() const {
+    Iterator it;
+    it.push_leftmost(this);
+    it.pop_finished();  // empty root has no entry
+    return it;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the Iterator past the largest entry.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  BTree<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+typename BTree<T>::Iterator BTree<T>::end() const {
+    return Iterator();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an Iterator to the first entry that is not less than entry.
+ *
+ * PRE-CONDITIONS:
+ *  const T& entry: entry to search
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  BTree<T>::Iterator: end() if all entries are less than entry
+ ******************************************************************************/
+template <typename T>
+typename BTree<T>::Iterator BTree<T>::lower_bound(const T& entry) const {
+    return bound(entry, false);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns an Iterator to the first entry that is greater than entry.
+ *
+ * PRE-CONDITIONS:
+ *  const T& entry: entry to search
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  BTree<T>::Iterator: end() if no entry is greater than entry
+ ******************************************************************************/
+template <typename T>
+typename BTree<T>::Iterator BTree<T>::upper_bound(const T& entry) const {
+    return bound(entry, true);
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Returns const entry contained in the BTree. If the entry is invalid, throws
@@ -305,7 +520,7 @@ bool BTree<T>::insert(const T& entry) {
 
     if(loose_insert(entry)) {
         if(_data_count > _max) {
-            BTree<T>* new_node = new BTree<T>(_dups_ok, _min);  // xfer to new
+            BTree<T>* new_node = make_node();  // xfer to new
 
             // transfer 'this' data/subset to new node's data/subset
             transfer_array(_data, _data_count, new_node->_data,
@@ -362,7 +577,7 @@ bool BTree<T>::remove(const T& entry) {
             update_size();
 
             pop->_child_count = 0;  // prevent double delete
-            delete pop;
+            destroy_node(pop);
         }
         return true;
     } else
@@ -371,8 +586,8 @@ bool BTree<T>::remove(const T& entry) {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Deallocates all heap BTrees and clear data/subset counts. Reallocate data
- *  and subset.
+ *  Deallocates all heap BTrees and clear data/subset counts. The root keeps
+ *  its arrays.
  *
  * PRE-CONDITIONS:
  *  none
@@ -386,8 +601,33 @@ bool BTree<T>::remove(const T& entry) {
 template <typename T>
 void BTree<T>::clear() {
     deallocate();
-    _data = new T[_max + 1];
-    _subset = new BTree<T>*[_max + 2];
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Swap the root states and node pointers of two BTrees. Only the roots are
+ *  touched, as no node points back to its root.
+ *
+ * PRE-CONDITIONS:
+ *  BTree<T>& other: BTree to swap with
+ *
+ * POST-CONDITIONS:
+ *  'this' and other's states swapped
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BTree<T>::swap(BTree<T>& other) {
+    std::swap(_min, other._min);
+    std::swap(_max, other._max);
+    std::swap(_dups_ok, other._dups_ok);
+    std::swap(_size, other._size);
+    std::swap(_data_count, other._data_count);
+    std::swap(_data, other._data);
+    std::swap(_child_count, other._child_count);
+    std::swap(_subset, other._subset);
+    std::swap(_pool, other._pool);
 }
 
 /*******************************************************************************
@@ -498,6 +738,140 @@ bool BTree<T>::verify() const {
     return verify_tree(height, has_stored_height);
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Saves the tree to a binary image: its node structure, or its entries in
+ *  ascending order. See the header for the format.
+ *
+ * PRE-CONDITIONS:
+ *  std::ostream& outs: binary output stream
+ *  Image image       : NODE_IMAGE or SORTED_IMAGE
+ *
+ * POST-CONDITIONS:
+ *  image written to outs
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BTree<T>::save(std::ostream& outs, Image image) const {
+    using binary_io::write_binary;
+
+    write_binary(outs, static_cast<std::uint32_t>(IMAGE_MAGIC));
+    write_binary(outs, static_cast<std::uint32_t>(IMAGE_VERSION));
+    write_binary(outs, static_cast<std::uint8_t>(image));
+    write_binary(outs, static_cast<std::uint8_t>(_dups_ok));
+    write_binary(outs, static_cast<std::uint64_t>(_min));
+    write_binary(outs, static_cast<std::uint64_t>(_size));
+
+    if(image == NODE_IMAGE)
+        save_nodes(outs);
+    else
+        save_sorted(outs);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Loads a binary image from save(), replacing the tree. A node image takes
+ *  the saved min and dups; a sorted image keeps this tree's. The tree is
+ *  unchanged if the image is bad.
+ *
+ * PRE-CONDITIONS:
+ *  std::istream& ins: binary input stream at an image
+ *
+ * POST-CONDITIONS:
+ *  tree replaced; throws runtime_error if the image is bad or short
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BTree<T>::load(std::istream& ins) {
+    using binary_io::read_binary;
+
+    std::uint32_t magic = 0, version = 0;
+    std::uint8_t image = 0, dups = 0;
+    std::uint64_t min = 0, size = 0;
+    bool is_valid = false;
+
+    read_binary(ins, magic);
+    read_binary(ins, version);
+    read_binary(ins, image);
+    read_binary(ins, dups);
+    read_binary(ins, min);
+    read_binary(ins, size);
+
+    if(!ins || magic != IMAGE_MAGIC || version != IMAGE_VERSION)
+        throw std::runtime_error("BTree - invalid binary image");
+
+    if(image == NODE_IMAGE && min > 0) {
+        BTree<T> temp(dups != 0, min, _pool != nullptr);
+        int leaf_level = -1;
+
+        is_valid = temp.load_nodes(ins, 0, leaf_level) && temp._size == size;
+        if(is_valid) swap(temp);
+    } else if(image == SORTED_IMAGE) {
+        BTree<T> temp(_dups_ok, _min, _pool != nullptr);
+        std::vector<T> items;
+
+        items.reserve(size < (1 << 20) ? size : (1 << 20));  // trust size less
+        for(is_valid = true; is_valid && items.size() < size;) {
+            items.emplace_back();
+            read_binary(ins, items.back());
+            is_valid = ins && (items.size() == 1 ||
+                               items[items.size() - 2] < items.back());
+        }
+
+        if(is_valid) {
+            temp.build(items);
+            swap(temp);
+        }
+    }
+
+    if(!is_valid) throw std::runtime_error("BTree - invalid binary image");
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Finds the lower or upper bound of entry in one descent from the root,
+ *  pushing a frame per level. A found entry ends a lower bound; an upper
+ *  bound goes on past it into the next child.
+ *
+ * PRE-CONDITIONS:
+ *  const T& entry: entry to search
+ *  bool is_upper : true for first entry > entry; else first entry >= entry
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  BTree<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+typename BTree<T>::Iterator BTree<T>::bound(const T& entry,
+                                            bool is_upper) const {
+    Iterator it;
+
+    for(const BTree<T>* node = this; node;) {
+        std::size_t i =
+            array_utils::first_ge(node->_data, node->_data_count, entry);
+
+        if(i < node->_data_count && !(entry < node->_data[i])) {  // found
+            if(!is_upper) {
+                it._path.push_back({node, i});
+                return it;
+            }
+            ++i;  // upper bound is after entry
+        }
+
+        it._path.push_back({node, i});
+        node = node->is_leaf() ? nullptr : node->_subset[i];
+    }
+    it.pop_finished();  // bound is past the leaf; next is an ancestor's
+
+    return it;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Uniquely copies another BTree's into 'this'. REQUIREMENT: empty 'this'.
@@ -525,14 +899,14 @@ void BTree<T>::copy(const BTree<T>& other) {
 
     // copy subset
     for(std::size_t i = 0; i < other._child_count; ++i) {
-        _subset[i] = new BTree<T>(other._dups_ok, other._min);
+        _subset[i] = make_node();
         _subset[i]->copy(*other._subset[i]);
     }
 }
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Deallocates all heap BTrees and clear data/subset counts.
+ *  Deallocates all heap BTrees and release data. Clear data/subset counts.
  *
  * PRE-CONDITIONS:
  *  none
@@ -545,18 +919,359 @@ void BTree<T>::copy(const BTree<T>& other) {
  ******************************************************************************/
 template <typename T>
 void BTree<T>::deallocate() {
-    for(std::size_t i = 0; i < _child_count; ++i) {
-        _subset[i]->clear();  // recurse into subset
-        delete _subset[i];
-    }
+    for(std::size_t i = 0; i < _child_count; ++i)
+        destroy_node(_subset[i]);  // destructor recurses into subset
+    for(std::size_t i = 0; i < _data_count; ++i) _data[i] = T();
+
     _size = 0;
     _data_count = 0;
     _child_count = 0;  // must clear child to prevent double delete
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Writes the node and its subtrees in preorder, as node records.
+ *
+ * PRE-CONDITIONS:
+ *  std::ostream& outs: binary output stream
+ *
+ * POST-CONDITIONS:
+ *  node records written
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BTree<T>::save_nodes(std::ostream& outs) const {
+    using binary_io::write_binary;
+
+    write_binary(outs, static_cast<std::uint32_t>(_data_count));
+    write_binary(outs, static_cast<std::uint32_t>(_child_count));
+    for(std::size_t i = 0; i < _data_count; ++i) write_binary(outs, _data[i]);
+    for(std::size_t i = 0; i < _child_count; ++i)
+        _subset[i]->save_nodes(outs);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Writes the entries of the node and its subtrees in ascending order.
+ *
+ * PRE-CONDITIONS:
+ *  std::ostream& outs: binary output stream
+ *
+ * POST-CONDITIONS:
+ *  entries written
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BTree<T>::save_sorted(std::ostream& outs) const {
+    using binary_io::write_binary;
 
-    delete[] _data;
-    delete[] _subset;
-    _data = nullptr;    // set to nullptr to prevent double delete
-    _subset = nullptr;  // set to nullptr to prevent double delete
+    for(std::size_t i = 0; i < _data_count; ++i) {
+        if(!is_leaf()) _subset[i]->save_sorted(outs);
+        write_binary(outs, _data[i]);
+    }
+    if(!is_leaf()) _subset[_data_count]->save_sorted(outs);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Reads the node and its subtrees from preorder node records. Checks the
+ *  counts and that all leaves are at one level, but not the entries' order.
+ *
+ * PRE-CONDITIONS:
+ *  std::istream& ins: binary input stream at a node record
+ *  int level        : level of this node; root is 0
+ *  int& leaf_level  : level of leaves; -1 until the first leaf is read
+ *
+ * POST-CONDITIONS:
+ *  node read; may be partly read if invalid
+ *
+ * RETURN:
+ *  bool: false if the records are short or break the BTree rules
+ ******************************************************************************/
+template <typename T>
+bool BTree<T>::load_nodes(std::istream& ins, int level, int& leaf_level) {
+    using binary_io::read_binary;
+
+    std::uint32_t data_count = 0, child_count = 0;
+
+    read_binary(ins, data_count);
+    read_binary(ins, child_count);
+
+    if(!ins || data_count > _max || (level > 0 && data_count < _min) ||
+       (child_count > 0 && (data_count == 0 || child_count != data_count + 1)))
+        return false;
+
+    while(_data_count < data_count) read_binary(ins, _data[_data_count++]);
+
+    if(child_count == 0) {  // all leaves must be at one level
+        if(leaf_level < 0) leaf_level = level;
+        if(leaf_level != level) return false;
+    }
+
+    for(; _child_count < child_count; ++_child_count) {
+        _subset[_child_count] = make_node();
+        if(!_subset[_child_count]->load_nodes(ins, level + 1, leaf_level)) {
+            ++_child_count;  // child is destroyed with the tree
+            return false;
+        }
+    }
+    update_size();
+
+    return static_cast<bool>(ins);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Builds the empty tree from ascending unique entries, bottom up. Leaves
+ *  are filled evenly, with an entry between leaves kept as a separator.
+ *  Each upper level groups the nodes below evenly under up to _max+1
+ *  children, until one node is left; it becomes the root.
+ *
+ * PRE-CONDITIONS:
+ *  std::vector<T>& items: ascending unique entries; tree is empty
+ *
+ * POST-CONDITIONS:
+ *  tree holds items; items are moved from
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BTree<T>::build(std::vector<T>& items) {
+    using namespace array_utils;
+
+    if(items.empty()) return;
+
+    std::vector<BTree<T>*> nodes, parents;
+    std::vector<T> keys, parent_keys;  // separators between nodes
+
+    // leaves: n entries = leaf entries + (leaves - 1) separators
+    std::size_t leaves = (items.size() + 1 + _max) / (_max + 1),
+                entries = items.size() - (leaves - 1), next = 0;
+
+    for(std::size_t i = 0; i < leaves; ++i) {
+        BTree<T>* leaf = make_node();
+        std::size_t count = entries / leaves + (i < entries % leaves);
+
+        while(leaf->_data_count < count)
+            leaf->_data[leaf->_data_count++] = std::move(items[next++]);
+        leaf->update_size();
+        nodes.push_back(leaf);
+
+        if(i + 1 < leaves) keys.push_back(std::move(items[next++]));
+    }
+
+    while(nodes.size() > 1) {  // group nodes under parents
+        std::size_t count = (nodes.size() + _max) / (_max + 1);
+        next = 0;
+
+        for(std::size_t i = 0; i < count; ++i) {
+            BTree<T>* parent = make_node();
+            std::size_t children =
+                nodes.size() / count + (i < nodes.size() % count);
+
+            for(std::size_t j = 0; j < children; ++j, ++next) {
+                parent->_subset[parent->_child_count++] = nodes[next];
+                if(j + 1 < children)
+                    parent->_data[parent->_data_count++] =
+                        std::move(keys[next]);
+            }
+            parent->update_size();
+            parents.push_back(parent);
+
+            if(i + 1 < count) parent_keys.push_back(std::move(keys[next - 1]));
+        }
+
+        nodes.swap(parents);
+        keys.swap(parent_keys);
+        parents.clear();
+        parent_keys.clear();
+    }
+
+    // transfer the top node's data/subset to 'this', like remove()
+    BTree<T>* top = nodes[0];
+    transfer_array(top->_data, top->_data_count, _data, _data_count);
+    transfer_array(top->_subset, top->_child_count, _subset, _child_count);
+    update_size();
+    destroy_node(top);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Node constructor. Constructs a node whose arrays follow it in block.
+ *
+ * PRE-CONDITIONS:
+ *  bool dups                 : allows duplicate items.
+ *  std::size_t min           : minimum entries per node
+ *  node_pool::NodePool* pool : tree's pool; nullptr when not pooled
+ *  char* block               : block of block_size() bytes; 'this' is at it
+ *
+ * POST-CONDITIONS:
+ *  initializations
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+BTree<T>::BTree(bool dups, std::size_t min, node_pool::NodePool* pool,
+                char* block)
+    : _min(min),
+      _max(2 * _min),
+      _dups_ok(dups),
+      _size(0),
+      _data_count(0),
+      _data(nullptr),
+      _child_count(0),
+      _subset(nullptr),
+      _pool(pool) {
+    construct_arrays(block);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the offset of the subset array in a block: right after the node.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename T>
+std::size_t BTree<T>::subset_offset() const {
+    const std::size_t ALIGN = alignof(BTree<T>*);
+    return (sizeof(BTree<T>) + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the offset of the data array in a block: after _max+2 subsets.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename T>
+std::size_t BTree<T>::data_offset() const {
+    const std::size_t ALIGN = alignof(T);
+    std::size_t end = subset_offset() + (_max + 2) * sizeof(BTree<T>*);
+    return (end + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the bytes of a block: a node, its subset and its data arrays.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename T>
+std::size_t BTree<T>::block_size() const {
+    return data_offset() + (_max + 1) * sizeof(T);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the block holding 'this' arrays. A node made by make_node() is at
+ *  the start of its own block; the root's block is elsewhere.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  char*
+ ******************************************************************************/
+template <typename T>
+char* BTree<T>::block() const {
+    return reinterpret_cast<char*>(_subset) - subset_offset();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Points subset and data into block and constructs the empty data entries.
+ *
+ * PRE-CONDITIONS:
+ *  char* block: block of block_size() bytes
+ *
+ * POST-CONDITIONS:
+ *  _subset and _data point into block
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BTree<T>::construct_arrays(char* block) {
+    _subset = reinterpret_cast<BTree<T>**>(block + subset_offset());
+    _data = reinterpret_cast<T*>(block + data_offset());
+
+    for(std::size_t i = 0; i <= _max; ++i)
+        new(_data + i) T();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns a new empty node of this tree. The node and its arrays are built
+ *  in one block, taken from the tree's pool when pooled.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  BTree<T>*
+ ******************************************************************************/
+template <typename T>
+BTree<T>* BTree<T>::make_node() {
+    char* block = static_cast<char*>(_pool ? _pool->allocate()
+                                           : ::operator new(block_size()));
+
+    return new(block) BTree<T>(_dups_ok, _min, _pool, block);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Destroys a node from make_node() with its subsets, and frees its block.
+ *
+ * PRE-CONDITIONS:
+ *  BTree<T>* node: node from make_node()
+ *
+ * POST-CONDITIONS:
+ *  node freed
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void BTree<T>::destroy_node(BTree<T>* node) {
+    node->~BTree();
+
+    if(_pool)
+        _pool->deallocate(node);
+    else
+        ::operator delete(node);
 }
 
 /*******************************************************************************
@@ -643,7 +1358,7 @@ bool BTree<T>::loose_insert(const T& entry) {
  ******************************************************************************/
 template <typename T>
 void BTree<T>::fix_excess(std::size_t i) {
-    BTree<T>* new_node = new BTree<T>(_dups_ok, _min);  // xfer excess after mid
+    BTree<T>* new_node = make_node();  // xfer excess after mid
 
     // move elements after half of subset[i]'s data to new node's data
     array_utils::split(_subset[i]->_data, _subset[i]->_data_count,
@@ -877,7 +1592,7 @@ void BTree<T>::merge_with_next_subset(std::size_t i) {
                        _subset[i]->_subset, _subset[i]->_child_count);
 
     // deallocate empty subset[i+1] and remove subset[i+1] from subset
-    delete _subset[i + 1];
+    destroy_node(_subset[i + 1]);
     array_utils::delete_item(_subset, i + 1, _child_count);  // shift left
 
     _subset[i]->update_size();
@@ -6,59 +6,66 @@
  * DESCRIPTION : This header defines a templated ChainedHash via Binary Search
  *      Tree list AVL (Adelson-Velsky and Landis). Table size for hash class
  *      uses dynamic allocation for user specificed table size.
+ *      Each bucket is a FlatAVL, whose nodes share one vector, so a bucket
+ *      makes no heap allocation per record.
  *
- *      NOTE: Unlike Open/Double Hash, T's _key can be negative for hash insert.
+ *      T is a record type with a key_type _key (see hash_record::Record).
+ *      Keys are hashed by H, hasher::Hash<key_type> by default.
  ******************************************************************************/
 #ifndef CHAINED_AVL_HASH_H
 #define CHAINED_AVL_HASH_H
 
-#include <cassert>   // assert()
-#include <iomanip>   // setw()
-#include <iostream>  // stream objects
-#include <string>    // string objects
-#include "avl.h"     // BST's AVL class
+#include <cassert>     // assert()
+#include <iomanip>     // setw()
+#include <iostream>    // stream objects
+#include <string>      // string objects
+#include "flat_avl.h"  // FlatAVL class
+#include "hasher.h"    // Hash class
 
 namespace chained_avl_hash {
 
-template <typename T>
+template <typename T, typename H = hasher::Hash<typename T::key_type>>
 class ChainedAVLHash {
     enum { TABLE_SIZE = 811 };
 
 public:
+    typedef typename T::key_type key_type;
+
     // CONSTRUCTORS
-    ChainedAVLHash(std::size_t size = TABLE_SIZE);
+    ChainedAVLHash(std::size_t size = TABLE_SIZE, const H& hasher = H());
 
     // BIG THREE
     ~ChainedAVLHash();
-    ChainedAVLHash(const ChainedAVLHash<T>& src);
-    ChainedAVLHash<T>& operator=(const ChainedAVLHash<T>& rhs);
+    ChainedAVLHash(const ChainedAVLHash<T, H>& src);
+    ChainedAVLHash<T, H>& operator=(const ChainedAVLHash<T, H>& rhs);
 
     // ACCESSORS
-    std::size_t capacity() const;                 // total unique entries
-    std::size_t collisions() const { return 0; }  // dummy function
-    std::size_t size() const;                     // number of keys in the table
-    bool find(int key, T& result) const;          // result <- record with key
+    std::size_t capacity() const;                     // total unique entries
+    std::size_t collisions() const { return 0; }      // dummy function
+    std::size_t size() const;                         // number of keys
+    bool find(const key_type& key, T& result) const;  // result <- record
     std::ostream& print(std::ostream& outs = std::cout) const;
 
     // MUTATORS
-    void clear();                 // remove all items
-    bool insert(const T& entry);  // insert key, value pair
-    bool remove(int key);         // remove this key
+    void clear();                      // remove all items
+    bool insert(const T& entry);       // insert key, value pair
+    bool remove(const key_type& key);  // remove this key
 
     // FRIENDS
     // print entire table with keys, etc.
     friend std::ostream& operator<<(std::ostream& outs,
-                                    const ChainedAVLHash<T>& h) {
+                                    const ChainedAVLHash<T, H>& h) {
         return h.print(outs);
     }
 
 private:
-    std::size_t _table_size;     // capacity _data array
-    std::size_t _total_records;  // number of keys in the table
-    avl::AVL<T>* _data;          // table of avl list of Records
+    std::size_t _table_size;      // capacity _data array
+    std::size_t _total_records;   // number of keys in the table
+    flat_avl::FlatAVL<T>* _data;  // table of avl list of Records
+    H _hasher;                    // key -> hash value
 
     // ACCESSORS
-    inline std::size_t hash(int key) const;  // hash function
+    inline std::size_t hash(const key_type& key) const;  // hash function
 };
 
 /*******************************************************************************
@@ -67,7 +74,8 @@ private:
  *  _data array with _table_size attribute.
  *
  * PRE-CONDITIONS:
- *  none
+ *  std::size_t size: table size > 0
+ *  const H& hasher : key -> hash value
  *
  * POST-CONDITIONS:
  *  new memory allocated to _data
@@ -75,11 +83,11 @@ private:
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-ChainedAVLHash<T>::ChainedAVLHash(std::size_t size)
-    : _table_size(size), _total_records(0), _data(nullptr) {
+template <typename T, typename H>
+ChainedAVLHash<T, H>::ChainedAVLHash(std::size_t size, const H& hasher)
+    : _table_size(size), _total_records(0), _data(nullptr), _hasher(hasher) {
     assert(_table_size > 0);
-    _data = new avl::AVL<T>[_table_size];
+    _data = new flat_avl::FlatAVL<T>[_table_size];
 }
 
 /*******************************************************************************
@@ -95,8 +103,8 @@ ChainedAVLHash<T>::ChainedAVLHash(std::size_t size)
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-ChainedAVLHash<T>::~ChainedAVLHash() {
+template <typename T, typename H>
+ChainedAVLHash<T, H>::~ChainedAVLHash() {
     delete[] _data;
 }
 
@@ -113,12 +121,13 @@ ChainedAVLHash<T>::~ChainedAVLHash() {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-ChainedAVLHash<T>::ChainedAVLHash(const ChainedAVLHash<T>& src)
+template <typename T, typename H>
+ChainedAVLHash<T, H>::ChainedAVLHash(const ChainedAVLHash<T, H>& src)
     : _table_size(src._table_size),
       _total_records(src._total_records),
-      _data(nullptr) {
-    _data = new avl::AVL<T>[_table_size];
+      _data(nullptr),
+      _hasher(src._hasher) {
+    _data = new flat_avl::FlatAVL<T>[_table_size];
     for(std::size_t i = 0; i < _table_size; ++i) _data[i] = src._data[i];
 }
 
@@ -135,14 +144,16 @@ ChainedAVLHash<T>::ChainedAVLHash(const ChainedAVLHash<T>& src)
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-ChainedAVLHash<T>& ChainedAVLHash<T>::operator=(const ChainedAVLHash<T>& rhs) {
+template <typename T, typename H>
+ChainedAVLHash<T, H>& ChainedAVLHash<T, H>::operator=(
+    const ChainedAVLHash<T, H>& rhs) {
     if(this != &rhs) {
         delete[] _data;
         _table_size = rhs._table_size;
         _total_records = rhs._total_records;
+        _hasher = rhs._hasher;
 
-        _data = new avl::AVL<T>[_table_size];
+        _data = new flat_avl::FlatAVL<T>[_table_size];
         for(std::size_t i = 0; i < _table_size; ++i) _data[i] = rhs._data[i];
     }
 
@@ -162,8 +173,8 @@ ChainedAVLHash<T>& ChainedAVLHash<T>::operator=(const ChainedAVLHash<T>& rhs) {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::size_t ChainedAVLHash<T>::capacity() const {
+template <typename T, typename H>
+std::size_t ChainedAVLHash<T, H>::capacity() const {
     return _table_size;
 }
 
@@ -180,8 +191,8 @@ std::size_t ChainedAVLHash<T>::capacity() const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::size_t ChainedAVLHash<T>::size() const {
+template <typename T, typename H>
+std::size_t ChainedAVLHash<T, H>::size() const {
     return _total_records;
 }
 
@@ -198,14 +209,14 @@ std::size_t ChainedAVLHash<T>::size() const {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool ChainedAVLHash<T>::find(int key, T& result) const {
+template <typename T, typename H>
+bool ChainedAVLHash<T, H>::find(const key_type& key, T& result) const {
     bool is_found = false;
-    bst_node::TreeNode<T>* search;
+    const T* search = nullptr;
 
     is_found = _data[hash(key)].search(T(key), search);
 
-    if(is_found) result = search->_item;
+    if(is_found) result = *search;
 
     return is_found;
 }
@@ -223,15 +234,15 @@ bool ChainedAVLHash<T>::find(int key, T& result) const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::ostream& ChainedAVLHash<T>::print(std::ostream& outs) const {
+template <typename T, typename H>
+std::ostream& ChainedAVLHash<T, H>::print(std::ostream& outs) const {
     std::size_t size = std::to_string(_table_size).size();
 
     outs << std::setfill('0');
     for(std::size_t i = 0; i < _table_size; ++i) {
         outs << "[" << std::setw(size) << std::right << i << "] ";
 
-        _data[i].print_inorder();
+        _data[i].print_inorder(outs);
 
         outs << std::endl;
     }
@@ -252,8 +263,8 @@ std::ostream& ChainedAVLHash<T>::print(std::ostream& outs) const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-void ChainedAVLHash<T>::clear() {
+template <typename T, typename H>
+void ChainedAVLHash<T, H>::clear() {
     if(_data)
         for(std::size_t i = 0; i < _table_size; ++i) _data[i].clear();
 
@@ -271,16 +282,20 @@ void ChainedAVLHash<T>::clear() {
  *  none
  *
  * POST-CONDITIONS:
- *  _total_records + 1
+ *  _total_records + 1 if new key
  *  item added into _data
  *
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-bool ChainedAVLHash<T>::insert(const T& entry) {
-    _data[hash(entry._key)].reinsert(entry);  // reinsert allow modifications
-    ++_total_records;
+template <typename T, typename H>
+bool ChainedAVLHash<T, H>::insert(const T& entry) {
+    flat_avl::FlatAVL<T>& bucket = _data[hash(entry._key)];
+
+    if(bucket.insert(entry))
+        ++_total_records;
+    else
+        bucket.reinsert(entry);  // reinsert allow modifications
 
     return true;
 }
@@ -299,8 +314,8 @@ bool ChainedAVLHash<T>::insert(const T& entry) {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool ChainedAVLHash<T>::remove(int key) {
+template <typename T, typename H>
+bool ChainedAVLHash<T, H>::remove(const key_type& key) {
     bool is_removed = _data[hash(key)].erase(T(key));
     if(is_removed) --_total_records;
 
@@ -309,11 +324,11 @@ bool ChainedAVLHash<T>::remove(int key) {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Convert key to index position via mod TABLE_SIZE. Recommended TABLE_SIZE
- *  should be 4k + 3 and prime number.
+ *  Convert key's hash value to index position via mod _table_size.
+ *  Recommended _table_size should be 4k + 3 and prime number.
  *
  * PRE-CONDITIONS:
- *  int key: >= 0
+ *  const key_type& key: key
  *
  * POST-CONDITIONS:
  *  none
@@ -321,9 +336,9 @@ bool ChainedAVLHash<T>::remove(int key) {
  * RETURN:
  *  std::size_t: array index
  ******************************************************************************/
-template <typename T>
-std::size_t ChainedAVLHash<T>::hash(int key) const {
-    return key % _table_size;
+template <typename T, typename H>
+std::size_t ChainedAVLHash<T, H>::hash(const key_type& key) const {
+    return _hasher(key) % _table_size;
 }
 
 }  // namespace chained_avl_hash
@@ -7,7 +7,8 @@
  *      List. Table size for hash class uses dynamic allocation for user
  *      specificed table size.
  *
- *      NOTE: Unlike Open/Double Hash, T's _key can be negative for hash insert.
+ *      T is a record type with a key_type _key (see hash_record::Record).
+ *      Keys are hashed by H, hasher::Hash<key_type> by default.
  ******************************************************************************/
 #ifndef CHAINED_LIST_HASH_H
 #define CHAINED_LIST_HASH_H
@@ -16,39 +17,42 @@
 #include <iomanip>   // setw()
 #include <iostream>  // stream objects
 #include <string>    // string objects
+#include "hasher.h"  // Hash class
 #include "list.h"    // List class
 
 namespace chained_list_hash {
 
-template <typename T>
+template <typename T, typename H = hasher::Hash<typename T::key_type>>
 class ChainedListHash {
     enum { TABLE_SIZE = 811 };
 
 public:
+    typedef typename T::key_type key_type;
+
     // CONSTRUCTORS
-    ChainedListHash(std::size_t size = TABLE_SIZE);
+    ChainedListHash(std::size_t size = TABLE_SIZE, const H& hasher = H());
 
     // BIG THREE
     ~ChainedListHash();
-    ChainedListHash(const ChainedListHash<T>& src);
-    ChainedListHash<T>& operator=(const ChainedListHash<T>& rhs);
+    ChainedListHash(const ChainedListHash<T, H>& src);
+    ChainedListHash<T, H>& operator=(const ChainedListHash<T, H>& rhs);
 
     // ACCESSORS
-    std::size_t capacity() const;                 // total unique entries
-    std::size_t collisions() const { return 0; }  // dummy function
-    std::size_t size() const;                     // number of keys in the table
-    bool find(int key, T& result) const;          // result <- record with key
+    std::size_t capacity() const;                     // total unique entries
+    std::size_t collisions() const { return 0; }      // dummy function
+    std::size_t size() const;                         // number of keys
+    bool find(const key_type& key, T& result) const;  // result <- record
     std::ostream& print(std::ostream& outs = std::cout) const;
 
     // MUTATORS
-    void clear();                 // remove all items
-    bool insert(const T& entry);  // insert key, value pair
-    bool remove(int key);         // remove this key
+    void clear();                      // remove all items
+    bool insert(const T& entry);       // insert key, value pair
+    bool remove(const key_type& key);  // remove this key
 
     // FRIENDS
     // print entire table with keys, etc.
     friend std::ostream& operator<<(std::ostream& outs,
-                                    const ChainedListHash<T>& h) {
+                                    const ChainedListHash<T, H>& h) {
         return h.print(outs);
     }
 
@@ -56,9 +60,10 @@ private:
     std::size_t _table_size;     // capacity _data array
     std::size_t _total_records;  // number of keys in the table
     list::List<T>* _data;        // table of singly linked list of Records
+    H _hasher;                   // key -> hash value
 
     // ACCESSORS
-    inline std::size_t hash(int key) const;  // hash function
+    inline std::size_t hash(const key_type& key) const;  // hash function
 };
 
 /*******************************************************************************
@@ -67,7 +72,8 @@ private:
  *  _data array with _table_size attribute.
  *
  * PRE-CONDITIONS:
- *  none
+ *  std::size_t size: table size > 0
+ *  const H& hasher : key -> hash value
  *
  * POST-CONDITIONS:
  *  new memory allocated to _data
@@ -75,9 +81,9 @@ private:
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-ChainedListHash<T>::ChainedListHash(std::size_t size)
-    : _table_size(size), _total_records(0), _data(nullptr) {
+template <typename T, typename H>
+ChainedListHash<T, H>::ChainedListHash(std::size_t size, const H& hasher)
+    : _table_size(size), _total_records(0), _data(nullptr), _hasher(hasher) {
     assert(_table_size > 0);
     _data = new list::List<T>[_table_size];
 }
@@ -95,8 +101,8 @@ ChainedListHash<T>::ChainedListHash(std::size_t size)
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-ChainedListHash<T>::~ChainedListHash() {
+template <typename T, typename H>
+ChainedListHash<T, H>::~ChainedListHash() {
     delete[] _data;
 }
 
@@ -113,11 +119,12 @@ ChainedListHash<T>::~ChainedListHash() {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-ChainedListHash<T>::ChainedListHash(const ChainedListHash<T>& src)
+template <typename T, typename H>
+ChainedListHash<T, H>::ChainedListHash(const ChainedListHash<T, H>& src)
     : _table_size(src._table_size),
       _total_records(src._total_records),
-      _data(nullptr) {
+      _data(nullptr),
+      _hasher(src._hasher) {
     _data = new list::List<T>[_table_size];
     for(std::size_t i = 0; i < _table_size; ++i) _data[i] = src._data[i];
 }
@@ -135,13 +142,14 @@ ChainedListHash<T>::ChainedListHash(const ChainedListHash<T>& src)
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-ChainedListHash<T>& ChainedListHash<T>::operator=(
-    const ChainedListHash<T>& rhs) {
+template <typename T, typename H>
+ChainedListHash<T, H>& ChainedListHash<T, H>::operator=(
+    const ChainedListHash<T, H>& rhs) {
     if(this != &rhs) {
         delete[] _data;
         _table_size = rhs._table_size;
         _total_records = rhs._total_records;
+        _hasher = rhs._hasher;
 
         _data = new list::List<T>[_table_size];
         for(std::size_t i = 0; i < _table_size; ++i) _data[i] = rhs._data[i];
@@ -163,8 +171,8 @@ ChainedListHash<T>& ChainedListHash<T>::operator=(
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::size_t ChainedListHash<T>::capacity() const {
+template <typename T, typename H>
+std::size_t ChainedListHash<T, H>::capacity() const {
     return _table_size;
 }
 
@@ -181,8 +189,8 @@ std::size_t ChainedListHash<T>::capacity() const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::size_t ChainedListHash<T>::size() const {
+template <typename T, typename H>
+std::size_t ChainedListHash<T, H>::size() const {
     return _total_records;
 }
 
@@ -199,8 +207,8 @@ std::size_t ChainedListHash<T>::size() const {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool ChainedListHash<T>::find(int key, T& result) const {
+template <typename T, typename H>
+bool ChainedListHash<T, H>::find(const key_type& key, T& result) const {
     typename list::List<T>::Iterator search;
 
     search = _data[hash(key)].search(T(key));
@@ -223,8 +231,8 @@ bool ChainedListHash<T>::find(int key, T& result) const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::ostream& ChainedListHash<T>::print(std::ostream& outs) const {
+template <typename T, typename H>
+std::ostream& ChainedListHash<T, H>::print(std::ostream& outs) const {
     std::size_t size = std::to_string(_table_size).size();
 
     outs << std::setfill('0');
@@ -248,8 +256,8 @@ std::ostream& ChainedListHash<T>::print(std::ostream& outs) const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-void ChainedListHash<T>::clear() {
+template <typename T, typename H>
+void ChainedListHash<T, H>::clear() {
     if(_data)
         for(std::size_t i = 0; i < _table_size; ++i) _data[i].clear();
 
@@ -265,23 +273,23 @@ void ChainedListHash<T>::clear() {
  *  none
  *
  * POST-CONDITIONS:
- *  _total_records + 1
+ *  _total_records + 1 if new key
  *  item added into _data
  *
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool ChainedListHash<T>::insert(const T& entry) {
-    typename list::List<T>::Iterator search;
-    search = _data[hash(entry._key)].search(entry);
+template <typename T, typename H>
+bool ChainedListHash<T, H>::insert(const T& entry) {
+    list::List<T>& bucket = _data[hash(entry._key)];
+    typename list::List<T>::Iterator search = bucket.search(entry);
 
     if(search)
         *search = entry;
-    else
-        _data[hash(entry._key)].push_back(entry);
-
-    ++_total_records;
+    else {
+        bucket.push_back(entry);
+        ++_total_records;
+    }
 
     return true;
 }
@@ -300,8 +308,8 @@ bool ChainedListHash<T>::insert(const T& entry) {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool ChainedListHash<T>::remove(int key) {
+template <typename T, typename H>
+bool ChainedListHash<T, H>::remove(const key_type& key) {
     bool is_removed = _data[hash(key)].remove(T(key));
     if(is_removed) --_total_records;
 
@@ -310,11 +318,11 @@ bool ChainedListHash<T>::remove(int key) {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Convert key to index position via mod TABLE_SIZE. Recommended TABLE_SIZE
- *  should be 4k + 3 and prime number.
+ *  Convert key's hash value to index position via mod _table_size.
+ *  Recommended _table_size should be 4k + 3 and prime number.
  *
  * PRE-CONDITIONS:
- *  int key: >= 0
+ *  const key_type& key: key
  *
  * POST-CONDITIONS:
  *  none
@@ -322,9 +330,9 @@ bool ChainedListHash<T>::remove(int key) {
  * RETURN:
  *  std::size_t: array index
  ******************************************************************************/
-template <typename T>
-std::size_t ChainedListHash<T>::hash(int key) const {
-    return key % _table_size;
+template <typename T, typename H>
+std::size_t ChainedListHash<T, H>::hash(const key_type& key) const {
+    return _hasher(key) % _table_size;
 }
 
 }  // namespace chained_list_hash
@@ -0,0 +1,1500 @@
+/*******************************************************************************
+ * AUTHOR      : Thuan Tang
+ * ID          : 00991588
+ * CLASS       : CS008
+ * HEADER      : concurrent_bptree
+ * DESCRIPTION : This header provides a templated thread-safe B+Tree, the
+ *      ConcurrentBPTree. find, lower_bound, upper_bound, iteration, insert
+ *      and remove may be called from many threads at once without an outside
+ *      mutex.
+ *
+ *      LOCKING:
+ *      Every node has a reader/writer latch. Lookups descend with shared
+ *      latches, coupling hand-over-hand: the child is latched before the
+ *      parent is released, so at most two latches are held.
+ *
+ *      Writers are optimistic: they descend like a lookup but latch the leaf
+ *      exclusively. If the leaf has room for an insert, or keeps _min
+ *      entries after a remove, the change is done there. Otherwise the writer
+ *      restarts, latching exclusively from the root down and releasing every
+ *      ancestor above a child that can't split (or fall under _min), so a
+ *      split or merge holds only the nodes it changes. Latches are taken
+ *      top-down, and left to right between siblings, so writers can't
+ *      deadlock.
+ *
+ *      RULES (differences from BPTree):
+ *      1. Splits move the upper half to a new right sibling. A node under
+ *         _min merges with a sibling if both fit in one node, else borrows
+ *         from its left sibling. A leaf can't borrow from its right sibling,
+ *         so a first child leaf may stay under _min. An inner key may have
+ *         no leaf entry; it is still a valid bound.
+ *      2. Entries only move right, except by a merge. A merged away leaf is
+ *         emptied and its _next points back to the leaf it merged into.
+ *         An Iterator holds a copy of its entry and the leaf; ++ finds the
+ *         next greater entry in that leaf or to its right along _next.
+ *         Iteration sees every entry that exists for the whole scan, and
+ *         may or may not see concurrent changes.
+ *      3. Merged away nodes are retired, not deleted. Lookups and iterators
+ *         hold an epoch guard; a retired node is deleted by a later retire
+ *         once every guard entered before it was retired has left. A live
+ *         iterator keeps the nodes retired since it was made in memory.
+ *
+ *      clear(), copy and the destructor are not thread-safe.
+ ******************************************************************************/
+#ifndef CONCURRENT_BPTREE_H
+#define CONCURRENT_BPTREE_H
+
+#include <atomic>        // atomic
+#include <cassert>       // assert()
+#include <iostream>      // ostream
+#include <mutex>         // mutex, lock_guard, unique_lock
+#include <shared_mutex>  // shared_timed_mutex
+#include <stdexcept>     // invalid_argument
+#include <utility>       // move(), swap()
+#include <vector>        // vector
+
+namespace concurrent_bptree {
+enum { MINIMUM = 16 };
+
+template <class T>
+class ConcurrentBPTree {
+private:
+    struct Node;
+
+    class Guard {  // keeps nodes retired after enter() from being deleted
+    public:
+        Guard() : _tree(nullptr), _epoch(0) {}
+        Guard(const Guard& src) : _tree(src._tree), _epoch(src._epoch) {
+            if(_tree) ++_tree->_active[_epoch % 3];  // src holds epoch
+        }
+        ~Guard() { leave(); }
+        Guard& operator=(const Guard& rhs) {
+            if(this != &rhs) {
+                Guard copy(rhs);
+                std::swap(_tree, copy._tree);
+                std::swap(_epoch, copy._epoch);
+            }
+            return *this;
+        }
+
+        void enter(ConcurrentBPTree* tree) {
+            leave();
+            _epoch = tree->enter();
+            _tree = tree;
+        }
+
+        void leave() {
+            if(_tree) --_tree->_active[_epoch % 3];
+            _tree = nullptr;
+        }
+
+    private:
+        ConcurrentBPTree* _tree;
+        std::size_t _epoch;
+    };
+
+public:
+    class Iterator {
+    public:
+        friend class ConcurrentBPTree;
+
+        // CONSTRUCTOR
+        Iterator(Node* leaf = nullptr)
+            : _leaf(leaf), _index(0), _entry(), _guard() {}
+
+        bool is_null() { return !_leaf; }
+        explicit operator bool() { return _leaf; }
+
+        const T& operator*() {
+            if(!_leaf)
+                throw std::invalid_argument(
+                    "ConcurrentBPTree::Iterator - nullptr check");
+
+            return _entry;
+        }
+
+        const T* operator->() { return &operator*(); }
+
+        Iterator& operator++() {  // pre-inc
+            if(_leaf) seek_next();
+            return *this;
+        }
+
+        Iterator operator++(int _u) {  // post-inc
+            (void)_u;                  // suppress unused warning
+            Iterator it = *this;       // make temp
+            operator++();              // pre-inc
+            return it;                 // return previous state
+        }
+
+        // FRIENDS
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs._leaf == rhs._leaf &&
+                   (!lhs._leaf || (!(lhs._entry < rhs._entry) &&
+                                       !(rhs._entry < lhs._entry)));
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        Node* _leaf;         // leaf of last copied entry
+        std::size_t _index;  // index of entry in leaf when copied
+        T _entry;            // copy of entry
+        Guard _guard;        // keeps _leaf and leaves right of it in memory
+
+        // copy first entry >= key (> key if not inclusive) from leaf rightward
+        template <typename U>
+        void seek(Node* leaf, const U& key, bool is_inclusive);
+        void seek_first(Node* leaf);  // copy first entry from leaf rightward
+        void seek_next();             // copy next entry after _entry
+    };
+
+    // CONSTRUCTOR
+    ConcurrentBPTree(bool dups = false, std::size_t min = MINIMUM);
+
+    // BIG THREE
+    ~ConcurrentBPTree();
+    ConcurrentBPTree(const ConcurrentBPTree<T>& src);
+    ConcurrentBPTree<T>& operator=(const ConcurrentBPTree<T>& rhs);
+
+    // capacity
+    std::size_t size() const;
+    bool empty() const;
+
+    // element access
+    Iterator begin();
+    Iterator end();
+    // lookups take T or any U where T < U and U < T compare (ie: a key)
+    template <typename U>
+    Iterator find(const U& entry);
+    template <typename U>
+    Iterator lower_bound(const U& entry);
+    template <typename U>
+    Iterator upper_bound(const U& entry);
+
+    // modifiers
+    bool insert(const T& entry);  // merges duplicates by += if dups_ok
+    bool remove(const T& entry);
+    void clear();  // not thread-safe
+
+    // misc
+    template <typename U>
+    bool contains(const U& entry);
+    void print(std::ostream& outs = std::cout) const;  // not thread-safe
+    bool verify() const;                                // not thread-safe
+
+    // FRIENDS
+    friend std::ostream& operator<<(std::ostream& outs,
+                                    const ConcurrentBPTree<T>& bt) {
+        bt.print(outs);
+        return outs;
+    }
+
+private:
+    typedef std::shared_timed_mutex Latch;
+    typedef std::unique_lock<Latch> WriteLock;
+
+    struct Node {
+        Latch latch;
+        bool is_leaf;
+        std::vector<T> data;          // entries or inner keys
+        std::vector<Node*> children;  // inner: data.size() + 1 children
+        Node* next;                   // next leaf; nullptr if last
+
+        Node(bool leaf) : latch(), is_leaf(leaf), data(), children(),
+                          next(nullptr) {}
+    };
+
+    std::size_t _min;                // minimum entries per split node
+    std::size_t _max;                // 2x min entries
+    bool _dups_ok;                   // true if duplicates merge by +=
+    std::atomic<std::size_t> _size;  // count of all entries
+    Latch _root_latch;               // guards _root; taken before root node
+    Node* _root;
+
+    // reclamation: guards live only in the current and previous epoch
+    std::atomic<std::size_t> _epoch;      // current epoch
+    std::atomic<std::size_t> _active[3];  // guards entered per epoch % 3
+    std::mutex _retire_mutex;             // guards _retired and advancing
+    std::vector<Node*> _retired[3];       // nodes retired per epoch % 3
+
+    void deallocate(Node* node);
+    void deallocate_retired();
+    Node* copy(const Node* node, Node*& last_leaf);
+    std::size_t enter();      // returns epoch of a new guard
+    void retire(Node* node);  // delete node once no guard can reach it
+
+    // search
+    template <typename U>
+    static std::size_t first_ge(const std::vector<T>& data, const U& entry);
+    template <typename U>
+    static std::size_t first_gt(const std::vector<T>& data, const U& entry);
+    template <typename U>
+    Node* find_leaf(const U& entry);  // returns leaf with shared latch
+
+    // insert
+    int optimistic_insert(const T& entry);  // -1 if leaf full, else 0 or 1
+    bool pessimistic_insert(const T& entry);
+    bool insert_leaf(Node* leaf, const T& entry);
+    void split(Node* node, T& key, Node*& right);
+
+    // remove
+    int optimistic_remove(const T& entry);  // -1 if leaf short, else 0 or 1
+    bool pessimistic_remove(const T& entry);
+    void fix_shortage(Node* parent, std::size_t i);  // merge/borrow child i
+    void merge(Node* parent, std::size_t i);  // merge child i + 1 into i
+
+    void print(const Node* node, std::ostream& outs, int level) const;
+    bool verify(const Node* node, int level, int& height, const T* low,
+                const T* high, std::size_t& count) const;
+};
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Copies the first entry >= key (> key if not inclusive), starting at leaf
+ *  and following the _next links. One leaf is latched at a time; the guard
+ *  keeps leaves in memory, and entries only move right or into the leaf a
+ *  merged leaf links to, so no entry can be skipped.
+ *
+ * PRE-CONDITIONS:
+ *  Node* leaf        : leaf at or left of key
+ *  const U& key      : target entry
+ *  bool is_inclusive : true to match an equal entry
+ *
+ * POST-CONDITIONS:
+ *  _leaf and _entry set; _leaf is nullptr if no entry is found
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+void ConcurrentBPTree<T>::Iterator::seek(Node* leaf, const U& key,
+                                         bool is_inclusive) {
+    while(leaf) {
+        std::shared_lock<Latch> lock(leaf->latch);
+        std::size_t i = is_inclusive ? first_ge(leaf->data, key)
+                                     : first_gt(leaf->data, key);
+
+        if(i < leaf->data.size()) {
+            _entry = leaf->data[i];
+            _leaf = leaf;
+            _index = i;
+            return;
+        }
+
+        leaf = leaf->next;
+    }
+
+    _leaf = nullptr;
+    _guard.leave();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Copies the first entry of leaf, or of the first nonempty leaf to its
+ *  right.
+ *
+ * PRE-CONDITIONS:
+ *  Node* leaf: any leaf
+ *
+ * POST-CONDITIONS:
+ *  _leaf and _entry set; _leaf is nullptr if no entry is found
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void ConcurrentBPTree<T>::Iterator::seek_first(Node* leaf) {
+    while(leaf) {
+        std::shared_lock<Latch> lock(leaf->latch);
+
+        if(!leaf->data.empty()) {
+            _entry = leaf->data.front();
+            _leaf = leaf;
+            _index = 0;
+            return;
+        }
+
+        leaf = leaf->next;
+    }
+
+    _leaf = nullptr;
+    _guard.leave();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Copies the entry after _entry. If _entry is still at _index of its leaf,
+ *  the next entry is taken without a search; else seeks from the leaf.
+ *
+ * PRE-CONDITIONS:
+ *  _leaf is not nullptr
+ *
+ * POST-CONDITIONS:
+ *  _leaf and _entry set; _leaf is nullptr if no entry is found
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void ConcurrentBPTree<T>::Iterator::seek_next() {
+    {
+        std::shared_lock<Latch> lock(_leaf->latch);
+        const std::vector<T>& data = _leaf->data;
+
+        if(_index + 1 < data.size() && !(data[_index] < _entry) &&
+           !(_entry < data[_index])) {  // leaf unchanged at _entry
+            _entry = data[++_index];
+            return;
+        }
+    }
+
+    seek(_leaf, _entry, false);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Constructor.
+ *
+ * PRE-CONDITIONS:
+ *  bool dups      : true if duplicates merge by +=
+ *  std::size_t min: minimum entries, at least 1
+ *
+ * POST-CONDITIONS:
+ *  empty root leaf
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+ConcurrentBPTree<T>::ConcurrentBPTree(bool dups, std::size_t min)
+    : _min(min ? min : 1),
+      _max(2 * _min),
+      _dups_ok(dups),
+      _size(0),
+      _root_latch(),
+      _root(new Node(true)),
+      _epoch(0),
+      _retire_mutex(),
+      _retired() {
+    for(auto& active : _active) active = 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Destructor.
+ *
+ * PRE-CONDITIONS:
+ *  no other thread uses the tree
+ *
+ * POST-CONDITIONS:
+ *  all nodes, including retired nodes, deallocated
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+ConcurrentBPTree<T>::~ConcurrentBPTree() {
+    deallocate(_root);
+    deallocate_retired();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Copy constructor.
+ *
+ * PRE-CONDITIONS:
+ *  const ConcurrentBPTree<T>& src: no other thread changes src
+ *
+ * POST-CONDITIONS:
+ *  deep copy of src
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+ConcurrentBPTree<T>::ConcurrentBPTree(const ConcurrentBPTree<T>& src)
+    : _min(src._min),
+      _max(src._max),
+      _dups_ok(src._dups_ok),
+      _size(src._size.load()),
+      _root_latch(),
+      _root(nullptr),
+      _epoch(0),
+      _retire_mutex(),
+      _retired() {
+    Node* last_leaf = nullptr;
+
+    for(auto& active : _active) active = 0;
+    _root = copy(src._root, last_leaf);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Assignment operator.
+ *
+ * PRE-CONDITIONS:
+ *  const ConcurrentBPTree<T>& rhs: no other thread uses either tree
+ *
+ * POST-CONDITIONS:
+ *  deep copy of rhs
+ *
+ * RETURN:
+ *  self
+ ******************************************************************************/
+template <typename T>
+ConcurrentBPTree<T>& ConcurrentBPTree<T>::operator=(
+    const ConcurrentBPTree<T>& rhs) {
+    if(this != &rhs) {
+        Node* last_leaf = nullptr;
+        Node* root = copy(rhs._root, last_leaf);
+
+        deallocate(_root);
+        _root = root;
+        _min = rhs._min;
+        _max = rhs._max;
+        _dups_ok = rhs._dups_ok;
+        _size = rhs._size.load();
+    }
+
+    return *this;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns total entries in tree.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename T>
+std::size_t ConcurrentBPTree<T>::size() const {
+    return _size.load();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if tree is empty.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+bool ConcurrentBPTree<T>::empty() const {
+    return _size.load() == 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the first entry.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  ConcurrentBPTree<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+typename ConcurrentBPTree<T>::Iterator ConcurrentBPTree<T>::begin() {
+    Iterator it;
+
+    it._guard.enter(this);
+
+    std::shared_lock<Latch> parent(_root_latch);
+    Node* node = _root;
+    std::shared_lock<Latch> lock(node->latch);
+
+    parent.unlock();
+    while(!node->is_leaf) {  // couple down the leftmost children
+        Node* child = node->children.front();
+        std::shared_lock<Latch> child_lock(child->latch);
+
+        lock.swap(child_lock);  // child_lock releases parent
+        node = child;
+    }
+
+    lock.unlock();
+    it.seek_first(node);
+
+    return it;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator past the last entry.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  ConcurrentBPTree<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+typename ConcurrentBPTree<T>::Iterator ConcurrentBPTree<T>::end() {
+    return Iterator(nullptr);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to a copy of entry; else end().
+ *
+ * PRE-CONDITIONS:
+ *  const U& entry: target entry
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  ConcurrentBPTree<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+typename ConcurrentBPTree<T>::Iterator ConcurrentBPTree<T>::find(
+    const U& entry) {
+    Iterator it = lower_bound(entry);
+
+    if(it && (entry < it._entry || it._entry < entry)) {
+        it._leaf = nullptr;
+        it._guard.leave();
+    }
+
+    return it;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the first entry greater than or equal to entry.
+ *
+ * PRE-CONDITIONS:
+ *  const U& entry: target entry
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  ConcurrentBPTree<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+typename ConcurrentBPTree<T>::Iterator ConcurrentBPTree<T>::lower_bound(
+    const U& entry) {
+    Iterator it;
+
+    it._guard.enter(this);
+
+    Node* leaf = find_leaf(entry);
+
+    leaf->latch.unlock_shared();
+    it.seek(leaf, entry, true);
+
+    return it;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the first entry greater than entry.
+ *
+ * PRE-CONDITIONS:
+ *  const U& entry: target entry
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  ConcurrentBPTree<T>::Iterator
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+typename ConcurrentBPTree<T>::Iterator ConcurrentBPTree<T>::upper_bound(
+    const U& entry) {
+    Iterator it;
+
+    it._guard.enter(this);
+
+    Node* leaf = find_leaf(entry);
+
+    leaf->latch.unlock_shared();
+    it.seek(leaf, entry, false);
+
+    return it;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts an entry. Tries the optimistic path first; a full leaf retries
+ *  with exclusive latches from the root.
+ *
+ * PRE-CONDITIONS:
+ *  const T& entry: entry to insert
+ *
+ * POST-CONDITIONS:
+ *  entry inserted, or merged by += if dups_ok
+ *
+ * RETURN:
+ *  bool: false if entry exists and dups not ok
+ ******************************************************************************/
+template <typename T>
+bool ConcurrentBPTree<T>::insert(const T& entry) {
+    int status = optimistic_insert(entry);
+
+    return status < 0 ? pessimistic_insert(entry) : status;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Removes an entry. Tries the optimistic path first; a leaf that would fall
+ *  under _min retries with exclusive latches from the root.
+ *
+ * PRE-CONDITIONS:
+ *  const T& entry: entry to remove
+ *
+ * POST-CONDITIONS:
+ *  entry removed if found
+ *
+ * RETURN:
+ *  bool: true if removed
+ ******************************************************************************/
+template <typename T>
+bool ConcurrentBPTree<T>::remove(const T& entry) {
+    int status = optimistic_remove(entry);
+
+    return status < 0 ? pessimistic_remove(entry) : status;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Deallocates all nodes and resets to an empty root leaf.
+ *
+ * PRE-CONDITIONS:
+ *  no other thread uses the tree
+ *
+ * POST-CONDITIONS:
+ *  tree is empty
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void ConcurrentBPTree<T>::clear() {
+    deallocate(_root);
+    deallocate_retired();
+    _root = new Node(true);
+    _size = 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if entry is in tree.
+ *
+ * PRE-CONDITIONS:
+ *  const U& entry: target entry
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+bool ConcurrentBPTree<T>::contains(const U& entry) {
+    return (bool)find(entry);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Prints the tree sideways; root at the left.
+ *
+ * PRE-CONDITIONS:
+ *  std::ostream& outs: out stream
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void ConcurrentBPTree<T>::print(std::ostream& outs) const {
+    print(_root, outs, 0);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if the tree's rules are valid: entries in order and within their
+ *  parent's keys, all leaves at the same level, no node over _max entries,
+ *  leaves linked in order and size matches.
+ *
+ * PRE-CONDITIONS:
+ *  no other thread changes the tree
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+bool ConcurrentBPTree<T>::verify() const {
+    int height = -1;
+    std::size_t count = 0;
+
+    if(!verify(_root, 0, height, nullptr, nullptr, count) || count != _size)
+        return false;
+
+    const Node* leaf = _root;
+    const T* previous = nullptr;
+
+    while(!leaf->is_leaf) leaf = leaf->children.front();
+
+    for(count = 0; leaf; leaf = leaf->next)  // walk leaf links
+        for(const auto& item : leaf->data) {
+            if(previous && !(*previous < item)) return false;
+            previous = &item;
+            ++count;
+        }
+
+    return count == _size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Recursively deallocates a subtree.
+ *
+ * PRE-CONDITIONS:
+ *  Node* node: root of subtree
+ *
+ * POST-CONDITIONS:
+ *  nodes deallocated
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void ConcurrentBPTree<T>::deallocate(Node* node) {
+    if(!node) return;
+
+    for(Node* child : node->children) deallocate(child);
+    delete node;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Deallocates all retired nodes.
+ *
+ * PRE-CONDITIONS:
+ *  no other thread uses the tree
+ *
+ * POST-CONDITIONS:
+ *  retired lists are empty
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void ConcurrentBPTree<T>::deallocate_retired() {
+    for(auto& retired : _retired) {
+        for(Node* node : retired) delete node;
+        retired.clear();
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Recursively copies a subtree and relinks the copied leaves.
+ *
+ * PRE-CONDITIONS:
+ *  const Node* node: root of subtree
+ *  Node*& last_leaf: last copied leaf; nullptr if none
+ *
+ * POST-CONDITIONS:
+ *  Node*& last_leaf: last leaf in the copied subtree
+ *
+ * RETURN:
+ *  Node*: copied subtree
+ ******************************************************************************/
+template <typename T>
+typename ConcurrentBPTree<T>::Node* ConcurrentBPTree<T>::copy(
+    const Node* node, Node*& last_leaf) {
+    Node* copied = new Node(node->is_leaf);
+    copied->data = node->data;
+
+    if(node->is_leaf) {
+        if(last_leaf) last_leaf->next = copied;
+        last_leaf = copied;
+    }
+
+    for(const Node* child : node->children)
+        copied->children.push_back(copy(child, last_leaf));
+
+    return copied;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Registers a guard in the current epoch. If the epoch advances before the
+ *  guard is counted, it retries, so a counted guard's epoch is never older
+ *  than the previous epoch.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  _active of the returned epoch inc
+ *
+ * RETURN:
+ *  std::size_t: epoch of guard
+ ******************************************************************************/
+template <typename T>
+std::size_t ConcurrentBPTree<T>::enter() {
+    while(true) {
+        std::size_t epoch = _epoch.load();
+
+        ++_active[epoch % 3];
+        if(_epoch.load() == epoch) return epoch;
+        --_active[epoch % 3];
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Retires a node no longer reachable from the tree, then tries to advance
+ *  the epoch. The epoch advances when no guard is left in the previous
+ *  epoch; the nodes retired two epochs back can't be reached by any guard
+ *  left, so they are deleted.
+ *
+ * PRE-CONDITIONS:
+ *  Node* node: node unlinked from the tree and its leaves
+ *
+ * POST-CONDITIONS:
+ *  node added to _retired of current epoch
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void ConcurrentBPTree<T>::retire(Node* node) {
+    std::lock_guard<std::mutex> lock(_retire_mutex);
+    std::size_t epoch = _epoch.load();
+
+    _retired[epoch % 3].push_back(node);
+
+    if(!_active[(epoch + 2) % 3].load()) {  // previous epoch has left
+        std::vector<Node*>& oldest = _retired[(epoch + 1) % 3];
+
+        for(Node* retired : oldest) delete retired;
+        oldest.clear();
+        _epoch.store(epoch + 1);
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Find the index of the first entry that's greater than or equal to entry.
+ *
+ * PRE-CONDITIONS:
+ *  const std::vector<T>& data: sorted entries
+ *  const U& entry            : target entry
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: index
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+std::size_t ConcurrentBPTree<T>::first_ge(const std::vector<T>& data,
+                                          const U& entry) {
+    std::size_t walker = 0;  // forward walker
+    while(walker < data.size() && data[walker] < entry) ++walker;
+
+    return walker;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Find the index of the first entry that's greater than entry.
+ *
+ * PRE-CONDITIONS:
+ *  const std::vector<T>& data: sorted entries
+ *  const U& entry            : target entry
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: index
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+std::size_t ConcurrentBPTree<T>::first_gt(const std::vector<T>& data,
+                                          const U& entry) {
+    std::size_t walker = 0;  // forward walker
+    while(walker < data.size() && !(entry < data[walker])) ++walker;
+
+    return walker;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Descends to the leaf for entry with shared latch coupling. Child i of an
+ *  inner node holds the entries >= key i - 1 and < key i.
+ *
+ * PRE-CONDITIONS:
+ *  const U& entry: target entry
+ *
+ * POST-CONDITIONS:
+ *  leaf latched shared; caller must unlock_shared()
+ *
+ * RETURN:
+ *  Node*: leaf
+ ******************************************************************************/
+template <typename T>
+template <typename U>
+typename ConcurrentBPTree<T>::Node* ConcurrentBPTree<T>::find_leaf(
+    const U& entry) {
+    _root_latch.lock_shared();
+    Node* node = _root;
+    node->latch.lock_shared();
+    _root_latch.unlock_shared();
+
+    while(!node->is_leaf) {
+        Node* child = node->children[first_gt(node->data, entry)];
+
+        child->latch.lock_shared();
+        node->latch.unlock_shared();
+        node = child;
+    }
+
+    return node;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts entry with shared latches down to the leaf's parent and an
+ *  exclusive latch on the leaf. Gives up if the leaf would split.
+ *
+ * PRE-CONDITIONS:
+ *  const T& entry: entry to insert
+ *
+ * POST-CONDITIONS:
+ *  entry inserted if status is not -1
+ *
+ * RETURN:
+ *  int: -1 if leaf is full, 1 if inserted or merged, 0 if duplicate
+ ******************************************************************************/
+template <typename T>
+int ConcurrentBPTree<T>::optimistic_insert(const T& entry) {
+    std::shared_lock<Latch> parent(_root_latch);
+    Node* node = _root;
+    std::shared_lock<Latch> lock;
+
+    if(!node->is_leaf) {
+        lock = std::shared_lock<Latch>(node->latch);
+        parent.unlock();
+
+        while(true) {  // couple down to the parent of the leaf
+            Node* child = node->children[first_gt(node->data, entry)];
+            if(child->is_leaf) {
+                node = child;
+                break;
+            }
+
+            std::shared_lock<Latch> child_lock(child->latch);
+            lock.swap(child_lock);  // child_lock releases parent
+            node = child;
+        }
+    }
+
+    WriteLock leaf(node->latch);
+    if(parent) parent.unlock();
+    if(lock) lock.unlock();
+
+    std::size_t i = first_ge(node->data, entry);
+    bool is_found = i < node->data.size() && !(entry < node->data[i]);
+
+    if(!is_found && node->data.size() >= _max) return -1;
+
+    return insert_leaf(node, entry);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts entry with exclusive latches from the root. A latched node with
+ *  room to take a key from a child split releases its ancestors. Full
+ *  nodes on the way back up are split.
+ *
+ * PRE-CONDITIONS:
+ *  const T& entry: entry to insert
+ *
+ * POST-CONDITIONS:
+ *  entry inserted, or merged by += if dups_ok
+ *
+ * RETURN:
+ *  bool: false if entry exists and dups not ok
+ ******************************************************************************/
+template <typename T>
+bool ConcurrentBPTree<T>::pessimistic_insert(const T& entry) {
+    WriteLock root_lock(_root_latch);
+    std::vector<WriteLock> locks;  // latched path from highest unsafe node
+    std::vector<Node*> path;
+    Node* node = _root;
+
+    locks.emplace_back(node->latch);
+    path.push_back(node);
+    if(node->data.size() < _max) root_lock.unlock();  // root can't split
+
+    while(!node->is_leaf) {
+        Node* child = node->children[first_gt(node->data, entry)];
+
+        locks.emplace_back(child->latch);
+        if(child->data.size() < _max) {  // child absorbs a split below
+            locks.erase(locks.begin(), locks.end() - 1);
+            path.clear();
+            if(root_lock) root_lock.unlock();
+        }
+        path.push_back(child);
+        node = child;
+    }
+
+    std::size_t before = node->data.size();
+    if(!insert_leaf(node, entry)) return false;
+    if(node->data.size() == before) return true;  // merged duplicate
+
+    for(std::size_t level = path.size(); level-- > 0;) {
+        Node* full = path[level];
+        if(full->data.size() <= _max) break;
+
+        T key;
+        Node* right = nullptr;
+        split(full, key, right);
+
+        if(level) {  // add key and right sibling to parent
+            Node* parent = path[level - 1];
+            std::size_t i = first_gt(parent->data, key);
+
+            parent->data.insert(parent->data.begin() + i, std::move(key));
+            parent->children.insert(parent->children.begin() + i + 1, right);
+        } else {  // full is the root; grow a new root
+            assert(root_lock && full == _root);
+
+            Node* root = new Node(false);
+            root->data.push_back(std::move(key));
+            root->children.push_back(full);
+            root->children.push_back(right);
+            _root = root;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts entry into an exclusively latched leaf, or merges a duplicate.
+ *
+ * PRE-CONDITIONS:
+ *  Node* leaf    : exclusively latched leaf
+ *  const T& entry: entry to insert
+ *
+ * POST-CONDITIONS:
+ *  entry inserted, or merged by += if dups_ok; leaf may exceed _max
+ *
+ * RETURN:
+ *  bool: false if entry exists and dups not ok
+ ******************************************************************************/
+template <typename T>
+bool ConcurrentBPTree<T>::insert_leaf(Node* leaf, const T& entry) {
+    std::size_t i = first_ge(leaf->data, entry);
+
+    if(i < leaf->data.size() && !(entry < leaf->data[i])) {
+        if(!_dups_ok) return false;
+
+        leaf->data[i] += entry;
+        return true;
+    }
+
+    leaf->data.insert(leaf->data.begin() + i, entry);
+    ++_size;
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Splits a node of _max + 1 entries. The upper half moves to a new right
+ *  sibling. A leaf copies the right's first entry up as key and links right
+ *  after itself; an inner node moves its middle key up.
+ *
+ * PRE-CONDITIONS:
+ *  Node* node  : exclusively latched node with _max + 1 entries
+ *  T& key      : any
+ *  Node*& right: any
+ *
+ * POST-CONDITIONS:
+ *  T& key      : key for the parent
+ *  Node*& right: new right sibling
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void ConcurrentBPTree<T>::split(Node* node, T& key, Node*& right) {
+    right = new Node(node->is_leaf);
+
+    if(node->is_leaf) {
+        right->data.assign(node->data.begin() + _min, node->data.end());
+        node->data.resize(_min);
+        key = right->data.front();
+
+        right->next = node->next;
+        node->next = right;
+    } else {
+        key = std::move(node->data[_min]);
+        right->data.assign(node->data.begin() + _min + 1, node->data.end());
+        right->children.assign(node->children.begin() + _min + 1,
+                               node->children.end());
+        node->data.resize(_min);
+        node->children.resize(_min + 1);
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Removes entry with shared latches down to the leaf's parent and an
+ *  exclusive latch on the leaf. Gives up if a leaf below the root would fall
+ *  under _min.
+ *
+ * PRE-CONDITIONS:
+ *  const T& entry: entry to remove
+ *
+ * POST-CONDITIONS:
+ *  entry removed if status is 1
+ *
+ * RETURN:
+ *  int: -1 if leaf would be short, 1 if removed, 0 if not found
+ ******************************************************************************/
+template <typename T>
+int ConcurrentBPTree<T>::optimistic_remove(const T& entry) {
+    std::shared_lock<Latch> parent(_root_latch);
+    Node* node = _root;
+    std::shared_lock<Latch> lock;
+
+    if(!node->is_leaf) {
+        lock = std::shared_lock<Latch>(node->latch);
+        parent.unlock();
+
+        while(true) {  // couple down to the parent of the leaf
+            Node* child = node->children[first_gt(node->data, entry)];
+            if(child->is_leaf) {
+                node = child;
+                break;
+            }
+
+            std::shared_lock<Latch> child_lock(child->latch);
+            lock.swap(child_lock);  // child_lock releases parent
+            node = child;
+        }
+    }
+
+    WriteLock leaf(node->latch);
+    bool is_root = parent.owns_lock();
+
+    if(parent) parent.unlock();
+    if(lock) lock.unlock();
+
+    std::size_t i = first_ge(node->data, entry);
+    if(i == node->data.size() || entry < node->data[i]) return 0;
+    if(!is_root && node->data.size() <= _min) return -1;
+
+    node->data.erase(node->data.begin() + i);
+    --_size;
+
+    return 1;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Removes entry with exclusive latches from the root. Each child is latched
+ *  with the sibling it would be fixed with. A latched node with more than
+ *  _min entries can lose a key to a child merge, so it releases its
+ *  ancestors. Short nodes on the way back up are fixed with a sibling,
+ *  and a root left with one child is replaced by it.
+ *
+ * PRE-CONDITIONS:
+ *  const T& entry: entry to remove
+ *
+ * POST-CONDITIONS:
+ *  entry removed if found
+ *
+ * RETURN:
+ *  bool: true if removed
+ ******************************************************************************/
+template <typename T>
+bool ConcurrentBPTree<T>::pessimistic_remove(const T& entry) {
+    Guard guard;  // nodes retired here outlive the latches on them
+    guard.enter(this);
+
+    WriteLock root_lock(_root_latch);
+    std::vector<WriteLock> locks;     // latched path from highest unsafe node
+    std::vector<WriteLock> siblings;  // latched sibling of each path node
+    std::vector<Node*> path;
+    Node* node = _root;
+
+    locks.emplace_back(node->latch);
+    siblings.emplace_back();
+    path.push_back(node);
+    if(node->is_leaf || node->data.size() > 1)
+        root_lock.unlock();  // root can't lose its last key
+
+    while(!node->is_leaf) {
+        std::size_t i = first_gt(node->data, entry);
+        Node* child = node->children[i];
+        WriteLock sibling;  // taken before child if left of it
+
+        if(i) sibling = WriteLock(node->children[i - 1]->latch);
+        locks.emplace_back(child->latch);
+        if(!i && node->children.size() > 1)
+            sibling = WriteLock(node->children[1]->latch);
+
+        if(child->data.size() > _min) {  // child can't fall under _min
+            locks.erase(locks.begin(), locks.end() - 1);
+            siblings.clear();
+            path.clear();
+            if(root_lock) root_lock.unlock();
+            if(sibling) sibling.unlock();
+        }
+        siblings.push_back(std::move(sibling));
+        path.push_back(child);
+        node = child;
+    }
+
+    std::size_t i = first_ge(node->data, entry);
+    if(i == node->data.size() || entry < node->data[i]) return false;
+
+    node->data.erase(node->data.begin() + i);
+    --_size;
+
+    for(std::size_t level = path.size(); level-- > 1;) {
+        if(path[level]->data.size() >= _min) break;
+
+        Node* parent = path[level - 1];
+        fix_shortage(parent, first_gt(parent->data, entry));
+    }
+
+    Node* root = path.front();
+    if(root_lock && !root->is_leaf && root->data.empty()) {  // shrink
+        assert(root == _root);
+
+        _root = root->children.front();
+        root->children.clear();
+        retire(root);
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Fixes a child under _min. Merges it with its left (or, if first, its
+ *  right) sibling when both fit one node. Else borrows from the left
+ *  sibling; a first inner child borrows from its right sibling and a first
+ *  leaf is left short, as a leaf's entries can't move left.
+ *
+ * PRE-CONDITIONS:
+ *  Node* parent : exclusively latched inner node with at least 2 children
+ *  std::size_t i: child under _min; it and its left sibling (or right if
+ *                 first) exclusively latched
+ *
+ * POST-CONDITIONS:
+ *  child merged or refilled; parent may be under _min
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void ConcurrentBPTree<T>::fix_shortage(Node* parent, std::size_t i) {
+    std::size_t l = i ? i - 1 : i;  // left of the pair
+    Node* left = parent->children[l];
+    Node* right = parent->children[l + 1];
+    std::size_t extra = left->is_leaf ? 0 : 1;  // separator moves down
+    if(left->data.size() + right->data.size() + extra <= _max) {
+        merge(parent, l);
+        return;
+    }
+
+    if(left->is_leaf) {
+        if(!i) return;  // can't move entries left
+
+        std::size_t count = (left->data.size() - right->data.size()) / 2;
+        auto first = left->data.end() - (count ? count : 1);
+
+        right->data.insert(right->data.begin(), first, left->data.end());
+        left->data.erase(first, left->data.end());
+        parent->data[l] = right->data.front();
+    } else if(i) {  // rotate keys right through the parent
+        while(left->data.size() > right->data.size() + 1) {
+            right->data.insert(right->data.begin(),
+                               std::move(parent->data[l]));
+            right->children.insert(right->children.begin(),
+                                   left->children.back());
+            parent->data[l] = std::move(left->data.back());
+            left->data.pop_back();
+            left->children.pop_back();
+        }
+    } else {  // rotate keys left through the parent
+        while(right->data.size() > left->data.size() + 1) {
+            left->data.push_back(std::move(parent->data[l]));
+            left->children.push_back(right->children.front());
+            parent->data[l] = std::move(right->data.front());
+            right->data.erase(right->data.begin());
+            right->children.erase(right->children.begin());
+        }
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Merges child i + 1 into child i and retires it. A merged leaf is left
+ *  empty with _next pointing to child i, so an iterator on it finds the
+ *  entries that moved left.
+ *
+ * PRE-CONDITIONS:
+ *  Node* parent : exclusively latched inner node
+ *  std::size_t i: children i and i + 1 exclusively latched and fit one node
+ *
+ * POST-CONDITIONS:
+ *  parent loses key i and child i + 1
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void ConcurrentBPTree<T>::merge(Node* parent, std::size_t i) {
+    Node* left = parent->children[i];
+    Node* right = parent->children[i + 1];
+
+    if(left->is_leaf) {
+        left->next = right->next;
+        right->next = left;
+    } else {
+        left->data.push_back(std::move(parent->data[i]));
+        left->children.insert(left->children.end(), right->children.begin(),
+                              right->children.end());
+        right->children.clear();
+    }
+    left->data.insert(left->data.end(), right->data.begin(),
+                      right->data.end());
+    right->data.clear();
+
+    parent->data.erase(parent->data.begin() + i);
+    parent->children.erase(parent->children.begin() + i + 1);
+    retire(right);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Recursively prints a subtree sideways.
+ *
+ * PRE-CONDITIONS:
+ *  const Node* node  : root of subtree
+ *  std::ostream& outs: out stream
+ *  int level         : depth of subtree
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void ConcurrentBPTree<T>::print(const Node* node, std::ostream& outs,
+                                int level) const {
+    for(std::size_t i = node->data.size() + 1; i-- > 0;) {
+        if(!node->is_leaf) print(node->children[i], outs, level + 1);
+
+        if(i) {
+            outs << std::string(4 * level, ' ');
+            outs << node->data[i - 1] << '\n';
+        }
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Recursively checks a subtree: entries in order and within [low, high),
+ *  inner nodes with one more child than keys, no node over _max entries
+ *  and all leaves at the same height.
+ *
+ * PRE-CONDITIONS:
+ *  const Node* node  : root of subtree
+ *  int level         : depth of subtree
+ *  int& height       : -1 until first leaf found
+ *  const T* low      : lower bound of entries; nullptr if none
+ *  const T* high     : upper bound of entries; nullptr if none
+ *  std::size_t& count: leaf entries counted so far
+ *
+ * POST-CONDITIONS:
+ *  int& height       : leaf level
+ *  std::size_t& count: add leaf entries of subtree
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+bool ConcurrentBPTree<T>::verify(const Node* node, int level, int& height,
+                                 const T* low, const T* high,
+                                 std::size_t& count) const {
+    if(node->data.size() > _max) return false;
+
+    for(std::size_t i = 0; i < node->data.size(); ++i) {
+        if(i && !(node->data[i - 1] < node->data[i])) return false;
+        if(low && node->data[i] < *low) return false;
+        if(high && !(node->data[i] < *high)) return false;
+    }
+
+    if(node->is_leaf) {
+        count += node->data.size();
+        if(height < 0) height = level;
+        return height == level;
+    }
+
+    if(node->children.size() != node->data.size() + 1) return false;
+
+    for(std::size_t i = 0; i < node->children.size(); ++i) {
+        const T* child_low = i ? &node->data[i - 1] : low;
+        const T* child_high = i < node->data.size() ? &node->data[i] : high;
+
+        if(!verify(node->children[i], level + 1, height, child_low,
+                   child_high, count))
+            return false;
+    }
+
+    return true;
+}
+
+}  // namespace concurrent_bptree
+
+#endif  // CONCURRENT_BPTREE_H
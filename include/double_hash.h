@@ -6,52 +6,74 @@
  * DESCRIPTION : This header defines a templated DoubleHash. Item insertions
  *      are done via record type's _key. If key's hash clashes with previous
  *      key, then insertion attempts as second hash value until empty spot.
- *      Item insertions are limited to hash table size. Table size for hash
- *      class uses dynamic allocation for user specificed table size.
- *
- *      NOTE: Requires T's _key as unsigned for hash insert!
+ *      Table size for hash class uses dynamic allocation for user specificed
+ *      table size.
+ *
+ *      The table grows before (keys + PREVIOUSLY_USED slots) passes the max
+ *      load factor (default 0.75). It doubles to the next twin prime size
+ *      when keys alone fill over half the max load, else it is rebuilt at
+ *      the same size to purge PREVIOUSLY_USED slots. Rebuilds are amortized
+ *      O(1) per insert; reserve() sizes the table up front to skip them.
+ *
+ *      T is a record type with a key_type _key (see hash_record::Record).
+ *      Keys are hashed by H, hasher::Hash<key_type> by default, and compared
+ *      with ==. Slot states are kept apart from the records, so any key value
+ *      can be stored.
  ******************************************************************************/
 #ifndef DOUBLE_HASH_H
 #define DOUBLE_HASH_H
 
-#include <cassert>   // assert()
-#include <iomanip>   // setw()
-#include <iostream>  // stream objects
-#include <string>    // string objects
+#include <cassert>    // assert()
+#include <cmath>      // ceil()
+#include <iomanip>    // setw()
+#include <iostream>   // stream objects
+#include <stdexcept>  // invalid_argument
+#include <string>     // string objects
+#include <utility>    // swap()
+#include "hasher.h"   // Hash class
 
 namespace double_hash {
 
-template <typename T>
+template <typename T, typename H = hasher::Hash<typename T::key_type>>
 class DoubleHash {
-    enum { PREVIOUSLY_USED = -2, NEVER_USED = -1, TABLE_SIZE = 811 };
+    enum { TABLE_SIZE = 811 };
+    enum Slot : unsigned char { NEVER_USED, PREVIOUSLY_USED, OCCUPIED };
 
 public:
+    typedef typename T::key_type key_type;
+
     // CONSTRUCTORS
-    DoubleHash(std::size_t size = TABLE_SIZE);
+    DoubleHash(std::size_t size = TABLE_SIZE, double max_load = 0.75,
+               const H& hasher = H());
 
     // BIG THREE
     ~DoubleHash();
-    DoubleHash(const DoubleHash<T>& src);
-    DoubleHash<T>& operator=(const DoubleHash<T>& rhs);
+    DoubleHash(const DoubleHash<T, H>& src);
+    DoubleHash<T, H>& operator=(const DoubleHash<T, H>& rhs);
 
     // ACCESSORS
-    std::size_t capacity() const;         // total unique entries
-    std::size_t collisions() const;       // number of collisions
-    std::size_t size() const;             // number of keys in the table
-    bool find(int key, T& result) const;  // result <- record with key
-    bool is_collision(int key, std::size_t i) const;  // is key collidded?
-    bool is_present(int key) const;  // is this key present in table?
+    std::size_t capacity() const;    // total unique entries
+    std::size_t collisions() const;  // number of collisions
+    std::size_t size() const;        // number of keys in the table
+    std::size_t tombstones() const;  // number of PREVIOUSLY_USED slots
+    double load_factor() const;      // keys / capacity
+    double max_load_factor() const;  // grow before passing this load
+    bool find(const key_type& key, T& result) const;  // result <- record
+    bool is_collision(const key_type& key, std::size_t i) const;
+    bool is_present(const key_type& key) const;  // is key in table?
     std::ostream& print(std::ostream& outs = std::cout) const;
 
     // MUTATORS
-    void clear();                 // remove all items
-    bool insert(const T& entry);  // insert key, value pair
-    bool remove(int key);         // remove this key
+    void clear();                           // remove all items
+    bool insert(const T& entry);            // insert key, value pair
+    void max_load_factor(double max_load);  // 0 < max_load <= 1
+    bool remove(const key_type& key);       // remove this key
+    void reserve(std::size_t count);        // room for count keys
 
     // FRIENDS
     // print entire table with keys, etc.
     friend std::ostream& operator<<(std::ostream& outs,
-                                    const DoubleHash<T>& h) {
+                                    const DoubleHash<T, H>& h) {
         return h.print(outs);
     }
 
@@ -59,15 +81,27 @@ private:
     std::size_t _table_size;     // capacity _data array
     std::size_t _collisions;     // number of entry collisions
     std::size_t _total_records;  // number of keys in the table
+    std::size_t _tombstones;     // number of PREVIOUSLY_USED slots
+    double _max_load;            // max (keys + tombstones) / _table_size
     T* _data;                    // table of Records
+    Slot* _slots;                // state of each _data slot
+    H _hasher;                   // key -> hash value
 
     // ACCESSORS
-    inline std::size_t hash1(int key) const;  // hash1 function
-    inline std::size_t hash2(int key) const;  // hash2 function
-    inline bool find_index(int key, std::size_t& i) const;
-    inline std::size_t next_index(int key, std::size_t i) const;
+    inline std::size_t hash1(const key_type& key) const;  // hash1 function
+    inline std::size_t hash2(const key_type& key) const;  // hash2 function
+    inline bool find_index(const key_type& key, std::size_t& i) const;
+    inline std::size_t next_index(std::size_t i, std::size_t step) const;
     inline bool never_used(std::size_t i) const;
     inline bool is_vacant(std::size_t i) const;
+    inline bool holds(std::size_t i, const key_type& key) const;
+    std::size_t fit_table_size(std::size_t count) const;
+    static bool is_prime(std::size_t n);
+    static std::size_t next_table_size(std::size_t size);
+
+    // MUTATORS
+    void place(const T& entry);     // add new key to first vacant slot
+    void rehash(std::size_t size);  // rebuild table without tombstones
 };
 
 /*******************************************************************************
@@ -76,19 +110,30 @@ private:
  *  _data array with _table_size attribute.
  *
  * PRE-CONDITIONS:
- *  none
+ *  std::size_t size: initial table size > 0
+ *  double max_load : max load factor, 0 < max_load <= 1
+ *  const H& hasher : key -> hash value
  *
  * POST-CONDITIONS:
- *  new memory allocated to _data
+ *  new memory allocated to _data and _slots
  *
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-DoubleHash<T>::DoubleHash(std::size_t size)
-    : _table_size(size), _collisions(0), _total_records(0), _data(nullptr) {
+template <typename T, typename H>
+DoubleHash<T, H>::DoubleHash(std::size_t size, double max_load, const H& hasher)
+    : _table_size(size),
+      _collisions(0),
+      _total_records(0),
+      _tombstones(0),
+      _max_load(0),
+      _data(nullptr),
+      _slots(nullptr),
+      _hasher(hasher) {
     assert(_table_size > 0);
+    max_load_factor(max_load);
     _data = new T[_table_size];
+    _slots = new Slot[_table_size]();  // all NEVER_USED
 }
 
 /*******************************************************************************
@@ -99,14 +144,15 @@ DoubleHash<T>::DoubleHash(std::size_t size)
  *  none
  *
  * POST-CONDITIONS:
- *  delete memory allocated to _data
+ *  delete memory allocated to _data and _slots
  *
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-DoubleHash<T>::~DoubleHash() {
+template <typename T, typename H>
+DoubleHash<T, H>::~DoubleHash() {
     delete[] _data;
+    delete[] _slots;
 }
 
 /*******************************************************************************
@@ -122,14 +168,22 @@ DoubleHash<T>::~DoubleHash() {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-DoubleHash<T>::DoubleHash(const DoubleHash<T>& src)
+template <typename T, typename H>
+DoubleHash<T, H>::DoubleHash(const DoubleHash<T, H>& src)
     : _table_size(src._table_size),
       _collisions(src._collisions),
       _total_records(src._total_records),
-      _data(nullptr) {
+      _tombstones(src._tombstones),
+      _max_load(src._max_load),
+      _data(nullptr),
+      _slots(nullptr),
+      _hasher(src._hasher) {
     _data = new T[_table_size];
-    for(std::size_t i = 0; i < _table_size; ++i) _data[i] = src._data[i];
+    _slots = new Slot[_table_size];
+    for(std::size_t i = 0; i < _table_size; ++i) {
+        _data[i] = src._data[i];
+        _slots[i] = src._slots[i];
+    }
 }
 
 /*******************************************************************************
@@ -145,16 +199,24 @@ DoubleHash<T>::DoubleHash(const DoubleHash<T>& src)
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-DoubleHash<T>& DoubleHash<T>::operator=(const DoubleHash<T>& rhs) {
+template <typename T, typename H>
+DoubleHash<T, H>& DoubleHash<T, H>::operator=(const DoubleHash<T, H>& rhs) {
     if(this != &rhs) {
         delete[] _data;
+        delete[] _slots;
         _table_size = rhs._table_size;
         _collisions = rhs._collisions;
         _total_records = rhs._total_records;
+        _tombstones = rhs._tombstones;
+        _max_load = rhs._max_load;
+        _hasher = rhs._hasher;
 
         _data = new T[_table_size];
-        for(std::size_t i = 0; i < _table_size; ++i) _data[i] = rhs._data[i];
+        _slots = new Slot[_table_size];
+        for(std::size_t i = 0; i < _table_size; ++i) {
+            _data[i] = rhs._data[i];
+            _slots[i] = rhs._slots[i];
+        }
     }
 
     return *this;
@@ -173,8 +235,8 @@ DoubleHash<T>& DoubleHash<T>::operator=(const DoubleHash<T>& rhs) {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::size_t DoubleHash<T>::capacity() const {
+template <typename T, typename H>
+std::size_t DoubleHash<T, H>::capacity() const {
     return _table_size;
 }
 
@@ -191,8 +253,8 @@ std::size_t DoubleHash<T>::capacity() const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::size_t DoubleHash<T>::collisions() const {
+template <typename T, typename H>
+std::size_t DoubleHash<T, H>::collisions() const {
     return _collisions;
 }
 
@@ -209,11 +271,65 @@ std::size_t DoubleHash<T>::collisions() const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::size_t DoubleHash<T>::size() const {
+template <typename T, typename H>
+std::size_t DoubleHash<T, H>::size() const {
     return _total_records;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Access to _tombstones
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: number of PREVIOUSLY_USED slots
+ ******************************************************************************/
+template <typename T, typename H>
+std::size_t DoubleHash<T, H>::tombstones() const {
+    return _tombstones;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Ratio of keys to table size.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  double: _total_records / _table_size
+ ******************************************************************************/
+template <typename T, typename H>
+double DoubleHash<T, H>::load_factor() const {
+    return static_cast<double>(_total_records) / _table_size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Access to _max_load
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  double: max (keys + tombstones) / _table_size before a rebuild
+ ******************************************************************************/
+template <typename T, typename H>
+double DoubleHash<T, H>::max_load_factor() const {
+    return _max_load;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Find templated item with key.
@@ -227,8 +343,8 @@ std::size_t DoubleHash<T>::size() const {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool DoubleHash<T>::find(int key, T& result) const {
+template <typename T, typename H>
+bool DoubleHash<T, H>::find(const key_type& key, T& result) const {
     bool is_found = false;
     std::size_t i = 0;
 
@@ -253,8 +369,8 @@ bool DoubleHash<T>::find(int key, T& result) const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-bool DoubleHash<T>::is_collision(int key, std::size_t i) const {
+template <typename T, typename H>
+bool DoubleHash<T, H>::is_collision(const key_type& key, std::size_t i) const {
     return hash1(key) != i;
 }
 
@@ -271,8 +387,8 @@ bool DoubleHash<T>::is_collision(int key, std::size_t i) const {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool DoubleHash<T>::is_present(int key) const {
+template <typename T, typename H>
+bool DoubleHash<T, H>::is_present(const key_type& key) const {
     std::size_t i;
     return find_index(key, i);
 }
@@ -290,22 +406,22 @@ bool DoubleHash<T>::is_present(int key) const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::ostream& DoubleHash<T>::print(std::ostream& outs) const {
+template <typename T, typename H>
+std::ostream& DoubleHash<T, H>::print(std::ostream& outs) const {
     std::size_t size = std::to_string(_table_size).size();
 
     outs << std::setfill('0');
     for(std::size_t i = 0; i < _table_size; ++i) {
         outs << "[" << std::setw(size) << std::right << i << "] ";
 
-        if(_data[i]._key > NEVER_USED) {
+        if(_slots[i] == OCCUPIED) {
             outs << _data[i] << " (" << std::setw(size) << hash1(_data[i]._key)
                  << ")";
 
             if(is_collision(_data[i]._key, i)) outs << " *";
         }
 
-        if(_data[i]._key == PREVIOUSLY_USED) outs << "-----";
+        if(_slots[i] == PREVIOUSLY_USED) outs << "-----";
 
         outs << std::endl;
     }
@@ -323,56 +439,86 @@ std::ostream& DoubleHash<T>::print(std::ostream& outs) const {
  * POST-CONDITIONS:
  *  _collisions = 0
  *  _total_records = 0
+ *  _tombstones = 0
  *
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-void DoubleHash<T>::clear() {
+template <typename T, typename H>
+void DoubleHash<T, H>::clear() {
     if(_data)
-        for(std::size_t i = 0; i < _table_size; ++i) _data[i] = T();
+        for(std::size_t i = 0; i < _table_size; ++i) {
+            _data[i] = T();
+            _slots[i] = NEVER_USED;
+        }
 
     _collisions = 0;
     _total_records = 0;
+    _tombstones = 0;
 }
 
 /*******************************************************************************
  * DESCRIPTION:
  *  Insert entry item with its _key. Entries are non-unique. If two entries
  *  have the same _key but different _value, then old entry is replaced.
+ *  A new key first grows or rebuilds the table when it would pass the max
+ *  load factor.
  *
  * PRE-CONDITIONS:
- *  _total_records < _table_size
+ *  const T& entry: record to insert
  *
  * POST-CONDITIONS:
- *  _collisions + 1 if entry's key is not hash value
- *  _total_records + 1
- *  item added into _data if success
+ *  _collisions + 1 if new entry's key is not hash value
+ *  _total_records + 1 if new entry
+ *  item added into _data
  *
  * RETURN:
- *  bool
+ *  bool: true; the table grows instead of filling up
  ******************************************************************************/
-template <typename T>
-bool DoubleHash<T>::insert(const T& entry) {
-    assert(entry._key >= 0);
-
+template <typename T, typename H>
+bool DoubleHash<T, H>::insert(const T& entry) {
     std::size_t i;
 
-    if(!find_index(entry._key, i)) {  // <--- see find_index's notes!
-        // EXIT and return false when hash key not found and FULL TABLE
-        if(_total_records >= _table_size) return false;
-
-        while(!is_vacant(i)) i = next_index(entry._key, i);
-        ++_total_records;
+    if(find_index(entry._key, i)) {  // replace entry with same key
+        _data[i] = entry;
+        return true;
     }
 
-    if(is_collision(entry._key, i)) ++_collisions;
+    if(_total_records + _tombstones + 1 > _max_load * _table_size) {
+        // grow when keys fill over half the max load, else purge tombstones
+        if(_total_records + 1 > _max_load * _table_size / 2)
+            rehash(fit_table_size(2 * (_total_records + 1)));
+        else
+            rehash(_table_size);
+    }
 
-    _data[i] = entry;
+    place(entry);
 
     return true;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Sets the max load factor. Takes effect on the next insert of a new key.
+ *
+ * PRE-CONDITIONS:
+ *  double max_load: 0 < max_load <= 1
+ *
+ * POST-CONDITIONS:
+ *  _max_load = max_load
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T, typename H>
+void DoubleHash<T, H>::max_load_factor(double max_load) {
+    if(!(max_load > 0 && max_load <= 1))
+        throw std::invalid_argument(
+            "DoubleHash - max load factor not in (0, 1]");
+
+    _max_load = max_load;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Remove templated item from _data table via its _key
@@ -383,20 +529,22 @@ bool DoubleHash<T>::insert(const T& entry) {
  * POST-CONDITIONS:
  *  _collisions - 1 if entry's key is not hash value
  *  _total_records - 1
- *  item removed from _data if success
+ *  item removed from _data if success; slot marked PREVIOUSLY_USED
  *
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool DoubleHash<T>::remove(int key) {
+template <typename T, typename H>
+bool DoubleHash<T, H>::remove(const key_type& key) {
     bool is_removed = false;
     std::size_t i = -1;
 
     if(find_index(key, i)) {
         if(is_collision(key, i)) --_collisions;
 
-        _data[i]._key = PREVIOUSLY_USED;
+        _data[i] = T();
+        _slots[i] = PREVIOUSLY_USED;
+        ++_tombstones;
         --_total_records;
         is_removed = true;
     }
@@ -406,11 +554,31 @@ bool DoubleHash<T>::remove(int key) {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Convert key to index position via mod _table_size. Recommended _table_size
- *  should be 4k + 3 and prime number.
+ *  Ensures count keys fit under the max load factor without a rebuild.
  *
  * PRE-CONDITIONS:
- *  int key: >= 0
+ *  std::size_t count: expected number of keys
+ *
+ * POST-CONDITIONS:
+ *  table rebuilt to a larger size if needed
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T, typename H>
+void DoubleHash<T, H>::reserve(std::size_t count) {
+    std::size_t size = fit_table_size(count);
+
+    if(size > _table_size) rehash(size);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Convert key's hash value to index position via mod _table_size.
+ *  Recommended _table_size should be 4k + 3 and prime number.
+ *
+ * PRE-CONDITIONS:
+ *  const key_type& key: key
  *
  * POST-CONDITIONS:
  *  none
@@ -418,19 +586,20 @@ bool DoubleHash<T>::remove(int key) {
  * RETURN:
  *  std::size_t: array index
  ******************************************************************************/
-template <typename T>
-std::size_t DoubleHash<T>::hash1(int key) const {
-    return key % _table_size;
+template <typename T, typename H>
+std::size_t DoubleHash<T, H>::hash1(const key_type& key) const {
+    return _hasher(key) % _table_size;
 }
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Convert key to second hash value to add with original hash1 value.
+ *  Convert key's hash value to second hash value to add with original hash1
+ *  value.
  *  Hash2's value must be relatively prime to _table_size. In addition,
  *  _table_size and (_table_size - 2) must also be twin primes.
  *
  * PRE-CONDITIONS:
- *  int key: >= 0
+ *  const key_type& key: key
  *
  * POST-CONDITIONS:
  *  none
@@ -438,9 +607,9 @@ std::size_t DoubleHash<T>::hash1(int key) const {
  * RETURN:
  *  std::size_t: array index
  ******************************************************************************/
-template <typename T>
-std::size_t DoubleHash<T>::hash2(int key) const {
-    return 1 + (key % (_table_size - 2));
+template <typename T, typename H>
+std::size_t DoubleHash<T, H>::hash2(const key_type& key) const {
+    return 1 + (_hasher(key) % (_table_size - 2));
 }
 
 /*******************************************************************************
@@ -454,7 +623,7 @@ std::size_t DoubleHash<T>::hash2(int key) const {
  *      Find_index returns i = 1 because [1] = NEVER_USED.
  *
  * PRE-CONDITIONS:
- *  int key: >= 0
+ *  const key_type& key: key
  *
  * POST-CONDITIONS:
  *  std::size_t& i: @NEVER_USED, @KEY's or @original hash if not found
@@ -462,17 +631,17 @@ std::size_t DoubleHash<T>::hash2(int key) const {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool DoubleHash<T>::find_index(int key, std::size_t& i) const {
-    std::size_t count = 0;
+template <typename T, typename H>
+bool DoubleHash<T, H>::find_index(const key_type& key, std::size_t& i) const {
+    std::size_t count = 0, step = hash2(key);
     i = hash1(key);
 
-    while(count < _table_size && !never_used(i) && _data[i]._key != key) {
+    while(count < _table_size && !never_used(i) && !holds(i, key)) {
         ++count;
-        i = next_index(key, i);
+        i = next_index(i, step);
     }
 
-    return _data[i]._key == key;
+    return holds(i, key);
 }
 
 /*******************************************************************************
@@ -480,7 +649,8 @@ bool DoubleHash<T>::find_index(int key, std::size_t& i) const {
  *  Return's next hash position.
  *
  * PRE-CONDITIONS:
- *  std::size_t i: array index >= 0
+ *  std::size_t i   : array index >= 0
+ *  std::size_t step: key's hash2() value
  *
  * POST-CONDITIONS:
  *  none
@@ -488,9 +658,10 @@ bool DoubleHash<T>::find_index(int key, std::size_t& i) const {
  * RETURN:
  *  std::size_t: array index
  ******************************************************************************/
-template <typename T>
-std::size_t DoubleHash<T>::next_index(int key, std::size_t i) const {
-    return (i + hash2(key)) % _table_size;
+template <typename T, typename H>
+std::size_t DoubleHash<T, H>::next_index(std::size_t i,
+                                         std::size_t step) const {
+    return (i + step) % _table_size;
 }
 
 /*******************************************************************************
@@ -506,9 +677,9 @@ std::size_t DoubleHash<T>::next_index(int key, std::size_t i) const {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool DoubleHash<T>::never_used(std::size_t i) const {
-    return _data[i]._key == NEVER_USED;
+template <typename T, typename H>
+bool DoubleHash<T, H>::never_used(std::size_t i) const {
+    return _slots[i] == NEVER_USED;
 }
 
 /*******************************************************************************
@@ -524,9 +695,154 @@ bool DoubleHash<T>::never_used(std::size_t i) const {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool DoubleHash<T>::is_vacant(std::size_t i) const {
-    return _data[i]._key <= NEVER_USED;
+template <typename T, typename H>
+bool DoubleHash<T, H>::is_vacant(std::size_t i) const {
+    return _slots[i] != OCCUPIED;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Check for array index holds key.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t i       : array index >= 0
+ *  const key_type& key : key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T, typename H>
+bool DoubleHash<T, H>::holds(std::size_t i, const key_type& key) const {
+    return _slots[i] == OCCUPIED && _data[i]._key == key;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Smallest table size that holds count keys under the max load factor.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t count: number of keys
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: twin prime table size
+ ******************************************************************************/
+template <typename T, typename H>
+std::size_t DoubleHash<T, H>::fit_table_size(std::size_t count) const {
+    return next_table_size(
+        static_cast<std::size_t>(std::ceil(count / _max_load)));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Check for prime number by trial division.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t n: number to check
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T, typename H>
+bool DoubleHash<T, H>::is_prime(std::size_t n) {
+    if(n < 2) return false;
+
+    for(std::size_t d = 2; d <= n / d; ++d)
+        if(n % d == 0) return false;
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Smallest size >= size where size and size - 2 are twin primes, so hash2's
+ *  step is relatively prime to the table size.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t size: minimum table size
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: table size
+ ******************************************************************************/
+template <typename T, typename H>
+std::size_t DoubleHash<T, H>::next_table_size(std::size_t size) {
+    size = size < 5 ? 5 : size | 1;  // twin primes > 3 are odd
+
+    while(!is_prime(size) || !is_prime(size - 2)) size += 2;
+
+    return size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Adds a new key to the first vacant slot of its probe sequence, reusing a
+ *  PREVIOUSLY_USED slot if one comes first.
+ *
+ * PRE-CONDITIONS:
+ *  entry's key is not in table and table has a vacant slot
+ *
+ * POST-CONDITIONS:
+ *  _collisions + 1 if entry's key is not hash value
+ *  _total_records + 1
+ *  _tombstones - 1 if a PREVIOUSLY_USED slot is reused
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T, typename H>
+void DoubleHash<T, H>::place(const T& entry) {
+    std::size_t home = hash1(entry._key), i = home,
+                step = hash2(entry._key);
+
+    while(!is_vacant(i)) i = next_index(i, step);
+
+    if(_slots[i] == PREVIOUSLY_USED) --_tombstones;
+    if(i != home) ++_collisions;
+
+    _data[i] = entry;
+    _slots[i] = OCCUPIED;
+    ++_total_records;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Rebuilds _data at the given size: keys are placed again, and collisions
+ *  are recounted. PREVIOUSLY_USED slots are dropped.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t size: new table size > _total_records
+ *
+ * POST-CONDITIONS:
+ *  new memory allocated to _data and _slots; old ones deleted
+ *  _tombstones = 0
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T, typename H>
+void DoubleHash<T, H>::rehash(std::size_t size) {
+    DoubleHash<T, H> table(size, _max_load, _hasher);
+
+    for(std::size_t i = 0; i < _table_size; ++i)
+        if(_slots[i] == OCCUPIED) table.place(_data[i]);
+
+    std::swap(_table_size, table._table_size);
+    std::swap(_collisions, table._collisions);
+    std::swap(_total_records, table._total_records);
+    std::swap(_tombstones, table._tombstones);
+    std::swap(_data, table._data);
+    std::swap(_slots, table._slots);
 }
 }  // namespace double_hash
 
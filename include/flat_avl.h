@@ -0,0 +1,806 @@
+/*******************************************************************************
+ * AUTHOR      : Thuan Tang
+ * ID          : 00991588
+ * CLASS       : CS008
+ * HEADER      : flat_avl
+ * DESCRIPTION : This header defines a templated FlatAVL, an AVL (Adelson-Velsky
+ *      and Landis) tree whose nodes are stored in one vector. Children are
+ *      32-bit indices into the vector instead of pointers, and erased nodes
+ *      are kept on a free list for the next insert, so the tree makes no heap
+ *      allocation per node and its nodes stay packed together.
+ *
+ *      Insert and erase are iterative: the search path is kept in a fixed
+ *      array of indices, then walked back up to update heights and rotate.
+ *      A rebalance stops at the first node whose height does not change.
+ *
+ *      Like AVL, an erased node with a left child takes the largest item of
+ *      its left subtree. Copies are plain vector copies.
+ ******************************************************************************/
+#ifndef FLAT_AVL_H
+#define FLAT_AVL_H
+
+#include <cassert>    // assert()
+#include <cstdint>    // int8_t, uint32_t
+#include <iostream>   // stream objects
+#include <stdexcept>  // length_error
+#include <string>     // string objects
+#include <utility>    // move()
+#include <vector>     // vector
+
+namespace flat_avl {
+
+template <typename T>
+class FlatAVL {
+public:
+    typedef std::uint32_t index_type;
+
+    // CONSTRUCTORS
+    FlatAVL() : _nodes(), _root(NIL), _free(NIL), _size(0) {}
+
+    // ACCESSORS
+    bool empty() const;
+    std::size_t size() const;
+    std::size_t capacity() const;  // nodes held, including free nodes
+    T& front();
+    const T& front() const;
+    void print_inorder(std::ostream& outs = std::cout) const;
+    bool search(const T& target, const T*& found_ptr) const;
+    bool verify() const;  // check order, heights and balance
+
+    // MUTATORS
+    void clear();
+    void reserve(std::size_t n);  // room for n nodes
+    bool erase(const T& target);
+    bool insert(const T& insert_me);
+    void reinsert(const T& insert_me);
+    void pop_front();
+
+    // FRIENDS
+    friend std::ostream& operator<<(std::ostream& outs,
+                                    const FlatAVL<T>& tree) {
+        tree.print(tree._root, outs);
+        return outs;
+    }
+
+private:
+    enum : index_type { NIL = 0xFFFFFFFF };  // no node
+    enum { MAX_PATH = 64 };  // > AVL height of 2^32 nodes (about 46)
+
+    struct Node {
+        T _item;
+        index_type _left;   // left child; next free node when freed
+        index_type _right;  // right child
+        std::int8_t _height;
+    };
+
+    std::vector<Node> _nodes;
+    index_type _root;  // root node
+    index_type _free;  // free list head
+    index_type _size;  // count of items
+
+    int height(index_type i) const;  // -1 if NIL
+    int balance_factor(index_type i) const;
+    void update_height(index_type i);
+
+    index_type find_node(const T& target) const;  // NIL if not found
+    index_type make_node(const T& item);  // take a free node or append one
+    void free_node(index_type i);
+    void relink(const index_type* path, int depth, index_type old_child,
+                index_type new_child);  // point parent of path[depth] at new
+    void erase_path(index_type* path, int depth);  // erase path[depth-1]
+    void rebalance(const index_type* path, int depth);  // up from path[depth-1]
+
+    index_type rotate_left(index_type i);   // right child becomes root
+    index_type rotate_right(index_type i);  // left child becomes root
+    index_type rotate(index_type i);        // rotate if out of balance
+
+    void print(index_type i, std::ostream& outs, int level = 0) const;
+    int verify_node(index_type i, const T* low, const T* high) const;
+};
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if FlatAVL is empty.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+bool FlatAVL<T>::empty() const {
+    return _root == NIL;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the count of items.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename T>
+std::size_t FlatAVL<T>::size() const {
+    return _size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the count of nodes held, used and free.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename T>
+std::size_t FlatAVL<T>::capacity() const {
+    return _nodes.size();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Access root's item.
+ *
+ * PRE-CONDITIONS:
+ *  not empty
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  T: root's item by reference
+ ******************************************************************************/
+template <typename T>
+T& FlatAVL<T>::front() {
+    assert(!empty());
+    return _nodes[_root]._item;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Access root's item.
+ *
+ * PRE-CONDITIONS:
+ *  not empty
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  const T: root's item by reference
+ ******************************************************************************/
+template <typename T>
+const T& FlatAVL<T>::front() const {
+    assert(!empty());
+    return _nodes[_root]._item;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Print items with an iterative inorder traversal, in the same format as
+ *  AVL's print_inorder().
+ *
+ * PRE-CONDITIONS:
+ *  std::ostream& outs: out stream
+ *
+ * POST-CONDITIONS:
+ *  out stream insertions
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void FlatAVL<T>::print_inorder(std::ostream& outs) const {
+    index_type stack[MAX_PATH];
+    int depth = 0;
+
+    for(index_type i = _root; i != NIL || depth > 0;) {
+        if(i != NIL) {  // go left as far as possible
+            stack[depth++] = i;
+            i = _nodes[i]._left;
+        } else {  // visit node, then its right subtree
+            i = stack[--depth];
+            outs << "|" << _nodes[i]._item << "|->";
+            i = _nodes[i]._right;
+        }
+    }
+    outs << "|||";
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Searches for target item and return non-nullptr by reference if found.
+ *
+ * PRE-CONDITIONS:
+ *  const T& target    : target item
+ *  const T*& found_ptr: pointer to search result
+ *
+ * POST-CONDITIONS:
+ *  const T*& found_ptr: nullptr if not found, else pointer to item
+ *
+ * RETURN:
+ *  bool: search success/failure
+ ******************************************************************************/
+template <typename T>
+bool FlatAVL<T>::search(const T& target, const T*& found_ptr) const {
+    index_type i = find_node(target);
+
+    found_ptr = i == NIL ? nullptr : &_nodes[i]._item;
+    return found_ptr;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks that items are in order, heights are correct and every node is
+ *  within balance limits.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+bool FlatAVL<T>::verify() const {
+    std::size_t free_count = 0;
+    for(index_type i = _free; i != NIL && free_count <= _nodes.size();
+        i = _nodes[i]._left)
+        ++free_count;
+
+    return verify_node(_root, nullptr, nullptr) != -2 &&
+           _size + free_count == _nodes.size();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Removes all items and nodes.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  empty
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void FlatAVL<T>::clear() {
+    _nodes.clear();
+    _root = _free = NIL;
+    _size = 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Reserves room for n nodes, so inserting up to n items does not grow the
+ *  node vector.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t n: count of nodes
+ *
+ * POST-CONDITIONS:
+ *  capacity of node vector >= n
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void FlatAVL<T>::reserve(std::size_t n) {
+    _nodes.reserve(n);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Erases the node that matches target item and rebalances.
+ *
+ * PRE-CONDITIONS:
+ *  const T& target: target item
+ *
+ * POST-CONDITIONS:
+ *  matching node freed
+ *
+ * RETURN:
+ *  bool: erasure success/failure
+ ******************************************************************************/
+template <typename T>
+bool FlatAVL<T>::erase(const T& target) {
+    index_type path[MAX_PATH];
+    int depth = 0;
+
+    for(index_type i = _root; i != NIL;) {
+        path[depth++] = i;
+
+        if(target == _nodes[i]._item) {
+            erase_path(path, depth);
+            return true;
+        }
+        i = target < _nodes[i]._item ? _nodes[i]._left : _nodes[i]._right;
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts an unique item and rebalances.
+ *
+ * PRE-CONDITIONS:
+ *  const T& insert_me: target item
+ *
+ * POST-CONDITIONS:
+ *  new node inserted if unique
+ *
+ * RETURN:
+ *  bool: insertion success/failure
+ ******************************************************************************/
+template <typename T>
+bool FlatAVL<T>::insert(const T& insert_me) {
+    index_type path[MAX_PATH];
+    int depth = 0;
+    bool is_left = false;
+
+    for(index_type i = _root; i != NIL;) {
+        if(!(insert_me < _nodes[i]._item) && !(_nodes[i]._item < insert_me))
+            return false;  // already in tree
+
+        path[depth++] = i;
+        is_left = insert_me < _nodes[i]._item;
+        i = is_left ? _nodes[i]._left : _nodes[i]._right;
+    }
+
+    index_type n = make_node(insert_me);  // may move _nodes, not indices
+    if(depth == 0)
+        _root = n;
+    else if(is_left)
+        _nodes[path[depth - 1]]._left = n;
+    else
+        _nodes[path[depth - 1]]._right = n;
+
+    rebalance(path, depth);
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Reinsert an equivalent T item, which has different sub-properties.
+ *  Ex: _key of old and new item are the same but have different item _values.
+ *
+ * PRE-CONDITIONS:
+ *  const T& insert_me: target item
+ *
+ * POST-CONDITIONS:
+ *  item inserted, or replaces its equal
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void FlatAVL<T>::reinsert(const T& insert_me) {
+    index_type i = find_node(insert_me);
+
+    if(i != NIL)
+        _nodes[i]._item = insert_me;
+    else
+        insert(insert_me);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Remove root's item and rebalance.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  root's node freed
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void FlatAVL<T>::pop_front() {
+    if(empty()) return;
+
+    index_type path[MAX_PATH] = {_root};
+    erase_path(path, 1);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the height of node i; -1 for no node.
+ *
+ * PRE-CONDITIONS:
+ *  index_type i: node or NIL
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  int
+ ******************************************************************************/
+template <typename T>
+int FlatAVL<T>::height(index_type i) const {
+    return i == NIL ? -1 : _nodes[i]._height;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the balance factor of node i: right's height - left's height.
+ *
+ * PRE-CONDITIONS:
+ *  index_type i: node
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  int
+ ******************************************************************************/
+template <typename T>
+int FlatAVL<T>::balance_factor(index_type i) const {
+    return height(_nodes[i]._right) - height(_nodes[i]._left);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Sets node i's height to max height of its children + 1.
+ *
+ * PRE-CONDITIONS:
+ *  index_type i: node
+ *
+ * POST-CONDITIONS:
+ *  height updated
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void FlatAVL<T>::update_height(index_type i) {
+    int left = height(_nodes[i]._left), right = height(_nodes[i]._right);
+    _nodes[i]._height = 1 + (left > right ? left : right);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Searches for the node of target item.
+ *
+ * PRE-CONDITIONS:
+ *  const T& target: target item
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  index_type: node; NIL if not found
+ ******************************************************************************/
+template <typename T>
+typename FlatAVL<T>::index_type FlatAVL<T>::find_node(const T& target) const {
+    index_type i = _root;
+
+    while(i != NIL && !(target == _nodes[i]._item))
+        i = target < _nodes[i]._item ? _nodes[i]._left : _nodes[i]._right;
+
+    return i;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns a leaf node holding item: the head of the free list if any, else
+ *  a node appended to the vector.
+ *
+ * PRE-CONDITIONS:
+ *  const T& item: item of node
+ *
+ * POST-CONDITIONS:
+ *  node in use; _size + 1
+ *
+ * RETURN:
+ *  index_type: new node
+ ******************************************************************************/
+template <typename T>
+typename FlatAVL<T>::index_type FlatAVL<T>::make_node(const T& item) {
+    index_type i = _free;
+
+    if(i != NIL) {
+        _free = _nodes[i]._left;
+        _nodes[i]._item = item;
+    } else {
+        if(_nodes.size() >= NIL)
+            throw std::length_error("FlatAVL - too many nodes");
+
+        i = _nodes.size();
+        _nodes.push_back(Node{item, NIL, NIL, 0});
+    }
+
+    _nodes[i]._left = _nodes[i]._right = NIL;
+    _nodes[i]._height = 0;
+    ++_size;
+
+    return i;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Puts node i on the free list and releases its item.
+ *
+ * PRE-CONDITIONS:
+ *  index_type i: node no longer linked in the tree
+ *
+ * POST-CONDITIONS:
+ *  node i free; _size - 1
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void FlatAVL<T>::free_node(index_type i) {
+    _nodes[i]._item = T();
+    _nodes[i]._left = _free;
+    _free = i;
+    --_size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Replaces old_child with new_child in the parent of path[depth], which is
+ *  path[depth-1]; or the root when depth is 0.
+ *
+ * PRE-CONDITIONS:
+ *  const index_type* path: search path from root
+ *  int depth             : position of old_child in path
+ *  index_type old_child  : child to replace
+ *  index_type new_child  : replacement
+ *
+ * POST-CONDITIONS:
+ *  parent points to new_child
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void FlatAVL<T>::relink(const index_type* path, int depth,
+                        index_type old_child, index_type new_child) {
+    if(depth == 0)
+        _root = new_child;
+    else if(_nodes[path[depth - 1]]._left == old_child)
+        _nodes[path[depth - 1]]._left = new_child;
+    else
+        _nodes[path[depth - 1]]._right = new_child;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Erases the node at the end of path. A node with a left child takes the
+ *  largest item of its left subtree, whose node is unlinked instead. Then
+ *  rebalances from the unlinked node's parent.
+ *
+ * PRE-CONDITIONS:
+ *  index_type* path: search path from root to the node; room for MAX_PATH
+ *  int depth       : length of path, > 0
+ *
+ * POST-CONDITIONS:
+ *  a node is freed
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void FlatAVL<T>::erase_path(index_type* path, int depth) {
+    index_type target = path[depth - 1], pop = target;
+
+    if(_nodes[target]._left != NIL) {  // find max of left subtree
+        for(pop = _nodes[target]._left; _nodes[pop]._right != NIL;
+            pop = _nodes[pop]._right)
+            path[depth++] = pop;
+        path[depth++] = pop;
+
+        _nodes[target]._item = std::move(_nodes[pop]._item);
+    }
+
+    // pop has at most one child: left if it is the max, else right
+    index_type child =
+        _nodes[pop]._left != NIL ? _nodes[pop]._left : _nodes[pop]._right;
+
+    relink(path, --depth, pop, child);
+    free_node(pop);
+    rebalance(path, depth);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Walks path back to the root, updating heights and rotating nodes out of
+ *  balance. Stops once a subtree's height is unchanged, as nothing above it
+ *  changes.
+ *
+ * PRE-CONDITIONS:
+ *  const index_type* path: search path from root
+ *  int depth             : length of path
+ *
+ * POST-CONDITIONS:
+ *  tree balanced
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void FlatAVL<T>::rebalance(const index_type* path, int depth) {
+    while(depth > 0) {
+        index_type i = path[--depth];
+        int old_height = _nodes[i]._height;
+
+        update_height(i);
+        index_type top = rotate(i);
+        if(top != i) relink(path, depth, i, top);
+
+        if(_nodes[top]._height == old_height) break;
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Rotates node i left: its right child becomes the subtree's root.
+ *
+ * PRE-CONDITIONS:
+ *  index_type i: node with a right child
+ *
+ * POST-CONDITIONS:
+ *  heights updated
+ *
+ * RETURN:
+ *  index_type: new root of subtree
+ ******************************************************************************/
+template <typename T>
+typename FlatAVL<T>::index_type FlatAVL<T>::rotate_left(index_type i) {
+    index_type top = _nodes[i]._right;
+
+    _nodes[i]._right = _nodes[top]._left;
+    _nodes[top]._left = i;
+    update_height(i);
+    update_height(top);
+
+    return top;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Rotates node i right: its left child becomes the subtree's root.
+ *
+ * PRE-CONDITIONS:
+ *  index_type i: node with a left child
+ *
+ * POST-CONDITIONS:
+ *  heights updated
+ *
+ * RETURN:
+ *  index_type: new root of subtree
+ ******************************************************************************/
+template <typename T>
+typename FlatAVL<T>::index_type FlatAVL<T>::rotate_right(index_type i) {
+    index_type top = _nodes[i]._left;
+
+    _nodes[i]._left = _nodes[top]._right;
+    _nodes[top]._right = i;
+    update_height(i);
+    update_height(top);
+
+    return top;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Decides which rotation is needed from node i's balance factor.
+ *
+ * PRE-CONDITIONS:
+ *  index_type i: node with updated height
+ *
+ * POST-CONDITIONS:
+ *  subtree balanced
+ *
+ * RETURN:
+ *  index_type: new root of subtree
+ ******************************************************************************/
+template <typename T>
+typename FlatAVL<T>::index_type FlatAVL<T>::rotate(index_type i) {
+    int balance = balance_factor(i);
+
+    if(balance > 1) {  // right heavy
+        if(balance_factor(_nodes[i]._right) < 0)
+            _nodes[i]._right = rotate_right(_nodes[i]._right);
+        return rotate_left(i);
+    }
+
+    if(balance < -1) {  // left heavy
+        if(balance_factor(_nodes[i]._left) > 0)
+            _nodes[i]._left = rotate_left(_nodes[i]._left);
+        return rotate_right(i);
+    }
+
+    return i;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Prints node i by reverse inorder traversal, in the same format as
+ *  bst_node::tree_print(). Recursion is bounded by the tree's height.
+ *
+ * PRE-CONDITIONS:
+ *  index_type i      : node
+ *  std::ostream& outs: out stream
+ *  int level         : recursion level for formatting
+ *
+ * POST-CONDITIONS:
+ *  out stream insertions
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void FlatAVL<T>::print(index_type i, std::ostream& outs, int level) const {
+    if(i == NIL) {  // base: no node
+        outs << std::string(5 * level, ' ') << "|||" << std::endl;
+        return;
+    }
+
+    print(_nodes[i]._right, outs, level + 1);  // recurse right
+    outs << std::string(5 * level, ' ') << "|" << _nodes[i]._item << "|"
+         << std::endl;
+    print(_nodes[i]._left, outs, level + 1);  // recurse left
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks the subtree at node i: items within (low, high), stored heights
+ *  and balance limits. Recursion is bounded by the tree's height.
+ *
+ * PRE-CONDITIONS:
+ *  index_type i  : node
+ *  const T* low  : items must be greater; nullptr if no bound
+ *  const T* high : items must be less; nullptr if no bound
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  int: height of subtree; -2 if invalid
+ ******************************************************************************/
+template <typename T>
+int FlatAVL<T>::verify_node(index_type i, const T* low, const T* high) const {
+    if(i == NIL) return -1;
+    if(i >= _nodes.size()) return -2;
+
+    const T& item = _nodes[i]._item;
+    if((low && !(*low < item)) || (high && !(item < *high))) return -2;
+
+    int left = verify_node(_nodes[i]._left, low, &item),
+        right = verify_node(_nodes[i]._right, &item, high);
+    if(left == -2 || right == -2) return -2;
+
+    int height = 1 + (left > right ? left : right);
+    if(height != _nodes[i]._height || right - left > 1 || left - right > 1)
+        return -2;
+
+    return height;
+}
+
+}  // namespace flat_avl
+
+#endif  // FLAT_AVL_H
@@ -5,20 +5,24 @@
  * HEADER      : hash_record
  * DESCRIPTION : This header defines a templated Record structure with _key
  *      and _value pair. Comparison of Record type are by _key, not _value.
- *      Used by Hash type classes.
+ *      Used by Hash type classes, which hash the key_type _key.
  ******************************************************************************/
 #ifndef RECORD_H
 #define RECORD_H
 
+#include <iostream>  // stream objects
+
 namespace hash_record {
 
-template <typename T>
+template <typename T, typename K = int>
 struct Record {
-    int _key;
+    typedef K key_type;
+
+    K _key;
     T _value;
 
     // CONSTRUCTORS
-    Record(int k = -1, const T& v = T()) : _key(k), _value(v) {}
+    Record(const K& k = K(), const T& v = T()) : _key(k), _value(v) {}
 
     // FRIENDS
     friend bool operator==(const Record& left, const Record& right) {
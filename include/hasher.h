@@ -0,0 +1,146 @@
+/*******************************************************************************
+ * AUTHOR      : Thuan Tang
+ * ID          : 00991588
+ * CLASS       : CS008
+ * HEADER      : hasher
+ * DESCRIPTION : This header defines Hash<K>, the default hash function of
+ *      the hash table classes, and hash_bytes(), a fast 64-bit hash of raw
+ *      bytes in the style of wyhash: 8 bytes at a time are mixed by a
+ *      64 x 64 -> 128 bit multiply folded back to 64 bits.
+ *
+ *      Hash<K> hashes integral keys to themselves, so a key's home slot is
+ *      key % table size as before; tables use prime sizes, which spreads
+ *      keys like ids and counters well. Strings go through hash_bytes().
+ *      Other types use std::hash<K>. A table can take any hasher with
+ *      std::size_t operator()(const K&) const instead.
+ ******************************************************************************/
+#ifndef HASHER_H
+#define HASHER_H
+
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <cstring>      // memcpy()
+#include <functional>   // hash
+#include <string>       // string
+#include <type_traits>  // enable_if, is_integral
+
+namespace hasher {
+
+// odd 64-bit constants with well mixed bits, from wyhash
+enum : std::uint64_t {
+    P0 = 0xa0761d6478bd642fULL,
+    P1 = 0xe7037ed1a0b428dbULL,
+    P2 = 0x8ebc6af09c88c6e3ULL,
+    P3 = 0x589965cc75374cc3ULL
+};
+
+inline std::uint64_t mum(std::uint64_t a, std::uint64_t b);
+inline std::uint64_t read_word(const unsigned char* p, std::size_t count);
+inline std::uint64_t hash_bytes(const void* key, std::size_t length,
+                                std::uint64_t seed = 0);
+
+template <typename K, typename Enable = void>
+struct Hash {
+    std::size_t operator()(const K& key) const { return std::hash<K>()(key); }
+};
+
+template <typename K>
+struct Hash<K, typename std::enable_if<std::is_integral<K>::value>::type> {
+    std::size_t operator()(K key) const {
+        return static_cast<std::size_t>(key);
+    }
+};
+
+template <>
+struct Hash<std::string> {
+    std::size_t operator()(const std::string& key) const {
+        return static_cast<std::size_t>(hash_bytes(key.data(), key.size()));
+    }
+};
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Multiplies a and b into 128 bits and folds the halves with xor. Uses
+ *  32-bit halves, so it needs no 128-bit integer type.
+ *
+ * PRE-CONDITIONS:
+ *  std::uint64_t a: first factor
+ *  std::uint64_t b: second factor
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::uint64_t: low 64 bits ^ high 64 bits of a * b
+ ******************************************************************************/
+inline std::uint64_t mum(std::uint64_t a, std::uint64_t b) {
+    const std::uint64_t LOW = 0xffffffffULL;
+    std::uint64_t a_hi = a >> 32, a_lo = a & LOW, b_hi = b >> 32,
+                  b_lo = b & LOW;
+    std::uint64_t hi_hi = a_hi * b_hi, hi_lo = a_hi * b_lo,
+                  lo_hi = a_lo * b_hi, lo_lo = a_lo * b_lo;
+    std::uint64_t middle = (lo_lo >> 32) + (hi_lo & LOW) + (lo_hi & LOW);
+
+    std::uint64_t low = (lo_lo & LOW) | (middle << 32);
+    std::uint64_t high = hi_hi + (hi_lo >> 32) + (lo_hi >> 32) + (middle >> 32);
+
+    return low ^ high;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Reads up to 8 bytes as a native order word, zero filling the rest.
+ *
+ * PRE-CONDITIONS:
+ *  const unsigned char* p: bytes to read
+ *  std::size_t count     : bytes to read, <= 8
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::uint64_t: word
+ ******************************************************************************/
+inline std::uint64_t read_word(const unsigned char* p, std::size_t count) {
+    std::uint64_t word = 0;
+    std::memcpy(&word, p, count);
+
+    return word;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Hashes length bytes of key. Every 16 bytes cost one mum(); the tail is
+ *  zero filled and the length is mixed in last, so keys that differ only by
+ *  trailing zero bytes still differ.
+ *
+ * PRE-CONDITIONS:
+ *  const void* key    : bytes to hash
+ *  std::size_t length : number of bytes
+ *  std::uint64_t seed : varies the hash between tables
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::uint64_t: hash value
+ ******************************************************************************/
+inline std::uint64_t hash_bytes(const void* key, std::size_t length,
+                                std::uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(key);
+    std::size_t left = length;
+
+    seed ^= P0;
+
+    for(; left > 16; left -= 16, p += 16)
+        seed = mum(read_word(p, 8) ^ P1, read_word(p + 8, 8) ^ seed);
+
+    std::uint64_t a = read_word(p, left < 8 ? left : 8),
+                  b = left > 8 ? read_word(p + 8, left - 8) : 0;
+
+    return mum(P1 ^ length, mum(a ^ P1, b ^ seed) ^ P3) ^ P2;
+}
+
+}  // namespace hasher
+
+#endif  // HASHER_H
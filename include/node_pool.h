@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * AUTHOR      : Thuan Tang
+ * ID          : 00991588
+ * CLASS       : CS008
+ * HEADER      : node_pool
+ * DESCRIPTION : This header provides NodePool, a slab allocator of fixed-size
+ *      blocks for tree nodes. Blocks are carved in order out of slabs, and
+ *      freed blocks are recycled through a free list. Slabs start small and
+ *      double up to SLAB_BLOCKS blocks, so a small tree keeps a small pool.
+ *      Slabs are only returned to the heap when the pool is destroyed, so a
+ *      tree's nodes stay packed together and allocating a node never calls
+ *      the heap except to add a slab.
+ *
+ *      A pool is not thread-safe. It is owned by one tree, and is used under
+ *      the same rules as that tree.
+ ******************************************************************************/
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <algorithm>  // min()
+#include <cstddef>    // max_align_t, size_t
+#include <new>        // operator new/delete
+#include <vector>     // vector
+
+namespace node_pool {
+enum { FIRST_SLAB = 4, SLAB_BLOCKS = 256 };
+
+class NodePool {
+public:
+    // CONSTRUCTOR
+    NodePool(std::size_t block_size, std::size_t slab_blocks = SLAB_BLOCKS)
+        : _block_size(round_up(block_size)),
+          _slab_blocks(slab_blocks ? slab_blocks : 1),
+          _next_slab(std::min<std::size_t>(_slab_blocks, FIRST_SLAB)),
+          _free(nullptr),
+          _bump(nullptr),
+          _end(nullptr),
+          _in_use(0) {}
+
+    ~NodePool() {
+        for(char* slab : _slabs) ::operator delete(slab);
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // ACCESSORS
+    std::size_t block_size() const { return _block_size; }
+    std::size_t slab_count() const { return _slabs.size(); }
+    std::size_t in_use() const { return _in_use; }  // blocks handed out
+
+    // MUTATORS
+    void* allocate() {
+        ++_in_use;
+
+        if(_free) {  // recycle a freed block
+            FreeBlock* block = _free;
+            _free = _free->next;
+            return block;
+        }
+
+        if(_bump == _end) {  // current slab is used up
+            _slabs.push_back(
+                static_cast<char*>(::operator new(_block_size * _next_slab)));
+            _bump = _slabs.back();
+            _end = _bump + _block_size * _next_slab;
+
+            if(_next_slab < _slab_blocks)  // double slabs up to the cap
+                _next_slab = std::min(2 * _next_slab, _slab_blocks);
+        }
+
+        void* block = _bump;
+        _bump += _block_size;
+        return block;
+    }
+
+    void deallocate(void* block) {
+        FreeBlock* freed = static_cast<FreeBlock*>(block);
+        freed->next = _free;
+        _free = freed;
+        --_in_use;
+    }
+
+    // round size up to a multiple of the strictest fundamental alignment
+    static std::size_t round_up(std::size_t size) {
+        const std::size_t ALIGN = alignof(std::max_align_t);
+        size = size < sizeof(FreeBlock) ? sizeof(FreeBlock) : size;
+        return (size + ALIGN - 1) / ALIGN * ALIGN;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;  // next free block
+    };
+
+    std::size_t _block_size;    // bytes per block
+    std::size_t _slab_blocks;   // most blocks per slab
+    std::size_t _next_slab;     // blocks in the next slab
+    std::vector<char*> _slabs;  // all slabs, freed with the pool
+    FreeBlock* _free;           // free list of recycled blocks
+    char* _bump;                // next unused block in the newest slab
+    char* _end;                 // end of the newest slab
+    std::size_t _in_use;        // count of blocks handed out
+};
+
+}  // namespace node_pool
+
+#endif  // NODE_POOL_H
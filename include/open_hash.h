@@ -6,51 +6,74 @@
  * DESCRIPTION : This header defines a templated OpenHash. Item insertions are
  *      done via record type's _key. If key's hash clashes with previous key,
  *      then insertion attempts next +1 position until it finds an empty spot.
- *      Item insertions are limited to hash table size. Table size for hash
- *      class uses dynamic allocation for user specificed table size.
- *
- *      NOTE: Requires T's _key as unsigned for hash insert!
+ *      Table size for hash class uses dynamic allocation for user specificed
+ *      table size.
+ *
+ *      The table grows before (keys + PREVIOUSLY_USED slots) passes the max
+ *      load factor (default 0.75). It doubles to the next 4k + 3 prime when
+ *      keys alone fill over half the max load, else it is rebuilt at the
+ *      same size to purge PREVIOUSLY_USED slots. Rebuilds are amortized O(1)
+ *      per insert; reserve() sizes the table up front to skip them.
+ *
+ *      T is a record type with a key_type _key (see hash_record::Record).
+ *      Keys are hashed by H, hasher::Hash<key_type> by default, and compared
+ *      with ==. Slot states are kept apart from the records, so any key value
+ *      can be stored.
  ******************************************************************************/
 #ifndef OPEN_HASH_H
 #define OPEN_HASH_H
 
-#include <cassert>   // assert()
-#include <iomanip>   // setw()
-#include <iostream>  // stream objects
-#include <string>    // string objects
+#include <cassert>    // assert()
+#include <cmath>      // ceil()
+#include <iomanip>    // setw()
+#include <iostream>   // stream objects
+#include <stdexcept>  // invalid_argument
+#include <string>     // string objects
+#include <utility>    // swap()
+#include "hasher.h"   // Hash class
 
 namespace open_hash {
 
-template <typename T>
+template <typename T, typename H = hasher::Hash<typename T::key_type>>
 class OpenHash {
-    enum { PREVIOUSLY_USED = -2, NEVER_USED = -1, TABLE_SIZE = 811 };
+    enum { TABLE_SIZE = 811 };
+    enum Slot : unsigned char { NEVER_USED, PREVIOUSLY_USED, OCCUPIED };
 
 public:
+    typedef typename T::key_type key_type;
+
     // CONSTRUCTORS
-    OpenHash(std::size_t size = TABLE_SIZE);
+    OpenHash(std::size_t size = TABLE_SIZE, double max_load = 0.75,
+             const H& hasher = H());
 
     // BIG THREE
     ~OpenHash();
-    OpenHash(const OpenHash<T>& src);
-    OpenHash<T>& operator=(const OpenHash<T>& rhs);
+    OpenHash(const OpenHash<T, H>& src);
+    OpenHash<T, H>& operator=(const OpenHash<T, H>& rhs);
 
     // ACCESSORS
-    std::size_t capacity() const;         // total unique entries
-    std::size_t collisions() const;       // number of collisions
-    std::size_t size() const;             // number of keys in the table
-    bool find(int key, T& result) const;  // result <- record with key
-    bool is_collision(int key, std::size_t i) const;  // is key collidded?
-    bool is_present(int key) const;  // is this key present in table?
+    std::size_t capacity() const;    // total unique entries
+    std::size_t collisions() const;  // number of collisions
+    std::size_t size() const;        // number of keys in the table
+    std::size_t tombstones() const;  // number of PREVIOUSLY_USED slots
+    double load_factor() const;      // keys / capacity
+    double max_load_factor() const;  // grow before passing this load
+    bool find(const key_type& key, T& result) const;  // result <- record
+    bool is_collision(const key_type& key, std::size_t i) const;
+    bool is_present(const key_type& key) const;  // is key in table?
     std::ostream& print(std::ostream& outs = std::cout) const;
 
     // MUTATORS
-    void clear();                 // remove all items
-    bool insert(const T& entry);  // insert key, value pair
-    bool remove(int key);         // remove this key
+    void clear();                           // remove all items
+    bool insert(const T& entry);            // insert key, value pair
+    void max_load_factor(double max_load);  // 0 < max_load <= 1
+    bool remove(const key_type& key);       // remove this key
+    void reserve(std::size_t count);        // room for count keys
 
     // FRIENDS
     // print entire table with keys, etc.
-    friend std::ostream& operator<<(std::ostream& outs, const OpenHash<T>& h) {
+    friend std::ostream& operator<<(std::ostream& outs,
+                                    const OpenHash<T, H>& h) {
         return h.print(outs);
     }
 
@@ -58,14 +81,26 @@ private:
     std::size_t _table_size;     // capacity _data array
     std::size_t _collisions;     // number of entry collisions
     std::size_t _total_records;  // number of keys in the table
+    std::size_t _tombstones;     // number of PREVIOUSLY_USED slots
+    double _max_load;            // max (keys + tombstones) / _table_size
     T* _data;                    // table of Records
+    Slot* _slots;                // state of each _data slot
+    H _hasher;                   // key -> hash value
 
     // ACCESSORS
-    inline std::size_t hash(int key) const;  // hash function
-    inline bool find_index(int key, std::size_t& i) const;
+    inline std::size_t hash(const key_type& key) const;  // hash function
+    inline bool find_index(const key_type& key, std::size_t& i) const;
     inline std::size_t next_index(std::size_t i) const;
     inline bool never_used(std::size_t i) const;
     inline bool is_vacant(std::size_t i) const;
+    inline bool holds(std::size_t i, const key_type& key) const;
+    std::size_t fit_table_size(std::size_t count) const;
+    static bool is_prime(std::size_t n);
+    static std::size_t next_table_size(std::size_t size);
+
+    // MUTATORS
+    void place(const T& entry);     // add new key to first vacant slot
+    void rehash(std::size_t size);  // rebuild table without tombstones
 };
 
 /*******************************************************************************
@@ -74,19 +109,30 @@ private:
  *  _data array with _table_size attribute.
  *
  * PRE-CONDITIONS:
- *  none
+ *  std::size_t size: initial table size > 0
+ *  double max_load : max load factor, 0 < max_load <= 1
+ *  const H& hasher : key -> hash value
  *
  * POST-CONDITIONS:
- *  new memory allocated to _data
+ *  new memory allocated to _data and _slots
  *
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-OpenHash<T>::OpenHash(std::size_t size)
-    : _table_size(size), _collisions(0), _total_records(0), _data(nullptr) {
+template <typename T, typename H>
+OpenHash<T, H>::OpenHash(std::size_t size, double max_load, const H& hasher)
+    : _table_size(size),
+      _collisions(0),
+      _total_records(0),
+      _tombstones(0),
+      _max_load(0),
+      _data(nullptr),
+      _slots(nullptr),
+      _hasher(hasher) {
     assert(_table_size > 0);
+    max_load_factor(max_load);
     _data = new T[_table_size];
+    _slots = new Slot[_table_size]();  // all NEVER_USED
 }
 
 /*******************************************************************************
@@ -97,14 +143,15 @@ OpenHash<T>::OpenHash(std::size_t size)
  *  none
  *
  * POST-CONDITIONS:
- *  delete memory allocated to _data
+ *  delete memory allocated to _data and _slots
  *
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-OpenHash<T>::~OpenHash() {
+template <typename T, typename H>
+OpenHash<T, H>::~OpenHash() {
     delete[] _data;
+    delete[] _slots;
 }
 
 /*******************************************************************************
@@ -120,14 +167,22 @@ OpenHash<T>::~OpenHash() {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-OpenHash<T>::OpenHash(const OpenHash<T>& src)
+template <typename T, typename H>
+OpenHash<T, H>::OpenHash(const OpenHash<T, H>& src)
     : _table_size(src._table_size),
       _collisions(src._collisions),
       _total_records(src._total_records),
-      _data(nullptr) {
+      _tombstones(src._tombstones),
+      _max_load(src._max_load),
+      _data(nullptr),
+      _slots(nullptr),
+      _hasher(src._hasher) {
     _data = new T[_table_size];
-    for(std::size_t i = 0; i < _table_size; ++i) _data[i] = src._data[i];
+    _slots = new Slot[_table_size];
+    for(std::size_t i = 0; i < _table_size; ++i) {
+        _data[i] = src._data[i];
+        _slots[i] = src._slots[i];
+    }
 }
 
 /*******************************************************************************
@@ -143,16 +198,24 @@ OpenHash<T>::OpenHash(const OpenHash<T>& src)
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-OpenHash<T>& OpenHash<T>::operator=(const OpenHash<T>& rhs) {
+template <typename T, typename H>
+OpenHash<T, H>& OpenHash<T, H>::operator=(const OpenHash<T, H>& rhs) {
     if(this != &rhs) {
         delete[] _data;
+        delete[] _slots;
         _table_size = rhs._table_size;
         _collisions = rhs._collisions;
         _total_records = rhs._total_records;
+        _tombstones = rhs._tombstones;
+        _max_load = rhs._max_load;
+        _hasher = rhs._hasher;
 
         _data = new T[_table_size];
-        for(std::size_t i = 0; i < _table_size; ++i) _data[i] = rhs._data[i];
+        _slots = new Slot[_table_size];
+        for(std::size_t i = 0; i < _table_size; ++i) {
+            _data[i] = rhs._data[i];
+            _slots[i] = rhs._slots[i];
+        }
     }
 
     return *this;
@@ -171,8 +234,8 @@ OpenHash<T>& OpenHash<T>::operator=(const OpenHash<T>& rhs) {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::size_t OpenHash<T>::capacity() const {
+template <typename T, typename H>
+std::size_t OpenHash<T, H>::capacity() const {
     return _table_size;
 }
 
@@ -189,8 +252,8 @@ std::size_t OpenHash<T>::capacity() const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::size_t OpenHash<T>::collisions() const {
+template <typename T, typename H>
+std::size_t OpenHash<T, H>::collisions() const {
     return _collisions;
 }
 
@@ -207,11 +270,65 @@ std::size_t OpenHash<T>::collisions() const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::size_t OpenHash<T>::size() const {
+template <typename T, typename H>
+std::size_t OpenHash<T, H>::size() const {
     return _total_records;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Access to _tombstones
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: number of PREVIOUSLY_USED slots
+ ******************************************************************************/
+template <typename T, typename H>
+std::size_t OpenHash<T, H>::tombstones() const {
+    return _tombstones;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Ratio of keys to table size.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  double: _total_records / _table_size
+ ******************************************************************************/
+template <typename T, typename H>
+double OpenHash<T, H>::load_factor() const {
+    return static_cast<double>(_total_records) / _table_size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Access to _max_load
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  double: max (keys + tombstones) / _table_size before a rebuild
+ ******************************************************************************/
+template <typename T, typename H>
+double OpenHash<T, H>::max_load_factor() const {
+    return _max_load;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Find templated item with key.
@@ -225,8 +342,8 @@ std::size_t OpenHash<T>::size() const {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool OpenHash<T>::find(int key, T& result) const {
+template <typename T, typename H>
+bool OpenHash<T, H>::find(const key_type& key, T& result) const {
     bool is_found = false;
     std::size_t i = 0;
 
@@ -251,8 +368,8 @@ bool OpenHash<T>::find(int key, T& result) const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-bool OpenHash<T>::is_collision(int key, std::size_t i) const {
+template <typename T, typename H>
+bool OpenHash<T, H>::is_collision(const key_type& key, std::size_t i) const {
     return hash(key) != i;
 }
 
@@ -269,8 +386,8 @@ bool OpenHash<T>::is_collision(int key, std::size_t i) const {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool OpenHash<T>::is_present(int key) const {
+template <typename T, typename H>
+bool OpenHash<T, H>::is_present(const key_type& key) const {
     std::size_t i;
     return find_index(key, i);
 }
@@ -288,22 +405,22 @@ bool OpenHash<T>::is_present(int key) const {
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-std::ostream& OpenHash<T>::print(std::ostream& outs) const {
+template <typename T, typename H>
+std::ostream& OpenHash<T, H>::print(std::ostream& outs) const {
     std::size_t size = std::to_string(_table_size).size();
 
     outs << std::setfill('0');
     for(std::size_t i = 0; i < _table_size; ++i) {
         outs << "[" << std::setw(size) << std::right << i << "] ";
 
-        if(_data[i]._key > NEVER_USED) {
+        if(_slots[i] == OCCUPIED) {
             outs << _data[i] << " (" << std::setw(size) << hash(_data[i]._key)
                  << ")";
 
             if(is_collision(_data[i]._key, i)) outs << " *";
         }
 
-        if(_data[i]._key == PREVIOUSLY_USED) outs << "-----";
+        if(_slots[i] == PREVIOUSLY_USED) outs << "-----";
 
         outs << std::endl;
     }
@@ -321,55 +438,84 @@ std::ostream& OpenHash<T>::print(std::ostream& outs) const {
  * POST-CONDITIONS:
  *  _collisions = 0
  *  _total_records = 0
+ *  _tombstones = 0
  *
  * RETURN:
  *  none
  ******************************************************************************/
-template <typename T>
-void OpenHash<T>::clear() {
+template <typename T, typename H>
+void OpenHash<T, H>::clear() {
     if(_data)
-        for(std::size_t i = 0; i < _table_size; ++i) _data[i] = T();
+        for(std::size_t i = 0; i < _table_size; ++i) {
+            _data[i] = T();
+            _slots[i] = NEVER_USED;
+        }
 
     _collisions = 0;
     _total_records = 0;
+    _tombstones = 0;
 }
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Insert templated item into _data table via its _key
+ *  Insert templated item into _data table via its _key. An entry with the
+ *  same _key is replaced. A new key first grows or rebuilds the table when
+ *  it would pass the max load factor.
  *
  * PRE-CONDITIONS:
- *  _total_records < _table_size
+ *  const T& entry: record to insert
  *
  * POST-CONDITIONS:
- *  _collisions + 1 if entry's key is not hash value
- *  _total_records + 1
- *  item added into _data if success
+ *  _collisions + 1 if new entry's key is not hash value
+ *  _total_records + 1 if new entry
+ *  item added into _data
  *
  * RETURN:
- *  bool
+ *  bool: true; the table grows instead of filling up
  ******************************************************************************/
-template <typename T>
-bool OpenHash<T>::insert(const T& entry) {
-    assert(entry._key >= 0);
-
+template <typename T, typename H>
+bool OpenHash<T, H>::insert(const T& entry) {
     std::size_t i;
 
-    if(!find_index(entry._key, i)) {  // <--- see find_index's notes!
-        // EXIT and return false when hash key not found and FULL TABLE
-        if(_total_records >= _table_size) return false;
-
-        while(!is_vacant(i)) i = next_index(i);
-        ++_total_records;
+    if(find_index(entry._key, i)) {  // replace entry with same key
+        _data[i] = entry;
+        return true;
     }
 
-    if(is_collision(entry._key, i)) ++_collisions;
+    if(_total_records + _tombstones + 1 > _max_load * _table_size) {
+        // grow when keys fill over half the max load, else purge tombstones
+        if(_total_records + 1 > _max_load * _table_size / 2)
+            rehash(fit_table_size(2 * (_total_records + 1)));
+        else
+            rehash(_table_size);
+    }
 
-    _data[i] = entry;
+    place(entry);
 
     return true;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Sets the max load factor. Takes effect on the next insert of a new key.
+ *
+ * PRE-CONDITIONS:
+ *  double max_load: 0 < max_load <= 1
+ *
+ * POST-CONDITIONS:
+ *  _max_load = max_load
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T, typename H>
+void OpenHash<T, H>::max_load_factor(double max_load) {
+    if(!(max_load > 0 && max_load <= 1))
+        throw std::invalid_argument("OpenHash - max load factor not in (0, 1]");
+
+    _max_load = max_load;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Remove templated item from _data table via its _key
@@ -380,22 +526,34 @@ bool OpenHash<T>::insert(const T& entry) {
  * POST-CONDITIONS:
  *  _collisions - 1 if entry's key is not hash value
  *  _total_records - 1
- *  item removed from _data if success
+ *  item removed from _data if success; slot marked PREVIOUSLY_USED, or
+ *  NEVER_USED when no probe sequence passes through it
  *
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool OpenHash<T>::remove(int key) {
+template <typename T, typename H>
+bool OpenHash<T, H>::remove(const key_type& key) {
     bool is_removed = false;
     std::size_t i = -1;
 
     if(find_index(key, i)) {
         if(is_collision(key, i)) --_collisions;
 
-        _data[i]._key = PREVIOUSLY_USED;
+        _data[i] = T();
+        _slots[i] = PREVIOUSLY_USED;
+        ++_tombstones;
         --_total_records;
         is_removed = true;
+
+        // a run of tombstones that ends at a NEVER_USED slot is not part of
+        // any probe sequence, so it is marked NEVER_USED again
+        if(never_used(next_index(i)))
+            while(_slots[i] == PREVIOUSLY_USED) {
+                _slots[i] = NEVER_USED;
+                --_tombstones;
+                i = (i + _table_size - 1) % _table_size;  // previous index
+            }
     }
 
     return is_removed;
@@ -403,11 +561,31 @@ bool OpenHash<T>::remove(int key) {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Convert key to index position via mod TABLE_SIZE. Recommended TABLE_SIZE
- *  should be 4k + 3 and prime number.
+ *  Ensures count keys fit under the max load factor without a rebuild.
  *
  * PRE-CONDITIONS:
- *  int key: >= 0
+ *  std::size_t count: expected number of keys
+ *
+ * POST-CONDITIONS:
+ *  table rebuilt to a larger size if needed
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T, typename H>
+void OpenHash<T, H>::reserve(std::size_t count) {
+    std::size_t size = fit_table_size(count);
+
+    if(size > _table_size) rehash(size);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Convert key's hash value to index position via mod _table_size.
+ *  Recommended _table_size should be 4k + 3 and prime number.
+ *
+ * PRE-CONDITIONS:
+ *  const key_type& key: key
  *
  * POST-CONDITIONS:
  *  none
@@ -415,9 +593,9 @@ bool OpenHash<T>::remove(int key) {
  * RETURN:
  *  std::size_t: array index
  ******************************************************************************/
-template <typename T>
-std::size_t OpenHash<T>::hash(int key) const {
-    return key % _table_size;
+template <typename T, typename H>
+std::size_t OpenHash<T, H>::hash(const key_type& key) const {
+    return _hasher(key) % _table_size;
 }
 
 /*******************************************************************************
@@ -431,7 +609,7 @@ std::size_t OpenHash<T>::hash(int key) const {
  *      Find_index returns i = 1 because [1] = NEVER_USED.
  *
  * PRE-CONDITIONS:
- *  int key: >= 0
+ *  const key_type& key: key
  *
  * POST-CONDITIONS:
  *  std::size_t& i: @NEVER_USED, @KEY's or @original hash if not found
@@ -439,17 +617,17 @@ std::size_t OpenHash<T>::hash(int key) const {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool OpenHash<T>::find_index(int key, std::size_t& i) const {
+template <typename T, typename H>
+bool OpenHash<T, H>::find_index(const key_type& key, std::size_t& i) const {
     std::size_t count = 0;
     i = hash(key);
 
-    while(count < _table_size && !never_used(i) && _data[i]._key != key) {
+    while(count < _table_size && !never_used(i) && !holds(i, key)) {
         ++count;
         i = next_index(i);
     }
 
-    return _data[i]._key == key;
+    return holds(i, key);
 }
 
 /*******************************************************************************
@@ -465,8 +643,8 @@ bool OpenHash<T>::find_index(int key, std::size_t& i) const {
  * RETURN:
  *  std::size_t: array index
  ******************************************************************************/
-template <typename T>
-std::size_t OpenHash<T>::next_index(std::size_t i) const {
+template <typename T, typename H>
+std::size_t OpenHash<T, H>::next_index(std::size_t i) const {
     return ++i % _table_size;
 }
 
@@ -483,9 +661,9 @@ std::size_t OpenHash<T>::next_index(std::size_t i) const {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool OpenHash<T>::never_used(std::size_t i) const {
-    return _data[i]._key == NEVER_USED;
+template <typename T, typename H>
+bool OpenHash<T, H>::never_used(std::size_t i) const {
+    return _slots[i] == NEVER_USED;
 }
 
 /*******************************************************************************
@@ -501,9 +679,152 @@ bool OpenHash<T>::never_used(std::size_t i) const {
  * RETURN:
  *  bool
  ******************************************************************************/
-template <typename T>
-bool OpenHash<T>::is_vacant(std::size_t i) const {
-    return _data[i]._key <= NEVER_USED;
+template <typename T, typename H>
+bool OpenHash<T, H>::is_vacant(std::size_t i) const {
+    return _slots[i] != OCCUPIED;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Check for array index holds key.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t i       : array index >= 0
+ *  const key_type& key : key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T, typename H>
+bool OpenHash<T, H>::holds(std::size_t i, const key_type& key) const {
+    return _slots[i] == OCCUPIED && _data[i]._key == key;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Smallest table size that holds count keys under the max load factor.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t count: number of keys
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: 4k + 3 prime table size
+ ******************************************************************************/
+template <typename T, typename H>
+std::size_t OpenHash<T, H>::fit_table_size(std::size_t count) const {
+    return next_table_size(
+        static_cast<std::size_t>(std::ceil(count / _max_load)));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Check for prime number by trial division.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t n: number to check
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T, typename H>
+bool OpenHash<T, H>::is_prime(std::size_t n) {
+    if(n < 2) return false;
+
+    for(std::size_t d = 2; d <= n / d; ++d)
+        if(n % d == 0) return false;
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Smallest prime of the form 4k + 3 that is >= size.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t size: minimum table size
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: table size
+ ******************************************************************************/
+template <typename T, typename H>
+std::size_t OpenHash<T, H>::next_table_size(std::size_t size) {
+    size = size < 3 ? 3 : size + (3 - size % 4) % 4;  // round up to 4k + 3
+
+    while(!is_prime(size)) size += 4;
+
+    return size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Adds a new key to the first vacant slot of its probe sequence, reusing a
+ *  PREVIOUSLY_USED slot if one comes first.
+ *
+ * PRE-CONDITIONS:
+ *  entry's key is not in table and table has a vacant slot
+ *
+ * POST-CONDITIONS:
+ *  _collisions + 1 if entry's key is not hash value
+ *  _total_records + 1
+ *  _tombstones - 1 if a PREVIOUSLY_USED slot is reused
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T, typename H>
+void OpenHash<T, H>::place(const T& entry) {
+    std::size_t home = hash(entry._key), i = home;
+
+    while(!is_vacant(i)) i = next_index(i);
+
+    if(_slots[i] == PREVIOUSLY_USED) --_tombstones;
+    if(i != home) ++_collisions;
+
+    _data[i] = entry;
+    _slots[i] = OCCUPIED;
+    ++_total_records;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Rebuilds _data at the given size: keys are placed again, and collisions
+ *  are recounted. PREVIOUSLY_USED slots are dropped.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t size: new table size > _total_records
+ *
+ * POST-CONDITIONS:
+ *  new memory allocated to _data and _slots; old ones deleted
+ *  _tombstones = 0
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T, typename H>
+void OpenHash<T, H>::rehash(std::size_t size) {
+    OpenHash<T, H> table(size, _max_load, _hasher);
+
+    for(std::size_t i = 0; i < _table_size; ++i)
+        if(_slots[i] == OCCUPIED) table.place(_data[i]);
+
+    std::swap(_table_size, table._table_size);
+    std::swap(_collisions, table._collisions);
+    std::swap(_total_records, table._total_records);
+    std::swap(_tombstones, table._tombstones);
+    std::swap(_data, table._data);
+    std::swap(_slots, table._slots);
 }
 }  // namespace open_hash
 
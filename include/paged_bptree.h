@@ -0,0 +1,1539 @@
+/*******************************************************************************
+ * AUTHOR      : Thuan Tang
+ * ID          : 00991588
+ * CLASS       : CS008
+ * HEADER      : paged_bptree
+ * DESCRIPTION : This header provides a templated disk resident B+Tree, the
+ *      PagedBPTree. Like BPTree, the real data is only at the leaf nodes and
+ *      each leaf links to its next sibling, but every node is a fixed size
+ *      page of a file. Only the pages in the buffer pool are in memory, so
+ *      the tree can be bigger than memory and is reopened without rebuilding.
+ *
+ *      The entries are (string key, V value) pairs in (key, value) order,
+ *      like an index of field value to record position. A key may have many
+ *      values; an identical entry is not inserted twice. V must be
+ *      trivially copyable.
+ *
+ *      Erasing an entry that leaves a node under a quarter of a page merges
+ *      the node with a sibling when both fit a page; otherwise the two are
+ *      split evenly again. A merged away page goes to a free list that new
+ *      pages are taken from first, so the file does not grow after erases.
+ *
+ *      FILE STRUCTURE (PAGE_SIZE bytes per page):
+ *      page 0 | magic | page size | root | page count | size | sizeof(V)
+ *             | first free page
+ *      page n | node: is_leaf(1) | pad(1) | count(2) | next leaf(4) | entries
+ *      A free page is an empty leaf whose next leaf is the next free page.
+ *
+ *      Leaf entry  : key length(2) | key | value
+ *      Inner entries: child 0(4) | { key length(2) | key | value | child }
+ *      Child i + 1 of an inner node holds the entries >= (key i, value i).
+ *
+ *      BUFFER POOL:
+ *      Pages are read into a fixed number of frames. A frame in use is
+ *      pinned; an unpinned frame is reused in clock order, and written back
+ *      first if it is dirty. flush() writes all dirty pages.
+ *
+ *      Iterators hold a page id and index, and copy their entry. They are
+ *      invalidated by insert and erase.
+ ******************************************************************************/
+#ifndef PAGED_BPTREE_H
+#define PAGED_BPTREE_H
+
+#include <cstdint>        // uint16_t, uint32_t, uint64_t
+#include <cstring>        // memcpy()
+#include <fstream>        // fstream
+#include <stdexcept>      // runtime_error
+#include <string>         // string
+#include <type_traits>    // is_trivially_copyable
+#include <unordered_map>  // unordered_map
+#include <vector>         // vector
+
+namespace paged_bptree {
+
+enum {
+    PAGE_SIZE = 8192,  // bytes per page
+    MAX_KEY = 1024,    // max key length; a page holds at least 7 entries
+    POOL_FRAMES = 64,  // default frames in buffer pool
+    MIN_BYTES = PAGE_SIZE / 4  // a non-root node under this is merged
+};
+
+template <typename V>
+class PagedBPTree {
+public:
+    typedef std::uint32_t page_id;
+
+    static const page_id NO_PAGE = 0;  // page 0 is meta, never a node
+
+    struct Entry {
+        std::string key;
+        V value;
+    };
+
+    class Iterator {
+    public:
+        friend class PagedBPTree;
+
+        // CONSTRUCTOR
+        Iterator(PagedBPTree<V>* tree = nullptr, page_id page = NO_PAGE,
+                 std::size_t index = 0)
+            : _tree(tree), _page(page), _index(index), _entry() {
+            load();
+        }
+
+        bool is_null() { return _page == NO_PAGE; }
+        explicit operator bool() { return _page != NO_PAGE; }
+
+        const Entry& operator*() {
+            if(_page == NO_PAGE)
+                throw std::invalid_argument(
+                    "PagedBPTree::Iterator - nullptr check");
+
+            return _entry;
+        }
+
+        const Entry* operator->() { return &operator*(); }
+
+        Iterator& operator++() {  // pre-inc
+            if(_page != NO_PAGE) {
+                ++_index;
+                load();
+            }
+            return *this;
+        }
+
+        Iterator operator++(int _u) {  // post-inc
+            (void)_u;                  // suppress unused warning
+            Iterator it = *this;       // make temp
+            operator++();              // pre-inc
+            return it;                 // return previous state
+        }
+
+        // FRIENDS
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs._page == rhs._page &&
+                   (lhs._page == NO_PAGE || lhs._index == rhs._index);
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        PagedBPTree<V>* _tree;
+        page_id _page;
+        std::size_t _index;
+        Entry _entry;  // copy of entry at _page/_index
+
+        void load();  // copy entry; skip to next leaf when past last entry
+    };
+
+    // CONSTRUCTOR
+    PagedBPTree(const std::string& fname = "",
+                std::size_t frames = POOL_FRAMES);
+
+    // BIG THREE
+    ~PagedBPTree();
+    PagedBPTree(const PagedBPTree<V>& src) = delete;
+    PagedBPTree<V>& operator=(const PagedBPTree<V>& rhs) = delete;
+
+    // file
+    void open(const std::string& fname);  // open or create tree file
+    void close();                         // flush and close tree file
+    void flush();                         // write dirty pages and meta
+    bool is_open() const;
+
+    // capacity
+    std::size_t size() const;
+    bool empty() const;
+
+    // element access
+    Iterator begin();
+    Iterator end();
+    Iterator find(const std::string& key);
+    Iterator lower_bound(const std::string& key);
+    Iterator upper_bound(const std::string& key);
+
+    // modifiers
+    bool insert(const std::string& key, const V& value);
+    bool erase(const std::string& key, const V& value);  // remove entry
+    std::size_t erase(const std::string& key);  // remove all entries of key
+
+    // operations
+    bool contains(const std::string& key);
+    std::size_t count(const std::string& key);
+    bool verify();
+
+private:
+    static_assert(std::is_trivially_copyable<V>::value,
+                  "PagedBPTree value must be trivially copyable");
+
+    enum {
+        MAGIC = 0x31545042,  // "BPT1"
+        HEADER_SIZE = 8      // node header bytes
+    };
+
+    struct Node {
+        bool is_leaf;
+        page_id next;                   // next leaf; NO_PAGE if last
+        std::vector<std::string> keys;  // entry or separator keys
+        std::vector<V> values;          // entry or separator values
+        std::vector<page_id> children;  // inner: keys.size() + 1 children
+
+        Node() : is_leaf(true), next(NO_PAGE) {}
+
+        std::size_t bytes() const;  // serialized size
+        void read(const char* page);
+        void write(char* page) const;
+    };
+
+    struct Frame {
+        page_id id;       // page in frame; NO_PAGE if free
+        Node node;        // decoded page
+        bool is_dirty;    // node changed since read
+        int pins;         // users of frame; pinned frame is not reused
+        bool is_used;     // clock reference bit
+    };
+
+    struct Split {        // result of a node split
+        std::string key;  // separator key for new right node
+        V value;          // separator value for new right node
+        page_id right;    // new right node; NO_PAGE if no split
+    };
+
+    std::string _fname;
+    std::fstream _file;
+    page_id _root;        // root node
+    page_id _page_count;  // pages in file, including meta page
+    page_id _free;        // first free page; NO_PAGE if none
+    std::size_t _size;    // count of all entries
+    std::vector<Frame> _frames;
+    std::unordered_map<page_id, std::size_t> _page_table;  // page to frame
+    std::size_t _clock;  // clock hand of buffer pool
+
+    // buffer pool
+    Node& pin(page_id id);                       // pin page in a frame
+    void unpin(page_id id, bool is_dirty = false);
+    Node& allocate(page_id& id, bool is_leaf);  // pin a new page
+    void release(page_id id);                    // add page to free list
+    std::size_t victim();                        // free frame to reuse
+    void read_page(page_id id, Node& node);
+    void write_page(page_id id, const Node& node);
+    void read_meta();
+    void write_meta();
+
+    // search
+    page_id find_leaf(const std::string& key);  // leftmost leaf with key
+    static int compare(const std::string& lkey, const V& lvalue,
+                       const std::string& rkey, const V& rvalue);
+
+    // insert
+    bool insert(page_id id, const std::string& key, const V& value,
+                Split& split);
+    void split_node(Node& node, Node& right, Split& split);
+
+    // erase
+    bool erase(page_id id, const std::string& key, const V& value,
+               bool& is_short);
+    void fix_shortage(Node& node, std::size_t i);  // merge/split child i
+
+    bool verify_node(page_id id, int level, int& height,
+                     const Entry* low, const Entry* high);
+};
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Copy entry at page and index. When index is past the last entry of the
+ *  leaf, moves to the next leaf. Points to NO_PAGE after the last leaf.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  _entry copied; _page is NO_PAGE if no more entries
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::Iterator::load() {
+    while(_page != NO_PAGE) {
+        Node& node = _tree->pin(_page);
+
+        if(_index < node.keys.size()) {
+            _entry.key = node.keys[_index];
+            _entry.value = node.values[_index];
+            _tree->unpin(_page);
+            return;
+        }
+
+        page_id next = node.next;  // past last entry, go to next leaf
+        _tree->unpin(_page);
+        _page = next;
+        _index = 0;
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Constructor. Opens the tree file if a file name is given.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& fname: tree file name; empty for no file
+ *  std::size_t frames      : frames in buffer pool, at least 8
+ *
+ * POST-CONDITIONS:
+ *  initializations
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+PagedBPTree<V>::PagedBPTree(const std::string& fname, std::size_t frames)
+    : _fname(),
+      _root(NO_PAGE),
+      _page_count(0),
+      _free(NO_PAGE),
+      _size(0),
+      _frames(frames < 8 ? 8 : frames),
+      _clock(0) {
+    for(auto& f : _frames) {
+        f.id = NO_PAGE;
+        f.is_dirty = false;
+        f.pins = 0;
+        f.is_used = false;
+    }
+
+    if(!fname.empty()) open(fname);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Destructor. Writes all dirty pages to the tree file.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  tree file closed
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+PagedBPTree<V>::~PagedBPTree() {
+    close();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Opens the tree file. A new file is created with an empty root leaf.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& fname: tree file name
+ *
+ * POST-CONDITIONS:
+ *  tree file opened; throws runtime_error if not a tree file or file
+ *  cannot be created
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::open(const std::string& fname) {
+    close();
+    _fname = fname;
+
+    _file.open(_fname.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+
+    if(_file) {  // existing tree
+        read_meta();
+    } else {  // create file with meta page and root leaf
+        std::ofstream create(_fname.c_str(), std::ios::binary);
+        create.close();
+        _file.clear();
+        _file.open(_fname.c_str(),
+                   std::ios::in | std::ios::out | std::ios::binary);
+
+        if(!_file) {
+            _fname.clear();
+            throw std::runtime_error("PagedBPTree - cannot open " + fname);
+        }
+
+        _page_count = 1;
+        _free = NO_PAGE;
+        _size = 0;
+        allocate(_root, true);
+        unpin(_root, true);
+        flush();
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Writes all dirty pages and closes the tree file.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  buffer pool emptied
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::close() {
+    if(!is_open()) return;
+
+    flush();
+    _file.close();
+
+    for(auto& f : _frames) {
+        f.id = NO_PAGE;
+        f.node = Node();
+        f.is_dirty = false;
+        f.pins = 0;
+        f.is_used = false;
+    }
+    _page_table.clear();
+    _fname.clear();
+    _root = NO_PAGE;
+    _page_count = 0;
+    _free = NO_PAGE;
+    _size = 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Writes all dirty pages and the meta page to the tree file.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  tree file up to date
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::flush() {
+    if(!is_open()) return;
+
+    for(auto& f : _frames)
+        if(f.id != NO_PAGE && f.is_dirty) {
+            write_page(f.id, f.node);
+            f.is_dirty = false;
+        }
+
+    write_meta();
+    _file.flush();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if a tree file is opened.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename V>
+bool PagedBPTree<V>::is_open() const {
+    return !_fname.empty();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns total entries in tree.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename V>
+std::size_t PagedBPTree<V>::size() const {
+    return _size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if tree is empty.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename V>
+bool PagedBPTree<V>::empty() const {
+    return _size == 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the first entry.
+ *
+ * PRE-CONDITIONS:
+ *  tree file opened
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  PagedBPTree<V>::Iterator
+ ******************************************************************************/
+template <typename V>
+typename PagedBPTree<V>::Iterator PagedBPTree<V>::begin() {
+    page_id id = _root;
+
+    while(true) {  // follow leftmost children to first leaf
+        Node& node = pin(id);
+        page_id child = node.is_leaf ? NO_PAGE : node.children[0];
+        unpin(id);
+
+        if(child == NO_PAGE) break;
+        id = child;
+    }
+
+    return Iterator(this, id, 0);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator past the last entry.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  PagedBPTree<V>::Iterator
+ ******************************************************************************/
+template <typename V>
+typename PagedBPTree<V>::Iterator PagedBPTree<V>::end() {
+    return Iterator(this, NO_PAGE);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the first entry with key; else end().
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: target key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  PagedBPTree<V>::Iterator
+ ******************************************************************************/
+template <typename V>
+typename PagedBPTree<V>::Iterator PagedBPTree<V>::find(
+    const std::string& key) {
+    Iterator it = lower_bound(key);
+
+    return it && it->key == key ? it : end();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the first entry with key greater than or equal to
+ *  key.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: target key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  PagedBPTree<V>::Iterator
+ ******************************************************************************/
+template <typename V>
+typename PagedBPTree<V>::Iterator PagedBPTree<V>::lower_bound(
+    const std::string& key) {
+    page_id id = find_leaf(key);
+    Node& leaf = pin(id);
+    std::size_t i = 0;
+
+    while(i < leaf.keys.size() && leaf.keys[i] < key) ++i;
+    unpin(id);
+
+    return Iterator(this, id, i);  // loads from next leaf if i is past last
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the first entry with key greater than key.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: target key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  PagedBPTree<V>::Iterator
+ ******************************************************************************/
+template <typename V>
+typename PagedBPTree<V>::Iterator PagedBPTree<V>::upper_bound(
+    const std::string& key) {
+    Iterator it = lower_bound(key);
+
+    while(it && it->key == key) ++it;
+
+    return it;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts an entry. Splits full nodes on the way back up; a root split
+ *  makes a new root.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: key of at most MAX_KEY bytes
+ *  const V& value        : value
+ *
+ * POST-CONDITIONS:
+ *  entry inserted; _size inc if successful
+ *
+ * RETURN:
+ *  bool: false if entry already exists or key is too long
+ ******************************************************************************/
+template <typename V>
+bool PagedBPTree<V>::insert(const std::string& key, const V& value) {
+    Split split;
+
+    if(key.size() > MAX_KEY || !insert(_root, key, value, split)) return false;
+
+    if(split.right != NO_PAGE) {  // grow new root over old root and right
+        page_id id;
+        Node& root = allocate(id, false);
+        root.keys.push_back(split.key);
+        root.values.push_back(split.value);
+        root.children.push_back(_root);
+        root.children.push_back(split.right);
+        unpin(id, true);
+        _root = id;
+    }
+    ++_size;
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Erases an entry. Nodes left short are merged or rebalanced on the way
+ *  back up; a root inner node left with one child is replaced by it.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: key
+ *  const V& value        : value
+ *
+ * POST-CONDITIONS:
+ *  entry erased; _size dec if successful
+ *
+ * RETURN:
+ *  bool: false if entry does not exist
+ ******************************************************************************/
+template <typename V>
+bool PagedBPTree<V>::erase(const std::string& key, const V& value) {
+    bool is_short = false;
+
+    if(key.size() > MAX_KEY || !erase(_root, key, value, is_short))
+        return false;
+
+    Node& root = pin(_root);
+    if(!root.is_leaf && root.keys.empty()) {  // shrink tree by one level
+        page_id old_root = _root;
+        _root = root.children[0];
+        unpin(old_root);
+        release(old_root);
+    } else
+        unpin(_root);
+    --_size;
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Erases all entries with key.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: key
+ *
+ * POST-CONDITIONS:
+ *  entries of key erased
+ *
+ * RETURN:
+ *  std::size_t: count of entries erased
+ ******************************************************************************/
+template <typename V>
+std::size_t PagedBPTree<V>::erase(const std::string& key) {
+    std::size_t count = 0;
+
+    for(Iterator it = find(key); it; it = find(key), ++count)
+        erase(key, it->value);
+
+    return count;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if key is in tree.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: target key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename V>
+bool PagedBPTree<V>::contains(const std::string& key) {
+    return (bool)find(key);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the number of entries with key.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: target key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename V>
+std::size_t PagedBPTree<V>::count(const std::string& key) {
+    std::size_t count = 0;
+
+    for(Iterator it = lower_bound(key); it && it->key == key; ++it) ++count;
+
+    return count;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if the tree's rules are valid: entries in order and within their
+ *  parent's separators, all leaves at the same level, every node fits a
+ *  page, leaves linked in order and _size matches.
+ *
+ * PRE-CONDITIONS:
+ *  tree file opened
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename V>
+bool PagedBPTree<V>::verify() {
+    int height = -1;
+    std::size_t count = 0;
+    Entry previous = Entry();
+
+    if(!verify_node(_root, 0, height, nullptr, nullptr)) return false;
+
+    for(Iterator it = begin(); it; ++it, ++count) {  // walk leaf links
+        if(count && compare(previous.key, previous.value, it->key,
+                            it->value) >= 0)
+            return false;
+        previous = *it;
+    }
+
+    return count == _size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Pins a page in the buffer pool, reading it into a free frame if needed.
+ *  The node reference is valid until the page is unpinned.
+ *
+ * PRE-CONDITIONS:
+ *  page_id id: page in tree file
+ *
+ * POST-CONDITIONS:
+ *  page pinned
+ *
+ * RETURN:
+ *  Node&
+ ******************************************************************************/
+template <typename V>
+typename PagedBPTree<V>::Node& PagedBPTree<V>::pin(page_id id) {
+    auto found = _page_table.find(id);
+
+    if(found != _page_table.end()) {
+        Frame& frame = _frames[found->second];
+        ++frame.pins;
+        frame.is_used = true;
+        return frame.node;
+    }
+
+    std::size_t i = victim();
+    Frame& frame = _frames[i];
+    read_page(id, frame.node);
+    frame.id = id;
+    frame.pins = 1;
+    frame.is_used = true;
+    _page_table[id] = i;
+
+    return frame.node;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Unpins a page. A changed page must be unpinned as dirty.
+ *
+ * PRE-CONDITIONS:
+ *  page_id id   : pinned page
+ *  bool is_dirty: page was changed
+ *
+ * POST-CONDITIONS:
+ *  page unpinned once
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::unpin(page_id id, bool is_dirty) {
+    Frame& frame = _frames[_page_table.at(id)];
+
+    --frame.pins;
+    if(is_dirty) frame.is_dirty = true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Pins a new empty page, taken from the free list or else at the end of
+ *  the tree file.
+ *
+ * PRE-CONDITIONS:
+ *  page_id& id : any
+ *  bool is_leaf: new node is leaf
+ *
+ * POST-CONDITIONS:
+ *  page_id& id: new page; pinned and dirty
+ *
+ * RETURN:
+ *  Node&
+ ******************************************************************************/
+template <typename V>
+typename PagedBPTree<V>::Node& PagedBPTree<V>::allocate(page_id& id,
+                                                         bool is_leaf) {
+    if(_free != NO_PAGE) {  // reuse first free page
+        id = _free;
+        Node& node = pin(id);
+        _free = node.next;
+        node = Node();
+        node.is_leaf = is_leaf;
+        _frames[_page_table.at(id)].is_dirty = true;
+
+        return node;
+    }
+
+    std::size_t i = victim();
+    Frame& frame = _frames[i];
+
+    id = _page_count++;
+    frame.id = id;
+    frame.node = Node();
+    frame.node.is_leaf = is_leaf;
+    frame.is_dirty = true;
+    frame.pins = 1;
+    frame.is_used = true;
+    _page_table[id] = i;
+
+    return frame.node;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Adds a page no longer in the tree to the front of the free list.
+ *
+ * PRE-CONDITIONS:
+ *  page_id id: unpinned page not referenced by any node
+ *
+ * POST-CONDITIONS:
+ *  page is an empty leaf linking to the previous first free page
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::release(page_id id) {
+    Node& node = pin(id);
+
+    node = Node();
+    node.next = _free;
+    _free = id;
+    unpin(id, true);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns a frame to reuse. Sweeps the clock over the frames, skipping
+ *  pinned frames and giving recently used frames a second chance. A dirty
+ *  victim is written back first.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  frame is free; throws runtime_error if every frame is pinned
+ *
+ * RETURN:
+ *  std::size_t: frame index
+ ******************************************************************************/
+template <typename V>
+std::size_t PagedBPTree<V>::victim() {
+    for(std::size_t n = 0; n < 2 * _frames.size(); ++n) {
+        std::size_t i = _clock;
+        Frame& frame = _frames[i];
+        _clock = (_clock + 1) % _frames.size();
+
+        if(frame.id == NO_PAGE) return i;
+        if(frame.pins) continue;
+
+        if(frame.is_used) {  // second chance
+            frame.is_used = false;
+            continue;
+        }
+
+        if(frame.is_dirty) write_page(frame.id, frame.node);
+        _page_table.erase(frame.id);
+        frame.id = NO_PAGE;
+        frame.is_dirty = false;
+
+        return i;
+    }
+
+    throw std::runtime_error("PagedBPTree - all buffer pool frames pinned");
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Reads a page from the tree file and decodes its node.
+ *
+ * PRE-CONDITIONS:
+ *  page_id id: page in tree file
+ *  Node& node: any
+ *
+ * POST-CONDITIONS:
+ *  Node& node: decoded page
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::read_page(page_id id, Node& node) {
+    std::vector<char> page(PAGE_SIZE, 0);
+
+    _file.clear();
+    _file.seekg(std::streamoff(id) * PAGE_SIZE);
+    _file.read(page.data(), PAGE_SIZE);
+    node.read(page.data());
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Encodes a node and writes it to its page in the tree file.
+ *
+ * PRE-CONDITIONS:
+ *  page_id id      : page of node
+ *  const Node& node: node that fits a page
+ *
+ * POST-CONDITIONS:
+ *  page written
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::write_page(page_id id, const Node& node) {
+    std::vector<char> page(PAGE_SIZE, 0);
+
+    node.write(page.data());
+    _file.clear();
+    _file.seekp(std::streamoff(id) * PAGE_SIZE);
+    _file.write(page.data(), PAGE_SIZE);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Reads tree states from the meta page.
+ *
+ * PRE-CONDITIONS:
+ *  tree file opened
+ *
+ * POST-CONDITIONS:
+ *  states read; throws runtime_error if not a tree file of this type
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::read_meta() {
+    std::vector<char> page(PAGE_SIZE, 0);
+    std::uint32_t meta[4];
+    std::uint64_t size;
+    std::uint32_t value_size;
+    const char* walker = page.data();
+
+    _file.clear();
+    _file.seekg(0);
+    _file.read(page.data(), PAGE_SIZE);
+    std::memcpy(meta, walker, sizeof(meta));
+    std::memcpy(&size, walker += sizeof(meta), sizeof(size));
+    std::memcpy(&value_size, walker += sizeof(size), sizeof(value_size));
+    std::memcpy(&_free, walker += sizeof(value_size), sizeof(_free));
+
+    if(!_file || meta[0] != MAGIC || meta[1] != PAGE_SIZE ||
+       value_size != sizeof(V)) {
+        _file.close();
+        _fname.clear();
+        throw std::runtime_error("PagedBPTree - invalid tree file");
+    }
+
+    _root = meta[2];
+    _page_count = meta[3];
+    _size = size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Writes tree states to the meta page.
+ *
+ * PRE-CONDITIONS:
+ *  tree file opened
+ *
+ * POST-CONDITIONS:
+ *  meta page written
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::write_meta() {
+    std::vector<char> page(PAGE_SIZE, 0);
+    std::uint32_t meta[4] = {MAGIC, PAGE_SIZE, _root, _page_count};
+    std::uint64_t size = _size;
+    std::uint32_t value_size = sizeof(V);
+    char* walker = page.data();
+
+    std::memcpy(walker, meta, sizeof(meta));
+    std::memcpy(walker += sizeof(meta), &size, sizeof(size));
+    std::memcpy(walker += sizeof(size), &value_size, sizeof(value_size));
+    std::memcpy(walker += sizeof(value_size), &_free, sizeof(_free));
+
+    _file.clear();
+    _file.seekp(0);
+    _file.write(page.data(), PAGE_SIZE);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the leftmost leaf that may hold key. In an inner node, the child
+ *  left of the first separator with a key not less than key is taken, since
+ *  that child may hold entries with key and smaller values.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: target key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  page_id
+ ******************************************************************************/
+template <typename V>
+typename PagedBPTree<V>::page_id PagedBPTree<V>::find_leaf(
+    const std::string& key) {
+    page_id id = _root;
+
+    while(true) {
+        Node& node = pin(id);
+
+        if(node.is_leaf) {
+            unpin(id);
+            return id;
+        }
+
+        std::size_t i = 0;
+        while(i < node.keys.size() && node.keys[i] < key) ++i;
+
+        page_id child = node.children[i];
+        unpin(id);
+        id = child;
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Compares two entries by key, then by value.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& lkey: left key
+ *  const V& lvalue        : left value
+ *  const std::string& rkey: right key
+ *  const V& rvalue        : right value
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  int: negative if left < right, 0 if equal, else positive
+ ******************************************************************************/
+template <typename V>
+int PagedBPTree<V>::compare(const std::string& lkey, const V& lvalue,
+                            const std::string& rkey, const V& rvalue) {
+    int cmp = lkey.compare(rkey);
+
+    if(cmp) return cmp;
+    if(lvalue < rvalue) return -1;
+    if(rvalue < lvalue) return 1;
+
+    return 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Recursively inserts an entry into the subtree at page id. When a child
+ *  splits, its separator is added to this node. When this node no longer
+ *  fits a page, it splits and split is set for the parent.
+ *
+ * PRE-CONDITIONS:
+ *  page_id id            : root of subtree
+ *  const std::string& key: key of at most MAX_KEY bytes
+ *  const V& value        : value
+ *  Split& split          : any
+ *
+ * POST-CONDITIONS:
+ *  Split& split: split.right is new right node; else NO_PAGE
+ *
+ * RETURN:
+ *  bool: false if entry already exists
+ ******************************************************************************/
+template <typename V>
+bool PagedBPTree<V>::insert(page_id id, const std::string& key,
+                            const V& value, Split& split) {
+    Node& node = pin(id);
+    std::size_t i = 0;
+    split.right = NO_PAGE;
+
+    if(node.is_leaf) {  // find first entry not less than new entry
+        while(i < node.keys.size() &&
+              compare(node.keys[i], node.values[i], key, value) < 0)
+            ++i;
+
+        if(i < node.keys.size() && node.keys[i] == key &&
+           !(node.values[i] < value) && !(value < node.values[i])) {
+            unpin(id);
+            return false;
+        }
+
+        node.keys.insert(node.keys.begin() + i, key);
+        node.values.insert(node.values.begin() + i, value);
+    } else {  // find child: count of separators <= new entry
+        while(i < node.keys.size() &&
+              compare(node.keys[i], node.values[i], key, value) <= 0)
+            ++i;
+
+        Split child;
+        if(!insert(node.children[i], key, value, child)) {
+            unpin(id);
+            return false;
+        }
+
+        if(child.right == NO_PAGE) {
+            unpin(id);
+            return true;
+        }
+
+        node.keys.insert(node.keys.begin() + i, child.key);
+        node.values.insert(node.values.begin() + i, child.value);
+        node.children.insert(node.children.begin() + i + 1, child.right);
+    }
+
+    if(node.bytes() > PAGE_SIZE) {
+        Node& right = allocate(split.right, node.is_leaf);
+        split_node(node, right, split);
+        unpin(split.right, true);
+    }
+    unpin(id, true);
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Moves the upper half (by bytes) of a node to an empty right node. A leaf
+ *  split copies the right's first entry up as separator and links right
+ *  after node. An inner split moves its middle separator up.
+ *
+ * PRE-CONDITIONS:
+ *  Node& node  : node over a page
+ *  Node& right : new empty node of same kind
+ *  Split& split: split.right is right's page
+ *
+ * POST-CONDITIONS:
+ *  Split& split: separator key/value set
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::split_node(Node& node, Node& right, Split& split) {
+    std::size_t half = node.bytes() / 2;
+    std::size_t bytes = HEADER_SIZE;
+    std::size_t m = 0;  // first entry moved to right
+
+    while(m + 2 < node.keys.size() && bytes < half)
+        bytes += 2 + node.keys[m++].size() + sizeof(V);
+    if(!m) m = 1;
+
+    if(node.is_leaf) {
+        right.keys.assign(node.keys.begin() + m, node.keys.end());
+        right.values.assign(node.values.begin() + m, node.values.end());
+        split.key = right.keys.front();
+        split.value = right.values.front();
+
+        right.next = node.next;
+        node.next = split.right;
+    } else {  // separator m moves up
+        split.key = node.keys[m];
+        split.value = node.values[m];
+
+        right.keys.assign(node.keys.begin() + m + 1, node.keys.end());
+        right.values.assign(node.values.begin() + m + 1, node.values.end());
+        right.children.assign(node.children.begin() + m + 1,
+                              node.children.end());
+        node.children.resize(m + 1);
+    }
+
+    node.keys.resize(m);
+    node.values.resize(m);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Recursively erases an entry from the subtree at page id. A child left
+ *  short is fixed with a sibling before returning.
+ *
+ * PRE-CONDITIONS:
+ *  page_id id            : root of subtree
+ *  const std::string& key: key
+ *  const V& value        : value
+ *  bool& is_short        : any
+ *
+ * POST-CONDITIONS:
+ *  bool& is_short: node at id is under MIN_BYTES
+ *
+ * RETURN:
+ *  bool: false if entry does not exist
+ ******************************************************************************/
+template <typename V>
+bool PagedBPTree<V>::erase(page_id id, const std::string& key, const V& value,
+                           bool& is_short) {
+    Node& node = pin(id);
+    std::size_t i = 0;
+
+    if(node.is_leaf) {  // find entry
+        while(i < node.keys.size() &&
+              compare(node.keys[i], node.values[i], key, value) < 0)
+            ++i;
+
+        if(i == node.keys.size() ||
+           compare(node.keys[i], node.values[i], key, value) != 0) {
+            unpin(id);
+            return false;
+        }
+
+        node.keys.erase(node.keys.begin() + i);
+        node.values.erase(node.values.begin() + i);
+    } else {  // find child: count of separators <= entry
+        while(i < node.keys.size() &&
+              compare(node.keys[i], node.values[i], key, value) <= 0)
+            ++i;
+
+        bool is_child_short = false;
+        if(!erase(node.children[i], key, value, is_child_short)) {
+            unpin(id);
+            return false;
+        }
+
+        if(is_child_short) fix_shortage(node, i);
+    }
+
+    is_short = node.bytes() < MIN_BYTES;
+    unpin(id, true);
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Fixes short child i of an inner node with its right sibling, or its left
+ *  sibling if it is the last child. The right node's entries are moved into
+ *  the left node (with the separator between them for inner nodes). If the
+ *  result fits a page, the right page is freed and its separator removed;
+ *  else the result is split evenly by bytes again with a new separator.
+ *
+ * PRE-CONDITIONS:
+ *  Node& node   : pinned inner node with at least 2 children
+ *  std::size_t i: short child
+ *
+ * POST-CONDITIONS:
+ *  children merged or rebalanced
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::fix_shortage(Node& node, std::size_t i) {
+    std::size_t l = i + 1 < node.children.size() ? i : i - 1;  // left child
+    page_id left_id = node.children[l], right_id = node.children[l + 1];
+    Node& left = pin(left_id);
+    Node& right = pin(right_id);
+
+    if(!left.is_leaf) {  // separator comes down between the children
+        left.keys.push_back(node.keys[l]);
+        left.values.push_back(node.values[l]);
+        left.children.insert(left.children.end(), right.children.begin(),
+                             right.children.end());
+    } else
+        left.next = right.next;
+    left.keys.insert(left.keys.end(), right.keys.begin(), right.keys.end());
+    left.values.insert(left.values.end(), right.values.begin(),
+                       right.values.end());
+
+    if(left.bytes() <= PAGE_SIZE) {  // merged; drop right
+        node.keys.erase(node.keys.begin() + l);
+        node.values.erase(node.values.begin() + l);
+        node.children.erase(node.children.begin() + l + 1);
+        unpin(right_id);
+        unpin(left_id, true);
+        release(right_id);
+    } else {  // split evenly again
+        Split split;
+        split.right = right_id;
+        right = Node();
+        right.is_leaf = left.is_leaf;
+        split_node(left, right, split);
+
+        node.keys[l] = split.key;
+        node.values[l] = split.value;
+        unpin(right_id, true);
+        unpin(left_id, true);
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Recursively checks a subtree: entries in order and within [low, high),
+ *  inner nodes with one more child than separators, every node fits a
+ *  page and all leaves at the same height.
+ *
+ * PRE-CONDITIONS:
+ *  page_id id        : root of subtree
+ *  int level         : depth of subtree
+ *  int& height       : -1 until first leaf found
+ *  const Entry* low  : lower bound of entries; nullptr if none
+ *  const Entry* high : upper bound of entries; nullptr if none
+ *
+ * POST-CONDITIONS:
+ *  int& height: leaf level
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename V>
+bool PagedBPTree<V>::verify_node(page_id id, int level, int& height,
+                                 const Entry* low, const Entry* high) {
+    Node node = pin(id);  // copy; children are pinned while checking
+    unpin(id);
+
+    if(node.bytes() > PAGE_SIZE) return false;
+
+    for(std::size_t i = 0; i < node.keys.size(); ++i) {
+        if(i && compare(node.keys[i - 1], node.values[i - 1], node.keys[i],
+                        node.values[i]) >= 0)
+            return false;
+        if(low && compare(node.keys[i], node.values[i], low->key,
+                          low->value) < 0)
+            return false;
+        if(high && compare(node.keys[i], node.values[i], high->key,
+                           high->value) >= 0)
+            return false;
+    }
+
+    if(node.is_leaf) {
+        if(height < 0) height = level;
+        return height == level;
+    }
+
+    if(node.children.size() != node.keys.size() + 1) return false;
+
+    for(std::size_t i = 0; i < node.children.size(); ++i) {
+        Entry left, right;
+        const Entry* child_low = low;
+        const Entry* child_high = high;
+
+        if(i) {
+            left = Entry{node.keys[i - 1], node.values[i - 1]};
+            child_low = &left;
+        }
+        if(i < node.keys.size()) {
+            right = Entry{node.keys[i], node.values[i]};
+            child_high = &right;
+        }
+
+        if(!verify_node(node.children[i], level + 1, height, child_low,
+                        child_high))
+            return false;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the number of bytes of the node encoded in a page.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename V>
+std::size_t PagedBPTree<V>::Node::bytes() const {
+    std::size_t bytes = HEADER_SIZE;
+
+    for(const auto& key : keys) bytes += 2 + key.size() + sizeof(V);
+    if(!is_leaf) bytes += sizeof(page_id) * children.size();
+
+    return bytes;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Decodes node from a page.
+ *
+ * PRE-CONDITIONS:
+ *  const char* page: page of PAGE_SIZE bytes
+ *
+ * POST-CONDITIONS:
+ *  node decoded
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::Node::read(const char* page) {
+    std::uint16_t count, length;
+    const char* walker = page + HEADER_SIZE;
+
+    is_leaf = page[0] != 0;
+    std::memcpy(&count, page + 2, sizeof(count));
+    std::memcpy(&next, page + 4, sizeof(next));
+
+    keys.resize(count);
+    values.resize(count);
+    children.clear();
+
+    if(!is_leaf) {
+        children.resize(count + 1);
+        std::memcpy(&children[0], walker, sizeof(page_id));
+        walker += sizeof(page_id);
+    }
+
+    for(std::size_t i = 0; i < count; ++i) {
+        std::memcpy(&length, walker, sizeof(length));
+        walker += sizeof(length);
+        keys[i].assign(walker, length);
+        walker += length;
+        std::memcpy(&values[i], walker, sizeof(V));
+        walker += sizeof(V);
+
+        if(!is_leaf) {
+            std::memcpy(&children[i + 1], walker, sizeof(page_id));
+            walker += sizeof(page_id);
+        }
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Encodes node to a page.
+ *
+ * PRE-CONDITIONS:
+ *  char* page: zeroed page of PAGE_SIZE bytes; bytes() <= PAGE_SIZE
+ *
+ * POST-CONDITIONS:
+ *  node encoded
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PagedBPTree<V>::Node::write(char* page) const {
+    std::uint16_t count = keys.size(), length;
+    char* walker = page + HEADER_SIZE;
+
+    page[0] = is_leaf;
+    std::memcpy(page + 2, &count, sizeof(count));
+    std::memcpy(page + 4, &next, sizeof(next));
+
+    if(!is_leaf) {
+        std::memcpy(walker, &children[0], sizeof(page_id));
+        walker += sizeof(page_id);
+    }
+
+    for(std::size_t i = 0; i < count; ++i) {
+        length = keys[i].size();
+        std::memcpy(walker, &length, sizeof(length));
+        walker += sizeof(length);
+        std::memcpy(walker, keys[i].data(), length);
+        walker += length;
+        std::memcpy(walker, &values[i], sizeof(V));
+        walker += sizeof(V);
+
+        if(!is_leaf) {
+            std::memcpy(walker, &children[i + 1], sizeof(page_id));
+            walker += sizeof(page_id);
+        }
+    }
+}
+
+}  // namespace paged_bptree
+
+#endif  // PAGED_BPTREE_H
@@ -9,28 +9,60 @@
  *          In the MPair, the value list is a vector and the vectors are merged
  *          when adding the same key.
  *          Used in conjunction with Map/MMap respectively.
+ *          Key is a search probe that compares with Pair/MPair by key only,
+ *          so a Map/MMap can be searched with any type comparable to its
+ *          key (ie: const char* for std::string) without building a Pair.
+ *          Both are saved/loaded with write_binary()/read_binary(), as used
+ *          by the tree images.
  ******************************************************************************/
 #ifndef PAIR_H
 #define PAIR_H
 
 #include <cassert>         // assert()
+#include <utility>         // forward(), move(), piecewise_construct
+#include "binary_io.h"     // write_binary(), read_binary()
 #include "vector_utils.h"  // vector utilities
 
 namespace pair {
 
+template <typename KT>
+struct Key {
+    const KT& key;
+
+    // CONSTRUCTOR
+    explicit Key(const KT& k) : key(k) {}
+};
+
 template <typename K, typename V>
 struct Pair {
     K key;
     V value;
 
     // CONSTRUCTOR
-    Pair(const K& k = K(), const V& v = V()) : key(k), value(v) {}
+    Pair(const K& k = K()) : key(k), value() {}  // no copy of default V
+    Pair(const K& k, const V& v) : key(k), value(v) {}
+    Pair(const K& k, V&& v) : key(k), value(std::move(v)) {}
+    template <typename... Args>  // value constructed in place from args
+    Pair(std::piecewise_construct_t, const K& k, Args&&... args)
+        : key(k), value(std::forward<Args>(args)...) {}
 
     // FRIENDS
     friend std::ostream& operator<<(std::ostream& outs, const Pair<K, V>& p) {
         return outs << p.key << " : " << p.value;
     }
 
+    friend void write_binary(std::ostream& outs, const Pair<K, V>& p) {
+        using binary_io::write_binary;
+        write_binary(outs, p.key);
+        write_binary(outs, p.value);
+    }
+
+    friend void read_binary(std::istream& ins, Pair<K, V>& p) {
+        using binary_io::read_binary;
+        read_binary(ins, p.key);
+        read_binary(ins, p.value);
+    }
+
     friend bool operator==(const Pair<K, V>& lhs, const Pair<K, V>& rhs) {
         return lhs.key == rhs.key;
     }
@@ -43,6 +75,16 @@ struct Pair {
         return lhs.key < rhs.key;
     }
 
+    template <typename KT>
+    friend bool operator<(const Pair<K, V>& lhs, const Key<KT>& rhs) {
+        return lhs.key < rhs.key;
+    }
+
+    template <typename KT>
+    friend bool operator<(const Key<KT>& lhs, const Pair<K, V>& rhs) {
+        return lhs.key < rhs.key;
+    }
+
     friend bool operator<=(const Pair<K, V>& lhs, const Pair<K, V>& rhs) {
         return lhs.key <= rhs.key;
     }
@@ -65,6 +107,12 @@ struct Pair {
         lhs.value = rhs.value;  // on same key, lhs value is set to rhs value
         return lhs;
     }
+
+    friend Pair<K, V>& operator+=(Pair<K, V>& lhs, Pair<K, V>&& rhs) {
+        assert(lhs.key == rhs.key);
+        lhs.value = std::move(rhs.value);  // on same key, rhs value moved in
+        return lhs;
+    }
 };
 
 template <typename K, typename V>
@@ -77,14 +125,58 @@ struct MPair {
     MPair(const K& k = K()) : key(k), values(), value(values.begin()) {}
     MPair(const K& k, const V& v)
         : key(k), values({v}), value(values.begin()) {}
+    MPair(const K& k, V&& v) : key(k), values(), value(values.begin()) {
+        values.push_back(std::move(v));
+        value = values.begin();
+    }
     MPair(const K& k, const std::vector<V>& vlist)
         : key(k), values(vlist), value(values.begin()) {}
+    template <typename... Args>  // one value constructed in place from args
+    MPair(std::piecewise_construct_t, const K& k, Args&&... args)
+        : key(k), values(), value(values.begin()) {
+        values.emplace_back(std::forward<Args>(args)...);
+        value = values.begin();
+    }
+
+    // COPY: value keeps its offset in the copied values
+    MPair(const MPair<K, V>& other)
+        : key(other.key), values(other.values), value(values.begin()) {
+        value += other.offset();
+    }
+    MPair<K, V>& operator=(const MPair<K, V>& rhs) {
+        key = rhs.key;
+        values = rhs.values;
+        value = values.begin() + rhs.offset();
+        return *this;
+    }
+
+    // MOVE: value still points into the moved values
+    MPair(MPair<K, V>&& other) = default;
+    MPair<K, V>& operator=(MPair<K, V>&& rhs) = default;
+
+    std::size_t offset() const {  // value's index in values; at most size()
+        std::ptrdiff_t i = value - values.begin();
+        return i < 0 ? 0 : std::size_t(i) < values.size() ? i : values.size();
+    }
 
     // FRIENDS
     friend std::ostream& operator<<(std::ostream& outs, const MPair<K, V>& mp) {
         return outs << mp.key << " : " << mp.values;
     }
 
+    friend void write_binary(std::ostream& outs, const MPair<K, V>& mp) {
+        using binary_io::write_binary;
+        write_binary(outs, mp.key);
+        write_binary(outs, mp.values);
+    }
+
+    friend void read_binary(std::istream& ins, MPair<K, V>& mp) {
+        using binary_io::read_binary;
+        read_binary(ins, mp.key);
+        read_binary(ins, mp.values);
+        mp.value = mp.values.begin();
+    }
+
     friend bool operator==(const MPair<K, V>& lhs, const MPair<K, V>& rhs) {
         return lhs.key == rhs.key;
     }
@@ -97,6 +189,16 @@ struct MPair {
         return lhs.key < rhs.key;
     }
 
+    template <typename KT>
+    friend bool operator<(const MPair<K, V>& lhs, const Key<KT>& rhs) {
+        return lhs.key < rhs.key;
+    }
+
+    template <typename KT>
+    friend bool operator<(const Key<KT>& lhs, const MPair<K, V>& rhs) {
+        return lhs.key < rhs.key;
+    }
+
     friend bool operator<=(const MPair<K, V>& lhs, const MPair<K, V>& rhs) {
         return lhs.key <= rhs.key;
     }
@@ -120,6 +222,12 @@ struct MPair {
         lhs.values += rhs.values;  // on same key, lists are merged
         return lhs;
     }
+
+    friend MPair<K, V>& operator+=(MPair<K, V>& lhs, MPair<K, V>&& rhs) {
+        assert(lhs.key == rhs.key);
+        for(auto& v : rhs.values) lhs.values.push_back(std::move(v));
+        return lhs;
+    }
 };
 
 }  // namespace pair
@@ -0,0 +1,1359 @@
+/*******************************************************************************
+ * AUTHOR      : Thuan Tang
+ * ID          : 00991588
+ * CLASS       : CS008
+ * HEADER      : prefix_bptree
+ * DESCRIPTION : This header provides a templated B+Tree map of std::string
+ *      keys to values, the PrefixBPTree, for indexes of sorted strings with
+ *      long shared prefixes. It follows the BPTree rules, but its leaves are
+ *      compressed instead of holding a smart pointer per key.
+ *
+ *      LEAF:
+ *      The common prefix of all keys in a leaf is stored once. The rest of
+ *      each key, its suffix, is stored back to back in one buffer with the
+ *      end offset of each suffix, so a leaf search is a binary search over
+ *      one small block of memory.
+ *
+ *      prefix   | "comput"
+ *      suffixes | "eerersing"   -> compute, computer, computers, computing
+ *      ends     | 1 3 6 9
+ *
+ *      INNER:
+ *      Inner keys are the shortest strings that separate two leaves, not a
+ *      copy of a leaf key: entry at i is greater than all keys in child i
+ *      and less than or equal to all keys in child i + 1.
+ *
+ *      Iterators copy their key out of the leaf and are invalidated by
+ *      insert and erase.
+ ******************************************************************************/
+#ifndef PREFIX_BPTREE_H
+#define PREFIX_BPTREE_H
+
+#include <algorithm>  // min(), upper_bound()
+#include <cstdint>    // uint32_t
+#include <cstring>    // memcmp()
+#include <iterator>   // make_move_iterator()
+#include <stdexcept>  // invalid_argument, out_of_range
+#include <string>     // string
+#include <utility>    // move(), swap()
+#include <vector>     // vector
+
+namespace prefix_bptree {
+enum { MINIMUM = 16 };
+
+template <typename V>
+class PrefixBPTree {
+private:
+    struct Node;
+
+public:
+    struct Entry {
+        const std::string& key;  // copy of key in iterator
+        V& value;                // value in leaf
+    };
+
+    class Iterator {
+    public:
+        friend class PrefixBPTree;
+
+        struct Arrow {  // holds Entry for operator->
+            Entry entry;
+            const Entry* operator->() const { return &entry; }
+        };
+
+        // CONSTRUCTOR
+        Iterator(Node* leaf = nullptr, std::size_t index = 0)
+            : _leaf(leaf), _index(index), _key() {
+            load();
+        }
+
+        bool is_null() { return !_leaf; }
+        explicit operator bool() { return _leaf; }
+
+        Entry operator*() {
+            if(!_leaf)
+                throw std::invalid_argument(
+                    "PrefixBPTree::Iterator - nullptr check");
+
+            return Entry{_key, _leaf->values[_index]};
+        }
+
+        Arrow operator->() { return Arrow{**this}; }
+
+        Iterator& operator++() {  // pre-inc
+            if(_leaf) {
+                ++_index;
+                load();
+            }
+            return *this;
+        }
+
+        Iterator operator++(int _u) {  // post-inc
+            (void)_u;                  // suppress unused warning
+            Iterator it = *this;       // make temp
+            operator++();              // pre-inc
+            return it;                 // return previous state
+        }
+
+        // FRIENDS
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs._leaf == rhs._leaf && lhs._index == rhs._index;
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        Node* _leaf;
+        std::size_t _index;
+        std::string _key;  // key at _index, decompressed
+
+        void load();  // copy key; go to next leaf when past the last key
+    };
+
+    // CONSTRUCTOR
+    PrefixBPTree(std::size_t min = MINIMUM);
+
+    // BIG THREE
+    ~PrefixBPTree();
+    PrefixBPTree(const PrefixBPTree<V>& src);
+    PrefixBPTree<V>& operator=(const PrefixBPTree<V>& rhs);
+
+    // MOVE
+    PrefixBPTree(PrefixBPTree<V>&& src);
+    PrefixBPTree<V>& operator=(PrefixBPTree<V>&& rhs);
+
+    // capacity
+    std::size_t size() const;
+    bool empty() const;
+
+    // element access
+    V& operator[](const std::string& key);  // insert V() if key is new
+    V& at(const std::string& key);
+    const V& at(const std::string& key) const;
+    Iterator begin();
+    Iterator end();
+    Iterator find(const std::string& key);
+    Iterator lower_bound(const std::string& key);
+    Iterator upper_bound(const std::string& key);
+
+    // modifiers
+    bool insert(const std::string& key, const V& value);  // false if not new
+    bool erase(const std::string& key);
+    void clear();
+    void swap(PrefixBPTree<V>& other);
+
+    // operations
+    bool contains(const std::string& key) const;
+    bool verify() const;
+
+private:
+    struct Node {
+        bool is_leaf;
+        // leaf
+        std::string prefix;                // common prefix of all keys
+        std::string suffixes;              // key suffixes back to back
+        std::vector<std::uint32_t> ends;   // end of each suffix
+        std::vector<V> values;             // value of each key
+        Node* next;                        // next leaf
+        // inner
+        std::vector<std::string> keys;     // separators
+        std::vector<Node*> children;       // keys.size() + 1 children
+
+        Node(bool leaf) : is_leaf(leaf), next(nullptr) {}
+
+        std::size_t count() const {
+            return is_leaf ? values.size() : keys.size();
+        }
+    };
+
+    struct Position {  // key's place in a leaf
+        Node* leaf;
+        std::size_t index;
+    };
+
+    std::size_t _min;   // minimum entries
+    std::size_t _max;   // 2x min entries
+    std::size_t _size;  // count of all keys
+    Node* _root;
+
+    void deallocate(Node* node);
+    Node* copy(const Node* node, Node*& last_leaf);
+
+    // leaf functions
+    static std::string key_at(const Node* leaf, std::size_t i);
+    static std::size_t first_ge(const Node* leaf, const std::string& key,
+                                bool& is_found);
+    static void insert_key(Node* leaf, std::size_t i, const std::string& key,
+                           V&& value);
+    static void erase_key(Node* leaf, std::size_t i);
+    static void assign(Node* leaf, const std::vector<std::string>& keys,
+                       std::size_t first, std::size_t last);
+    static std::vector<std::string> decompress(const Node* leaf);
+    static std::string separator(const std::string& left,
+                                 const std::string& right);
+
+    // search
+    static std::size_t child_index(const Node* node, const std::string& key);
+    Position find_position(const std::string& key, bool& is_found) const;
+
+    // insert
+    Position insert(Node* node, const std::string& key, bool& is_new);
+    void fix_excess(Node* node, std::size_t i, Position& position);
+
+    // erase
+    bool erase(Node* node, const std::string& key);
+    void fix_shortage(Node* node, std::size_t i);
+    void merge(Node* node, std::size_t i);  // merge child i + 1 into i
+
+    bool verify(const Node* node, int level, int& height,
+                const std::string* low, const std::string* high) const;
+};
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Copies the key at _index. When _index is past the last key of the leaf,
+ *  moves to the next leaf. Points to nullptr after the last leaf.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  _key copied; _leaf is nullptr if no more keys
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PrefixBPTree<V>::Iterator::load() {
+    while(_leaf && _index >= _leaf->values.size()) {
+        _leaf = _leaf->next;
+        _index = 0;
+    }
+
+    if(_leaf) _key = key_at(_leaf, _index);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Constructor.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t min: minimum entries, at least 1
+ *
+ * POST-CONDITIONS:
+ *  empty root leaf
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+PrefixBPTree<V>::PrefixBPTree(std::size_t min)
+    : _min(min ? min : 1), _max(2 * _min), _size(0), _root(new Node(true)) {}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Destructor.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  all nodes deallocated
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+PrefixBPTree<V>::~PrefixBPTree() {
+    deallocate(_root);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Copy constructor.
+ *
+ * PRE-CONDITIONS:
+ *  const PrefixBPTree<V>& src: source
+ *
+ * POST-CONDITIONS:
+ *  deep copy of src
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+PrefixBPTree<V>::PrefixBPTree(const PrefixBPTree<V>& src)
+    : _min(src._min), _max(src._max), _size(src._size), _root(nullptr) {
+    Node* last_leaf = nullptr;
+    _root = copy(src._root, last_leaf);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Assignment operator.
+ *
+ * PRE-CONDITIONS:
+ *  const PrefixBPTree<V>& rhs: source
+ *
+ * POST-CONDITIONS:
+ *  deep copy of rhs
+ *
+ * RETURN:
+ *  self
+ ******************************************************************************/
+template <typename V>
+PrefixBPTree<V>& PrefixBPTree<V>::operator=(const PrefixBPTree<V>& rhs) {
+    if(this != &rhs) {
+        PrefixBPTree<V> temp(rhs);
+        swap(temp);
+    }
+
+    return *this;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Move constructor. Takes src's nodes; src is left empty.
+ *
+ * PRE-CONDITIONS:
+ *  PrefixBPTree<V>&& src: source
+ *
+ * POST-CONDITIONS:
+ *  src is empty
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+PrefixBPTree<V>::PrefixBPTree(PrefixBPTree<V>&& src)
+    : PrefixBPTree(src._min) {
+    swap(src);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Move assignment. Takes rhs's nodes; rhs is left empty.
+ *
+ * PRE-CONDITIONS:
+ *  PrefixBPTree<V>&& rhs: source
+ *
+ * POST-CONDITIONS:
+ *  rhs is empty
+ *
+ * RETURN:
+ *  self
+ ******************************************************************************/
+template <typename V>
+PrefixBPTree<V>& PrefixBPTree<V>::operator=(PrefixBPTree<V>&& rhs) {
+    if(this != &rhs) {
+        swap(rhs);
+        rhs.clear();
+    }
+
+    return *this;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns total keys in tree.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename V>
+std::size_t PrefixBPTree<V>::size() const {
+    return _size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if tree is empty.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename V>
+bool PrefixBPTree<V>::empty() const {
+    return _size == 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the value at key. A new key is inserted with V().
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: key
+ *
+ * POST-CONDITIONS:
+ *  key in tree
+ *
+ * RETURN:
+ *  V&
+ ******************************************************************************/
+template <typename V>
+V& PrefixBPTree<V>::operator[](const std::string& key) {
+    bool is_new = false;
+    Position position = insert(_root, key, is_new);
+
+    if(_root->count() > _max) {  // grow new root over old root
+        Node* root = new Node(false);
+        root->children.push_back(_root);
+        _root = root;
+        fix_excess(_root, 0, position);
+    }
+
+    return position.leaf->values[position.index];
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the value at key.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: key
+ *
+ * POST-CONDITIONS:
+ *  throws out_of_range if key is not found
+ *
+ * RETURN:
+ *  V&
+ ******************************************************************************/
+template <typename V>
+V& PrefixBPTree<V>::at(const std::string& key) {
+    bool is_found = false;
+    Position position = find_position(key, is_found);
+
+    if(!is_found) throw std::out_of_range("PrefixBPTree::at - key not found");
+
+    return position.leaf->values[position.index];
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the value at key.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: key
+ *
+ * POST-CONDITIONS:
+ *  throws out_of_range if key is not found
+ *
+ * RETURN:
+ *  const V&
+ ******************************************************************************/
+template <typename V>
+const V& PrefixBPTree<V>::at(const std::string& key) const {
+    bool is_found = false;
+    Position position = find_position(key, is_found);
+
+    if(!is_found) throw std::out_of_range("PrefixBPTree::at - key not found");
+
+    return position.leaf->values[position.index];
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the first key.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  PrefixBPTree<V>::Iterator
+ ******************************************************************************/
+template <typename V>
+typename PrefixBPTree<V>::Iterator PrefixBPTree<V>::begin() {
+    Node* node = _root;
+    while(!node->is_leaf) node = node->children.front();
+
+    return Iterator(node, 0);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator past the last key.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  PrefixBPTree<V>::Iterator
+ ******************************************************************************/
+template <typename V>
+typename PrefixBPTree<V>::Iterator PrefixBPTree<V>::end() {
+    return Iterator(nullptr);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to key; else end().
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: target key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  PrefixBPTree<V>::Iterator
+ ******************************************************************************/
+template <typename V>
+typename PrefixBPTree<V>::Iterator PrefixBPTree<V>::find(
+    const std::string& key) {
+    bool is_found = false;
+    Position position = find_position(key, is_found);
+
+    return is_found ? Iterator(position.leaf, position.index) : end();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the first key greater than or equal to key.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: target key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  PrefixBPTree<V>::Iterator
+ ******************************************************************************/
+template <typename V>
+typename PrefixBPTree<V>::Iterator PrefixBPTree<V>::lower_bound(
+    const std::string& key) {
+    bool is_found = false;
+    Position position = find_position(key, is_found);
+
+    return Iterator(position.leaf, position.index);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the first key greater than key.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: target key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  PrefixBPTree<V>::Iterator
+ ******************************************************************************/
+template <typename V>
+typename PrefixBPTree<V>::Iterator PrefixBPTree<V>::upper_bound(
+    const std::string& key) {
+    bool is_found = false;
+    Position position = find_position(key, is_found);
+
+    return Iterator(position.leaf, position.index + (is_found ? 1 : 0));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts value at key. An existing key's value is replaced.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: key
+ *  const V& value        : value
+ *
+ * POST-CONDITIONS:
+ *  value at key
+ *
+ * RETURN:
+ *  bool: true if key is new
+ ******************************************************************************/
+template <typename V>
+bool PrefixBPTree<V>::insert(const std::string& key, const V& value) {
+    std::size_t size = _size;
+
+    operator[](key) = value;
+
+    return _size != size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Removes key. Children short of minimum borrow from or merge with a
+ *  sibling; an empty root is replaced by its only child.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: key
+ *
+ * POST-CONDITIONS:
+ *  key removed if found
+ *
+ * RETURN:
+ *  bool: true if removed
+ ******************************************************************************/
+template <typename V>
+bool PrefixBPTree<V>::erase(const std::string& key) {
+    if(!erase(_root, key)) return false;
+
+    if(!_root->is_leaf && _root->keys.empty()) {  // shrink tree
+        Node* root = _root->children.front();
+        _root->children.clear();
+        delete _root;
+        _root = root;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Deallocates all nodes and resets to an empty root leaf.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  tree is empty
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PrefixBPTree<V>::clear() {
+    deallocate(_root);
+    _root = new Node(true);
+    _size = 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Swaps two trees without copying.
+ *
+ * PRE-CONDITIONS:
+ *  PrefixBPTree<V>& other: other tree
+ *
+ * POST-CONDITIONS:
+ *  trees swapped
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PrefixBPTree<V>::swap(PrefixBPTree<V>& other) {
+    std::swap(_min, other._min);
+    std::swap(_max, other._max);
+    std::swap(_size, other._size);
+    std::swap(_root, other._root);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if key is in tree.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: target key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename V>
+bool PrefixBPTree<V>::contains(const std::string& key) const {
+    bool is_found = false;
+    find_position(key, is_found);
+
+    return is_found;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if the tree's rules are valid: keys in order and within their
+ *  parent's keys, every leaf key has its leaf prefix, entries within
+ *  minimum and maximum, all leaves at the same level and leaves linked in
+ *  order.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename V>
+bool PrefixBPTree<V>::verify() const {
+    int height = -1;
+
+    if(!verify(_root, 0, height, nullptr, nullptr)) return false;
+
+    const Node* leaf = _root;
+    std::size_t count = 0;
+    std::string previous;
+
+    while(!leaf->is_leaf) leaf = leaf->children.front();
+
+    for(; leaf; leaf = leaf->next)  // walk leaf links
+        for(std::size_t i = 0; i < leaf->values.size(); ++i, ++count) {
+            std::string key = key_at(leaf, i);
+            if(count && !(previous < key)) return false;
+            previous = std::move(key);
+        }
+
+    return count == _size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Recursively deallocates a subtree.
+ *
+ * PRE-CONDITIONS:
+ *  Node* node: root of subtree
+ *
+ * POST-CONDITIONS:
+ *  nodes deallocated
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PrefixBPTree<V>::deallocate(Node* node) {
+    if(!node) return;
+
+    for(Node* child : node->children) deallocate(child);
+    delete node;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Recursively copies a subtree and relinks the copied leaves.
+ *
+ * PRE-CONDITIONS:
+ *  const Node* node: root of subtree
+ *  Node*& last_leaf: last copied leaf; nullptr if none
+ *
+ * POST-CONDITIONS:
+ *  Node*& last_leaf: last leaf in the copied subtree
+ *
+ * RETURN:
+ *  Node*: copied subtree
+ ******************************************************************************/
+template <typename V>
+typename PrefixBPTree<V>::Node* PrefixBPTree<V>::copy(const Node* node,
+                                                      Node*& last_leaf) {
+    Node* copied = new Node(*node);
+
+    copied->next = nullptr;
+    if(node->is_leaf) {
+        if(last_leaf) last_leaf->next = copied;
+        last_leaf = copied;
+    }
+
+    for(auto& child : copied->children) child = copy(child, last_leaf);
+
+    return copied;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the key at i of a leaf: the prefix and the suffix at i.
+ *
+ * PRE-CONDITIONS:
+ *  const Node* leaf: leaf
+ *  std::size_t i   : index of key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::string
+ ******************************************************************************/
+template <typename V>
+std::string PrefixBPTree<V>::key_at(const Node* leaf, std::size_t i) {
+    std::size_t begin = i ? leaf->ends[i - 1] : 0;
+    std::string key(leaf->prefix);
+
+    key.append(leaf->suffixes, begin, leaf->ends[i] - begin);
+
+    return key;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Binary searches a leaf for the first key greater than or equal to key.
+ *  key is compared with the prefix once, then only with the suffixes.
+ *
+ * PRE-CONDITIONS:
+ *  const Node* leaf      : leaf
+ *  const std::string& key: target key
+ *  bool& is_found        : any
+ *
+ * POST-CONDITIONS:
+ *  bool& is_found: true if key at index
+ *
+ * RETURN:
+ *  std::size_t: index
+ ******************************************************************************/
+template <typename V>
+std::size_t PrefixBPTree<V>::first_ge(const Node* leaf, const std::string& key,
+                                      bool& is_found) {
+    std::size_t count = leaf->values.size();
+    std::size_t length = leaf->prefix.size();
+    is_found = false;
+
+    if(!count) return 0;
+
+    int cmp = key.compare(0, length, leaf->prefix);
+    if(cmp < 0) return 0;       // key is below the prefix
+    if(cmp > 0) return count;  // key is above the prefix
+
+    const char* target = key.data() + length;
+    std::size_t target_size = key.size() - length;
+    const char* suffixes = leaf->suffixes.data();
+    std::size_t low = 0, high = count;
+
+    while(low < high) {
+        std::size_t mid = low + (high - low) / 2;
+        std::size_t begin = mid ? leaf->ends[mid - 1] : 0;
+        std::size_t size = leaf->ends[mid] - begin;
+        int c = std::memcmp(suffixes + begin, target,
+                            std::min(size, target_size));
+
+        if(!c) c = size < target_size ? -1 : size > target_size ? 1 : 0;
+
+        if(c < 0)
+            low = mid + 1;
+        else {
+            if(!c) is_found = true;
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts key and value at i of a leaf. A key with the prefix only adds its
+ *  suffix; else the leaf is rebuilt with a shorter prefix.
+ *
+ * PRE-CONDITIONS:
+ *  Node* leaf            : leaf
+ *  std::size_t i         : index of key in order
+ *  const std::string& key: new key
+ *  V&& value             : value
+ *
+ * POST-CONDITIONS:
+ *  key and value inserted
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PrefixBPTree<V>::insert_key(Node* leaf, std::size_t i,
+                                 const std::string& key, V&& value) {
+    leaf->values.insert(leaf->values.begin() + i, std::move(value));
+
+    if(leaf->values.size() > 1 &&
+       !key.compare(0, leaf->prefix.size(), leaf->prefix)) {
+        std::size_t begin = i ? leaf->ends[i - 1] : 0;
+        std::size_t size = key.size() - leaf->prefix.size();
+
+        leaf->suffixes.insert(begin, key, leaf->prefix.size(), size);
+        leaf->ends.insert(leaf->ends.begin() + i, begin);
+        for(std::size_t j = i; j < leaf->ends.size(); ++j)
+            leaf->ends[j] += size;
+    } else {  // rebuild with key
+        std::vector<std::string> keys = decompress(leaf);
+
+        keys.insert(keys.begin() + i, key);
+        assign(leaf, keys, 0, keys.size());
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Erases key and value at i of a leaf. The prefix stays valid.
+ *
+ * PRE-CONDITIONS:
+ *  Node* leaf   : leaf
+ *  std::size_t i: index of key
+ *
+ * POST-CONDITIONS:
+ *  key and value erased
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PrefixBPTree<V>::erase_key(Node* leaf, std::size_t i) {
+    std::size_t begin = i ? leaf->ends[i - 1] : 0;
+    std::size_t size = leaf->ends[i] - begin;
+
+    leaf->values.erase(leaf->values.begin() + i);
+    leaf->suffixes.erase(begin, size);
+    leaf->ends.erase(leaf->ends.begin() + i);
+    for(std::size_t j = i; j < leaf->ends.size(); ++j) leaf->ends[j] -= size;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Rebuilds a leaf's keys from keys [first, last). The prefix is the common
+ *  prefix of the first and last key, which sorted keys all share.
+ *
+ * PRE-CONDITIONS:
+ *  Node* leaf                           : leaf with last - first values
+ *  const std::vector<std::string>& keys : sorted keys
+ *  std::size_t first                    : first key
+ *  std::size_t last                     : past the last key
+ *
+ * POST-CONDITIONS:
+ *  prefix, suffixes and ends rebuilt
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PrefixBPTree<V>::assign(Node* leaf, const std::vector<std::string>& keys,
+                             std::size_t first, std::size_t last) {
+    std::size_t length = 0;
+
+    leaf->prefix.clear();
+    leaf->suffixes.clear();
+    leaf->ends.clear();
+    if(first == last) return;
+
+    const std::string& front = keys[first];
+    const std::string& back = keys[last - 1];
+    while(length < front.size() && length < back.size() &&
+          front[length] == back[length])
+        ++length;
+
+    leaf->prefix.assign(front, 0, length);
+    for(std::size_t i = first; i < last; ++i) {
+        leaf->suffixes.append(keys[i], length, std::string::npos);
+        leaf->ends.push_back(leaf->suffixes.size());
+    }
+    leaf->suffixes.shrink_to_fit();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns all keys of a leaf.
+ *
+ * PRE-CONDITIONS:
+ *  const Node* leaf: leaf
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::vector<std::string>
+ ******************************************************************************/
+template <typename V>
+std::vector<std::string> PrefixBPTree<V>::decompress(const Node* leaf) {
+    std::vector<std::string> keys;
+
+    keys.reserve(leaf->ends.size() + 1);
+    for(std::size_t i = 0; i < leaf->ends.size(); ++i)
+        keys.push_back(key_at(leaf, i));
+
+    return keys;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the shortest string greater than left and less than or equal to
+ *  right: the common prefix of both plus right's next character.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& left : last key of left leaf
+ *  const std::string& right: first key of right leaf; left < right
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::string
+ ******************************************************************************/
+template <typename V>
+std::string PrefixBPTree<V>::separator(const std::string& left,
+                                       const std::string& right) {
+    std::size_t length = 0;
+
+    while(length < left.size() && length < right.size() &&
+          left[length] == right[length])
+        ++length;
+
+    return right.substr(0, length + 1);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the child of an inner node to hold key: the number of keys less
+ *  than or equal to key.
+ *
+ * PRE-CONDITIONS:
+ *  const Node* node      : inner node
+ *  const std::string& key: target key
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: child index
+ ******************************************************************************/
+template <typename V>
+std::size_t PrefixBPTree<V>::child_index(const Node* node,
+                                         const std::string& key) {
+    return std::upper_bound(node->keys.begin(), node->keys.end(), key) -
+           node->keys.begin();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the leaf and index of the first key greater than or equal to
+ *  key.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& key: target key
+ *  bool& is_found        : any
+ *
+ * POST-CONDITIONS:
+ *  bool& is_found: true if key at position
+ *
+ * RETURN:
+ *  Position
+ ******************************************************************************/
+template <typename V>
+typename PrefixBPTree<V>::Position PrefixBPTree<V>::find_position(
+    const std::string& key, bool& is_found) const {
+    Node* node = _root;
+
+    while(!node->is_leaf) node = node->children[child_index(node, key)];
+
+    return Position{node, first_ge(node, key, is_found)};
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Recursively inserts key with V() into a subtree if key is new. A child
+ *  over maximum is split on the way back up.
+ *
+ * PRE-CONDITIONS:
+ *  Node* node            : root of subtree
+ *  const std::string& key: key
+ *  bool& is_new          : any
+ *
+ * POST-CONDITIONS:
+ *  bool& is_new: true if key was inserted; node may be over maximum
+ *
+ * RETURN:
+ *  Position: key's leaf and index
+ ******************************************************************************/
+template <typename V>
+typename PrefixBPTree<V>::Position PrefixBPTree<V>::insert(
+    Node* node, const std::string& key, bool& is_new) {
+    if(node->is_leaf) {
+        bool is_found = false;
+        std::size_t i = first_ge(node, key, is_found);
+
+        if(!is_found) {
+            insert_key(node, i, key, V());
+            ++_size;
+            is_new = true;
+        }
+
+        return Position{node, i};
+    }
+
+    std::size_t i = child_index(node, key);
+    Position position = insert(node->children[i], key, is_new);
+
+    if(node->children[i]->count() > _max) fix_excess(node, i, position);
+
+    return position;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Splits child i, which is over maximum, and adds the new right sibling
+ *  and its separator to node. A leaf split keeps the shortest separator; an
+ *  inner split moves its middle key up.
+ *
+ * PRE-CONDITIONS:
+ *  Node* node         : inner node
+ *  std::size_t i      : child over maximum
+ *  Position& position : a key's position
+ *
+ * POST-CONDITIONS:
+ *  Position& position: moved to right sibling if its key moved
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PrefixBPTree<V>::fix_excess(Node* node, std::size_t i,
+                                 Position& position) {
+    Node* child = node->children[i];
+    Node* right = new Node(child->is_leaf);
+    std::string key;
+
+    if(child->is_leaf) {
+        std::vector<std::string> keys = decompress(child);
+
+        right->values.assign(std::make_move_iterator(child->values.begin() +
+                                                     _min),
+                             std::make_move_iterator(child->values.end()));
+        child->values.resize(_min);
+        assign(child, keys, 0, _min);
+        assign(right, keys, _min, keys.size());
+        key = separator(keys[_min - 1], keys[_min]);
+
+        right->next = child->next;
+        child->next = right;
+
+        if(position.leaf == child && position.index >= _min) {
+            position.leaf = right;
+            position.index -= _min;
+        }
+    } else {
+        key = std::move(child->keys[_min]);
+        right->keys.assign(std::make_move_iterator(child->keys.begin() + _min +
+                                                   1),
+                           std::make_move_iterator(child->keys.end()));
+        right->children.assign(child->children.begin() + _min + 1,
+                               child->children.end());
+        child->keys.resize(_min);
+        child->children.resize(_min + 1);
+    }
+
+    node->keys.insert(node->keys.begin() + i, std::move(key));
+    node->children.insert(node->children.begin() + i + 1, right);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Recursively erases key from a subtree. A child short of minimum is fixed
+ *  on the way back up.
+ *
+ * PRE-CONDITIONS:
+ *  Node* node            : root of subtree
+ *  const std::string& key: key
+ *
+ * POST-CONDITIONS:
+ *  key erased if found; node may be short of minimum
+ *
+ * RETURN:
+ *  bool: true if erased
+ ******************************************************************************/
+template <typename V>
+bool PrefixBPTree<V>::erase(Node* node, const std::string& key) {
+    if(node->is_leaf) {
+        bool is_found = false;
+        std::size_t i = first_ge(node, key, is_found);
+
+        if(!is_found) return false;
+
+        erase_key(node, i);
+        --_size;
+
+        return true;
+    }
+
+    std::size_t i = child_index(node, key);
+    if(!erase(node->children[i], key)) return false;
+
+    if(node->children[i]->count() < _min) fix_shortage(node, i);
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Fixes child i, short of minimum, by borrowing from a sibling over
+ *  minimum; else by merging with a sibling.
+ *
+ * PRE-CONDITIONS:
+ *  Node* node   : inner node
+ *  std::size_t i: child short of minimum
+ *
+ * POST-CONDITIONS:
+ *  children of node within minimum; node may be short of minimum
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PrefixBPTree<V>::fix_shortage(Node* node, std::size_t i) {
+    Node* child = node->children[i];
+    Node* left = i ? node->children[i - 1] : nullptr;
+    Node* right =
+        i + 1 < node->children.size() ? node->children[i + 1] : nullptr;
+
+    if(left && left->count() > _min) {  // rotate left's last into child
+        if(child->is_leaf) {
+            std::size_t last = left->values.size() - 1;
+
+            insert_key(child, 0, key_at(left, last),
+                       std::move(left->values[last]));
+            erase_key(left, last);
+            node->keys[i - 1] =
+                separator(key_at(left, last - 1), key_at(child, 0));
+        } else {
+            child->keys.insert(child->keys.begin(),
+                               std::move(node->keys[i - 1]));
+            child->children.insert(child->children.begin(),
+                                   left->children.back());
+            node->keys[i - 1] = std::move(left->keys.back());
+            left->keys.pop_back();
+            left->children.pop_back();
+        }
+    } else if(right && right->count() > _min) {  // rotate right's first
+        if(child->is_leaf) {
+            std::size_t last = child->values.size();
+
+            insert_key(child, last, key_at(right, 0),
+                       std::move(right->values[0]));
+            erase_key(right, 0);
+            node->keys[i] = separator(key_at(child, last), key_at(right, 0));
+        } else {
+            child->keys.push_back(std::move(node->keys[i]));
+            child->children.push_back(right->children.front());
+            node->keys[i] = std::move(right->keys.front());
+            right->keys.erase(right->keys.begin());
+            right->children.erase(right->children.begin());
+        }
+    } else if(left)
+        merge(node, i - 1);
+    else if(right)
+        merge(node, i);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Merges child i + 1 into child i and removes their separator from node.
+ *
+ * PRE-CONDITIONS:
+ *  Node* node   : inner node
+ *  std::size_t i: left child of merge
+ *
+ * POST-CONDITIONS:
+ *  child i + 1 deallocated
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename V>
+void PrefixBPTree<V>::merge(Node* node, std::size_t i) {
+    Node* left = node->children[i];
+    Node* right = node->children[i + 1];
+
+    if(left->is_leaf) {
+        std::vector<std::string> keys = decompress(left);
+        std::vector<std::string> right_keys = decompress(right);
+
+        keys.insert(keys.end(), std::make_move_iterator(right_keys.begin()),
+                    std::make_move_iterator(right_keys.end()));
+        left->values.insert(left->values.end(),
+                            std::make_move_iterator(right->values.begin()),
+                            std::make_move_iterator(right->values.end()));
+        assign(left, keys, 0, keys.size());
+        left->next = right->next;
+    } else {
+        left->keys.push_back(std::move(node->keys[i]));
+        left->keys.insert(left->keys.end(),
+                          std::make_move_iterator(right->keys.begin()),
+                          std::make_move_iterator(right->keys.end()));
+        left->children.insert(left->children.end(), right->children.begin(),
+                              right->children.end());
+        right->children.clear();
+    }
+
+    node->keys.erase(node->keys.begin() + i);
+    node->children.erase(node->children.begin() + i + 1);
+    delete right;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Recursively checks a subtree: keys in order and within [low, high), leaf
+ *  keys share the leaf prefix, entries within minimum (except root) and
+ *  maximum, inner nodes with one more child than keys and all leaves at the
+ *  same height.
+ *
+ * PRE-CONDITIONS:
+ *  const Node* node       : root of subtree
+ *  int level              : depth of subtree
+ *  int& height            : -1 until first leaf found
+ *  const std::string* low : lower bound of keys; nullptr if none
+ *  const std::string* high: upper bound of keys; nullptr if none
+ *
+ * POST-CONDITIONS:
+ *  int& height: leaf level
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename V>
+bool PrefixBPTree<V>::verify(const Node* node, int level, int& height,
+                             const std::string* low,
+                             const std::string* high) const {
+    if(node->count() > _max || (node != _root && node->count() < _min))
+        return false;
+
+    std::vector<std::string> keys =
+        node->is_leaf ? decompress(node) : node->keys;
+
+    if(node->is_leaf && (node->ends.size() != node->values.size() ||
+                         (!keys.empty() && node->ends.back() !=
+                                               node->suffixes.size())))
+        return false;
+
+    for(std::size_t i = 0; i < keys.size(); ++i) {
+        if(i && !(keys[i - 1] < keys[i])) return false;
+        if(low && keys[i] < *low) return false;
+        if(high && !(keys[i] < *high)) return false;
+    }
+
+    if(node->is_leaf) {
+        if(height < 0) height = level;
+        return height == level;
+    }
+
+    if(node->children.size() != node->keys.size() + 1) return false;
+
+    for(std::size_t i = 0; i < node->children.size(); ++i) {
+        const std::string* child_low = i ? &node->keys[i - 1] : low;
+        const std::string* child_high =
+            i < node->keys.size() ? &node->keys[i] : high;
+
+        if(!verify(node->children[i], level + 1, height, child_low,
+                   child_high))
+            return false;
+    }
+
+    return true;
+}
+
+}  // namespace prefix_bptree
+
+#endif  // PREFIX_BPTREE_H
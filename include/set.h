@@ -5,7 +5,8 @@
  * HEADER      : bpt_set
  * DESCRIPTION : This header provides a templated Set based on the B+Tree data
  *          structure. The templated item can not be modified but can be
- *          removed.
+ *          removed. Copies share the tree's nodes, so a copy or snapshot()
+ *          is O(1), and a write copies only its root-to-leaf path.
  ******************************************************************************/
 #ifndef SET_H
 #define SET_H
@@ -63,6 +64,8 @@ public:
     Set(std::size_t min = bptree::MINIMUM) : _set(false, min) {}
     Set(const std::initializer_list<T>& l, std::size_t min = bptree::MINIMUM);
 
+    Set<T> snapshot() const;  // O(1) copy; shares tree until a write
+
     // capacity
     std::size_t size() const;
     bool empty() const;
@@ -78,10 +81,21 @@ public:
 
     // modifiers
     bool insert(const T& item);
+    bool insert(T&& item);
+    template <typename... Args>
+    bool emplace(Args&&... args);  // insert T constructed from args
     bool erase(const T& item);
+    std::size_t erase_range(const T& low, const T& high);  // erase [low, high)
+    template <typename Pred>
+    std::size_t erase_if(Pred pred);  // erase items where pred(item)
     void intersect(const Set<T>& rhs, Set<T>& result) const;
     void clear();
 
+    // order statistics
+    std::size_t rank(const T& item) const;  // count of items < item
+    Iterator select(std::size_t k) const;   // k-th item from 0; else end()
+    std::size_t count_range(const T& low, const T& high) const;  // [low, high)
+
     // operations
     bool contains(const T& item) const;
     std::size_t count(const T& item) const;
@@ -89,7 +103,7 @@ public:
     bool verify() const;
 
     friend std::ostream& operator<<(std::ostream& outs, const Set<T>& set) {
-        return outs << set._set;
+        return outs << *set._set;
     }
 
     friend Set<T>& operator+=(Set<T>& lhs, const Set<T>& rhs) {
@@ -141,7 +155,7 @@ public:
     }
 
 private:
-    SetBase _set;
+    bptree::CowBPTree<T> _set;  // shared with copies until written
 };
 
 // ----- SET IMPLEMENTATIONS -----
@@ -162,7 +176,28 @@ private:
 template <typename T>
 Set<T>::Set(const std::initializer_list<T>& l, std::size_t min)
     : _set(false, min) {
-    for(const auto& a : l) _set.insert(a);
+    for(const auto& a : l) _set.write().insert(a);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns a snapshot of 'this' in O(1). The snapshot shares the tree's
+ *  nodes, and a write on either side copies only the nodes on its path.
+ *  References taken from 'this' before the snapshot may still point into
+ *  shared nodes, so take them again before writing through them.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Set<T>
+ ******************************************************************************/
+template <typename T>
+Set<T> Set<T>::snapshot() const {
+    return *this;
 }
 
 /*******************************************************************************
@@ -180,7 +215,7 @@ Set<T>::Set(const std::initializer_list<T>& l, std::size_t min)
  ******************************************************************************/
 template <typename T>
 std::size_t Set<T>::size() const {
-    return _set.size();
+    return _set->size();
 }
 
 /*******************************************************************************
@@ -198,7 +233,7 @@ std::size_t Set<T>::size() const {
  ******************************************************************************/
 template <typename T>
 bool Set<T>::empty() const {
-    return _set.empty();
+    return _set->empty();
 }
 
 /*******************************************************************************
@@ -216,7 +251,7 @@ bool Set<T>::empty() const {
  ******************************************************************************/
 template <typename T>
 typename Set<T>::Iterator Set<T>::begin() const {
-    return Set<T>::Iterator(_set.begin());
+    return Set<T>::Iterator(_set->begin());
 }
 
 /*******************************************************************************
@@ -234,7 +269,7 @@ typename Set<T>::Iterator Set<T>::begin() const {
  ******************************************************************************/
 template <typename T>
 typename Set<T>::Iterator Set<T>::end() const {
-    return Set<T>::Iterator(_set.end());
+    return Set<T>::Iterator(_set->end());
 }
 
 /*******************************************************************************
@@ -252,7 +287,7 @@ typename Set<T>::Iterator Set<T>::end() const {
  ******************************************************************************/
 template <typename T>
 typename Set<T>::Iterator Set<T>::find(const T& item) const {
-    return Set<T>::Iterator(_set.find(item));
+    return Set<T>::Iterator(_set->find(item));
 }
 
 /*******************************************************************************
@@ -270,7 +305,7 @@ typename Set<T>::Iterator Set<T>::find(const T& item) const {
  ******************************************************************************/
 template <typename T>
 const T& Set<T>::front() const {
-    return _set.front();
+    return _set->front();
 }
 
 /*******************************************************************************
@@ -288,7 +323,7 @@ const T& Set<T>::front() const {
  ******************************************************************************/
 template <typename T>
 const T& Set<T>::back() const {
-    return _set.back();
+    return _set->back();
 }
 
 /*******************************************************************************
@@ -306,7 +341,7 @@ const T& Set<T>::back() const {
  ******************************************************************************/
 template <typename T>
 const T& Set<T>::operator[](const T& item) {
-    return _set.get(item);
+    return _set.write().get(item);
 }
 
 /*******************************************************************************
@@ -324,7 +359,7 @@ const T& Set<T>::operator[](const T& item) {
  ******************************************************************************/
 template <typename T>
 const T& Set<T>::at(const T& item) {
-    return _set.get(item);
+    return _set.write().get(item);
 }
 
 /*******************************************************************************
@@ -342,7 +377,44 @@ const T& Set<T>::at(const T& item) {
  ******************************************************************************/
 template <typename T>
 bool Set<T>::insert(const T& item) {
-    return _set.insert(item);
+    return _set.write().insert(item);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts T into set by moving it.
+ *
+ * PRE-CONDITIONS:
+ *  T&& item: templated item
+ *
+ * POST-CONDITIONS:
+ *  item moved from
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+bool Set<T>::insert(T&& item) {
+    return _set.write().insert(std::move(item));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts T constructed from args into set.
+ *
+ * PRE-CONDITIONS:
+ *  Args&&... args: arguments for T's constructor
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+template <typename T>
+template <typename... Args>
+bool Set<T>::emplace(Args&&... args) {
+    return _set.write().emplace(std::forward<Args>(args)...);
 }
 
 /*******************************************************************************
@@ -360,7 +432,45 @@ bool Set<T>::insert(const T& item) {
  ******************************************************************************/
 template <typename T>
 bool Set<T>::erase(const T& item) {
-    return _set.remove(item);
+    return _set.write().remove(item);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Erase all items in the range [low, high).
+ *
+ * PRE-CONDITIONS:
+ *  const T& low : inclusive lower bound
+ *  const T& high: exclusive upper bound
+ *
+ * POST-CONDITIONS:
+ *  items in range removed
+ *
+ * RETURN:
+ *  std::size_t: count of erased items
+ ******************************************************************************/
+template <typename T>
+std::size_t Set<T>::erase_range(const T& low, const T& high) {
+    return _set.write().erase_range(low, high);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Erase all items where pred(item) is true.
+ *
+ * PRE-CONDITIONS:
+ *  Pred pred: callable as bool pred(const T&)
+ *
+ * POST-CONDITIONS:
+ *  items satisfying pred removed
+ *
+ * RETURN:
+ *  std::size_t: count of erased items
+ ******************************************************************************/
+template <typename T>
+template <typename Pred>
+std::size_t Set<T>::erase_if(Pred pred) {
+    return _set.write().erase_if(pred);
 }
 
 /*******************************************************************************
@@ -416,7 +526,7 @@ void Set<T>::clear() {
  ******************************************************************************/
 template <typename T>
 bool Set<T>::contains(const T& item) const {
-    return _set.contains(item);
+    return _set->contains(item);
 }
 
 /*******************************************************************************
@@ -434,7 +544,62 @@ bool Set<T>::contains(const T& item) const {
  ******************************************************************************/
 template <typename T>
 std::size_t Set<T>::count(const T& item) const {
-    return _set.find(MPair(item)) ? 1 : 0;
+    return _set->contains(item) ? 1 : 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the count of items less than item.
+ *
+ * PRE-CONDITIONS:
+ *  const T& item: item to rank
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename T>
+std::size_t Set<T>::rank(const T& item) const {
+    return _set->rank(item);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the k-th smallest item, counting from 0.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t k: index of item in sorted order
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Set<T>::Iterator: end() when k is out of range
+ ******************************************************************************/
+template <typename T>
+typename Set<T>::Iterator Set<T>::select(std::size_t k) const {
+    return Set<T>::Iterator(_set->select(k));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the count of items in the range [low, high).
+ *
+ * PRE-CONDITIONS:
+ *  const T& low : inclusive lower bound
+ *  const T& high: exclusive upper bound
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+template <typename T>
+std::size_t Set<T>::count_range(const T& low, const T& high) const {
+    return _set->count_range(low, high);
 }
 
 /*******************************************************************************
@@ -452,7 +617,7 @@ std::size_t Set<T>::count(const T& item) const {
  ******************************************************************************/
 template <typename T>
 void Set<T>::print_debug() const {
-    _set.print(std::cout, true);
+    _set->print(std::cout, true);
 }
 
 /*******************************************************************************
@@ -470,7 +635,7 @@ void Set<T>::print_debug() const {
  ******************************************************************************/
 template <typename T>
 bool Set<T>::verify() const {
-    return _set.verify();
+    return _set->verify();
 }
 
 }  // namespace set
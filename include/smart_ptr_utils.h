@@ -44,11 +44,17 @@ std::size_t first_ge(const T* data, std::size_t size, const U& entry);
 template <typename T>
 void attach_item(T* data, std::size_t& size, const T& entry);
 
+template <typename T>
+void attach_item(T* data, std::size_t& size, T&& entry);
+
 // insert entry at index i in data
 // pro: ensure data actual size is size+1 to shift right
 template <typename T>
 void insert_item(T* data, std::size_t i, std::size_t& size, const T& entry);
 
+template <typename T>
+void insert_item(T* data, std::size_t i, std::size_t& size, T&& entry);
+
 // remove the last element in data and place it in entry
 template <typename T>
 void detach_item(T* data, std::size_t& size, T& entry);
@@ -238,6 +244,8 @@ std::size_t first_ge(const T* data, std::size_t size, const T& entry) {
 /*******************************************************************************
  * DESCRIPTION:
  *  Find the index of the first value that's greater than or equal to entry.
+ *  Stops at the first such value: every step dereferences a pointer, so
+ *  comparing the rest costs more than the branch it saves.
  *
  * PRE-CONDITIONS:
  *  const T* data   : array of smart pointers
@@ -279,6 +287,27 @@ void attach_item(T* data, std::size_t& size, const T& entry) {
     data[size++] = entry;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Moves entry to the end of the array.
+ *
+ * PRE-CONDITIONS:
+ *  T* data           : array of smart pointers
+ *  std::size_t & size: size + 1 MUST be valid for shifting values to right
+ *  T&& entry         : entry item to be moved in
+ *
+ * POST-CONDITIONS:
+ *  std::size_t size: increases by 1
+ *  T entry         : moved into array
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void attach_item(T* data, std::size_t& size, T&& entry) {
+    data[size++] = std::move(entry);
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Inserts entry at position i into array.
@@ -309,6 +338,36 @@ void insert_item(T* data, std::size_t i, std::size_t& size, const T& entry) {
     ++size;  // return new size to caller
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Moves entry to position i of array.
+ *
+ * PRE-CONDITIONS:
+ *  T* data          : array of smart pointers
+ *  std::size_t i    : position to insert
+ *  std::size_t& size: size + 1 MUST be valid for shifting values to right
+ *  T&& entry        : entry item to be moved in
+ *
+ * POST-CONDITIONS:
+ *  std::size_t size: increases by 1
+ *  T entry         : moved into array
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+template <typename T>
+void insert_item(T* data, std::size_t i, std::size_t& size, T&& entry) {
+    std::size_t walker = size;
+
+    while(walker != i) {
+        data[walker] = std::move(data[walker - 1]);  // shift right
+        --walker;                                    // walker backwards
+    }
+    data[walker] = std::move(entry);
+
+    ++size;  // return new size to caller
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Removes the last item in the array.
@@ -7,12 +7,17 @@
  * DESCRIPTION : This header defines the SQL class. The SQL class stores data
  *          in table files (.tbl) and load them into memory, which are sorted
  *          Maps. From there, various SQL commands can process such data.
+ *          Tables of a restored session are only registered by name; each
+ *          table file is opened and indexed on its first access.
  *
  *          SUPPORTED COMMANDS:
- *          - CREATE: create a table
+ *          - CREATE: create a table; CREATE COLUMNAR TABLE stores each
+ *                    field in its own column file
  *          - INSERT: insert values into table
  *          - SELECT: select data from table with WHERE conditions to display
- *                    specific fields
+ *                    specific fields or aggregates (COUNT, SUM, MIN, MAX,
+ *                    AVG) with optional GROUP BY; two tables can be
+ *                    joined with JOIN table [AS alias] ON field = field
  ******************************************************************************/
 #ifndef SQL_H
 #define SQL_H
@@ -38,7 +43,9 @@ enum SQL_QUERY_CODE
     NOT_EXIST_TABLE = 3,
     WRONG_FIELD_SIZE = 4,
     FIELDS_OVERLIMIT = 5,
-    WRONG_FIELDS_NAME = 6
+    WRONG_FIELDS_NAME = 6,
+    WRONG_AGGREGATE = 7,
+    WRONG_JOIN = 8
 };
 
 class SQL
@@ -78,10 +85,17 @@ class SQL
     int create_table(const std::string &table_name, bool table_found);
     int insert_table(const std::string &table_name, bool table_found);
     int select_table(const std::string &table_name, bool table_found);
+    int select_join(const std::string &table_name);
+    void select_rows(SQLTable &table, const std::string &title);
 
     // pre-condition: table exists
+    SQLTable &open_table(const std::string &table_name);
     bool insert_values_match_fields_size(const std::string &table_name);
-    int is_valid_fields(const std::string &table_name);
+    int is_valid_fields(SQLTable &table);
+    int is_valid_aggregate(SQLTable &table);
+    bool is_aggregate_query();
+    bool qualify_field(const SQLTable &joined, std::string &field);
+    int qualify_fields(const SQLTable &joined);
 };
 
 } // namespace sql
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * AUTHOR      : Thuan Tang
+ * ID          : 00991588
+ * CLASS       : CS008
+ * HEADER      : sql_columns
+ * NAMESPACE   : sql
+ * DESCRIPTION : This header provides a SQL Columns class. It reads/writes
+ *      record data at a given position like SQLRecord, but stores each field
+ *      in its own column file. Each value is dictionary encoded to a fixed
+ *      width code, so a value is found by position without reading the
+ *      other columns. A read can ask for only the columns it needs.
+ *
+ *      Each column file is kept open from open() until close() or the
+ *      destructor, and reads and writes seek within it. A read of the
+ *      record after the last one read does not seek.
+ *
+ *      Record positions start at 1; position 0 (field names) is kept by the
+ *      table's SQLRecord.
+ *
+ *      FILES FOR COLUMN i:
+ *      name_i.col  | code of record 1 | code of record 2 | ...
+ *      name_i.dict | SQLDictionary file of column's distinct values
+ ******************************************************************************/
+#ifndef SQL_COLUMNS_H
+#define SQL_COLUMNS_H
+
+#include <cassert>           // assert()
+#include <cstdio>            // remove()
+#include <fstream>           // file streams
+#include <string>            // string
+#include <vector>            // vector
+#include "sql_dictionary.h"  // SQLDictionary class
+
+namespace sql {
+
+class SQLColumns {
+public:
+    typedef SQLDictionary::code_type code_type;
+
+    SQLColumns(const std::string& name = "", std::size_t count = 0);
+
+    ~SQLColumns();
+    SQLColumns(const SQLColumns& src);
+    SQLColumns& operator=(const SQLColumns& rhs);
+    SQLColumns(SQLColumns&& src) = default;
+    SQLColumns& operator=(SQLColumns&& rhs) = default;
+
+    bool exists() const;   // true if column files exist
+    bool is_open() const;  // true if column files are open
+    void open();           // open column files for reading and writing
+    void close();          // close column files
+    void create();         // create empty column files
+    void remove();         // remove column files
+
+    std::streamsize read(std::vector<std::string>& v, long rpos);
+    std::streamsize read(std::vector<std::string>& v, long rpos,
+                         const std::vector<int>& columns);
+    long write(const std::vector<std::string>& v, long rpos);
+
+private:
+    std::string _name;                  // table name
+    std::vector<SQLDictionary> _dicts;  // dictionary per column
+    std::vector<std::fstream> _files;   // open column files; empty if closed
+    std::vector<long> _next;            // record each file is at; 0: seek
+
+    std::string column_fname(std::size_t column) const;
+    std::string dict_fname(std::size_t column) const;
+};
+
+}  // namespace sql
+
+#endif  // SQL_COLUMNS_H
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * AUTHOR      : Thuan Tang
+ * ID          : 00991588
+ * CLASS       : CS008
+ * HEADER      : sql_dictionary
+ * NAMESPACE   : sql
+ * DESCRIPTION : This header provides a SQL Dictionary class. It encodes
+ *      strings to fixed-width integer codes and decodes codes back to
+ *      strings. Codes are given in order of first encoding, starting at 0.
+ *      With a file name, new strings are appended to the dictionary file and
+ *      the file is loaded when the file name is set.
+ *
+ *      Each string is stored once, in code order, and keeps its address
+ *      while the dictionary grows or is moved. Lookup by string uses an
+ *      open addressing hash table of codes (linear probing), which is
+ *      doubled when it is more than half full.
+ *
+ *      BINARY STRUCTURE OF DICTIONARY FILE:
+ *      size of string 0 | string 0 characters
+ *      size of string 1 | string 1 characters
+ *       .
+ *       .
+ ******************************************************************************/
+#ifndef SQL_DICTIONARY_H
+#define SQL_DICTIONARY_H
+
+#include <cassert>     // assert()
+#include <cstdint>     // uint32_t
+#include <deque>       // deque
+#include <fstream>     // file streams
+#include <functional>  // hash
+#include <string>      // string
+#include <utility>     // move()
+#include <vector>      // vector
+
+namespace sql {
+
+class SQLDictionary {
+public:
+    typedef std::uint32_t code_type;
+
+    SQLDictionary(const std::string& fname = "");
+
+    void set_fname(const std::string& fname);  // set file name and load
+
+    std::size_t size() const;
+    bool find(const std::string& value, code_type& code) const;
+    const std::string& decode(code_type code) const;
+    code_type encode(const std::string& value);  // add value if new
+    code_type encode(std::string&& value);       // move value in if new
+
+    void clear();
+
+private:
+    enum { MIN_SLOTS = 16 };
+    static const code_type EMPTY_SLOT = static_cast<code_type>(-1);
+
+    std::vector<code_type> _slots;    // hash table of codes
+    std::deque<std::string> _values;  // code to value; stable addresses
+    std::string _fname;
+
+    std::size_t find_slot(const std::string& value) const;
+    code_type append(std::string&& value);  // add new value to file
+    void add(std::string&& value);
+    void rehash(std::size_t slots);
+    void load();
+};
+
+}  // namespace sql
+
+#endif  // SQL_DICTIONARY_H
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * AUTHOR      : Thuan Tang
+ * ID          : 00991588
+ * CLASS       : CS008
+ * HEADER      : sql_index
+ * NAMESPACE   : sql
+ * DESCRIPTION : This header provides a SQL Index class, the IndexMap of a
+ *      field. It maps each distinct value of a field to the set of record
+ *      positions with that value.
+ *
+ *      Values are dictionary encoded: each distinct value is stored once in
+ *      a SQLDictionary and the posting sets are kept in a vector by code, so
+ *      contains() and operator[] are a hash lookup and a code index. For
+ *      range lookups and ordered iteration, a BPTree keeps the codes in
+ *      order of value; a new value is inserted in O(log n) and the tree
+ *      points at the dictionary's copy of the value rather than storing it
+ *      again. find() answers a missing value from the dictionary alone and
+ *      positions its iterator with one tree search otherwise.
+ *
+ *      Iterator returns Entry, with key/value references like Map's Pair.
+ ******************************************************************************/
+#ifndef SQL_INDEX_H
+#define SQL_INDEX_H
+
+#include <string>            // string
+#include <vector>            // vector
+#include "bptree.h"          // BPTree class
+#include "set.h"             // Set class
+#include "sql_dictionary.h"  // SQLDictionary class
+
+namespace sql {
+
+class SQLIndex {
+public:
+    typedef SQLDictionary::code_type code_type;
+
+    struct Entry {
+        const std::string& key;  // field value
+        set::Set<long>& value;   // record positions
+    };
+
+    // code ordered by the dictionary's value it points at
+    struct Key {
+        const std::string* value;  // value in _dict
+        code_type code;
+
+        friend bool operator<(const Key& lhs, const Key& rhs) {
+            return *lhs.value < *rhs.value;
+        }
+        friend bool operator<(const Key& lhs, const std::string& rhs) {
+            return *lhs.value < rhs;
+        }
+        friend bool operator<(const std::string& lhs, const Key& rhs) {
+            return lhs < *rhs.value;
+        }
+        friend Key& operator+=(Key& lhs, const Key& rhs) {  // same value
+            lhs = rhs;
+            return lhs;
+        }
+    };
+
+    typedef bptree::BPTree<Key> Order;
+    class Iterator {
+    public:
+        friend class SQLIndex;
+
+        struct Arrow {  // holds Entry for operator->
+            Entry entry;
+            const Entry* operator->() const { return &entry; }
+        };
+
+        Iterator(SQLIndex* index = nullptr,
+                 Order::Iterator it = Order::Iterator())
+            : _index(index), _it(it) {}
+
+        Entry operator*() const {
+            Order::Iterator it = _it;
+            return Entry{*it->value, _index->_postings[it->code]};
+        }
+
+        Arrow operator->() const { return Arrow{**this}; }
+
+        Iterator& operator++() {  // pre-inc
+            ++_it;
+            return *this;
+        }
+
+        Iterator operator++(int _u) {  // post-inc
+            (void)_u;
+            Iterator it = *this;
+            ++_it;
+            return it;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs._index == rhs._index && lhs._it == rhs._it;
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        SQLIndex* _index;     // index to iterate
+        Order::Iterator _it;  // position in ordered codes
+    };
+
+    SQLIndex() {}
+
+    // BIG THREE; _order points into _dict, so copies rebuild it
+    SQLIndex(const SQLIndex& src);
+    SQLIndex& operator=(const SQLIndex& rhs);
+
+    // MOVE; moved values keep their addresses
+    SQLIndex(SQLIndex&& src) = default;
+    SQLIndex& operator=(SQLIndex&& rhs) = default;
+
+    // capacity
+    std::size_t size() const;
+    bool empty() const;
+
+    // element access
+    bool contains(const std::string& value) const;
+    set::Set<long>& operator[](const std::string& value);
+    set::Set<long>& operator[](std::string&& value);  // moves a new value in
+
+    // iterators, in order of values
+    Iterator begin();
+    Iterator end();
+    Iterator find(const std::string& value);
+    Iterator lower_bound(const std::string& value);
+    Iterator upper_bound(const std::string& value);
+
+    // modifiers
+    void clear();
+
+private:
+    SQLDictionary _dict;                    // value to code
+    std::vector<set::Set<long>> _postings;  // code to record positions
+    Order _order;                           // codes in order of values
+
+    void copy_order();                         // rebuild _order from _dict
+    set::Set<long>& postings(code_type code);  // add set for a new code
+};
+
+}  // namespace sql
+
+#endif  // SQL_INDEX_H
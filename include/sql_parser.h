@@ -14,6 +14,7 @@
 #define SQLPARSER_H
 
 #include <algorithm>        // transform()
+#include <cassert>          // assert()
 #include <memory>           // shared_ptr
 #include <string>           // string
 #include "bpt_map.h"        // MMap class
@@ -44,6 +45,8 @@ public:
     friend SQLParser& operator<<(SQLParser& p, char* buffer);
 
 private:
+    enum { MAX_KEYWORD = 8 };  // longest keyword in _types, COLUMNAR
+
     static bool _need_init;                 // need Class initializations?
     static int _table[MAX_ROWS][MAX_COLS];  // adjacency table
     static ParseKey _keys;                  // map of parse keys
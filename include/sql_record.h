@@ -25,17 +25,37 @@
  *       .
  *       .
  *      EOF
+ *
+ *      ZONE MAPS:
+ *      update_zone() keeps the min/max values of each field for a block of
+ *      ZONE_RECORDS records in a zone file (file name + ".zone"). Only the
+ *      first ZONE_WIDTH characters of a value are kept: a prefix of the min
+ *      is still a lower bound and a prefix of the max bounds the prefixes of
+ *      the block's values, so truncated zones stay safe to prune with. Each
+ *      block of the zone file has a fixed size:
+ *      field count | REC_ROW min prefixes | REC_ROW max prefixes
+ *      A zone is started only by the first record of its block, so a block
+ *      written before it had a zone keeps none. A zone only widens, so it is
+ *      a safe bound even after overwrites. Record 0 (field names) is not
+ *      part of any zone.
+ *
+ *      The REC_SIZE buffer is only scratch space for one read/write. It is
+ *      allocated on the first read/write and is not copied with the record,
+ *      so copying or moving a record (ie: with its SQLTable) is cheap.
  ******************************************************************************/
 #ifndef SQL_RECORD_H
 #define SQL_RECORD_H
 
-#include <cassert>   // assert()
-#include <cstring>   // strncpy
-#include <fstream>   // file streams
-#include <iostream>  //stream
-#include <memory>    // memcpy
-#include <string>    // string
-#include <vector>    // vector
+#include <algorithm>  // find(), max()
+#include <cassert>    // assert()
+#include <cstdio>     // remove()
+#include <cstring>    // strncpy, memcpy(), memset()
+#include <fstream>    // file streams
+#include <iostream>   //stream
+#include <memory>     // memcpy
+#include <string>     // string
+#include <utility>    // move(), swap()
+#include <vector>     // vector
 
 namespace sql {
 
@@ -45,6 +65,8 @@ enum RECORD_SIZE {
     REC_SIZE = REC_ROW * REC_COL
 };
 
+enum ZONE_SIZE { ZONE_RECORDS = 1024, ZONE_WIDTH = 16 };
+
 class SQLRecord {
 public:
     SQLRecord(const std::string& fname = "");
@@ -52,14 +74,31 @@ public:
     ~SQLRecord();
     SQLRecord(const SQLRecord& src);
     SQLRecord& operator=(const SQLRecord& rhs);
+    SQLRecord(SQLRecord&& src);
+    SQLRecord& operator=(SQLRecord&& rhs);
 
     void set_fname(const std::string& fname);  // set file name
     std::streamsize read(std::vector<std::string>& v, long rpos = 0);
     long write(const std::vector<std::string>& v, long rpos = -1);
 
+    void update_zone(const std::vector<std::string>& v, long rpos);
+    bool read_zone(long block, std::vector<std::string>& min,
+                   std::vector<std::string>& max);
+    void remove_zones();  // remove zone file
+
 private:
-    char* _data;
+    char* _data;  // I/O buffer; allocated on first read/write, never copied
     std::string _fname;
+    long _zone_block;                   // block of cached zone
+    std::vector<std::string> _zone_min;  // cached zone's min prefixes
+    std::vector<std::string> _zone_max;  // cached zone's max prefixes
+
+    std::streamsize read_file(const std::string& fname,
+                              std::vector<std::string>& v, long rpos);
+    long write_file(const std::string& fname, const std::vector<std::string>& v,
+                    long rpos);
+    void write_zone(long block);  // write cached zone
+    void allocate();  // allocate I/O buffer if not yet allocated
 };
 
 }  // namespace sql
@@ -19,10 +19,10 @@ namespace sql {
 
 enum COMMANDS {
     CMD_START = 0,
-    CMD_CREATE = 10,  // uses 4 rows
+    CMD_CREATE = 10,  // uses 7 rows
     CMD_INSERT = 20,  // uses 6 rows
-    CMD_SELECT = 30,  // uses 11 rows
-    CMD_SIZE = 45
+    CMD_SELECT = 30,  // uses 26 rows
+    CMD_SIZE = 60
 };
 
 enum CREATE_STATES {
@@ -31,7 +31,8 @@ enum CREATE_STATES {
     CREATE_TABLE,
     CREATE_FIELDS_KEY,
     CREATE_FIELDS,
-    CREATE_COMMA
+    CREATE_COMMA,
+    CREATE_STORAGE
 };
 
 enum INSERT_STATES {
@@ -55,6 +56,21 @@ enum SELECT_STATES {
     SELECT_R_OPS,
     SELECT_VALUE,
     SELECT_L_OPS,
+    SELECT_AGGR,
+    SELECT_AGGR_L_PAREN,
+    SELECT_AGGR_FIELD,
+    SELECT_AGGR_R_PAREN,
+    SELECT_GROUP,
+    SELECT_GROUP_BY,
+    SELECT_GROUP_FIELD,
+    SELECT_JOIN,
+    SELECT_JOIN_TABLE,
+    SELECT_ON,
+    SELECT_ON_L_FIELD,
+    SELECT_ON_OP,
+    SELECT_ON_R_FIELD,
+    SELECT_JOIN_AS,
+    SELECT_JOIN_ALIAS,
 };
 
 enum ROWS { MAX_ROWS = CMD_SIZE };
@@ -79,6 +95,15 @@ enum COLUMNS {
     L_OPS,
     AND,
     OR,
+    AGGREGATE,
+    L_PAREN,
+    R_PAREN,
+    GROUP,
+    BY,
+    JOIN,
+    ON,
+    AS,
+    COLUMNAR,
     SPACE,
     MAX_COLS
 };
@@ -101,6 +126,12 @@ enum PARSE_KEYS {
     KEY_WHERE,
     KEY_TABLE,
     KEY_VALUES,
+    KEY_A_FIELDS,
+    KEY_GROUP,
+    KEY_JOIN,
+    KEY_ON,
+    KEY_STORAGE,
+    KEY_ALIAS,
     MAX_KEYS
 };
 
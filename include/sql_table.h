@@ -13,17 +13,55 @@
  *
  *          The table also have select function to return a new table for the
  *          selected data. The new table can be displayed via print.
+ *
+ *          The storage is chosen when the table is created. STORAGE_ROW keeps
+ *          whole records in the table file. STORAGE_COLUMN keeps only the
+ *          field labels in the table file and each field in its own
+ *          dictionary encoded column file (SQLColumns), so scans and
+ *          projections read only the fields they need.
+ *
+ *          A table created or opened without indexes (ie: a joined table)
+ *          keeps no IndexMaps, except one built for a GROUP BY field.
+ *          Instead, its writes and a column stored table's writes keep a
+ *          zone map per block of ZONE_RECORDS records (min/max prefix per
+ *          field, in SQLRecord's zone file). SELECT and aggregate WHERE
+ *          conditions on a table without IndexMaps scan the records in one
+ *          pass, reading only the needed fields and skipping each block
+ *          whose zone map cannot match.
+ *
+ *          Aggregate functions (COUNT, SUM, MIN, MAX, AVG) with optional
+ *          GROUP BY are answered from the IndexMap whenever possible: the
+ *          posting set sizes give the counts and the index keys with their
+ *          posting set sizes give the values. Otherwise, the aggregated
+ *          column is read for the selected records and reduced in one pass.
+ *
+ *          Two tables are joined on an equality of fields into a new table.
+ *          plan_join() picks the method. An index nested loop join probes
+ *          the other table's IndexMap for its join field with each record.
+ *          A hash join hashes the other table's join values in memory and
+ *          probes them. It is used when the other table has no IndexMap for
+ *          the field, or when this table is the larger one and the other
+ *          table fits in memory. When the other table has more than
+ *          join_memory_rows() records, both tables' join values are first
+ *          spilled to partition files by hash so only one partition is held
+ *          in memory at a time.
  ******************************************************************************/
 #ifndef SQL_TABLE_H
 #define SQL_TABLE_H
 
 #include <algorithm>       // transform()
 #include <cstdio>          // remove()
+#include <cstdlib>         // strtod()
+#include <fstream>         // fstream
+#include <functional>      // function, hash
 #include <iomanip>         // setw()
+#include <sstream>         // ostringstream
 #include <string>          // string
+#include <unordered_map>   // unordered_map
 #include <vector>          // vector
 #include "bpt_map.h"       // B+Tree's Map/MMap class
 #include "set.h"           // Set class
+#include "sql_columns.h"   // SQLColumns class
 #include "sql_record.h"    // SQLRecord class
 #include "sql_token.h"     // SQLToken class
 #include "sql_typedefs.h"  // typedefs for SQL
@@ -33,16 +71,30 @@ namespace sql {
 
 class SQLTable {
 public:
-    enum { PRINT_COL_WIDTH = 20 };
-
-    SQLTable() : _rec_count(0), _table_name() {}
-    SQLTable(const std::string& table_name);
+    enum { PRINT_COL_WIDTH = 20, JOIN_MEMORY_ROWS = 4096 };
+    enum STORAGE { STORAGE_ROW, STORAGE_COLUMN };
+    enum JOIN_METHOD { JOIN_INDEX, JOIN_HASH };
+
+    // records of a hash join's build side held in memory at a time
+    static std::size_t join_memory_rows();
+    static void set_join_memory_rows(std::size_t rows);
+
+    SQLTable()
+        : _rec_count(0),
+          _storage(STORAGE_ROW),
+          _is_indexed(true),
+          _table_name() {}
+    SQLTable(const std::string& table_name, bool is_indexed = true);
     SQLTable(const std::string& table_name,
-             const std::vector<std::string>& fields);
+             const std::vector<std::string>& fields,
+             int storage = STORAGE_ROW, bool is_indexed = true);
 
+    bool is_open() const;
     std::size_t field_count() const;
     std::size_t size() const;
+    int storage() const;
     const FieldMap& map() const;
+    std::vector<std::string> field_names() const;
 
     void delete_table();
 
@@ -52,6 +104,12 @@ public:
 
     bool select(const std::vector<std::string>& fields_list, QueueTokens& infix,
                 SQLTable& new_table);
+    bool aggregate(const std::vector<std::string>& fields_list,
+                   const std::string& group_field, QueueTokens& infix,
+                   SQLTable& new_table);
+    bool join(SQLTable& other, const std::string& field,
+              const std::string& other_field, SQLTable& new_table);
+    int plan_join(const SQLTable& other, const std::string& other_field) const;
 
     void print(const std::vector<std::string>& field_names =
                    std::vector<std::string>({"*"}),
@@ -62,7 +120,21 @@ public:
                       int width = PRINT_COL_WIDTH);
 
 private:
+    struct Aggregate {        // running state of an aggregate function
+        std::size_t count;    // count of non-empty values
+        std::size_t numbers;  // count of numeric values
+        double sum;           // sum of numeric values
+        std::string min;      // smallest value
+        std::string max;      // largest value
+
+        Aggregate() : count(0), numbers(0), sum(0) {}
+    };
+
+    static std::size_t _join_memory_rows;  // build side rows in memory
+
     long _rec_count;              // total records
+    int _storage;                 // STORAGE_ROW or STORAGE_COLUMN
+    bool _is_indexed;             // keep IndexMaps of all fields
     FieldMap _map;                // map of all IndexMaps
     FieldPosMap _pos_to_fields;   // map field pos to field name
     FiledNamesMap _field_to_pos;  // map field name to pos
@@ -70,11 +142,18 @@ private:
     std::string _ext;             // file extension
     std::string _fname;           // filename for table
     SQLRecord _record;            // read/write to table file
+    SQLColumns _columns;          // read/write to column files
 
     void init_table();
     void init_fields();
+    void init_storage();
     void init_data();
 
+    std::streamsize read_record(std::vector<std::string>& values, long pos);
+    std::streamsize read_record(std::vector<std::string>& values, long pos,
+                                const std::vector<int>& columns);
+    long write_record(const std::vector<std::string>& values, long pos);
+
     void make_equal_set(const std::string& field, const std::string& value,
                         set_ptr& result);
     void make_less_set(const std::string& field, const std::string& value,
@@ -86,9 +165,54 @@ private:
     void make_greater_eq_set(const std::string& field, const std::string& value,
                              set_ptr& result);
 
+    std::string aggregate_value(const std::string& label,
+                                const set::Set<long>* rows);
+    void accumulate(Aggregate& agg, const std::string& value,
+                    std::size_t n = 1);
+    std::string aggregate_result(const std::string& func,
+                                 const Aggregate& agg);
+    bool is_numeric(const std::string& str, double& number) const;
+    bool is_value_less(const std::string& lhs, const std::string& rhs) const;
+    std::string format_number(double number) const;
+
+    typedef std::unordered_map<std::string, std::vector<long>> JoinHash;
+
+    void index_join(SQLTable& other, const std::string& field,
+                    const std::string& other_field, SQLTable& new_table);
+    bool read_join_value(long pos, const std::vector<int>& column,
+                         std::vector<std::string>& values, std::string& key);
+    void hash_join(SQLTable& other, const std::string& field,
+                   const std::string& other_field, SQLTable& new_table);
+    void hash_probe(SQLTable& other, const JoinHash& hash,
+                    const std::string& field, SQLTable& new_table);
+    void hash_probe(SQLTable& other, const JoinHash& hash,
+                    std::istream& part, SQLTable& new_table);
+    void hash_build(const std::string& field, JoinHash& hash);
+    void join_records(const std::vector<std::string>& values,
+                      SQLTable& other, long other_pos, SQLTable& new_table);
+    void partition(const std::string& field, std::size_t count,
+                   const std::string& ext, std::vector<std::string>& files);
+    bool read_partition(std::istream& part, std::string& key, long& pos);
+
     std::string truncate(std::string str, size_t width, bool ellipsis = true);
+    struct Term {           // WHERE term in postfix order
+        int op;             // SQLTokenTypes of relational or logical op
+        int pos;            // field position of relational term
+        std::string value;  // value of relational term
+    };
+    typedef std::function<bool(const Term&)> TermTest;
+    typedef std::function<void(long, std::vector<std::string>&)> RecordVisit;
+
     void infix_to_postfix(QueueTokens& infix, QueueTokens& postfix);
     void eval_postfix(QueueTokens& postfix, set_ptr& result_set);
+    void eval_where(QueueTokens& infix, set_ptr& result_set);
+    void scan_postfix(QueueTokens& postfix, std::vector<int> columns,
+                      const RecordVisit& visit);
+    bool eval_terms(const std::vector<Term>& terms, const TermTest& test);
+    bool is_term_match(const std::string& value, const Term& term) const;
+    bool is_zone_match(const std::string& min, const std::string& max,
+                       const Term& term) const;
+    void index_field(const std::string& field);
 
     void update_fields(const std::vector<std::string>& fields);
 };
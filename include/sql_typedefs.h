@@ -15,6 +15,7 @@
 #include "bpt_map.h"    // MMap class
 #include "queue.h"      // Queue class
 #include "set.h"        // Set calss
+#include "sql_index.h"  // SQLIndex class
 #include "sql_token.h"  // SQLToken class
 #include "stack.h"      // Stack class
 
@@ -33,7 +34,7 @@ typedef bpt_map::Map<int, std::string> FieldPosMap;
 typedef bpt_map::Map<std::string, int> FiledNamesMap;
 
 // map chains
-typedef bpt_map::Map<std::string, set::Set<long>> IndexMap;
+typedef SQLIndex IndexMap;  // dictionary encoded value to record positions
 typedef bpt_map::Map<std::string, IndexMap> FieldMap;
 
 // conditional WHERE
@@ -25,7 +25,7 @@ enum STATES {
     STATE_SPACE = 25,             // uses 2 rows
     STATE_PUNCT = 30,             // uses 2 rows
     STATE_IDENT = 34,             // identifier states
-    STATE_IDENT_NORM = 35,        // uses 2 rows
+    STATE_IDENT_NORM = 35,        // uses 2 rows (3 rows if qualified)
     STATE_IDENT_QUOTE = 39,       // ident in quotes
     STATE_IN_QUOTE_S_IDENT = 40,  // uses 4 rows
     STATE_IN_QUOTE_D_IDENT = 45,  // uses 4 rows
@@ -101,6 +101,9 @@ void mark_table_double(int _table[][MAX_COLUMNS], int state);
 // mark table for STATE_IDENTIFIER
 void mark_table_identifier(int _table[][MAX_COLUMNS], int state);
 
+// mark table for STATE_IDENTIFIER with qualifiers, ie: "table.field"
+void mark_table_qualified_identifier(int _table[][MAX_COLUMNS], int state);
+
 void mark_table_r_ops(int _table[][MAX_COLUMNS], int state);
 
 // this can realistically be used on a small table
@@ -214,6 +214,8 @@ void SQL::init() {
     _query_code_map[WRONG_FIELD_SIZE] = error + "Wrong field size";
     _query_code_map[FIELDS_OVERLIMIT] = error + "Too many fields";
     _query_code_map[WRONG_FIELDS_NAME] = error + "Field name does not match";
+    _query_code_map[WRONG_AGGREGATE] = error + "Invalid aggregate or GROUP BY";
+    _query_code_map[WRONG_JOIN] = error + "Invalid JOIN table or ON fields";
 
     _need_init = false;
 }
@@ -288,13 +290,14 @@ void SQL::change_session(const std::string &name) {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Load session information.
+ *  Load session information. Tables are registered as unopened handles,
+ *  which are opened on first access by open_table.
  *
  * PRE-CONDITIONS:
  *  none
  *
  * POST-CONDITIONS:
- *  none
+ *  _table_map has an unopened SQLTable for each table in session
  *
  * RETURN:
  *  none
@@ -303,7 +306,7 @@ void SQL::load_session() {
     std::string fname = _session + ".sql";
     std::ifstream file(fname.c_str(), std::ios::binary);
     std::string table_name;
-    while(file >> table_name) _table_map[table_name] = SQLTable(table_name);
+    while(file >> table_name) _table_map[table_name] = SQLTable();
 }
 
 /*******************************************************************************
@@ -355,6 +358,28 @@ int SQL::exec_query() {
     }
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the table by name. A table registered by load_session is opened
+ *  from its table file (and indexed) on its first access.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string &table_name: existing table name
+ *
+ * POST-CONDITIONS:
+ *  _table_map's SQLTable opened
+ *
+ * RETURN:
+ *  SQLTable&
+ ******************************************************************************/
+SQLTable &SQL::open_table(const std::string &table_name) {
+    SQLTable &table = _table_map[table_name];
+
+    if(!table.is_open()) table = SQLTable(table_name);
+
+    return table;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Create SQL table.
@@ -373,7 +398,11 @@ int SQL::create_table(const std::string &table_name, bool table_found) {
     if(table_found)
         return EXIST_TABLE;
     else {
-        _table_map[table_name] = SQLTable(table_name, _parse_tree["FIELDS"]);
+        int storage = SQLTable::STORAGE_ROW;
+        if(_parse_tree.contains("STORAGE")) storage = SQLTable::STORAGE_COLUMN;
+
+        _table_map[table_name] =
+            SQLTable(table_name, _parse_tree["FIELDS"], storage);
         return 0;
     }
 }
@@ -395,7 +424,7 @@ int SQL::create_table(const std::string &table_name, bool table_found) {
 int SQL::insert_table(const std::string &table_name, bool table_found) {
     if(table_found) {
         if(insert_values_match_fields_size(table_name)) {
-            _table_map[table_name].insert(_parse_tree["VALUES"]);
+            open_table(table_name).insert(_parse_tree["VALUES"]);
             return 0;
         } else
             return WRONG_FIELD_SIZE;
@@ -419,24 +448,211 @@ int SQL::insert_table(const std::string &table_name, bool table_found) {
  ******************************************************************************/
 int SQL::select_table(const std::string &table_name, bool table_found) {
     if(table_found) {
-        int query_code = is_valid_fields(table_name);
+        if(_parse_tree.contains("JOIN")) return select_join(table_name);
 
-        if(query_code == 0) {
-            std::cout << "\nTABLE: " << table_name << std::endl;
+        SQLTable &table = open_table(table_name);
+        int query_code = is_valid_fields(table);
 
-            SQLTable new_table(table_name + "__temp__");
+        if(query_code == 0) select_rows(table, table_name);
 
-            _table_map[table_name].select(_parse_tree["FIELDS"], _infix,
-                                          new_table);
-            new_table.delete_table();
+        return query_code;
+    } else
+        return NOT_EXIST_TABLE;
+}
 
-            std::cout << std::endl;
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Select data from two SQL tables joined on an equality of fields. The
+ *  joined table has both tables' fields, qualified by their table names, ie:
+ *  "employee.last". The JOIN table is qualified by its alias when it has
+ *  one, so a table can join itself: JOIN employee AS boss. Unqualified field
+ *  names in the query are qualified when they belong to only one of the
+ *  tables.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string &table_name: existing table name
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  int: Query code
+ ******************************************************************************/
+int SQL::select_join(const std::string &table_name) {
+    std::string join_name = _parse_tree["JOIN"][0];
+    std::string alias = join_name;  // JOIN table's qualifier
+    std::vector<std::string> &on = _parse_tree["ON"];  // field, op, field
+    std::vector<std::string> fields;                   // joined field names
 
-            return 0;
-        } else
-            return query_code;
+    if(_parse_tree.contains("ALIAS")) alias = _parse_tree["ALIAS"][0];
+
+    if(!_table_map.contains(join_name)) return NOT_EXIST_TABLE;
+    if(alias == table_name || on[1] != "=") return WRONG_JOIN;
+
+    SQLTable &table = open_table(table_name);
+    SQLTable self;  // second reader of table for a self-join
+    SQLTable *join_table = &open_table(join_name);
+
+    if(join_name == table_name) {  // own column streams; no seeks between
+        self = table;
+        join_table = &self;
+    }
+
+    if(table.field_count() + join_table->field_count() >= REC_ROW)
+        return FIELDS_OVERLIMIT;
+
+    for(const auto &a : table.field_names())
+        fields.push_back(table_name + "." + a);
+    for(const auto &a : join_table->field_names())
+        fields.push_back(alias + "." + a);
+
+    SQLTable joined(table_name + "__join__", fields, SQLTable::STORAGE_ROW,
+                    false);
+    int query_code = 0;
+
+    // ON fields must be one field from each table, in either order
+    if(!qualify_field(joined, on[0]) || !qualify_field(joined, on[2]))
+        query_code = WRONG_JOIN;
+    else {
+        if(on[0].compare(0, alias.size() + 1, alias + ".") == 0)
+            std::swap(on[0], on[2]);
+        if(on[0].compare(0, table_name.size() + 1, table_name + ".") != 0 ||
+           on[2].compare(0, alias.size() + 1, alias + ".") != 0)
+            query_code = WRONG_JOIN;
+    }
+
+    if(query_code == 0) query_code = qualify_fields(joined);
+    if(query_code == 0) query_code = is_valid_fields(joined);
+
+    if(query_code == 0) {
+        table.join(*join_table, on[0].substr(table_name.size() + 1),
+                   on[2].substr(alias.size() + 1), joined);
+        select_rows(joined, table_name + " JOIN " + join_name +
+                                (alias != join_name ? " AS " + alias : ""));
+    }
+
+    joined.delete_table();
+
+    return query_code;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Select and print rows or aggregates from a validated table.
+ *
+ * PRE-CONDITIONS:
+ *  SQLTable &table          : table with valid query fields
+ *  const std::string &title : table name to display
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQL::select_rows(SQLTable &table, const std::string &title) {
+    std::cout << "\nTABLE: " << title << std::endl;
+
+    SQLTable new_table(title.substr(0, title.find(' ')) + "__temp__");
+
+    if(is_aggregate_query()) {
+        std::string group;
+        if(_parse_tree.contains("GROUP")) group = _parse_tree["GROUP"][0];
+
+        table.aggregate(_parse_tree["FIELDS"], group, _infix, new_table);
     } else
-        return NOT_EXIST_TABLE;
+        table.select(_parse_tree["FIELDS"], _infix, new_table);
+    new_table.delete_table();
+
+    std::cout << std::endl;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Qualifies a field name with its table name for a joined table. A field
+ *  that is already qualified must exist; an unqualified field must exist in
+ *  exactly one of the joined tables.
+ *
+ * PRE-CONDITIONS:
+ *  const SQLTable &joined: joined table with qualified field names
+ *  std::string &field    : field name
+ *
+ * POST-CONDITIONS:
+ *  std::string &field: qualified field name
+ *
+ * RETURN:
+ *  bool: false if field is unknown or ambiguous
+ ******************************************************************************/
+bool SQL::qualify_field(const SQLTable &joined, std::string &field) {
+    if(field.find('.') != std::string::npos) return joined.contains(field);
+
+    std::string qualified;
+    std::size_t matches = 0;
+
+    for(const auto &a : joined.field_names()) {
+        std::size_t dot = a.find('.');
+        if(a.compare(dot + 1, std::string::npos, field) == 0) {
+            qualified = a;
+            ++matches;
+        }
+    }
+
+    if(matches == 1) field = qualified;
+
+    return matches == 1;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Qualifies all field names of the SELECT query for a joined table: the
+ *  fields, aggregate fields, GROUP BY field and WHERE's relation fields.
+ *
+ * PRE-CONDITIONS:
+ *  const SQLTable &joined: joined table with qualified field names
+ *
+ * POST-CONDITIONS:
+ *  _parse_tree and _infix: field names qualified
+ *
+ * RETURN:
+ *  int: Query code
+ ******************************************************************************/
+int SQL::qualify_fields(const SQLTable &joined) {
+    QueueTokens infix;
+    std::string field;
+    int count = 0;
+
+    for(auto &a : _parse_tree["FIELDS"]) {
+        std::size_t open = a.find('(');
+
+        if(open == std::string::npos) {
+            if(a != "*" && !qualify_field(joined, a)) return WRONG_FIELDS_NAME;
+        } else if(a.compare(open, std::string::npos, "(*)") != 0) {
+            field = a.substr(open + 1, a.size() - open - 2);
+            if(!qualify_field(joined, field)) return WRONG_FIELDS_NAME;
+            a = a.substr(0, open + 1) + field + ")";
+        }
+    }
+
+    for(const auto &key : {"A_FIELDS", "GROUP", "R_FIELDS"})
+        if(_parse_tree.contains(key))
+            for(auto &a : _parse_tree[key])
+                if(!qualify_field(joined, a)) return WRONG_FIELDS_NAME;
+
+    // WHERE is: field op value [L_OP field op value]...
+    while(!_infix.empty()) {
+        token_ptr t = _infix.pop();
+
+        if(count++ % 4 == 0) {
+            field = t->string();
+            if(!qualify_field(joined, field)) return WRONG_FIELDS_NAME;
+            t = std::make_shared<SQLToken>(field, TOKEN_SET_STR);
+        }
+
+        infix.push(t);
+    }
+    _infix = infix;
+
+    return 0;
 }
 
 /*******************************************************************************
@@ -453,7 +669,7 @@ int SQL::select_table(const std::string &table_name, bool table_found) {
  *  bool
  ******************************************************************************/
 bool SQL::insert_values_match_fields_size(const std::string &table_name) {
-    if(_parse_tree["VALUES"].size() != _table_map[table_name].field_count())
+    if(_parse_tree["VALUES"].size() != open_table(table_name).field_count())
         return false;
     else
         return true;
@@ -464,7 +680,7 @@ bool SQL::insert_values_match_fields_size(const std::string &table_name) {
  *  Checks if fields or relation fields are valid from SQL table.
  *
  * PRE-CONDITIONS:
- *  const std::string &table_name: table name
+ *  SQLTable &table: table to select from
  *
  * POST-CONDITIONS:
  *  none
@@ -472,19 +688,88 @@ bool SQL::insert_values_match_fields_size(const std::string &table_name) {
  * RETURN:
  *  int: Query code
  ******************************************************************************/
-int SQL::is_valid_fields(const std::string &table_name) {
-    if(_parse_tree["FIELDS"].size() > _table_map[table_name].field_count())
+int SQL::is_valid_fields(SQLTable &table) {
+    if(is_aggregate_query()) return is_valid_aggregate(table);
+
+    if(_parse_tree["FIELDS"].size() > table.field_count())
         return FIELDS_OVERLIMIT;
 
     if(_parse_tree["FIELDS"][0] != "*" &&
-       !_table_map[table_name].is_match_fields(_parse_tree["FIELDS"]))
+       !table.is_match_fields(_parse_tree["FIELDS"]))
         return WRONG_FIELDS_NAME;
 
     if(_parse_tree.contains("WHERE") &&
-       !_table_map[table_name].is_match_fields(_parse_tree["R_FIELDS"]))
+       !table.is_match_fields(_parse_tree["R_FIELDS"]))
         return WRONG_FIELDS_NAME;
 
     return 0;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if aggregate fields, GROUP BY field and relation fields are valid
+ *  from SQL table. Non-aggregate fields must be the GROUP BY field and only
+ *  COUNT can take the asterisk.
+ *
+ * PRE-CONDITIONS:
+ *  SQLTable &table: table to select from
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  int: Query code
+ ******************************************************************************/
+int SQL::is_valid_aggregate(SQLTable &table) {
+    std::string group;
+
+    if(_parse_tree["FIELDS"].size() >= REC_ROW) return FIELDS_OVERLIMIT;
+
+    if(_parse_tree.contains("GROUP")) {
+        group = _parse_tree["GROUP"][0];
+        if(!table.contains(group)) return WRONG_FIELDS_NAME;
+    }
+
+    if(_parse_tree.contains("A_FIELDS") &&
+       !table.is_match_fields(_parse_tree["A_FIELDS"]))
+        return WRONG_FIELDS_NAME;
+
+    for(const auto &field : _parse_tree["FIELDS"]) {
+        std::size_t open = field.find('(');
+
+        if(open == std::string::npos) {  // plain field must be group field
+            if(field != group) return WRONG_AGGREGATE;
+        } else if(field.substr(open) == "(*)" && field.substr(0, open) != "COUNT")
+            return WRONG_AGGREGATE;
+    }
+
+    if(_parse_tree.contains("WHERE") &&
+       !table.is_match_fields(_parse_tree["R_FIELDS"]))
+        return WRONG_FIELDS_NAME;
+
+    return 0;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if SELECT query has aggregate fields or GROUP BY.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+bool SQL::is_aggregate_query() {
+    if(_parse_tree.contains("GROUP")) return true;
+
+    for(const auto &field : _parse_tree["FIELDS"])
+        if(field.find('(') != std::string::npos) return true;
+
+    return false;
+}
+
 }  // namespace sql
@@ -0,0 +1,336 @@
+#include "../include/sql_columns.h"
+
+namespace sql {
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Construct columns for a table and load the columns' dictionaries.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& name: table name
+ *  std::size_t count      : number of columns
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+SQLColumns::SQLColumns(const std::string& name, std::size_t count)
+    : _name(name) {
+    _dicts.reserve(count);
+    for(std::size_t i = 0; i < count; ++i) _dicts.emplace_back(dict_fname(i));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Closes the column files.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+SQLColumns::~SQLColumns() { close(); }
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Copy constructor. The copy opens its own column files if src has them
+ *  open.
+ *
+ * PRE-CONDITIONS:
+ *  const SQLColumns& src: source object
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+SQLColumns::SQLColumns(const SQLColumns& src)
+    : _name(src._name), _dicts(src._dicts) {
+    if(src.is_open()) open();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Assignment operator. 'this' closes its column files and opens rhs's if
+ *  rhs has them open.
+ *
+ * PRE-CONDITIONS:
+ *  const SQLColumns& rhs: right hand side object
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  SQLColumns&
+ ******************************************************************************/
+SQLColumns& SQLColumns::operator=(const SQLColumns& rhs) {
+    if(this != &rhs) {
+        close();
+        _name = rhs._name;
+        _dicts = rhs._dicts;
+        if(rhs.is_open()) open();
+    }
+    return *this;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if the column files of the table exist.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+bool SQLColumns::exists() const {
+    return !_dicts.empty() && std::ifstream(column_fname(0).c_str()).good();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if the column files are open.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+bool SQLColumns::is_open() const { return !_files.empty(); }
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Open the column files for reading and writing. They stay open until
+ *  close(), remove() or the destructor.
+ *
+ * PRE-CONDITIONS:
+ *  column files exist
+ *
+ * POST-CONDITIONS:
+ *  one open stream per column
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLColumns::open() {
+    close();
+    _files.reserve(_dicts.size());
+    for(std::size_t i = 0; i < _dicts.size(); ++i)
+        _files.emplace_back(column_fname(i).c_str(),
+                            std::ios::in | std::ios::out | std::ios::binary);
+    _next.assign(_dicts.size(), 0);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Close the column files.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  no open column files
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLColumns::close() {
+    _files.clear();
+    _next.clear();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Create empty column and dictionary files.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  empty column files and dictionaries
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLColumns::create() {
+    bool was_open = is_open();
+
+    close();
+    for(std::size_t i = 0; i < _dicts.size(); ++i) {
+        std::ofstream file(column_fname(i).c_str(),
+                           std::ios::binary | std::ios::trunc);
+        _dicts[i].clear();
+    }
+    if(was_open) open();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Remove column and dictionary files.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  column files closed and removed
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLColumns::remove() {
+    close();
+    for(std::size_t i = 0; i < _dicts.size(); ++i) {
+        std::remove(column_fname(i).c_str());
+        std::remove(dict_fname(i).c_str());
+    }
+    _dicts.clear();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Read all column values of a record and return by ref to a vector.
+ *
+ * PRE-CONDITIONS:
+ *  std::vector<std::string>& v: empty vector
+ *  long rpos                  : record position, starting at 1
+ *
+ * POST-CONDITIONS:
+ *  std::vector<std::string>& v: one value per column
+ *
+ * RETURN:
+ *  std::streamsize: bytes read; 0 when record does not exist
+ ******************************************************************************/
+std::streamsize SQLColumns::read(std::vector<std::string>& v, long rpos) {
+    std::vector<int> columns(_dicts.size());
+    for(std::size_t i = 0; i < columns.size(); ++i) columns[i] = i;
+
+    return read(v, rpos, columns);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Read the given column values of a record and return by ref to a vector.
+ *  Only the given columns' files are read.
+ *
+ * PRE-CONDITIONS:
+ *  std::vector<std::string>& v     : empty vector
+ *  long rpos                       : record position, starting at 1
+ *  const std::vector<int>& columns : column positions to read
+ *
+ * POST-CONDITIONS:
+ *  std::vector<std::string>& v: one value per given column, in given order
+ *
+ * RETURN:
+ *  std::streamsize: bytes read; 0 when record does not exist
+ ******************************************************************************/
+std::streamsize SQLColumns::read(std::vector<std::string>& v, long rpos,
+                                 const std::vector<int>& columns) {
+    std::streamsize count = 0;
+    code_type code;
+
+    if(rpos < 1 || !is_open()) return 0;
+
+    for(const auto& i : columns) {
+        std::fstream& file = _files[i];
+
+        if(_next[i] != rpos) {  // not where the last read left off
+            file.clear();
+            file.seekg((rpos - 1) * sizeof(code));
+        }
+
+        _next[i] = 0;
+        if(!file.read(reinterpret_cast<char*>(&code), sizeof(code)) ||
+           code >= _dicts[i].size())
+            return 0;
+
+        _next[i] = rpos + 1;
+
+        v.push_back(_dicts[i].decode(code));
+        count += sizeof(code);
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Write a record's values to their column files. Missing values are
+ *  written as empty strings.
+ *
+ * PRE-CONDITIONS:
+ *  const std::vector<std::string>& v: values in column order
+ *  long rpos                        : record position, starting at 1
+ *
+ * POST-CONDITIONS:
+ *  Codes written to column files at rpos; new values added to dictionaries
+ *
+ * RETURN:
+ *  long: record position
+ ******************************************************************************/
+long SQLColumns::write(const std::vector<std::string>& v, long rpos) {
+    assert(rpos > 0 && is_open());
+    code_type code;
+
+    for(std::size_t i = 0; i < _dicts.size(); ++i) {
+        code = _dicts[i].encode(i < v.size() ? v[i] : std::string());
+
+        std::fstream& file = _files[i];
+        file.clear();
+        file.seekp((rpos - 1) * sizeof(code));
+        file.write(reinterpret_cast<const char*>(&code), sizeof(code));
+        file.flush();  // other streams on the file see the code
+        _next[i] = 0;  // switch back to reading with a seek
+    }
+
+    return rpos;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the file name of a column.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t column: column position
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::string
+ ******************************************************************************/
+std::string SQLColumns::column_fname(std::size_t column) const {
+    return _name + "_" + std::to_string(column) + ".col";
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the dictionary file name of a column.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t column: column position
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::string
+ ******************************************************************************/
+std::string SQLColumns::dict_fname(std::size_t column) const {
+    return _name + "_" + std::to_string(column) + ".dict";
+}
+
+}  // namespace sql
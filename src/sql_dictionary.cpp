@@ -0,0 +1,286 @@
+#include "../include/sql_dictionary.h"
+
+namespace sql {
+
+// STATIC VARIABLES
+const SQLDictionary::code_type SQLDictionary::EMPTY_SLOT;
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Construct dictionary and load values from dictionary file if it exists.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& fname: file name or empty for in-memory dictionary
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+SQLDictionary::SQLDictionary(const std::string& fname) : _fname(fname) {
+    load();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Set new file name and load values from dictionary file if it exists.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& fname: file name or empty for in-memory dictionary
+ *
+ * POST-CONDITIONS:
+ *  Old values cleared and new values loaded
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLDictionary::set_fname(const std::string& fname) {
+    _fname = fname;
+    _slots.clear();
+    _values.clear();
+    load();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns number of encoded values.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+std::size_t SQLDictionary::size() const { return _values.size(); }
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Find the code of a value without adding it.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& value: value to find
+ *  code_type& code         : code by ref
+ *
+ * POST-CONDITIONS:
+ *  code_type& code: value's code when found
+ *
+ * RETURN:
+ *  bool: true when found
+ ******************************************************************************/
+bool SQLDictionary::find(const std::string& value, code_type& code) const {
+    if(_slots.empty()) return false;
+
+    code = _slots[find_slot(value)];
+
+    return code != EMPTY_SLOT;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the value of a code.
+ *
+ * PRE-CONDITIONS:
+ *  code_type code: code less than size()
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  const std::string&
+ ******************************************************************************/
+const std::string& SQLDictionary::decode(code_type code) const {
+    assert(code < _values.size());
+    return _values[code];
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the code of a value. A new value gets the next code and is
+ *  appended to the dictionary file.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& value: value to encode
+ *
+ * POST-CONDITIONS:
+ *  new value added to dictionary and its file
+ *
+ * RETURN:
+ *  code_type
+ ******************************************************************************/
+SQLDictionary::code_type SQLDictionary::encode(const std::string& value) {
+    code_type code;
+
+    if(find(value, code)) return code;
+
+    return append(std::string(value));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the code of a value. A new value is moved into the dictionary.
+ *
+ * PRE-CONDITIONS:
+ *  std::string&& value: value to encode
+ *
+ * POST-CONDITIONS:
+ *  new value added to dictionary and its file; value moved from
+ *
+ * RETURN:
+ *  code_type
+ ******************************************************************************/
+SQLDictionary::code_type SQLDictionary::encode(std::string&& value) {
+    code_type code;
+
+    if(find(value, code)) return code;
+
+    return append(std::move(value));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Add a new value with the next code and append it to the dictionary file.
+ *
+ * PRE-CONDITIONS:
+ *  std::string&& value: value not in dictionary
+ *
+ * POST-CONDITIONS:
+ *  value added to dictionary and its file
+ *
+ * RETURN:
+ *  code_type: code of value
+ ******************************************************************************/
+SQLDictionary::code_type SQLDictionary::append(std::string&& value) {
+    code_type code = _values.size();
+
+    if(!_fname.empty()) {
+        std::ofstream file(_fname.c_str(), std::ios::binary | std::ios::app);
+        std::size_t size = value.size();
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        file.write(value.data(), size);
+    }
+
+    add(std::move(value));
+
+    return code;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Remove all values and truncate dictionary file.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  empty dictionary
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLDictionary::clear() {
+    _slots.clear();
+    _values.clear();
+
+    if(!_fname.empty())
+        std::ofstream file(_fname.c_str(), std::ios::binary | std::ios::trunc);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the slot of a value's code, or the empty slot where the value's
+ *  code would go.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& value: value to find
+ *  _slots                  : not empty and not full
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t: slot position
+ ******************************************************************************/
+std::size_t SQLDictionary::find_slot(const std::string& value) const {
+    std::size_t mask = _slots.size() - 1;  // slot count is a power of 2
+    std::size_t slot = std::hash<std::string>()(value) & mask;
+
+    while(_slots[slot] != EMPTY_SLOT && _values[_slots[slot]] != value)
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Add a new value with the next code.
+ *
+ * PRE-CONDITIONS:
+ *  std::string&& value: value not in dictionary
+ *
+ * POST-CONDITIONS:
+ *  value added; hash table doubled if more than half full
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLDictionary::add(std::string&& value) {
+    if(2 * (_values.size() + 1) > _slots.size())
+        rehash(_slots.empty() ? std::size_t(MIN_SLOTS) : 2 * _slots.size());
+
+    _slots[find_slot(value)] = _values.size();
+    _values.push_back(std::move(value));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Rebuild hash table with a new number of slots.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t slots: power of 2 greater than 2 * size()
+ *
+ * POST-CONDITIONS:
+ *  all codes re-inserted into new hash table
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLDictionary::rehash(std::size_t slots) {
+    _slots.assign(slots, EMPTY_SLOT);
+
+    for(std::size_t code = 0; code < _values.size(); ++code)
+        _slots[find_slot(_values[code])] = code;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Load values from dictionary file in code order.
+ *
+ * PRE-CONDITIONS:
+ *  std::string _fname: dictionary file name
+ *
+ * POST-CONDITIONS:
+ *  values loaded
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLDictionary::load() {
+    if(_fname.empty()) return;
+
+    std::ifstream file(_fname.c_str(), std::ios::binary);
+    std::string value;
+    std::size_t size;
+
+    while(file.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+        value.resize(size);
+        if(!file.read(&value[0], size)) break;
+
+        add(std::move(value));
+    }
+}
+
+}  // namespace sql
@@ -0,0 +1,280 @@
+#include "../include/sql_index.h"
+
+namespace sql {
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Copy constructor. The ordered codes are rebuilt to point at this index's
+ *  own dictionary.
+ *
+ * PRE-CONDITIONS:
+ *  const SQLIndex& src: index to copy
+ *
+ * POST-CONDITIONS:
+ *  deep copy of src
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+SQLIndex::SQLIndex(const SQLIndex& src)
+    : _dict(src._dict), _postings(src._postings) {
+    copy_order();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Copy assignment. The ordered codes are rebuilt to point at this index's
+ *  own dictionary.
+ *
+ * PRE-CONDITIONS:
+ *  const SQLIndex& rhs: index to copy
+ *
+ * POST-CONDITIONS:
+ *  deep copy of rhs
+ *
+ * RETURN:
+ *  SQLIndex&
+ ******************************************************************************/
+SQLIndex& SQLIndex::operator=(const SQLIndex& rhs) {
+    if(this != &rhs) {
+        _dict = rhs._dict;
+        _postings = rhs._postings;
+        copy_order();
+    }
+
+    return *this;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns number of distinct values.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+std::size_t SQLIndex::size() const { return _postings.size(); }
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if index has no values.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+bool SQLIndex::empty() const { return _postings.empty(); }
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if value is in index.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& value: field value
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+bool SQLIndex::contains(const std::string& value) const {
+    code_type code;
+    return _dict.find(value, code);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the record positions of a value. A new value is encoded and gets
+ *  an empty set.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& value: field value
+ *
+ * POST-CONDITIONS:
+ *  new value added to dictionary
+ *
+ * RETURN:
+ *  set::Set<long>&
+ ******************************************************************************/
+set::Set<long>& SQLIndex::operator[](const std::string& value) {
+    return postings(_dict.encode(value));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the record positions of a value. A new value is moved into the
+ *  dictionary and gets an empty set.
+ *
+ * PRE-CONDITIONS:
+ *  std::string&& value: field value
+ *
+ * POST-CONDITIONS:
+ *  new value added to dictionary; value moved from
+ *
+ * RETURN:
+ *  set::Set<long>&
+ ******************************************************************************/
+set::Set<long>& SQLIndex::operator[](std::string&& value) {
+    return postings(_dict.encode(std::move(value)));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the smallest value.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Iterator
+ ******************************************************************************/
+SQLIndex::Iterator SQLIndex::begin() { return Iterator(this, _order.begin()); }
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator past the largest value.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Iterator
+ ******************************************************************************/
+SQLIndex::Iterator SQLIndex::end() { return Iterator(this, _order.end()); }
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to value or end() if not found. A missing value is
+ *  found missing by the dictionary without searching the ordered codes; a
+ *  found value probes the ordered codes with the value itself.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& value: field value
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Iterator
+ ******************************************************************************/
+SQLIndex::Iterator SQLIndex::find(const std::string& value) {
+    code_type code;
+
+    if(!_dict.find(value, code)) return end();
+
+    return Iterator(this, _order.find(value));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the first value not less than value.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& value: field value
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Iterator
+ ******************************************************************************/
+SQLIndex::Iterator SQLIndex::lower_bound(const std::string& value) {
+    return Iterator(this, _order.lower_bound(value));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns iterator to the first value greater than value.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& value: field value
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  Iterator
+ ******************************************************************************/
+SQLIndex::Iterator SQLIndex::upper_bound(const std::string& value) {
+    return Iterator(this, _order.upper_bound(value));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Remove all values.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  empty index
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLIndex::clear() {
+    _dict.clear();
+    _postings.clear();
+    _order.clear();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Rebuild the ordered codes from the dictionary, in code order.
+ *
+ * PRE-CONDITIONS:
+ *  SQLDictionary _dict: values of all codes
+ *
+ * POST-CONDITIONS:
+ *  Order _order: all codes, pointing at _dict's values
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLIndex::copy_order() {
+    _order.clear();
+
+    for(code_type code = 0; code < _dict.size(); ++code)
+        _order.insert(Key{&_dict.decode(code), code});
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the record positions of a code. A new code gets an empty set.
+ *
+ * PRE-CONDITIONS:
+ *  code_type code: code from _dict, at most one past the last code
+ *
+ * POST-CONDITIONS:
+ *  new code added to _postings and inserted in order into _order
+ *
+ * RETURN:
+ *  set::Set<long>&
+ ******************************************************************************/
+set::Set<long>& SQLIndex::postings(code_type code) {
+    if(code == _postings.size()) {  // new value
+        _postings.emplace_back();
+        _order.insert(Key{&_dict.decode(code), code});
+    }
+
+    return _postings[code];
+}
+
+}  // namespace sql
@@ -96,6 +96,7 @@ bool SQLParser::parse_query(ParseTree &tree, QueueTokens &infix) {
     bool is_good = false;  // query's success
     int state = CMD_START;
     int key_code;
+    std::string aggregate;  // aggregate field label, ie: COUNT(*)
 
     token::Token t = next_token();  // get SQL Token from STokenizer
 
@@ -114,6 +115,15 @@ bool SQLParser::parse_query(ParseTree &tree, QueueTokens &infix) {
             }
         }
 
+        // build aggregate label from function, field and parentheses
+        if(state == SELECT_AGGR)
+            aggregate = t.string();
+        else if(state == SELECT_AGGR_FIELD) {
+            aggregate += "(" + t.string() + ")";
+            if(t.string() != "*") tree[_keys[KEY_A_FIELDS]] += t.string();
+        } else if(state == SELECT_AGGR_R_PAREN)
+            tree[_keys[KEY_FIELDS]] += aggregate;
+
         t = next_token();  // get next SQL Token
     }
 
@@ -168,6 +178,12 @@ void SQLParser::init_keys(ParseKey &keys) {
     keys[KEY_WHERE] = "WHERE";
     keys[KEY_TABLE] = "TABLE";
     keys[KEY_VALUES] = "VALUES";
+    keys[KEY_A_FIELDS] = "A_FIELDS";
+    keys[KEY_GROUP] = "GROUP";
+    keys[KEY_JOIN] = "JOIN";
+    keys[KEY_ON] = "ON";
+    keys[KEY_STORAGE] = "STORAGE";
+    keys[KEY_ALIAS] = "ALIAS";
 }
 
 /*******************************************************************************
@@ -198,6 +214,21 @@ void SQLParser::init_types(TokenType &types) {
     types[","] = COMMA;
     types["AND"] = L_OPS;
     types["OR"] = L_OPS;
+    types["COUNT"] = AGGREGATE;
+    types["SUM"] = AGGREGATE;
+    types["MIN"] = AGGREGATE;
+    types["MAX"] = AGGREGATE;
+    types["AVG"] = AGGREGATE;
+    types["("] = L_PAREN;
+    types[")"] = R_PAREN;
+    types["GROUP"] = GROUP;
+    types["BY"] = BY;
+    types["JOIN"] = JOIN;
+    types["ON"] = ON;
+    types["AS"] = AS;
+    types["COLUMNAR"] = COLUMNAR;
+
+    for(const auto &a : types) assert(a.key.size() <= MAX_KEYWORD);
 }
 
 /*******************************************************************************
@@ -280,7 +311,8 @@ void SQLParser::parse_token(token::Token &t) {
  * DESCRIPTION:
  *  Find if the string is a keyword. If found, set Token type to keyword ID and
  *  if L_OP type, also set subtype ID to distinguish what type of L_OP. If
- *  keyword is not found, set to generic IDENT id.
+ *  keyword is not found, set to generic IDENT id. The upper case token is
+ *  looked up as chars, and a token longer than any keyword is not looked up.
  *
  * PRE-CONDITIONS:
  *  token::Token &t: extracted token from SQL Tokenizer
@@ -293,12 +325,21 @@ void SQLParser::parse_token(token::Token &t) {
  *  void
  ******************************************************************************/
 void SQLParser::get_keyword(token::Token &t, int default_id) {
-    std::string cmp_str = t.string();
-    std::transform(cmp_str.begin(), cmp_str.end(), cmp_str.begin(), ::toupper);
+    const std::string str = t.string();
+    char upper[MAX_KEYWORD + 1];  // upper case probe key
+
+    if(str.size() > MAX_KEYWORD) {  // longer than any keyword
+        t.set_type(default_id);
+        return;
+    }
+
+    std::transform(str.begin(), str.end(), upper, ::toupper);
+    upper[str.size()] = '\0';
 
-    if(_types.contains(cmp_str)) {
-        t.set_string(cmp_str);
-        t.set_type(_types[cmp_str]);
+    auto it = _types.find(upper);  // probe with chars; no string built
+    if(it) {
+        t.set_string(upper);
+        t.set_type(it->value);
     } else
         t.set_type(default_id);
 }
@@ -319,9 +360,11 @@ void SQLParser::get_keyword(token::Token &t, int default_id) {
  *  void
  ******************************************************************************/
 void SQLParser::get_r_op_subtype(token::Token &t, int default_id) {
-    if(_subtypes.contains(t.string())) {
+    auto it = _subtypes.find(t.string());
+
+    if(it) {
         t.set_type(R_OPS);
-        t.set_sub_type(_subtypes[t.string()]);
+        t.set_sub_type(it->value);
     } else {
         t.set_type(default_id);
         t.set_sub_type(default_id);
@@ -373,6 +416,23 @@ bool SQLParser::get_parse_key(int state, int &key_code) {
         case SELECT_L_OPS:
             key_code = KEY_WHERE;
             break;
+        case SELECT_GROUP_FIELD:
+            key_code = KEY_GROUP;
+            break;
+        case CREATE_STORAGE:
+            key_code = KEY_STORAGE;
+            break;
+        case SELECT_JOIN_TABLE:
+            key_code = KEY_JOIN;
+            break;
+        case SELECT_JOIN_ALIAS:
+            key_code = KEY_ALIAS;
+            break;
+        case SELECT_ON_L_FIELD:
+        case SELECT_ON_OP:
+        case SELECT_ON_R_FIELD:
+            key_code = KEY_ON;
+            break;
         default:
             is_valid = false;
     }
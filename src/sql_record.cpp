@@ -2,9 +2,14 @@
 
 namespace sql {
 
+// bytes per block of the zone file: field count, min and max prefixes
+const std::streamsize ZONE_BYTES =
+    sizeof(std::size_t) + 2 * REC_ROW * ZONE_WIDTH;
+
 /*******************************************************************************
  * DESCRIPTION:
- *  Construct record with a char array of REC_SIZE.
+ *  Construct record. The char array of REC_SIZE is allocated on first
+ *  read/write.
  *
  * PRE-CONDITIONS:
  *  const std::string& fname: file name
@@ -15,13 +20,12 @@ namespace sql {
  * RETURN:
  *  none
  ******************************************************************************/
-SQLRecord::SQLRecord(const std::string& fname) : _data(nullptr), _fname(fname) {
-    _data = new char[REC_SIZE]();
-}
+SQLRecord::SQLRecord(const std::string& fname)
+    : _data(nullptr), _fname(fname), _zone_block(-1) {}
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Copy constructor.
+ *  Copy constructor. The I/O buffer is not copied.
  *
  * PRE-CONDITIONS:
  *  const SQLRecord& src: source object
@@ -33,14 +37,15 @@ SQLRecord::SQLRecord(const std::string& fname) : _data(nullptr), _fname(fname) {
  *  none
  ******************************************************************************/
 SQLRecord::SQLRecord(const SQLRecord& src)
-    : _data(nullptr), _fname(src._fname) {
-    _data = new char[REC_SIZE]();
-    std::memcpy(_data, src._data, REC_SIZE);
-}
+    : _data(nullptr),
+      _fname(src._fname),
+      _zone_block(src._zone_block),
+      _zone_min(src._zone_min),
+      _zone_max(src._zone_max) {}
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Assignment operator.
+ *  Assignment operator. The I/O buffer is kept, not copied.
  *
  * PRE-CONDITIONS:
  *  const SQLRecord& rhs: right hand side object
@@ -54,7 +59,57 @@ SQLRecord::SQLRecord(const SQLRecord& src)
 SQLRecord& SQLRecord::operator=(const SQLRecord& rhs) {
     if(this != &rhs) {
         _fname = rhs._fname;
-        std::memcpy(_data, rhs._data, REC_SIZE);
+        _zone_block = rhs._zone_block;
+        _zone_min = rhs._zone_min;
+        _zone_max = rhs._zone_max;
+    }
+    return *this;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Move constructor. Takes src's I/O buffer.
+ *
+ * PRE-CONDITIONS:
+ *  SQLRecord&& src: source object
+ *
+ * POST-CONDITIONS:
+ *  src has no I/O buffer
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+SQLRecord::SQLRecord(SQLRecord&& src)
+    : _data(src._data),
+      _fname(std::move(src._fname)),
+      _zone_block(src._zone_block),
+      _zone_min(std::move(src._zone_min)),
+      _zone_max(std::move(src._zone_max)) {
+    src._data = nullptr;
+    src._zone_block = -1;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Move assignment operator. Swaps I/O buffers with rhs.
+ *
+ * PRE-CONDITIONS:
+ *  SQLRecord&& rhs: right hand side object
+ *
+ * POST-CONDITIONS:
+ *  rhs has 'this' old I/O buffer
+ *
+ * RETURN:
+ *  SQLRecord&
+ ******************************************************************************/
+SQLRecord& SQLRecord::operator=(SQLRecord&& rhs) {
+    if(this != &rhs) {
+        std::swap(_data, rhs._data);
+        _fname = std::move(rhs._fname);
+        _zone_block = rhs._zone_block;
+        _zone_min = std::move(rhs._zone_min);
+        _zone_max = std::move(rhs._zone_max);
+        rhs._zone_block = -1;
     }
     return *this;
 }
@@ -87,7 +142,10 @@ SQLRecord::~SQLRecord() { delete[] _data; }
  * RETURN:
  *  none
  ******************************************************************************/
-void SQLRecord::set_fname(const std::string& fname) { _fname = fname; }
+void SQLRecord::set_fname(const std::string& fname) {
+    _fname = fname;
+    _zone_block = -1;
+}
 
 /*******************************************************************************
  * DESCRIPTION:
@@ -104,7 +162,109 @@ void SQLRecord::set_fname(const std::string& fname) { _fname = fname; }
  *  none
  ******************************************************************************/
 std::streamsize SQLRecord::read(std::vector<std::string>& v, long rpos) {
-    std::fstream file(_fname.c_str(), std::ios::in | std::ios::binary);
+    return read_file(_fname, v, rpos);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Write a record data of size REC_SIZE from vector data.
+ *
+ * PRE-CONDITIONS:
+ *  std::vector<std::string>& v: non-empty vector
+ *  long rpos                  : record position to seek
+ *
+ * POST-CONDITIONS:
+ *  Data written to file of REC_SIZE at rpos
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+long SQLRecord::write(const std::vector<std::string>& v, long rpos) {
+    return write_file(_fname, v, rpos);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Read the min/max value prefixes of each field for a block of
+ *  ZONE_RECORDS records.
+ *
+ * PRE-CONDITIONS:
+ *  long block                   : records [block * ZONE_RECORDS, next block)
+ *  std::vector<std::string>& min: empty vector
+ *  std::vector<std::string>& max: empty vector
+ *
+ * POST-CONDITIONS:
+ *  std::vector<std::string>& min: min value prefix per field
+ *  std::vector<std::string>& max: max value prefix per field
+ *
+ * RETURN:
+ *  bool: false if block has no zone
+ ******************************************************************************/
+bool SQLRecord::read_zone(long block, std::vector<std::string>& min,
+                          std::vector<std::string>& max) {
+    if(block == _zone_block) {
+        min = _zone_min;
+        max = _zone_max;
+        return true;
+    }
+
+    std::ifstream file((_fname + ".zone").c_str(), std::ios::binary);
+    std::size_t count = 0;  // fields in zone; 0 for a hole in the file
+    allocate();
+
+    file.seekg(block * ZONE_BYTES);
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if(!file.read(_data, ZONE_BYTES - sizeof(count)) || !count) return false;
+
+    for(std::size_t i = 0; i < count && i < REC_ROW; ++i) {
+        const char* lo = _data + i * ZONE_WIDTH;
+        const char* hi = lo + REC_ROW * ZONE_WIDTH;
+        min.emplace_back(lo, std::find(lo, lo + ZONE_WIDTH, '\0'));
+        max.emplace_back(hi, std::find(hi, hi + ZONE_WIDTH, '\0'));
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Remove zone file.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  zone file removed and cached zone cleared
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLRecord::remove_zones() {
+    std::remove((_fname + ".zone").c_str());
+    _zone_block = -1;
+    _zone_min.clear();
+    _zone_max.clear();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Read a record data of size REC_SIZE from a file.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& fname   : file name
+ *  std::vector<std::string>& v: empty vector
+ *  long rpos                  : record position to seek
+ *
+ * POST-CONDITIONS:
+ *  std::vector<std::string>& v: populated vector for size REC_ROW
+ *
+ * RETURN:
+ *  std::streamsize: bytes read
+ ******************************************************************************/
+std::streamsize SQLRecord::read_file(const std::string& fname,
+                                     std::vector<std::string>& v, long rpos) {
+    std::fstream file(fname.c_str(), std::ios::in | std::ios::binary);
+    allocate();
     file.seekg(rpos * REC_SIZE);
     file.read(_data, REC_SIZE);
     std::size_t size = file.gcount() / REC_COL;
@@ -116,9 +276,10 @@ std::streamsize SQLRecord::read(std::vector<std::string>& v, long rpos) {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Write a record data of size REC_SIZE from vector data.
+ *  Write a record data of size REC_SIZE from vector data to a file.
  *
  * PRE-CONDITIONS:
+ *  const std::string& fname   : existing file name
  *  std::vector<std::string>& v: non-empty vector
  *  long rpos                  : record position to seek
  *
@@ -128,18 +289,20 @@ std::streamsize SQLRecord::read(std::vector<std::string>& v, long rpos) {
  * RETURN:
  *  none
  ******************************************************************************/
-long SQLRecord::write(const std::vector<std::string>& v, long rpos) {
+long SQLRecord::write_file(const std::string& fname,
+                           const std::vector<std::string>& v, long rpos) {
     assert(v.size() <= REC_ROW);
     std::string value;
     std::size_t size = v.size();
     long original_pos;
+    allocate();
 
     for(std::size_t i = 0; i < size; ++i) {
         value = v[i].substr(0, REC_COL - 1);
         std::strncpy(_data + i * REC_COL, value.c_str(), REC_COL);
     }
 
-    std::fstream file(_fname.c_str(),
+    std::fstream file(fname.c_str(),
                       std::ios::in | std::ios::out | std::ios::binary);
 
     if(rpos < 0)
@@ -153,4 +316,108 @@ long SQLRecord::write(const std::vector<std::string>& v, long rpos) {
     return original_pos / REC_SIZE;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Widen the zone of a record's block with the prefixes of the record's
+ *  values and write the zone back when it changed. A block without a zone
+ *  gets one only from its first record.
+ *
+ * PRE-CONDITIONS:
+ *  const std::vector<std::string>& v: values written at rpos
+ *  long rpos                        : record position, greater than 0
+ *
+ * POST-CONDITIONS:
+ *  zone of rpos's block, if any, includes v
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLRecord::update_zone(const std::vector<std::string>& v, long rpos) {
+    long block = rpos / ZONE_RECORDS;
+    bool is_changed = false;
+    std::string value;
+
+    if(block != _zone_block) {  // cache zone of block
+        _zone_min.clear();
+        _zone_max.clear();
+        if(!read_zone(block, _zone_min, _zone_max)) {
+            _zone_min.clear();
+            _zone_max.clear();
+
+            // earlier records of block are not in a zone; leave it without
+            if(rpos != std::max(block * ZONE_RECORDS, 1L)) return;
+        }
+        _zone_block = block;
+    }
+
+    for(std::size_t i = 0; i < v.size() && i < REC_ROW; ++i) {
+        value = v[i].substr(0, ZONE_WIDTH);  // prefix kept in zone
+
+        if(i >= _zone_min.size()) {  // first value of field in zone
+            _zone_min.push_back(value);
+            _zone_max.push_back(value);
+            is_changed = true;
+        } else if(value < _zone_min[i]) {
+            _zone_min[i] = value;
+            is_changed = true;
+        } else if(value > _zone_max[i]) {
+            _zone_max[i] = value;
+            is_changed = true;
+        }
+    }
+
+    if(is_changed) write_zone(block);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Write the cached zone as a block of the zone file.
+ *
+ * PRE-CONDITIONS:
+ *  long block: block of cached zone
+ *
+ * POST-CONDITIONS:
+ *  zone file holds the cached zone at block
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLRecord::write_zone(long block) {
+    std::string fname = _fname + ".zone";
+    std::size_t count = _zone_min.size();
+    allocate();
+
+    std::memset(_data, 0, ZONE_BYTES - sizeof(count));
+    for(std::size_t i = 0; i < count; ++i) {
+        char* lo = _data + i * ZONE_WIDTH;
+        std::memcpy(lo, _zone_min[i].data(), _zone_min[i].size());
+        std::memcpy(lo + REC_ROW * ZONE_WIDTH, _zone_max[i].data(),
+                    _zone_max[i].size());
+    }
+
+    std::ofstream(fname.c_str(), std::ios::binary | std::ios::app).close();
+    std::fstream file(fname.c_str(),
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(block * ZONE_BYTES);
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(_data, ZONE_BYTES - sizeof(count));
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Allocate the I/O buffer of REC_SIZE if not yet allocated.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  _data allocated
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLRecord::allocate() {
+    if(!_data) _data = new char[REC_SIZE]();
+}
+
 }  // namespace sql
@@ -169,7 +169,7 @@ void mark_table_command(int _table[][MAX_COLS]) {
  *  CREATE command.
  *
  * PRE-CONDITIONS:
- *  REQUIRE ROWS: 6
+ *  REQUIRE ROWS: 7
  *  int _table[][MAX_COLS]: integer array
  *  int state             : CMD_CREATE
  *
@@ -187,12 +187,14 @@ void mark_table_create(int _table[][MAX_COLS]) {
     // state [+3] ---> fail
     // state [+4] ---> success
     // state [+5] ---> fail
+    // state [+6] ---> fail
     mark_fail(_table, CREATE_START);
     mark_fail(_table, CREATE_TABLE_KEY);
     mark_fail(_table, CREATE_TABLE);
     mark_fail(_table, CREATE_FIELDS_KEY);
     mark_success(_table, CREATE_FIELDS);
     mark_fail(_table, CREATE_COMMA);
+    mark_fail(_table, CREATE_STORAGE);
 
     // MARK CELLS
     // state [0] ---- CREATE ---> [+0] <-- COMMAND STATE
@@ -200,12 +202,16 @@ void mark_table_create(int _table[][MAX_COLS]) {
     // state [+1] --- IDENT ----> [+2]
     // state [+2] --- COMMA ----> [+3]
     // state [+3] --- IDENT ----> [+2]
+    // state [+0] --- COLUMNAR -> [+6]
+    // state [+6] --- TABLE ----> [+1]
     mark_cell(CREATE_START, _table, TABLE, CREATE_TABLE_KEY);
     mark_cell(CREATE_TABLE_KEY, _table, IDENT, CREATE_TABLE);
     mark_cell(CREATE_TABLE, _table, FIELDS, CREATE_FIELDS_KEY);
     mark_cell(CREATE_FIELDS_KEY, _table, IDENT, CREATE_FIELDS);
     mark_cell(CREATE_FIELDS, _table, COMMA, CREATE_COMMA);
     mark_cell(CREATE_COMMA, _table, IDENT, CREATE_FIELDS);
+    mark_cell(CREATE_START, _table, COLUMNAR, CREATE_STORAGE);
+    mark_cell(CREATE_STORAGE, _table, TABLE, CREATE_TABLE_KEY);
 }
 
 /*******************************************************************************
@@ -265,7 +271,7 @@ void mark_table_insert(int _table[][MAX_COLS]) {
  *  SELECT command.
  *
  * PRE-CONDITIONS:
- *  REQUIRE ROWS: 7
+ *  REQUIRE ROWS: 26
  *  int _table[][MAX_COLS]: integer array
  *  int state             : CMD_SELECT
  *
@@ -283,6 +289,26 @@ void mark_table_select(int _table[][MAX_COLS]) {
     // state [+3] ---> success
     // state [+4] ---> fail
     // state [+5] ---> fail
+    // state [+6] ---> fail
+    // state [+7] ---> fail
+    // state [+8] ---> fail
+    // state [+9] ---> success
+    // state [+10] --> fail
+    // state [+11] --> fail
+    // state [+12] --> fail
+    // state [+13] --> fail
+    // state [+14] --> fail
+    // state [+15] --> fail
+    // state [+16] --> fail
+    // state [+17] --> success
+    // state [+18] --> fail
+    // state [+19] --> fail
+    // state [+20] --> fail
+    // state [+21] --> fail
+    // state [+22] --> fail
+    // state [+23] --> success
+    // state [+24] --> fail
+    // state [+25] --> fail
     mark_fail(_table, SELECT_START);
     mark_fail(_table, SELECT_ASTERISK);
     mark_fail(_table, SELECT_FROM);
@@ -294,6 +320,21 @@ void mark_table_select(int _table[][MAX_COLS]) {
     mark_fail(_table, SELECT_R_OPS);
     mark_success(_table, SELECT_VALUE);
     mark_fail(_table, SELECT_L_OPS);
+    mark_fail(_table, SELECT_AGGR);
+    mark_fail(_table, SELECT_AGGR_L_PAREN);
+    mark_fail(_table, SELECT_AGGR_FIELD);
+    mark_fail(_table, SELECT_AGGR_R_PAREN);
+    mark_fail(_table, SELECT_GROUP);
+    mark_fail(_table, SELECT_GROUP_BY);
+    mark_success(_table, SELECT_GROUP_FIELD);
+    mark_fail(_table, SELECT_JOIN);
+    mark_fail(_table, SELECT_JOIN_TABLE);
+    mark_fail(_table, SELECT_ON);
+    mark_fail(_table, SELECT_ON_L_FIELD);
+    mark_fail(_table, SELECT_ON_OP);
+    mark_success(_table, SELECT_ON_R_FIELD);
+    mark_fail(_table, SELECT_JOIN_AS);
+    mark_fail(_table, SELECT_JOIN_ALIAS);
 
     // MARK CELLS
     // state [0] ---- SELECT ---> [+0] <-- COMMAND STATE
@@ -319,6 +360,58 @@ void mark_table_select(int _table[][MAX_COLS]) {
     mark_cell(SELECT_R_OPS, _table, VALUE, SELECT_VALUE);
     mark_cell(SELECT_VALUE, _table, L_OPS, SELECT_L_OPS);
     mark_cell(SELECT_L_OPS, _table, IDENT, SELECT_R_FIELDS);
+
+    // AGGREGATE FIELDS: COUNT(*), SUM(field), MIN(field), ...
+    // state [+0] --- AGGREGATE -> [+11]
+    // state [+5] --- AGGREGATE -> [+11]
+    // state [+11] -- L_PAREN --> [+12]
+    // state [+12] -- IDENT ----> [+13]
+    // state [+12] -- ASTERISK -> [+13]
+    // state [+13] -- R_PAREN --> [+14]
+    // state [+14] -- FROM -----> [+2]
+    // state [+14] -- COMMA ----> [+5]
+    mark_cell(SELECT_START, _table, AGGREGATE, SELECT_AGGR);
+    mark_cell(SELECT_COMMA, _table, AGGREGATE, SELECT_AGGR);
+    mark_cell(SELECT_AGGR, _table, L_PAREN, SELECT_AGGR_L_PAREN);
+    mark_cell(SELECT_AGGR_L_PAREN, _table, IDENT, SELECT_AGGR_FIELD);
+    mark_cell(SELECT_AGGR_L_PAREN, _table, ASTERISK, SELECT_AGGR_FIELD);
+    mark_cell(SELECT_AGGR_FIELD, _table, R_PAREN, SELECT_AGGR_R_PAREN);
+    mark_cell(SELECT_AGGR_R_PAREN, _table, FROM, SELECT_FROM);
+    mark_cell(SELECT_AGGR_R_PAREN, _table, COMMA, SELECT_COMMA);
+
+    // GROUP BY
+    // state [+3] --- GROUP ----> [+15]
+    // state [+9] --- GROUP ----> [+15]
+    // state [+15] -- BY -------> [+16]
+    // state [+16] -- IDENT ----> [+17]
+    mark_cell(SELECT_TABLE, _table, GROUP, SELECT_GROUP);
+    mark_cell(SELECT_VALUE, _table, GROUP, SELECT_GROUP);
+    mark_cell(SELECT_GROUP, _table, BY, SELECT_GROUP_BY);
+    mark_cell(SELECT_GROUP_BY, _table, IDENT, SELECT_GROUP_FIELD);
+
+    // JOIN table [AS alias] ON field = field
+    // state [+3] --- JOIN -----> [+18]
+    // state [+18] -- IDENT ----> [+19]
+    // state [+19] -- ON -------> [+20]
+    // state [+19] -- AS -------> [+24]
+    // state [+24] -- IDENT ----> [+25]
+    // state [+25] -- ON -------> [+20]
+    // state [+20] -- IDENT ----> [+21]
+    // state [+21] -- R_OPS ----> [+22]
+    // state [+22] -- IDENT ----> [+23]
+    // state [+23] -- WHERE ----> [+6]
+    // state [+23] -- GROUP ----> [+15]
+    mark_cell(SELECT_TABLE, _table, JOIN, SELECT_JOIN);
+    mark_cell(SELECT_JOIN, _table, IDENT, SELECT_JOIN_TABLE);
+    mark_cell(SELECT_JOIN_TABLE, _table, ON, SELECT_ON);
+    mark_cell(SELECT_JOIN_TABLE, _table, AS, SELECT_JOIN_AS);
+    mark_cell(SELECT_JOIN_AS, _table, IDENT, SELECT_JOIN_ALIAS);
+    mark_cell(SELECT_JOIN_ALIAS, _table, ON, SELECT_ON);
+    mark_cell(SELECT_ON, _table, IDENT, SELECT_ON_L_FIELD);
+    mark_cell(SELECT_ON_L_FIELD, _table, R_OPS, SELECT_ON_OP);
+    mark_cell(SELECT_ON_OP, _table, IDENT, SELECT_ON_R_FIELD);
+    mark_cell(SELECT_ON_R_FIELD, _table, WHERE, SELECT_WHERE);
+    mark_cell(SELECT_ON_R_FIELD, _table, GROUP, SELECT_GROUP);
 }
 
 /*******************************************************************************
@@ -2,13 +2,52 @@
 
 namespace sql {
 
+// STATIC VARIABLES
+std::size_t SQLTable::_join_memory_rows = SQLTable::JOIN_MEMORY_ROWS;
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the number of records of a hash join's build side that are held
+ *  in memory at a time. A larger build side is partitioned on disk.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::size_t
+ ******************************************************************************/
+std::size_t SQLTable::join_memory_rows() { return _join_memory_rows; }
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Sets the number of records of a hash join's build side that are held in
+ *  memory at a time.
+ *
+ * PRE-CONDITIONS:
+ *  std::size_t rows: records, at least 1
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::set_join_memory_rows(std::size_t rows) {
+    _join_memory_rows = rows ? rows : 1;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Constructor which attempts to open a file with the supplied table name.
- *  If file does not exist, create a new table file.
+ *  If file does not exist, create a new table file. A table opened without
+ *  indexes is scanned with its zone maps.
  *
  * PRE-CONDITIONS:
  *  const std::string& table_name: table name
+ *  bool is_indexed              : build IndexMaps of all fields
  *
  * POST-CONDITIONS:
  *  initializations
@@ -16,8 +55,10 @@ namespace sql {
  * RETURN:
  *  none
  ******************************************************************************/
-SQLTable::SQLTable(const std::string& table_name)
+SQLTable::SQLTable(const std::string& table_name, bool is_indexed)
     : _rec_count(0),
+      _storage(STORAGE_ROW),
+      _is_indexed(is_indexed),
       _table_name(table_name),
       _ext(".tbl"),
       _fname(_table_name + _ext),
@@ -38,6 +79,7 @@ SQLTable::SQLTable(const std::string& table_name)
         _table_name = old_name;
         _fname = _table_name + _ext;
         _record.set_fname(_fname);
+        _record.remove_zones();
         std::ofstream file(_fname.c_str(), std::ios::binary | std::ios::trunc);
         file.close();
     }
@@ -58,18 +100,45 @@ SQLTable::SQLTable(const std::string& table_name)
  *  none
  ******************************************************************************/
 SQLTable::SQLTable(const std::string& table_name,
-                   const std::vector<std::string>& fields)
+                   const std::vector<std::string>& fields, int storage,
+                   bool is_indexed)
     : _rec_count(0),
+      _storage(storage),
+      _is_indexed(is_indexed),
       _table_name(table_name),
       _ext(".tbl"),
       _fname(_table_name + _ext),
-      _record(_fname) {
+      _record(_fname),
+      _columns(_table_name, fields.size()) {
     std::ofstream file(_fname.c_str(), std::ios::binary | std::ios::trunc);
     file.close();
+    _record.remove_zones();
     _record.write(fields, _rec_count);
+
+    if(_storage == STORAGE_COLUMN)
+        _columns.create();
+    else  // remove stale column files of a table with same name
+        _columns.remove();
+
     init_table();
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if table is opened with a table file. A default constructed table
+ *  is not.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+bool SQLTable::is_open() const { return !_fname.empty(); }
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Returns the number of fields in table.
@@ -100,6 +169,21 @@ std::size_t SQLTable::field_count() const { return _pos_to_fields.size(); }
  ******************************************************************************/
 std::size_t SQLTable::size() const { return _rec_count; }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns table's storage type.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  int: STORAGE_ROW or STORAGE_COLUMN
+ ******************************************************************************/
+int SQLTable::storage() const { return _storage; }
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Explicit table deletion, which removes the associated table file and clears
@@ -116,6 +200,7 @@ std::size_t SQLTable::size() const { return _rec_count; }
  ******************************************************************************/
 void SQLTable::delete_table() {
     std::remove(_fname.c_str());
+    _record.remove_zones();
     _rec_count = 0;
     _map.clear();
     _pos_to_fields.clear();
@@ -123,6 +208,8 @@ void SQLTable::delete_table() {
     _table_name.clear();
     _fname.clear();
     _record.set_fname("");
+    _columns.remove();
+    _storage = STORAGE_ROW;
 }
 
 /*******************************************************************************
@@ -157,6 +244,28 @@ bool SQLTable::contains(const std::string& field_name) const {
  ******************************************************************************/
 const FieldMap& SQLTable::map() const { return _map; }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the field names in field position order.
+ *
+ * PRE-CONDITIONS:
+ *  none
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::vector<std::string>: field names
+ ******************************************************************************/
+std::vector<std::string> SQLTable::field_names() const {
+    std::vector<std::string> fields;
+    fields.reserve(_pos_to_fields.size());
+
+    for(auto const& a : _pos_to_fields) fields.push_back(a.value);
+
+    return fields;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Performs insertion of a vector of values into table.
@@ -173,14 +282,15 @@ const FieldMap& SQLTable::map() const { return _map; }
 bool SQLTable::insert(const std::vector<std::string>& values) {
     std::string field_name;
 
-    long pos = _record.write(values, _rec_count++);
+    long pos = write_record(values, _rec_count++);
 
     for(std::size_t i = 0; i < values.size(); ++i) {
         if(values[i].empty())  // if the next value is empty string, stop
             break;
         else {
             field_name = _pos_to_fields[i];
-            _map[field_name][values[i]] += pos;
+            if(_is_indexed || _map.contains(field_name))
+                _map[field_name][values[i]] += pos;
         }
     }
 
@@ -209,7 +319,9 @@ bool SQLTable::is_match_fields(const std::vector<std::string>& fields) {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Returns a new table with selected data.
+ *  Returns a new table with selected data. A table without IndexMaps is
+ *  scanned once with its zone maps, reading only the selected and WHERE
+ *  fields.
  *
  * PRE-CONDITIONS:
  *  const std::vector<std::string>& fields_list: fields list
@@ -224,33 +336,50 @@ bool SQLTable::is_match_fields(const std::vector<std::string>& fields) {
  ******************************************************************************/
 bool SQLTable::select(const std::vector<std::string>& fields_list,
                       QueueTokens& infix, SQLTable& new_table) {
-    QueueTokens postfix;              // postfix for WHERE condition
     set_ptr result;                   // final set result
     std::vector<std::string> fields;  // fields to copy to new_table
     std::vector<std::string> values;  // values read from record
+    std::vector<int> columns;         // field positions to read
     fields.reserve(REC_ROW);
     values.reserve(REC_ROW);
 
-    // get all fields (in order) from current table
-    for(auto const& a : _pos_to_fields) fields.push_back(a.value);
+    if(fields_list[0] == "*")  // get all fields (in order) from current table
+        for(auto const& a : _pos_to_fields) fields.push_back(a.value);
+    else  // get only the listed fields, once each
+        for(const auto& a : fields_list)
+            if(std::find(fields.begin(), fields.end(), a) == fields.end())
+                fields.push_back(a);
 
-    // copy all field labels to new table
+    for(const auto& a : fields) columns.push_back(_field_to_pos[a]);
+
+    // copy field labels to new table
     new_table.update_fields(fields);
 
-    if(!infix.empty()) {                   // if infix exist
-        infix_to_postfix(infix, postfix);  // convert infix to postfix
-        eval_postfix(postfix, result);     // eval postfix for final result set
+    if(!infix.empty() && !_is_indexed) {  // scan with zone maps
+        QueueTokens postfix;
+        infix_to_postfix(infix, postfix);
+
+        scan_postfix(postfix, columns,
+                     [&](long i, std::vector<std::string>& record) {
+                         (void)i;
+                         for(const auto& c : columns)
+                             values.push_back(std::move(record[c]));
+                         new_table.insert(values);
+                         values.clear();
+                     });
+    } else if(!infix.empty()) {     // if infix exist
+        eval_where(infix, result);  // eval infix for final result set
 
         // add records only in result set to new table
         for(const auto& i : *result) {
-            if(i > 0 && _record.read(values, i)) {  // skip i == 0 b/c
-                new_table.insert(values);           // b/c 0 represent empty set
+            if(i > 0 && read_record(values, i, columns)) {  // skip i == 0
+                new_table.insert(values);  // b/c 0 represent empty set
                 values.clear();
             }
         }
     } else {                                    // if no infix
         for(long i = 1; i < _rec_count; ++i) {  // add all records to new table
-            if(_record.read(values, i)) {
+            if(read_record(values, i, columns)) {
                 new_table.insert(values);
                 values.clear();
             }
@@ -263,6 +392,141 @@ bool SQLTable::select(const std::vector<std::string>& fields_list,
     return true;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns a new table with one row of aggregated values per group. Without
+ *  GROUP BY, all selected records are one group. Group rows are in the order
+ *  of the group field's IndexMap.
+ *
+ * PRE-CONDITIONS:
+ *  const std::vector<std::string>& fields_list: group field and aggregate
+ *                                               labels, ie: "COUNT(*)"
+ *  const std::string& group_field             : GROUP BY field or empty
+ *  QueueTokens& infix                         : queue of SQLTokens
+ *  SQLTable& new_table                        : new table
+ *
+ * POST-CONDITIONS:
+ *  SQLTable& new_table: old table deleted and populated with new data
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+bool SQLTable::aggregate(const std::vector<std::string>& fields_list,
+                         const std::string& group_field, QueueTokens& infix,
+                         SQLTable& new_table) {
+    set_ptr result;                   // WHERE result; nullptr for all records
+    std::vector<std::string> values;  // aggregated values for one group
+    values.reserve(fields_list.size());
+
+    // copy all labels to new table
+    new_table.update_fields(fields_list);
+
+    if(!infix.empty()) eval_where(infix, result);  // eval WHERE result set
+
+    if(group_field.empty()) {  // all selected records are one group
+        for(const auto& label : fields_list)
+            values.push_back(aggregate_value(label, result.get()));
+        new_table.insert(values);
+    } else {
+        if(!_map.contains(group_field)) index_field(group_field);
+
+        for(const auto& group : _map[group_field]) {
+            set::Set<long> rows;  // group's records in WHERE result
+            const set::Set<long>* group_rows = &group.value;
+
+            if(result) {  // intersect by walking the smaller set
+                if(result->size() < group.value.size())
+                    group.value.intersect(*result, rows);
+                else
+                    result->intersect(group.value, rows);
+
+                if(rows.empty()) continue;  // no records for group
+                group_rows = &rows;
+            }
+
+            values.clear();
+            for(const auto& label : fields_list) {
+                if(label == group_field)
+                    values.push_back(group.key);
+                else
+                    values.push_back(aggregate_value(label, group_rows));
+            }
+            new_table.insert(values);
+        }
+    }
+
+    // print all records in new table
+    new_table.print(fields_list);
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts every pair of records where this table's field value equals the
+ *  other table's field value into the new table. Each new record is this
+ *  table's values followed by the other table's values. Empty values never
+ *  match. Uses an index nested loop join or a hash join, as picked by
+ *  plan_join(). other may be this table.
+ *
+ * PRE-CONDITIONS:
+ *  SQLTable& other               : table to join with
+ *  const std::string& field      : this table's join field
+ *  const std::string& other_field: other table's join field
+ *  SQLTable& new_table           : table with this table's fields followed
+ *                                  by other table's fields
+ *
+ * POST-CONDITIONS:
+ *  SQLTable& new_table: populated with joined records
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+bool SQLTable::join(SQLTable& other, const std::string& field,
+                    const std::string& other_field, SQLTable& new_table) {
+    if(!contains(field) || !other.contains(other_field)) return false;
+
+    if(plan_join(other, other_field) == JOIN_INDEX)
+        index_join(other, field, other_field, new_table);
+    else
+        hash_join(other, field, other_field, new_table);
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Picks the join method for joining the other table. Both methods read
+ *  this table once. An index join looks up each record in the other table's
+ *  IndexMap, while a hash join reads the other table's join column once and
+ *  looks up each record in a hash. So the index join is used when it is
+ *  available, unless this table has more records than the other table and
+ *  the other table's hash fits in memory without spilling.
+ *
+ * PRE-CONDITIONS:
+ *  const SQLTable& other         : table to join with
+ *  const std::string& other_field: other table's join field
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  int: JOIN_INDEX or JOIN_HASH
+ ******************************************************************************/
+int SQLTable::plan_join(const SQLTable& other,
+                        const std::string& other_field) const {
+    long rows = _rec_count > 0 ? _rec_count - 1 : 0;
+    long other_rows = other._rec_count > 0 ? other._rec_count - 1 : 0;
+
+    if(!other._map.contains(other_field)) return JOIN_HASH;
+
+    if(rows > other_rows &&
+       static_cast<std::size_t>(other_rows) <= _join_memory_rows)
+        return JOIN_HASH;
+
+    return JOIN_INDEX;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Return by ref a set of records of specified conditions.
@@ -280,7 +544,10 @@ bool SQLTable::select(const std::vector<std::string>& fields_list,
  ******************************************************************************/
 void SQLTable::make_equal_set(const std::string& field,
                               const std::string& value, set_ptr& result) {
-    if(_map[field].contains(value)) *result += _map[field][value];
+    IndexMap& index = _map[field];
+    auto it = index.find(value);
+
+    if(it != index.end()) *result += it->value;
 }
 
 /*******************************************************************************
@@ -300,8 +567,9 @@ void SQLTable::make_equal_set(const std::string& field,
  ******************************************************************************/
 void SQLTable::make_less_set(const std::string& field, const std::string& value,
                              set_ptr& result) {
-    auto low = _map[field].lower_bound(value);
-    auto beg = _map[field].begin();
+    IndexMap& index = _map[field];
+    auto low = index.lower_bound(value);
+    auto beg = index.begin();
 
     while(beg != low) {
         *result += beg->value;
@@ -326,8 +594,9 @@ void SQLTable::make_less_set(const std::string& field, const std::string& value,
  ******************************************************************************/
 void SQLTable::make_less_eq_set(const std::string& field,
                                 const std::string& value, set_ptr& result) {
-    auto upp = _map[field].upper_bound(value);
-    auto beg = _map[field].begin();
+    IndexMap& index = _map[field];
+    auto upp = index.upper_bound(value);
+    auto beg = index.begin();
 
     while(beg != upp) {
         *result += beg->value;
@@ -352,8 +621,9 @@ void SQLTable::make_less_eq_set(const std::string& field,
  ******************************************************************************/
 void SQLTable::make_greater_set(const std::string& field,
                                 const std::string& value, set_ptr& result) {
-    auto upp = _map[field].upper_bound(value);
-    auto end = _map[field].end();
+    IndexMap& index = _map[field];
+    auto upp = index.upper_bound(value);
+    auto end = index.end();
 
     while(upp != end) {
         *result += upp->value;
@@ -378,8 +648,9 @@ void SQLTable::make_greater_set(const std::string& field,
  ******************************************************************************/
 void SQLTable::make_greater_eq_set(const std::string& field,
                                    const std::string& value, set_ptr& result) {
-    auto low = _map[field].lower_bound(value);
-    auto end = _map[field].end();
+    IndexMap& index = _map[field];
+    auto low = index.lower_bound(value);
+    auto end = index.end();
 
     while(low != end) {
         *result += low->value;
@@ -447,7 +718,7 @@ void SQLTable::print_rec(long rec_pos,
 
     std::cout.setf(std::ios::left);
 
-    if(_record.read(values, rec_pos)) {
+    if(read_record(values, rec_pos)) {
         for(std::size_t i = 0; i < size; ++i) {
             field_name = field_names[i];
             field_pos = _field_to_pos[field_name];
@@ -502,6 +773,7 @@ void SQLTable::print_header(const std::vector<std::string>& field_names,
  ******************************************************************************/
 void SQLTable::init_table() {
     init_fields();
+    init_storage();
     init_data();
 }
 
@@ -556,9 +828,9 @@ void SQLTable::init_data() {
     assert(values.size() <= size);
 
     // keep reading until record returns 0
-    while(_record.read(values, _rec_count)) {  // read record to vector
+    while(read_record(values, _rec_count)) {  // read record to vector
         // populate table; ie: _map["lName"]["Gates"] += 1;
-        for(std::size_t i = 0; i < size; ++i)
+        for(std::size_t i = 0; i < size && _is_indexed; ++i)
             _map[_pos_to_fields[i]][std::move(values.at(i))] += _rec_count;
 
         values.clear();
@@ -566,6 +838,113 @@ void SQLTable::init_data() {
     }
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Initialize column files for the table's fields. The table is column
+ *  stored when its column files exist; they are then kept open until the
+ *  table is destroyed.
+ *
+ * PRE-CONDITIONS:
+ *  FieldPosMap _pos_to_fields: initialized
+ *
+ * POST-CONDITIONS:
+ *  int _storage: STORAGE_ROW or STORAGE_COLUMN
+ *  _columns    : open for STORAGE_COLUMN
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::init_storage() {
+    _columns = SQLColumns(_table_name, _pos_to_fields.size());
+    _storage = _columns.exists() ? STORAGE_COLUMN : STORAGE_ROW;
+
+    if(_storage == STORAGE_COLUMN) _columns.open();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Read all values of a record from the table's storage. Record 0 (field
+ *  labels) is always in the table file.
+ *
+ * PRE-CONDITIONS:
+ *  std::vector<std::string>& values: empty vector
+ *  long pos                        : record position
+ *
+ * POST-CONDITIONS:
+ *  std::vector<std::string>& values: record values
+ *
+ * RETURN:
+ *  std::streamsize: bytes read; 0 when record does not exist
+ ******************************************************************************/
+std::streamsize SQLTable::read_record(std::vector<std::string>& values,
+                                      long pos) {
+    if(_storage == STORAGE_COLUMN && pos > 0)
+        return _columns.read(values, pos);
+    else
+        return _record.read(values, pos);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Read only the given field positions of a record. Column storage reads
+ *  only those columns' files.
+ *
+ * PRE-CONDITIONS:
+ *  std::vector<std::string>& values: empty vector
+ *  long pos                        : record position
+ *  const std::vector<int>& columns : field positions to read
+ *
+ * POST-CONDITIONS:
+ *  std::vector<std::string>& values: values in order of columns
+ *
+ * RETURN:
+ *  std::streamsize: bytes read; 0 when record does not exist
+ ******************************************************************************/
+std::streamsize SQLTable::read_record(std::vector<std::string>& values,
+                                      long pos,
+                                      const std::vector<int>& columns) {
+    if(_storage == STORAGE_COLUMN && pos > 0)
+        return _columns.read(values, pos, columns);
+
+    std::vector<std::string> record;  // whole record from table file
+    record.reserve(REC_ROW);
+
+    std::streamsize count = _record.read(record, pos);
+    if(count)
+        for(const auto& i : columns) values.push_back(std::move(record[i]));
+
+    return count;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Write a record's values to the table's storage. A table without
+ *  IndexMaps is scanned, so it also widens the zone of the record's block.
+ *  A column stored table always does, so it can be opened without indexes
+ *  and still be scanned with complete zones.
+ *
+ * PRE-CONDITIONS:
+ *  const std::vector<std::string>& values: values in field order
+ *  long pos                              : record position
+ *
+ * POST-CONDITIONS:
+ *  record written at pos; zone updated when not indexed or column stored
+ *
+ * RETURN:
+ *  long: record position
+ ******************************************************************************/
+long SQLTable::write_record(const std::vector<std::string>& values, long pos) {
+    if(_storage == STORAGE_COLUMN && pos > 0)
+        pos = _columns.write(values, pos);
+    else
+        pos = _record.write(values, pos);
+
+    if((!_is_indexed || _storage == STORAGE_COLUMN) && pos > 0)
+        _record.update_zone(values, pos);
+
+    return pos;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Convert infix expression to postfix expression.
@@ -690,23 +1069,788 @@ void SQLTable::eval_postfix(QueueTokens& postfix, set_ptr& result_set) {
 
 /*******************************************************************************
  * DESCRIPTION:
- *  Update field labels and position information.
+ *  Evaluate WHERE infix expression to record positions. Uses the IndexMaps
+ *  when the table is indexed; else scans the records with zone maps.
  *
  * PRE-CONDITIONS:
- *  const std::vector<std::string>& fields: list of fields
+ *  QueueTokens& infix : Queue of SQL Tokens from parse tree with infix order
+ *  set_ptr& result_set: empty set
  *
  * POST-CONDITIONS:
- *  field maps are cleared and updated to with new field list
+ *  QueueTokens& infix : empty
+ *  set_ptr& result_set: set with record positions (may be emtpy set)
  *
  * RETURN:
  *  none
  ******************************************************************************/
-void SQLTable::update_fields(const std::vector<std::string>& fields) {
-    _record.write(fields, 0);
+void SQLTable::eval_where(QueueTokens& infix, set_ptr& result_set) {
+    QueueTokens postfix;  // postfix for WHERE condition
+
+    infix_to_postfix(infix, postfix);
+
+    if(_is_indexed)
+        eval_postfix(postfix, result_set);
+    else {
+        result_set = std::make_shared<set::Set<long>>();
+        scan_postfix(postfix, std::vector<int>(),
+                     [&](long i, std::vector<std::string>& record) {
+                         (void)record;
+                         *result_set += i;
+                     });
+    }
+}
 
-    _pos_to_fields.clear();
-    _field_to_pos.clear();
-    init_fields();
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Evaluate postfix expression by reading the records block by block. A
+ *  block is skipped without reading its records when its zone map shows
+ *  that no record can match. Only the WHERE fields and the given columns
+ *  are read, which column storage reads from their own files.
+ *
+ * PRE-CONDITIONS:
+ *  QueueTokens& postfix    : Queue of SQL Tokens with postfix order
+ *  std::vector<int> columns: field positions to read for visit
+ *  const RecordVisit& visit: called with each matching record
+ *
+ * POST-CONDITIONS:
+ *  QueueTokens& postfix: empty
+ *  visit called in record order with the record's position and its values
+ *  by field position; only the WHERE fields and columns are read
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::scan_postfix(QueueTokens& postfix, std::vector<int> columns,
+                            const RecordVisit& visit) {
+    std::vector<Term> terms;            // postfix terms
+    std::vector<std::string> values;    // values read, in order of columns
+    std::vector<std::string> record;    // values read, by field position
+    std::vector<std::string> min, max;  // zone of block
+    std::string field;                  // field of relational term
+    long blocks = _rec_count / ZONE_RECORDS + 1;
+    values.reserve(REC_ROW);
+    record.resize(field_count());
+
+    while(!postfix.empty()) {  // operands are field, value pairs
+        auto t = postfix.pop();
+
+        if(t->type() < 0 && field.empty())
+            field = t->string();
+        else if(t->type() < 0) {
+            terms.push_back(Term{-1, _field_to_pos[field], t->string()});
+            columns.push_back(terms.back().pos);
+        } else if(t->subtype() == TOKEN_OP_OR || t->subtype() == TOKEN_OP_AND)
+            terms.push_back(Term{t->subtype(), -1, ""});
+        else {
+            terms.back().op = t->subtype();
+            field.clear();
+        }
+    }
+
+    std::sort(columns.begin(), columns.end());
+    columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+    TermTest zone_test = [&](const Term& t) {
+        return is_zone_match(min[t.pos], max[t.pos], t);
+    };
+    TermTest record_test = [&](const Term& t) {
+        return is_term_match(record[t.pos], t);
+    };
+
+    for(long block = 0; block < blocks; ++block) {
+        min.clear();
+        max.clear();
+        if(_record.read_zone(block, min, max) && !eval_terms(terms, zone_test))
+            continue;  // no record in block can match
+
+        long first = std::max(block * ZONE_RECORDS, 1L);
+        long last = std::min((block + 1) * ZONE_RECORDS, _rec_count);
+
+        for(long i = first; i < last; ++i) {
+            values.clear();
+            if(!read_record(values, i, columns)) continue;
+
+            for(std::size_t j = 0; j < columns.size(); ++j)
+                record[columns[j]] = std::move(values[j]);
+
+            if(eval_terms(terms, record_test)) visit(i, record);
+        }
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Evaluate postfix terms, using test for relational terms.
+ *
+ * PRE-CONDITIONS:
+ *  const std::vector<Term>& terms: postfix terms
+ *  const TermTest& test          : result of a relational term
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+bool SQLTable::eval_terms(const std::vector<Term>& terms,
+                          const TermTest& test) {
+    std::vector<bool> operands;  // results of terms
+    bool first, second;
+
+    for(const auto& t : terms) {
+        if(t.op == TOKEN_OP_OR || t.op == TOKEN_OP_AND) {
+            second = operands.back();
+            operands.pop_back();
+            first = operands.back();
+            operands.pop_back();
+
+            if(t.op == TOKEN_OP_OR)
+                operands.push_back(first || second);
+            else
+                operands.push_back(first && second);
+        } else
+            operands.push_back(test(t));
+    }
+
+    return !operands.empty() && operands.back();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if a field value matches a relational term. Compares as strings,
+ *  like the IndexMap order.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& value: record's field value
+ *  const Term& term        : relational term
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+bool SQLTable::is_term_match(const std::string& value,
+                             const Term& term) const {
+    switch(term.op) {
+        case TOKEN_R_EQ:
+            return value == term.value;
+        case TOKEN_R_L:
+            return value < term.value;
+        case TOKEN_R_LEQ:
+            return value <= term.value;
+        case TOKEN_R_G:
+            return value > term.value;
+        case TOKEN_R_GEQ:
+            return value >= term.value;
+        default:
+            return false;
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if any value of a zone can match a relational term. The zone
+ *  holds prefixes of ZONE_WIDTH characters: min is at most the smallest
+ *  value and max is the largest value's prefix, so the term's value is
+ *  compared by its prefix against max.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& min: zone's min value prefix of field
+ *  const std::string& max: zone's max value prefix of field
+ *  const Term& term      : relational term
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+bool SQLTable::is_zone_match(const std::string& min, const std::string& max,
+                             const Term& term) const {
+    // a value > or = term's value has a prefix >= the value's prefix
+    bool is_max_ge = term.value.compare(0, ZONE_WIDTH, max) <= 0;
+
+    switch(term.op) {
+        case TOKEN_R_EQ:
+            return min <= term.value && is_max_ge;
+        case TOKEN_R_L:
+            return min < term.value;
+        case TOKEN_R_LEQ:
+            return min <= term.value;
+        case TOKEN_R_G:
+        case TOKEN_R_GEQ:
+            return is_max_ge;
+        default:
+            return true;
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Build the IndexMap of one field by reading its column.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& field: field name
+ *
+ * POST-CONDITIONS:
+ *  FieldMap _map: field's IndexMap populated
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::index_field(const std::string& field) {
+    IndexMap& index = _map[field];
+    std::vector<int> columns(1, _field_to_pos[field]);
+    std::vector<std::string> values;  // field value read from record
+
+    for(long i = 1; i < _rec_count; ++i) {
+        values.clear();
+        if(read_record(values, i, columns)) index[values[0]] += i;
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Update field labels and position information.
+ *
+ * PRE-CONDITIONS:
+ *  const std::vector<std::string>& fields: list of fields
+ *
+ * POST-CONDITIONS:
+ *  field maps are cleared and updated to with new field list
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::update_fields(const std::vector<std::string>& fields) {
+    _record.write(fields, 0);
+
+    _pos_to_fields.clear();
+    _field_to_pos.clear();
+    init_fields();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the aggregated value of a label such as "SUM(salary)" for a set
+ *  of records. Without a record set, the value is computed from the field's
+ *  IndexMap: each key is accumulated as many times as its posting set size,
+ *  without reading the table file. With a record set, COUNT(*) is the set
+ *  size and other functions read the field's column for the set's records.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& label   : FUNC(field) or COUNT(*)
+ *  const set::Set<long>* rows : record positions or nullptr for all records
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::string: aggregated value
+ ******************************************************************************/
+std::string SQLTable::aggregate_value(const std::string& label,
+                                      const set::Set<long>* rows) {
+    std::size_t open = label.find('(');
+    std::string func = label.substr(0, open);
+    std::string field = label.substr(open + 1, label.size() - open - 2);
+    std::vector<std::string> values;  // values read from record
+    Aggregate agg;
+    values.reserve(REC_ROW);
+
+    if(field == "*")  // only COUNT(*) passes SQL's validation
+        return std::to_string(rows ? rows->size() : _rec_count - 1);
+
+    if(!rows && _map.contains(field)) {  // from index keys and posting sizes
+        for(const auto& a : _map[field]) accumulate(agg, a.key, a.value.size());
+    } else if(!rows) {  // read field's column for all records
+        std::vector<int> columns(1, _field_to_pos[field]);
+
+        for(long i = 1; i < _rec_count; ++i) {
+            if(read_record(values, i, columns)) {
+                accumulate(agg, values[0]);
+                values.clear();
+            }
+        }
+    } else {  // read field's column for the records in rows
+        std::vector<int> columns(1, _field_to_pos[field]);
+
+        for(const auto& i : *rows) {
+            if(i > 0 && read_record(values, i, columns)) {
+                accumulate(agg, values[0]);
+                values.clear();
+            }
+        }
+    }
+
+    return aggregate_result(func, agg);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Accumulate a value, n number of times, into the aggregate state. Empty
+ *  values are skipped. Non-numeric values are counted and compared for MIN
+ *  and MAX but are excluded from SUM and AVG.
+ *
+ * PRE-CONDITIONS:
+ *  Aggregate& agg          : aggregate state
+ *  const std::string& value: field value
+ *  std::size_t n           : number of records with value
+ *
+ * POST-CONDITIONS:
+ *  Aggregate& agg: updated with value
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::accumulate(Aggregate& agg, const std::string& value,
+                          std::size_t n) {
+    double number = 0;
+
+    if(value.empty() || !n) return;
+
+    if(!agg.count || is_value_less(value, agg.min)) agg.min = value;
+    if(!agg.count || is_value_less(agg.max, value)) agg.max = value;
+    agg.count += n;
+
+    if(is_numeric(value, number)) {
+        agg.numbers += n;
+        agg.sum += number * n;
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Returns the result of the aggregate function from aggregate state.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& func: COUNT, SUM, MIN, MAX or AVG
+ *  const Aggregate& agg   : aggregate state
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::string: empty when there are no values to aggregate
+ ******************************************************************************/
+std::string SQLTable::aggregate_result(const std::string& func,
+                                       const Aggregate& agg) {
+    if(func == "COUNT")
+        return std::to_string(agg.count);
+    else if(func == "MIN")
+        return agg.min;
+    else if(func == "MAX")
+        return agg.max;
+    else if(func == "SUM")
+        return agg.numbers ? format_number(agg.sum) : "";
+    else if(func == "AVG")
+        return agg.numbers ? format_number(agg.sum / agg.numbers) : "";
+    else
+        return "";
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Checks if the entire string is a number and return the number by ref.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& str: string to convert
+ *  double& number        : number holder
+ *
+ * POST-CONDITIONS:
+ *  double& number: converted number if string is numeric
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+bool SQLTable::is_numeric(const std::string& str, double& number) const {
+    char* end = nullptr;
+
+    if(str.empty()) return false;
+
+    number = std::strtod(str.c_str(), &end);
+
+    return end == str.c_str() + str.size();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Compares two values by number when both are numeric; else by string.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& lhs: left hand side value
+ *  const std::string& rhs: right hand side value
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  bool
+ ******************************************************************************/
+bool SQLTable::is_value_less(const std::string& lhs,
+                             const std::string& rhs) const {
+    double l = 0, r = 0;
+
+    if(is_numeric(lhs, l) && is_numeric(rhs, r))
+        return l < r;
+    else
+        return lhs < rhs;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Format number without trailing zeros.
+ *
+ * PRE-CONDITIONS:
+ *  double number: number to format
+ *
+ * POST-CONDITIONS:
+ *  none
+ *
+ * RETURN:
+ *  std::string
+ ******************************************************************************/
+std::string SQLTable::format_number(double number) const {
+    std::ostringstream outs;
+    outs << std::setprecision(15) << number;
+
+    return outs.str();
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Index nested loop join. Reads each record of this table once and probes
+ *  the other table's IndexMap with its join value; the matching records of
+ *  the other table are read by record position.
+ *
+ * PRE-CONDITIONS:
+ *  SQLTable& other               : table with IndexMap for other_field
+ *  const std::string& field      : this table's join field
+ *  const std::string& other_field: other table's join field
+ *  SQLTable& new_table           : joined table
+ *
+ * POST-CONDITIONS:
+ *  SQLTable& new_table: populated with joined records
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::index_join(SQLTable& other, const std::string& field,
+                          const std::string& other_field,
+                          SQLTable& new_table) {
+    IndexMap& index = other._map[other_field];
+    std::vector<int> column(1, _field_to_pos[field]);  // join field only
+    std::string key;                  // join value read from record
+    std::vector<std::string> values;  // values read from record
+    values.reserve(REC_ROW);
+
+    for(long i = 1; i < _rec_count; ++i) {
+        values.clear();
+        if(!read_join_value(i, column, values, key) || key.empty()) continue;
+
+        if(!index.contains(key)) continue;
+
+        if(values.empty() && !read_record(values, i)) continue;
+
+        for(const auto& j : index[key])
+            join_records(values, other, j, new_table);
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Read the join value of a record. Row storage reads the whole record once
+ *  and keeps it in values, so a matching record is not read again. Column
+ *  storage reads only the join column and leaves values empty.
+ *
+ * PRE-CONDITIONS:
+ *  long pos                        : record position
+ *  const std::vector<int>& column  : join field position
+ *  std::vector<std::string>& values: empty vector
+ *  std::string& key                : join value by ref
+ *
+ * POST-CONDITIONS:
+ *  std::vector<std::string>& values: record values; empty for column storage
+ *  std::string& key                : join value
+ *
+ * RETURN:
+ *  bool: false when record does not exist
+ ******************************************************************************/
+bool SQLTable::read_join_value(long pos, const std::vector<int>& column,
+                               std::vector<std::string>& values,
+                               std::string& key) {
+    if(_storage == STORAGE_COLUMN) {
+        if(!read_record(values, pos, column)) return false;
+
+        key = std::move(values[0]);
+        values.clear();
+    } else {
+        if(!read_record(values, pos)) return false;
+
+        key = values[column[0]];
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Hash join. The other table is the build side: its join values are hashed
+ *  to record positions, then this table's records probe the hash. When the
+ *  other table has more than join_memory_rows() records, both tables' join
+ *  values are spilled to partition files by hash first and each partition
+ *  pair is joined in turn, so memory is bounded by one partition.
+ *
+ * PRE-CONDITIONS:
+ *  SQLTable& other               : table to join with
+ *  const std::string& field      : this table's join field
+ *  const std::string& other_field: other table's join field
+ *  SQLTable& new_table           : joined table
+ *
+ * POST-CONDITIONS:
+ *  SQLTable& new_table: populated with joined records
+ *  partition files removed
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::hash_join(SQLTable& other, const std::string& field,
+                         const std::string& other_field, SQLTable& new_table) {
+    std::size_t rows = other._rec_count > 0 ? other._rec_count - 1 : 0;
+    std::size_t count = (rows + _join_memory_rows - 1) / _join_memory_rows;
+    std::vector<std::string> parts, other_parts;  // partition file names
+    std::string key;
+    long pos;
+    JoinHash hash;
+
+    if(count <= 1) {  // build side fits in memory; no partition files
+        other.hash_build(other_field, hash);
+        hash_probe(other, hash, field, new_table);
+        return;
+    }
+
+    // distinct names, so a table can be partitioned on both sides
+    partition(field, count, ".probe", parts);
+    other.partition(other_field, count, ".build", other_parts);
+
+    for(std::size_t p = 0; p < count; ++p) {
+        std::ifstream other_part(other_parts[p].c_str(), std::ios::binary);
+        while(read_partition(other_part, key, pos)) hash[key].push_back(pos);
+        other_part.close();
+
+        std::ifstream part(parts[p].c_str(), std::ios::binary);
+        hash_probe(other, hash, part, new_table);
+        part.close();
+
+        hash.clear();
+        std::remove(parts[p].c_str());
+        std::remove(other_parts[p].c_str());
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Hashes the non-empty values of a field to their record positions.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& field: field to hash
+ *  JoinHash& hash          : empty hash
+ *
+ * POST-CONDITIONS:
+ *  JoinHash& hash: field values to record positions
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::hash_build(const std::string& field, JoinHash& hash) {
+    std::vector<int> column(1, _field_to_pos[field]);  // join field only
+    std::vector<std::string> key;  // join value read from record
+
+    for(long i = 1; i < _rec_count; ++i) {
+        key.clear();
+        if(read_record(key, i, column) && !key[0].empty())
+            hash[key[0]].push_back(i);
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Probes the hash of the other table with the join value of every record
+ *  of this table and inserts the matching records into new table.
+ *
+ * PRE-CONDITIONS:
+ *  SQLTable& other         : build side table
+ *  const JoinHash& hash    : other table's join values to record positions
+ *  const std::string& field: this table's join field
+ *  SQLTable& new_table     : joined table
+ *
+ * POST-CONDITIONS:
+ *  SQLTable& new_table: populated with joined records
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::hash_probe(SQLTable& other, const JoinHash& hash,
+                          const std::string& field, SQLTable& new_table) {
+    std::vector<int> column(1, _field_to_pos[field]);  // join field only
+    std::string key;                  // join value read from record
+    std::vector<std::string> values;  // values read from record
+    values.reserve(REC_ROW);
+
+    for(long i = 1; i < _rec_count; ++i) {
+        values.clear();
+        if(!read_join_value(i, column, values, key) || key.empty()) continue;
+
+        auto it = hash.find(key);
+        if(it == hash.end()) continue;
+
+        if(values.empty() && !read_record(values, i)) continue;
+
+        for(const auto& j : it->second)
+            join_records(values, other, j, new_table);
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Probes the hash of the other table with every join value of this
+ *  table's partition and inserts the matching records into new table.
+ *
+ * PRE-CONDITIONS:
+ *  SQLTable& other      : build side table
+ *  const JoinHash& hash : other table's join values to record positions
+ *  std::istream& part   : this table's partition file
+ *  SQLTable& new_table  : joined table
+ *
+ * POST-CONDITIONS:
+ *  SQLTable& new_table: populated with joined records
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::hash_probe(SQLTable& other, const JoinHash& hash,
+                          std::istream& part, SQLTable& new_table) {
+    std::string key;
+    long pos;
+    std::vector<std::string> values;  // values read from record
+    values.reserve(REC_ROW);
+
+    while(read_partition(part, key, pos)) {
+        auto it = hash.find(key);
+        if(it == hash.end()) continue;
+
+        values.clear();
+        if(!read_record(values, pos)) continue;
+
+        for(const auto& j : it->second)
+            join_records(values, other, j, new_table);
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Inserts this table's values followed by the values of the other table's
+ *  record into new table.
+ *
+ * PRE-CONDITIONS:
+ *  const std::vector<std::string>& values: this table's record values
+ *  SQLTable& other                       : table to join with
+ *  long other_pos                        : other table's record position
+ *  SQLTable& new_table                   : joined table
+ *
+ * POST-CONDITIONS:
+ *  SQLTable& new_table: one record inserted
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::join_records(const std::vector<std::string>& values,
+                            SQLTable& other, long other_pos,
+                            SQLTable& new_table) {
+    std::vector<std::string> other_values;  // values read from other record
+    other_values.reserve(REC_ROW);
+
+    if(!other.read_record(other_values, other_pos)) return;
+
+    std::vector<std::string> joined(values.begin(),
+                                    values.begin() + field_count());
+    joined.insert(joined.end(), other_values.begin(),
+                  other_values.begin() + other.field_count());
+
+    new_table.insert(joined);
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Writes the non-empty values of a field with their record positions to
+ *  count partition files, choosing the file by the value's hash. File p is
+ *  named by the table file name, ext and p.
+ *
+ * PRE-CONDITIONS:
+ *  const std::string& field        : field to partition by
+ *  std::size_t count               : number of partitions
+ *  const std::string& ext          : partition file extension
+ *  std::vector<std::string>& files : empty
+ *
+ * POST-CONDITIONS:
+ *  std::vector<std::string>& files: partition file names
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void SQLTable::partition(const std::string& field, std::size_t count,
+                         const std::string& ext,
+                         std::vector<std::string>& files) {
+    std::hash<std::string> hasher;
+    std::vector<std::ofstream> parts(count);
+    std::vector<int> columns(1, _field_to_pos[field]);  // partition field
+    std::vector<std::string> key;  // partition value read from record
+    std::size_t size;
+
+    for(std::size_t p = 0; p < count; ++p) {
+        files.push_back(_fname + ext + std::to_string(p));
+        parts[p].open(files[p].c_str(), std::ios::binary | std::ios::trunc);
+    }
+
+    for(long i = 1; i < _rec_count; ++i) {
+        key.clear();
+        if(!read_record(key, i, columns) || key[0].empty()) continue;
+
+        std::ofstream& part = parts[hasher(key[0]) % count];
+        size = key[0].size();
+        part.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        part.write(key[0].data(), size);
+        part.write(reinterpret_cast<const char*>(&i), sizeof(i));
+    }
+}
+
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Reads the next join value and record position from a partition file.
+ *
+ * PRE-CONDITIONS:
+ *  std::istream& part: partition file
+ *  std::string& key  : join value by ref
+ *  long& pos         : record position by ref
+ *
+ * POST-CONDITIONS:
+ *  std::string& key: next join value
+ *  long& pos       : next record position
+ *
+ * RETURN:
+ *  bool: false at end of partition
+ ******************************************************************************/
+bool SQLTable::read_partition(std::istream& part, std::string& key,
+                              long& pos) {
+    std::size_t size;
+
+    if(!part.read(reinterpret_cast<char*>(&size), sizeof(size))) return false;
+
+    key.resize(size);
+    part.read(&key[0], size);
+    part.read(reinterpret_cast<char*>(&pos), sizeof(pos));
+
+    return static_cast<bool>(part);
 }
 
 /*******************************************************************************
@@ -225,13 +225,13 @@ void SQLTokenizer::make_table(int _table[][state_machine::MAX_COLUMNS]) {
 
     // mark table with adjacency values
     mark_table_double(_table, STATE_DOUBLE);
-    mark_table_identifier(_table, STATE_IDENT_NORM);
+    mark_table_qualified_identifier(_table, STATE_IDENT_NORM);
     mark_table_enclosed_delim(_table, STATE_IN_QUOTE_S, '\'');
     mark_table_enclosed_delim(_table, STATE_IN_QUOTE_D, '\"');
     mark_table_enclosed_delim_ident(_table, STATE_IN_QUOTE_S_IDENT, '\'');
     mark_table_enclosed_delim_ident(_table, STATE_IN_QUOTE_D_IDENT, '\"');
     mark_table_generic(_table, STATE_SPACE, SPACE);
-    mark_table_generic(_table, STATE_PUNCT, PUNCT);
+    mark_table_single_char(_table, STATE_PUNCT, PUNCT);  // "(*)" is 3 tokens
     mark_table_r_ops(_table, STATE_R_OP);
 
     _need_init = false;  // disable further make_table() calls in CTOR
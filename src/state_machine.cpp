@@ -486,6 +486,39 @@ void mark_table_identifier(int _table[][MAX_COLUMNS], int state) {
     mark_cells(state + 1, _table, '_', '_', state + 1);
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *  Mark the table's cells with fail/success states and the adjacency values
+ *  for searching for qualified IDENTIFIER tokens, such as "employee.last".
+ *  A trailing '.' is not part of the token.
+ *
+ * PRE-CONDITIONS:
+ *  ROWS REQUIRE: 3
+ *  int _table[][MAX_COLUMNS]: integer array
+ *  int state                : 0 to MAX_ROWS - 1
+ *
+ * POST-CONDITIONS:
+ *  Cells are marked with state
+ *
+ * RETURN:
+ *  none
+ ******************************************************************************/
+void mark_table_qualified_identifier(int _table[][MAX_COLUMNS], int state) {
+    mark_table_identifier(_table, state);
+
+    // MARK SUCCESS/FAILURE
+    // state [+2] ---> fail
+    mark_fail(_table, state + 2);
+
+    // MARK CELLS
+    // state [+1] --- '.' -----> [+2]
+    // state [+2] --- ALPHA ---> [+1]
+    // state [+2] --- '_' -----> [+1]
+    mark_cells(state + 1, _table, '.', '.', state + 2);
+    mark_cells(state + 2, _table, ALPHA, state + 1);
+    mark_cells(state + 2, _table, '_', '_', state + 1);
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *  Mark the table's cells with fail/success states and the adjacency values